@@ -16,8 +16,8 @@ contains(QT_VERSION, ^4\\.[0-5]\\..*){
 }
 
 TEMPLATE	= subdirs
-SUBDIRS		= qrmc qrxc qrgui qrxml qrrepo
+SUBDIRS		= qrmc qrxc qrgui qrxml qrrepo typelib
 
 qrmc.depends = qrrepo
-qrgui.depends = qrxc qrxml qrrepo
+qrgui.depends = qrxc qrxml qrrepo typelib
 qrxml.depends = qrxc
@@ -0,0 +1,204 @@
+#include "editorBuilder.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QThread>
+
+using namespace qReal;
+
+EditorBuilder::EditorBuilder(QObject *parent)
+	: QObject(parent)
+	, mStep(0)
+	, mSteps(0)
+	, mCancelled(false)
+{
+	mProcess.setProcessChannelMode(QProcess::MergedChannels);
+	connect(&mProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(readOutput()));
+	connect(&mProcess, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(processFinished(int, QProcess::ExitStatus)));
+	connect(&mProcess, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processError(QProcess::ProcessError)));
+}
+
+EditorBuilder::~EditorBuilder()
+{
+	mJobs.clear();
+	if (mProcess.state() != QProcess::NotRunning) {
+		mProcess.disconnect(this);
+		mProcess.kill();
+		mProcess.waitForFinished(1000);
+	}
+}
+
+void EditorBuilder::build(QString const &editorName, QString const &directory
+		, QString const &qmakeCommand, QString const &makeCommand, QString const &pluginFileName
+		, Preparation *preparation)
+{
+	Job job;
+	job.editorName = editorName;
+	job.directory = directory;
+	job.pluginFileName = pluginFileName;
+	job.preparation = QSharedPointer<Preparation>(preparation);
+	job.started = false;
+	if (!makefileIsUpToDate(directory))
+		job.commands << qmakeCommand;
+	job.commands << parallelMakeCommand(makeCommand);
+
+	bool const wasRunning = isRunning();
+	mJobs.append(job);
+	mSteps += job.commands.size();
+	emit progress(mStep, mSteps);
+
+	if (!wasRunning) {
+		mCancelled = false;
+		startNextCommand();
+	}
+}
+
+bool EditorBuilder::isRunning() const
+{
+	return !mJobs.isEmpty() || mCancelled;
+}
+
+void EditorBuilder::cancel()
+{
+	if (mJobs.isEmpty())
+		return;
+
+	mStep = 0;
+	mSteps = 0;
+	if (mCancelled) {
+		// The killed process is still running, builds queued meanwhile never started
+		mJobs.clear();
+		return;
+	}
+
+	mCancelled = true;
+	mCancelledEditor = mJobs.first().editorName;
+	mJobs.clear();
+	if (mProcess.state() != QProcess::NotRunning) {
+		// Finished in processFinished(), so neither the old plugin is reloaded nor a build
+		// queued meanwhile is started while the killed make may still write files
+		mProcess.kill();
+		return;
+	}
+	finishCancel();
+}
+
+void EditorBuilder::finishCancel()
+{
+	mCancelled = false;
+	emit failed(mCancelledEditor, tr("build cancelled"));
+	startNextCommand();
+}
+
+void EditorBuilder::startNextCommand()
+{
+	if (mJobs.isEmpty()) {
+		mStep = 0;
+		mSteps = 0;
+		emit finished();
+		return;
+	}
+
+	if (!mJobs.first().started) {
+		mJobs.first().started = true;
+		emit aboutToBuild(mJobs.first().editorName, mJobs.first().pluginFileName);
+
+		QString error;
+		QSharedPointer<Preparation> const preparation = mJobs.first().preparation;
+		if (preparation && !preparation->prepare(error)) {
+			failCurrentJob(error);
+			return;
+		}
+	}
+
+	Job &job = mJobs.first();
+	if (job.commands.isEmpty()) {
+		Job const done = mJobs.takeFirst();
+		emit built(done.editorName, done.pluginFileName);
+		startNextCommand();
+		return;
+	}
+
+	QString const command = job.commands.takeFirst();
+	emit output(QDir(job.directory).absolutePath() + "> " + command);
+	mProcess.setWorkingDirectory(job.directory);
+	mProcess.start(command);
+}
+
+void EditorBuilder::readOutput()
+{
+	mPendingOutput += QString::fromLocal8Bit(mProcess.readAllStandardOutput());
+	int newLine = mPendingOutput.indexOf('\n');
+	while (newLine != -1) {
+		QString const line = mPendingOutput.left(newLine).trimmed();
+		if (!line.isEmpty())
+			emit output(line);
+		mPendingOutput.remove(0, newLine + 1);
+		newLine = mPendingOutput.indexOf('\n');
+	}
+}
+
+void EditorBuilder::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+	readOutput();
+	if (!mPendingOutput.trimmed().isEmpty())
+		emit output(mPendingOutput.trimmed());
+	mPendingOutput.clear();
+
+	if (mCancelled) {
+		finishCancel();
+		return;
+	}
+	if (mJobs.isEmpty())
+		return;
+
+	if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+		failCurrentJob(tr("command failed with exit code %1").arg(exitCode));
+		return;
+	}
+
+	++mStep;
+	emit progress(mStep, mSteps);
+	startNextCommand();
+}
+
+void EditorBuilder::processError(QProcess::ProcessError error)
+{
+	// Crashes and kills are reported through finished(), only failure to start is not.
+	if (error != QProcess::FailedToStart || mCancelled || mJobs.isEmpty())
+		return;
+
+	failCurrentJob(tr("cannot start %1").arg(mProcess.errorString()));
+}
+
+void EditorBuilder::failCurrentJob(QString const &reason)
+{
+	Job const job = mJobs.takeFirst();
+	mSteps -= job.commands.size();
+	emit failed(job.editorName, reason);
+	startNextCommand();
+}
+
+bool EditorBuilder::makefileIsUpToDate(QString const &directory)
+{
+	QDir const dir(directory);
+	QFileInfo const makefile(dir.absoluteFilePath("Makefile"));
+	if (!makefile.exists())
+		return false;
+
+	foreach (QFileInfo const &project, dir.entryInfoList(QStringList("*.pro"), QDir::Files)) {
+		if (project.lastModified() > makefile.lastModified())
+			return false;
+	}
+	return true;
+}
+
+QString EditorBuilder::parallelMakeCommand(QString const &makeCommand)
+{
+	// nmake does not know about parallel builds, and the user may have set -j already.
+	if (makeCommand.contains("nmake", Qt::CaseInsensitive) || makeCommand.contains(" -j"))
+		return makeCommand;
+
+	int const jobs = qMax(1, QThread::idealThreadCount());
+	return makeCommand + " -j" + QString::number(jobs);
+}
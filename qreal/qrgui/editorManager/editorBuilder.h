@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QProcess>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+namespace qReal {
+
+/// Builds editor plugins in background: runs qmake and make through QProcess without
+/// blocking the GUI, streams their output, supports cancellation. Builds are queued
+/// and executed one after another.
+class EditorBuilder : public QObject
+{
+	Q_OBJECT
+
+public:
+	/// Step of a build executed in the GUI thread right before its commands, when commands of
+	/// previous builds are finished, e.g. generation of the sources the build compiles.
+	class Preparation
+	{
+	public:
+		virtual ~Preparation() {}
+		/// Returns false and the reason if the build can not go on
+		virtual bool prepare(QString &error) = 0;
+	};
+
+	explicit EditorBuilder(QObject *parent = NULL);
+	~EditorBuilder();
+
+	/// Queues a build of the plugin project in a given directory. qmake is skipped if
+	/// the Makefile is newer than the project file, make is run with -jN where N is
+	/// the number of processor cores, so only changed sources are recompiled.
+	/// Takes ownership of preparation, which may be NULL.
+	void build(QString const &editorName, QString const &directory
+			, QString const &qmakeCommand, QString const &makeCommand, QString const &pluginFileName
+			, Preparation *preparation = NULL);
+
+	/// True while builds are queued or a cancelled one is still being stopped
+	bool isRunning() const;
+
+public slots:
+	/// Stops the current build and drops all queued ones. The current build fails when its
+	/// process is gone, builds queued meanwhile wait for that.
+	void cancel();
+
+signals:
+	/// Emitted before the first step of a build, so the loaded version of the plugin can be
+	/// unloaded and make can replace its file. Either built() or failed() follows.
+	void aboutToBuild(QString const &editorName, QString const &pluginFileName);
+	void output(QString const &line);
+	/// Step of all queued builds which is being executed, for a progress bar.
+	void progress(int step, int steps);
+	void built(QString const &editorName, QString const &pluginFileName);
+	void failed(QString const &editorName, QString const &reason);
+	/// Emitted when the queue becomes empty, whatever the results were.
+	void finished();
+
+private slots:
+	void readOutput();
+	void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+	void processError(QProcess::ProcessError error);
+
+private:
+	struct Job {
+		QString editorName;
+		QString directory;
+		QStringList commands;
+		QString pluginFileName;
+		QSharedPointer<Preparation> preparation;
+		bool started;
+	};
+
+	void startNextCommand();
+	void failCurrentJob(QString const &reason);
+	void finishCancel();
+	static bool makefileIsUpToDate(QString const &directory);
+	static QString parallelMakeCommand(QString const &makeCommand);
+
+	QList<Job> mJobs;
+	QProcess mProcess;
+	QString mPendingOutput;
+	int mStep;
+	int mSteps;
+	bool mCancelled;
+	QString mCancelledEditor;
+};
+
+}
@@ -1,6 +1,7 @@
 #include "editorManager.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QSettings>
 #include <QtGui/QMessageBox>
 #include <QtGui/QIcon>
 
@@ -11,6 +12,7 @@
 #include "../../qrrepo/repoApi.h"
 #include "../umllib/uml_nodeelement.h"
 #include "../umllib/uml_edgeelement.h"
+#include "../view/gestures/gesturesrecognizer.h"
 
 using namespace qReal;
 
@@ -36,6 +38,7 @@ EditorManager::EditorManager(QObject *parent)
 				mPluginsLoaded += iEditor->id();
 				mPluginFileName.insert(iEditor->id(), fileName);
 				mPluginIface[iEditor->id()] = iEditor;
+				buildGesturesRecognizers(iEditor->id());
 			}
 		} else {
 			qDebug() << "Plugin loading failed: " << loader->errorString();
@@ -45,6 +48,11 @@ EditorManager::EditorManager(QObject *parent)
 	}
 }
 
+EditorManager::~EditorManager()
+{
+	qDeleteAll(mGesturesRecognizers);
+}
+
 bool EditorManager::loadPlugin(const QString &pluginName)
 {
 	QPluginLoader *loader = new QPluginLoader(mPluginsDir.absoluteFilePath(pluginName));
@@ -54,9 +62,15 @@ bool EditorManager::loadPlugin(const QString &pluginName)
 	if (plugin) {
 		EditorInterface *iEditor = qobject_cast<EditorInterface *>(plugin);
 		if (iEditor) {
+			{
+				QMutexLocker locker(&mPropertySchemasMutex);
+				dropPropertySchemas(iEditor->id());
+				mPluginIface[iEditor->id()] = iEditor;
+			}
+			dropGesturesRecognizers(iEditor->id());
 			mPluginsLoaded += iEditor->id();
 			mPluginFileName.insert(iEditor->id(), pluginName);
-			mPluginIface[iEditor->id()] = iEditor;
+			buildGesturesRecognizers(iEditor->id());
 			return true;
 		}
 	}
@@ -69,6 +83,12 @@ bool EditorManager::unloadPlugin(const QString &pluginName)
 {
 	QPluginLoader *loader = mLoaders[mPluginFileName[pluginName]];
 	if (loader != NULL) {
+		{
+			QMutexLocker locker(&mPropertySchemasMutex);
+			dropPropertySchemas(pluginName);
+			mPluginIface.remove(pluginName);
+		}
+		dropGesturesRecognizers(pluginName);
 		mPluginsLoaded.removeAll(pluginName);
 		mPluginFileName.remove(pluginName);
 		return loader->unload();
@@ -166,6 +186,40 @@ QString EditorManager::mouseGesture(const Id &id) const
 	return mPluginIface[id.editor()]->elementMouseGesture(id.diagram(), id.element());
 }
 
+GesturesRecognizer *EditorManager::gesturesRecognizer(Id const &diagram) const
+{
+	return mGesturesRecognizers.value(Id(diagram.editor(), diagram.diagram()));
+}
+
+void EditorManager::buildGesturesRecognizers(QString const &editor)
+{
+	QString const kind = QSettings("SPbSU", "QReal").value("GesturesRecognizer").toString();
+	foreach (Id const &diagram, diagrams(Id(editor))) {
+		QList<QPair<Id, PathVector> > gestures;
+		foreach (Id const &element, elements(diagram)) {
+			QString const gesture = mouseGesture(element);
+			if (!gesture.isEmpty()) {
+				gestures << qMakePair(element, GesturesRecognizer::stringToGesture(gesture));
+			}
+		}
+		GesturesRecognizer *recognizer = GesturesRecognizer::create(kind);
+		recognizer->setIdealGestures(gestures);
+		mGesturesRecognizers.insert(diagram, recognizer);
+	}
+}
+
+void EditorManager::dropGesturesRecognizers(QString const &editor)
+{
+	QMutableHashIterator<Id, GesturesRecognizer *> iterator(mGesturesRecognizers);
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (iterator.key().editor() == editor) {
+			delete iterator.value();
+			iterator.remove();
+		}
+	}
+}
+
 QIcon EditorManager::icon(const Id &id) const
 {
 	Q_ASSERT(mPluginsLoaded.contains(id.editor()));
@@ -191,8 +245,63 @@ UML::Element* EditorManager::graphicalObject(const Id &id) const
 QStringList EditorManager::getPropertyNames(const Id &id) const
 {
 	Q_ASSERT(id.idSize() == 3); // Applicable only to element types
-	Q_ASSERT(mPluginsLoaded.contains(id.editor()));
-	return mPluginIface[id.editor()]->getPropertyNames(id.diagram(), id.element());
+	QSharedPointer<PropertySchema const> const schema = propertySchema(id);
+	return schema ? schema->names() : QStringList();
+}
+
+QSharedPointer<PropertySchema const> EditorManager::propertySchema(Id const &id) const
+{
+	Q_ASSERT(id.idSize() == 3); // Applicable only to element types
+
+	QMutexLocker locker(&mPropertySchemasMutex);
+	QSharedPointer<PropertySchema const> schema = mPropertySchemas.value(id);
+	if (!schema) {
+		EditorInterface const *editor = mPluginIface.value(id.editor());
+		if (!editor)
+			return schema;
+		QStringList const names = editor->getPropertyNames(id.diagram(), id.element());
+		QStringList defaultValues;
+		QStringList typeNames;
+		QList<qRealType::QRealType *> types;
+		foreach (QString const &name, names) {
+			QString const typeName = editor->getPropertyType(id.element(), name);
+			defaultValues << editor->getPropertyDefaultValue(id.element(), name);
+			typeNames << typeName;
+
+			QString const element = referencedElement(editor, typeName);
+			types << PropertySchema::compileType(element.isEmpty() ? typeName : element
+					, editor->getEnumValues(typeName), !element.isEmpty());
+		}
+		schema = QSharedPointer<PropertySchema const>(new PropertySchema(names, defaultValues, typeNames, types));
+		mPropertySchemas.insert(id, schema);
+	}
+	return schema;
+}
+
+void EditorManager::dropPropertySchemas(QString const &editor)
+{
+	// Schemas still held by their users are deleted when released
+	QMutableHashIterator<Id, QSharedPointer<PropertySchema const> > iterator(mPropertySchemas);
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (iterator.key().editor() == editor)
+			iterator.remove();
+	}
+}
+
+QString EditorManager::referencedElement(EditorInterface const *editor, QString const &typeName) const
+{
+	if (typeName.isEmpty()) {
+		return QString();
+	}
+	foreach (QString const &diagram, editor->diagrams()) {
+		foreach (QString const &element, editor->elements(diagram)) {
+			if (element.compare(typeName, Qt::CaseInsensitive) == 0) {
+				return element;
+			}
+		}
+	}
+	return QString();
 }
 
 IdList EditorManager::getContainedTypes(const Id &id) const
@@ -238,19 +347,28 @@ IdList EditorManager::getUsedTypes(const Id &id) const
 QStringList EditorManager::getEnumValues(Id const &id, const QString &name) const
 {
 	Q_ASSERT(mPluginsLoaded.contains(id.editor()));
-	QString typeName = mPluginIface[id.editor()]->getPropertyType(id.element(), name);
+	QString const typeName = getTypeName(id, name);
 	return mPluginIface[id.editor()]->getEnumValues(typeName);
 }
 
 QString EditorManager::getTypeName(const Id &id, const QString &name) const
 {
-	return mPluginIface[id.editor()]->getPropertyType(id.element(), name);
+	QSharedPointer<PropertySchema const> const schema = propertySchema(id.type());
+	if (!schema)
+		return QString();
+	int const slot = schema->slot(name);
+	return slot >= 0 ? schema->typeName(slot)
+			: mPluginIface[id.editor()]->getPropertyType(id.element(), name);
 }
 
 QString EditorManager::getDefaultPropertyValue(Id const &id, QString name) const
 {
-	Q_ASSERT(mPluginsLoaded.contains(id.editor()));
-	return mPluginIface[id.editor()]->getPropertyDefaultValue(id.element(), name);
+	QSharedPointer<PropertySchema const> const schema = propertySchema(id.type());
+	if (!schema)
+		return QString();
+	int const slot = schema->slot(name);
+	return slot >= 0 ? schema->defaultValue(slot)
+			: mPluginIface[id.editor()]->getPropertyDefaultValue(id.element(), name);
 }
 
 QStringList EditorManager::getPropertiesWithDefaultValues(Id const &id) const
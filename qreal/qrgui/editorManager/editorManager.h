@@ -3,11 +3,15 @@
 #include <QtCore/QDir>
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QPluginLoader>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QStringList>
 #include <QtGui/QIcon>
 
 #include "listenerManager.h"
+#include "propertySchema.h"
 #include "../kernel/ids.h"
 #include "../pluginInterface/editorInterface.h"
 #include "../../qrrepo/graphicalRepoApi.h"
@@ -16,6 +20,8 @@
 namespace UML {
 	class Element;
 }
+class GesturesRecognizer;
+
 namespace qReal {
 	class EditorManager : public QObject
 	{
@@ -23,6 +29,7 @@ namespace qReal {
 
 	public:
 		explicit EditorManager(QObject *parent = NULL);
+		~EditorManager();
 
 		IdList editors() const;
 		IdList diagrams(Id const &editor) const;
@@ -31,6 +38,11 @@ namespace qReal {
 		bool unloadPlugin(QString const &pluginName);
 
 		QString mouseGesture(Id const &id) const;
+		/// Recognizer of gestures of elements of a diagram. Keys of ideal gestures are built when
+		/// the plugin is loaded, kind of the recognizer is taken from "GesturesRecognizer" setting.
+		/// Recognizer is deleted when the plugin is unloaded or reloaded, so it shall not be kept.
+		/// NULL if the plugin is not loaded.
+		GesturesRecognizer *gesturesRecognizer(Id const &diagram) const;
 		QString friendlyName(Id const &id) const;
 		QString description(Id const &id) const;
 		QString propertyDescription(Id const &id, QString const &propertyName) const;
@@ -51,6 +63,11 @@ namespace qReal {
 		virtual QString getDefaultPropertyValue(Id const &id, QString name) const;
 		virtual QStringList getPropertiesWithDefaultValues(Id const &id) const;
 
+		/// Cached description of properties of a given element type. Schema stays valid while it
+		/// is held, even if the plugin of the type is reloaded meanwhile, e.g. by a background
+		/// generator. Null if the plugin is not loaded. Thread-safe.
+		QSharedPointer<PropertySchema const> propertySchema(Id const &id) const;
+
 		IdList checkNeededPlugins(qrRepo::LogicalRepoApi const &logicalApi
 				, qrRepo::GraphicalRepoApi const &graphicalApi) const;
 		bool hasElement(Id const &element) const;
@@ -70,6 +87,18 @@ namespace qReal {
 		QDir mPluginsDir;
 		QStringList mPluginFileNames;
 
+		mutable QHash<Id, QSharedPointer<PropertySchema const> > mPropertySchemas;
+		/// Schemas are built on first use, also by generators reading a snapshot in a worker thread.
+		/// Guards plugin interfaces too, as schemas are built from them.
+		mutable QMutex mPropertySchemasMutex;
+		QHash<Id, GesturesRecognizer *> mGesturesRecognizers;
+
+		/// Shall be called with mPropertySchemasMutex locked.
+		void dropPropertySchemas(QString const &editor);
+		void buildGesturesRecognizers(QString const &editor);
+		void dropGesturesRecognizers(QString const &editor);
+		/// Element of the editor a property of given type refers to, empty if the type is not an element.
+		QString referencedElement(EditorInterface const *editor, QString const &typeName) const;
 		void checkNeededPluginsRecursive(qrRepo::CommonRepoApi const &api, Id const &id, IdList &result) const;
 	};
 
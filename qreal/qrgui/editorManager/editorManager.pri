@@ -2,7 +2,11 @@ HEADERS += \
 	editorManager/editorManager.h \
 	editorManager/listenerManager.h \
 	editorManager/listenerApi.h \
+	editorManager/editorBuilder.h \
+	editorManager/propertySchema.h \
 
 SOURCES += \
 	editorManager/editorManager.cpp \
 	editorManager/listenerManager.cpp \
+	editorManager/editorBuilder.cpp \
+	editorManager/propertySchema.cpp \
@@ -0,0 +1,85 @@
+#include "propertySchema.h"
+
+using namespace qReal;
+using namespace qRealType;
+
+PropertySchema::PropertySchema(QStringList const &names, QStringList const &defaultValues
+		, QStringList const &typeNames, QList<QRealType *> const &types)
+	: mNames(names)
+	, mDefaultValues(defaultValues)
+	, mTypeNames(typeNames)
+	, mTypes(types)
+{
+	Q_ASSERT(names.count() == defaultValues.count() && names.count() == typeNames.count());
+	Q_ASSERT(names.count() == types.count());
+	for (int i = 0; i < mNames.count(); ++i) {
+		mSlots.insert(mNames[i], i);
+	}
+}
+
+PropertySchema::~PropertySchema()
+{
+	qDeleteAll(mTypes);
+}
+
+int PropertySchema::count() const
+{
+	return mNames.count();
+}
+
+int PropertySchema::slot(QString const &name) const
+{
+	return mSlots.value(name, -1);
+}
+
+QString const &PropertySchema::name(int slot) const
+{
+	Q_ASSERT(slot >= 0 && slot < mNames.count());
+	return mNames.at(slot);
+}
+
+QString const &PropertySchema::defaultValue(int slot) const
+{
+	Q_ASSERT(slot >= 0 && slot < mDefaultValues.count());
+	return mDefaultValues.at(slot);
+}
+
+QString const &PropertySchema::typeName(int slot) const
+{
+	Q_ASSERT(slot >= 0 && slot < mTypeNames.count());
+	return mTypeNames.at(slot);
+}
+
+QRealType const &PropertySchema::type(int slot) const
+{
+	Q_ASSERT(slot >= 0 && slot < mTypes.count());
+	return *mTypes.at(slot);
+}
+
+QStringList const &PropertySchema::names() const
+{
+	return mNames;
+}
+
+QRealType *PropertySchema::compileType(QString const &typeName
+		, QStringList const &enumValues, bool isReference)
+{
+	QRealType const *string = QRealTypeFactory::getTypeByName("string");
+	if (!enumValues.isEmpty()) {
+		return string->restricted(QConstraintList() << QRealConstraint::enumeration(enumValues));
+	}
+	if (isReference) {
+		return string->restricted(QConstraintList() << QRealConstraint::reference(QStringList(typeName)));
+	}
+
+	QString const name = typeName.toLower();
+	QRealType const *base = string;
+	if (name == "int" || name == "integer") {
+		base = QRealTypeFactory::getTypeByName("integer");
+	} else if (name == "bool" || name == "boolean") {
+		base = QRealTypeFactory::getTypeByName("boolean");
+	} else if (name == "float" || name == "double" || name == "real") {
+		base = QRealTypeFactory::getTypeByName("real");
+	}
+	return base->restricted(QConstraintList());
+}
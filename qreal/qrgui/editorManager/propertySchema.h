@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtCore/QStringList>
+#include <QtCore/QHash>
+
+#include "../../typelib/typelib.h"
+
+namespace qReal {
+
+	/// Immutable description of properties of one element type, published by EditorManager.
+	/// Slot of a property is its stable index in the list of property names, so a model role
+	/// of a property is roles::customPropertiesBeginRole + slot.
+	/// Each property also has a type compiled once from the metamodel, values written
+	/// to the repository are checked against it.
+	class PropertySchema
+	{
+	public:
+		/// Takes ownership of types.
+		PropertySchema(QStringList const &names, QStringList const &defaultValues
+				, QStringList const &typeNames, QList<qRealType::QRealType *> const &types);
+		~PropertySchema();
+
+		int count() const;
+
+		/// Returns slot of a property with given name or -1 if there is no such property.
+		int slot(QString const &name) const;
+
+		QString const &name(int slot) const;
+		QString const &defaultValue(int slot) const;
+		QString const &typeName(int slot) const;
+		qRealType::QRealType const &type(int slot) const;
+
+		QStringList const &names() const;
+
+		/// Type of a property as declared in the metamodel: enumeration if it has enum values,
+		/// reference to elements of type typeName if isReference, otherwise one of basic types.
+		/// Unknown type names are treated as unrestricted strings. Caller owns the result.
+		static qRealType::QRealType *compileType(QString const &typeName
+				, QStringList const &enumValues, bool isReference);
+
+	private:
+		PropertySchema(PropertySchema const &);
+		PropertySchema &operator =(PropertySchema const &);
+
+		QStringList const mNames;
+		QStringList const mDefaultValues;
+		QStringList const mTypeNames;
+		QList<qRealType::QRealType *> const mTypes;
+		QHash<QString, int> mSlots;
+	};
+
+}
@@ -0,0 +1,61 @@
+#include "backgroundGenerator.h"
+#include "../../qrrepo/repoApi.h"
+
+#include <QtCore/QtConcurrentRun>
+
+using namespace qReal;
+using namespace generators;
+
+BackgroundGenerator::BackgroundGenerator(QObject *parent)
+	: QObject(parent)
+{
+	connect(&mWatcher, SIGNAL(finished()), this, SLOT(generationFinished()));
+}
+
+BackgroundGenerator::~BackgroundGenerator()
+{
+	mWatcher.disconnect(this);
+	mWatcher.waitForFinished();
+	foreach (Job const &job, mJobs)
+		delete job.snapshot;
+}
+
+void BackgroundGenerator::generate(QString const &name, Generation generation
+		, qrRepo::RepoControlInterface const &repo, QString const &target)
+{
+	Job job;
+	job.name = name;
+	job.generation = generation;
+	job.snapshot = repo.snapshot();
+	job.target = target;
+
+	bool const wasRunning = isRunning();
+	mJobs.append(job);
+	if (!wasRunning)
+		startNextJob();
+}
+
+bool BackgroundGenerator::isRunning() const
+{
+	return !mJobs.isEmpty();
+}
+
+void BackgroundGenerator::startNextJob()
+{
+	mWatcher.setFuture(QtConcurrent::run(&BackgroundGenerator::run, mJobs.first()));
+}
+
+QString BackgroundGenerator::run(Job const &job)
+{
+	return job.generation(*job.snapshot, job.target);
+}
+
+void BackgroundGenerator::generationFinished()
+{
+	QString const errors = mWatcher.result();
+	Job const job = mJobs.takeFirst();
+	delete job.snapshot;
+	if (!mJobs.isEmpty())
+		startNextJob();
+	emit finished(job.name, errors);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QFutureWatcher>
+
+#include "../../qrrepo/repoControlInterface.h"
+#include "../../qrrepo/logicalRepoApi.h"
+
+namespace qReal {
+
+	namespace generators {
+
+		/// Runs generators in a worker thread against a snapshot of repository, so the user
+		/// can keep editing while they run. Generations are queued and executed one after another.
+		class BackgroundGenerator : public QObject
+		{
+			Q_OBJECT
+
+		public:
+			/// Generates code or a document from a model to the target path, returns errors.
+			typedef QString (*Generation)(qrRepo::LogicalRepoApi const &api, QString const &target);
+
+			explicit BackgroundGenerator(QObject *parent = NULL);
+			/// Waits for the current generation, drops queued ones.
+			~BackgroundGenerator();
+
+			/// Snapshot is taken right away, so the generation doesn't see later changes.
+			void generate(QString const &name, Generation generation
+					, qrRepo::RepoControlInterface const &repo, QString const &target);
+
+			bool isRunning() const;
+
+		signals:
+			void finished(QString const &name, QString const &errors);
+
+		private slots:
+			void generationFinished();
+
+		private:
+			struct Job {
+				QString name;
+				Generation generation;
+				qrRepo::RepoApi *snapshot;
+				QString target;
+			};
+
+			void startNextJob();
+			static QString run(Job const &job);
+
+			QList<Job> mJobs;
+			QFutureWatcher<QString> mWatcher;
+		};
+
+	}
+
+}
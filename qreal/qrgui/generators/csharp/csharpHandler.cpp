@@ -22,72 +22,68 @@ Interfac::Interfac(){
     numVariables = 0;
     numMethods = 0;
 }
-QString Interfac::Print(void){
-    QString result = "";
+void Interfac::Print(QTextStream &out){
 
     if(visibility != "")
-        result += visibility + " ";
-    result +="interface "+ name;
+        out << visibility + " ";
+    out << "interface "+ name;
     bool key = false;
     foreach (QString str,interf ){
         if (key == false){
-            result +=": "+ str;
+            out << ": "+ str;
             key = true;
         }else{
-            result += ",  " + str;
+            out << ",  " + str;
         }
     }
-    result+="{\n";
+    out << "{\n";
 
     foreach (Variable var,variables ){
-          result += "  " + var.Print();
+          out << "  ";
+          var.Print(out);
     }
 
     Method met;
     for(int i = 0; i < numMethods; i++){
          met = methods.at(i);
-         result += "  " + met.Print();
+         out << "  ";
+         met.Print(out);
     }
 
 
-    result +="}\n\n";
+    out << "}\n\n";
     variables.clear();
     methods.clear();
-    return result;
 }
 
 Variable::Variable(){
     isStatic = false;
     isFinal = false;
 }
-QString Variable::Print(){
-    QString result = "";
+void Variable::Print(QTextStream &out){
     if(visibility != "")
-        result += visibility + " ";
-    result += type + " ";
+        out << visibility + " ";
+    out << type + " ";
     if(isStatic)
-            result += "static ";
-    result += name;
+            out << "static ";
+    out << name;
     if(defaultVal != "")
-        result += " = "+defaultVal;
-    result += ";\n";
-    return result;
+        out << " = "+defaultVal;
+    out << ";\n";
 }
 
 Method::Method(){
     isStatic = false;
     isFinal = false;
 }
-QString Method::Print(){
-    QString result = "";
+void Method::Print(QTextStream &out){
     if(visibility != "")
-        result += visibility + " ";
+        out << visibility + " ";
     if(isStatic)
-        result += "static ";
-    result += type + " "+ name + "()";
+        out << "static ";
+    out << type + " "+ name + "()";
 
-    result += "{}\n";
-    return result;
+    out << "{}\n";
 }
 
 ClassSet::ClassSet(){
@@ -100,48 +96,48 @@ ClassSet::ClassSet(){
     numMethods = 0;
 }
 
-QString ClassSet::Print(void){
-    QString result = "";
+void ClassSet::Print(QTextStream &out){
 
     if(property.visibility != "")
-        result += property.visibility + " ";
+        out << property.visibility + " ";
     if(property.isAbstract)
-        result +="abstract ";
+        out << "abstract ";
     if(property.isLeaf)
-        result +="sealed ";
-    result +="class "+ name;
+        out << "sealed ";
+    out << "class "+ name;
     if(cl != ""){
-        result += ": "+cl;
+        out << ": "+cl;
         foreach (QString str,interf ){
-            result += ",  " + str;
+            out << ",  " + str;
          }
     }else{
         bool key = false;
         foreach (QString str,interf ){
             if (key == false){
-                result +=": "+ str;
+                out << ": "+ str;
                 key = true;
             }else{
-                result += ",  " + str;
+                out << ",  " + str;
             }
         }
     }
-    result+="{\n";
+    out << "{\n";
 
     foreach (Variable var,variables ){
-        result += "  " + var.Print();
+        out << "  ";
+        var.Print(out);
     }
 
     Method met;
     for(int i = 0; i < numMethods; i++){
          met = methods.at(i);
-         result += "  " + met.Print();
+         out << "  ";
+         met.Print(out);
     }
 
-    result +="}\n\n";
+    out << "}\n\n";
     variables.clear();
     methods.clear();
-    return result;
 }
 
 QString CsharpHandler::generateToCsharp(QString const &pathToFile)
@@ -178,7 +174,7 @@ QString CsharpHandler::generateToCsharp(QString const &pathToFile)
        Interfac newInterface;
         for(int i = 0; i < numberInterface; i++){
             newInterface = interfaces.at(i);
-            out << newInterface.Print();
+            newInterface.Print(out);
 
         }
 
@@ -186,7 +182,7 @@ QString CsharpHandler::generateToCsharp(QString const &pathToFile)
         ClassSet newClass;
         for(int i = 0; i<number; i++){
             newClass = classes.at(i);
-            out << newClass.Print();
+            newClass.Print(out);
 
         }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtCore/QTextStream>
 #include <QSet>
 
 #include "../../kernel/ids.h"
@@ -29,7 +30,7 @@ namespace qReal {
                     bool isStatic;
                     bool isFinal;
                     Variable();
-                    QString Print(void);
+                    void Print(QTextStream &out);
 
 
             };
@@ -43,7 +44,7 @@ namespace qReal {
                     QString visibility;
                 QList<Variable > inputValue;
                 Method();
-                QString Print(void);
+                void Print(QTextStream &out);
 
             };
             class Interfac{
@@ -58,7 +59,7 @@ namespace qReal {
 
                 public:
                     Interfac();
-                    QString Print(void);
+                    void Print(QTextStream &out);
 
             };
 
@@ -75,7 +76,7 @@ namespace qReal {
 
                 public:
                     ClassSet();
-                    QString Print(void);
+                    void Print(QTextStream &out);
                     void SetName(QString &Classname);
                     void SetProperty(QString visability, bool isAbstract, bool isLeaf );
 
@@ -2,6 +2,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QCryptographicHash>
 
 #include <QtCore/QDebug>
 #include <QtCore/QFileInfo>
@@ -9,14 +10,11 @@
 
 #include "../../kernel/roles.h"
 
-#include "../../../utils/outFile.h"
-
 using namespace qReal;
 using namespace generators;
-using namespace utils;
 
 EditorGenerator::EditorGenerator(qrRepo::LogicalRepoApi const &api)
-	: mApi(api)
+	: mApi(api), mGeneratedFiles(0), mChangedFiles(0)
 {
 }
 
@@ -24,7 +22,7 @@ QHash<Id, QString> EditorGenerator::getMetamodelList()
 {
 	Id repoId = Id::rootId();
 
-	IdList const metamodels = mApi.children(repoId);
+	IdList const &metamodels = mApi.constChildren(repoId);
 	QHash<Id, QString> metamodelList;
 
 	foreach (Id const key, metamodels) {
@@ -42,6 +40,9 @@ QHash<Id, QString> EditorGenerator::getMetamodelList()
 
 gui::ErrorReporter &EditorGenerator::generateEditor(Id const metamodelId, const QString &pathToFile)
 {
+	mGeneratedFiles = 0;
+	mChangedFiles = 0;
+
 	QString includeProList;
 	QFileInfo fileName(pathToFile);
 	QString baseName = fileName.baseName();
@@ -67,17 +68,15 @@ gui::ErrorReporter &EditorGenerator::generateEditor(Id const metamodelId, const
 
 	createDiagrams(metamodel, metamodelId);
 
-	OutFile outpro(pathToFile + ".pro");
-	outpro() << QString("QREAL_XML = %1\n").arg(baseName + ".xml");
+	QString pro = QString("QREAL_XML = %1\n").arg(baseName + ".xml");
 	if (includeProList != "")
-		outpro() << QString("QREAL_XML_DEPENDS = %1\n").arg(includeProList);
-	outpro() << QString ("QREAL_EDITOR_NAME = %1\n").arg(baseName);
-	outpro() << "\n";
-	outpro() << "include (../editorsCommon.pri)";
-
-	OutFile outxml(pathToFile + ".xml");
-	outxml() << "<?xml version='1.0' encoding='utf-8'?>\n";
-	outxml() << mDocument.toString(4);
+		pro += QString("QREAL_XML_DEPENDS = %1\n").arg(includeProList);
+	pro += QString ("QREAL_EDITOR_NAME = %1\n").arg(baseName);
+	pro += "\n";
+	pro += "include (../editorsCommon.pri)";
+	saveIfChanged(pathToFile + ".pro", pro);
+
+	saveIfChanged(pathToFile + ".xml", "<?xml version='1.0' encoding='utf-8'?>\n" + mDocument.toString(4));
 	mDocument.clear();
 
 	copyImages(pathToFile);
@@ -85,6 +84,41 @@ gui::ErrorReporter &EditorGenerator::generateEditor(Id const metamodelId, const
 	return mErrorReporter;
 }
 
+int EditorGenerator::generatedFilesCount() const
+{
+	return mGeneratedFiles;
+}
+
+int EditorGenerator::changedFilesCount() const
+{
+	return mChangedFiles;
+}
+
+void EditorGenerator::saveIfChanged(QString const &fileName, QString const &content)
+{
+	++mGeneratedFiles;
+	QByteArray const data = content.toUtf8();
+	if (fileHash(fileName, QIODevice::Text) == QCryptographicHash::hash(data, QCryptographicHash::Md5))
+		return;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		mErrorReporter.addError("cannot write " + fileName);
+		return;
+	}
+	file.write(data);
+	file.close();
+	++mChangedFiles;
+}
+
+QByteArray EditorGenerator::fileHash(QString const &fileName, QIODevice::OpenMode mode)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | mode))
+		return QByteArray();
+	return QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5);
+}
+
 void EditorGenerator::copyImages(QString const &pathToFile)
 {
 	QSettings settings("SPbSU", "QReal");
@@ -99,13 +133,27 @@ void EditorGenerator::copyImages(QString const &pathToFile)
 	destDir.mkdir("images");
 	destDir.cd("images");
 
-	foreach (QString const file, sourceDir.entryList(QDir::Files))
-		QFile::copy(sourceDir.absolutePath() + "/" + file, destDir.absolutePath() + "/" + file);
+	foreach (QString const file, sourceDir.entryList(QDir::Files)) {
+		++mGeneratedFiles;
+		QFileInfo const source(sourceDir.absoluteFilePath(file));
+		QFileInfo const destination(destDir.absoluteFilePath(file));
+		if (destination.exists() && destination.size() == source.size()
+				&& fileHash(destination.filePath(), QIODevice::NotOpen) == fileHash(source.filePath(), QIODevice::NotOpen))
+		{
+			continue;
+		}
+		// QFile::copy() does not overwrite, so a changed image has to be removed first.
+		QFile::remove(destination.filePath());
+		if (QFile::copy(source.filePath(), destination.filePath()))
+			++mChangedFiles;
+		else
+			mErrorReporter.addError("cannot copy image " + file);
+	}
 }
 
 void EditorGenerator::createDiagrams(QDomElement &parent, const Id &id)
 {
-	IdList rootElements = mApi.children(id);
+	IdList const &rootElements = mApi.constChildren(id);
 	foreach (Id const typeElement, rootElements) {
 		QString const objectType = mApi.typeName(typeElement);
 		if (objectType == "MetaEditorDiagramNode") {
@@ -129,7 +177,7 @@ void EditorGenerator::createDiagrams(QDomElement &parent, const Id &id)
 
 void EditorGenerator::serializeObjects(QDomElement &parent, Id const &idParent)
 {
-	IdList const childElems = mApi.children(idParent);
+	IdList const &childElems = mApi.constChildren(idParent);
 	mElements = childElems;
 	mDiagramName = mApi.name(idParent);
 
@@ -294,7 +342,7 @@ void EditorGenerator::setGeneralization(QDomElement &parent, const Id &id)
 void EditorGenerator::setProperties(QDomElement &parent,Id const &id)
 {
 	QDomElement tagProperties = mDocument.createElement("properties");
-	IdList const childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	foreach (Id const idChild, childElems)
 		if (idChild != Id::rootId()) {
@@ -320,7 +368,7 @@ void EditorGenerator::setProperties(QDomElement &parent,Id const &id)
 void EditorGenerator::setContextMenuFields(QDomElement &parent, const Id &id)
 {
 	QDomElement fields = mDocument.createElement("bonusContextMenuFields");
-	IdList const childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	foreach (Id const idChild, childElems)
 		if (idChild != Id::rootId()) {
@@ -338,7 +386,7 @@ void EditorGenerator::setContextMenuFields(QDomElement &parent, const Id &id)
 
 void EditorGenerator::setValues(QDomElement &parent, const Id &id)
 {
-	IdList childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	foreach (Id const idChild, childElems) {
 		if (idChild != Id::rootId()) {
@@ -352,7 +400,7 @@ void EditorGenerator::setValues(QDomElement &parent, const Id &id)
 
 void EditorGenerator::setAssociations(QDomElement &parent, const Id &id)
 {
-	IdList const childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	foreach (Id const idChild, childElems) {
 		QString const objectType = mApi.typeName(idChild);
@@ -383,7 +431,7 @@ void EditorGenerator::setConnections(QDomElement &parent, const Id &id)
 void EditorGenerator::newSetConnections(QDomElement &parent, const Id &id,
 		QString const &commonTagName, QString const &internalTagName, QString const &typeName)
 {
-	IdList const childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	QDomElement connectionsTag = mDocument.createElement(commonTagName);
 
@@ -402,7 +450,7 @@ void EditorGenerator::newSetConnections(QDomElement &parent, const Id &id,
 
 void EditorGenerator::setPossibleEdges(QDomElement &parent, const Id &id)
 {
-	IdList const childElems = mApi.children(id);
+	IdList const &childElems = mApi.constChildren(id);
 
 	QDomElement possibleEdges = mDocument.createElement("possibleEdges");
 
@@ -467,7 +515,7 @@ void EditorGenerator::setContainer(QDomElement &parent, const Id &id)
 
 void EditorGenerator::setContainerProperties(QDomElement &parent, const Id &id)
 {
-	IdList elements = mApi.children(id);
+	IdList const &elements = mApi.constChildren(id);
 
 	foreach (Id const idChild, elements) {
 		if (mApi.typeName(idChild) == "MetaEntityPropertiesAsContainer") {
@@ -4,6 +4,7 @@
 #include <QtXml/QDomDocument>
 #include <QtXml/QDomElement>
 #include <QtCore/QHash>
+#include <QtCore/QIODevice>
 
 #include "../../kernel/ids.h"
 #include "../../mainwindow/errorReporter.h"
@@ -20,6 +21,11 @@ namespace qReal {
 
 			QHash<Id, QString> getMetamodelList();
 			gui::ErrorReporter& generateEditor(Id const metamodelId, QString const &pathToFile);
+
+			/// Files (.pro, .xml and images) produced by the last generateEditor() call.
+			int generatedFilesCount() const;
+			/// Those of them that were actually written: the rest already had the same content.
+			int changedFilesCount() const;
 		private:
 			void serializeObjects(QDomElement &parent, Id const &idParent);
 			void createImport(QDomElement &parent, Id const &id);
@@ -45,7 +51,11 @@ namespace qReal {
 			void ensureCorrectness (Id const &id, QDomElement element, QString const &tagName, QString const &value);
 			void setBoolValuesForContainer (QString const &propertyName, QDomElement &properties, Id const &id);
 			void setSizesForContainer (QString const &propertyName, QDomElement &properties, Id const &id);
-			static void copyImages(QString const &pathToFile);
+			void copyImages(QString const &pathToFile);
+			/// Writes the file only if its content hash differs from the one on disk, so that
+			/// unchanged files keep their timestamps and qrxc and make have nothing to redo.
+			void saveIfChanged(QString const &fileName, QString const &content);
+			static QByteArray fileHash(QString const &fileName, QIODevice::OpenMode mode);
 
 			qrRepo::LogicalRepoApi const &mApi;
 			QDomDocument mDocument;
@@ -53,6 +63,8 @@ namespace qReal {
 			IdList mElements;
 			QString mDiagramName;
 			gui::ErrorReporter mErrorReporter;
+			int mGeneratedFiles;
+			int mChangedFiles;
 		};
 	}
 }
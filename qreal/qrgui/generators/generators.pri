@@ -1,3 +1,7 @@
+HEADERS += generators/backgroundGenerator.h \
+
+SOURCES += generators/backgroundGenerator.cpp \
+
 # XMI
 HEADERS += generators/xmi/xmiHandler.h \
 
@@ -5,8 +9,10 @@ SOURCES += generators/xmi/xmiHandler.cpp \
 
 # JAVA
 HEADERS += generators/java/javaHandler.h \
+	generators/java/controlFlowGraph.h \
 
 SOURCES += generators/java/javaHandler.cpp \
+	generators/java/controlFlowGraph.cpp \
 
 # Генератор хаскола
 HEADERS += generators/hascol/hascolGenerator.h \
@@ -0,0 +1,286 @@
+#include "controlFlowGraph.h"
+
+#include <QtCore/QPair>
+
+using namespace qReal;
+using namespace generators;
+
+ControlFlowGraph::ControlFlowGraph(qrRepo::LogicalRepoApi const &api, Id const &container)
+{
+	IdList const children = api.children(container);
+
+	// Links are children of the diagram too, so find them first and take the rest as nodes.
+	QHash<Id, IdList> outgoing;
+	QSet<Id> links;
+	foreach (Id const child, children) {
+		IdList const childLinks = api.outgoingLinks(child);
+		outgoing.insert(child, childLinks);
+		foreach (Id const link, childLinks) {
+			links.insert(link);
+		}
+	}
+	foreach (Id const child, children) {
+		if (!links.contains(child)) {
+			mIndices.insert(child, mNodes.size());
+			mNodes.append(child);
+		}
+	}
+
+	int const count = mNodes.size();
+	mOutgoing.resize(count);
+	mIncoming.resize(count);
+	mExceptions.resize(count);
+
+	for (int i = 0; i < count; ++i) {
+		Id const node = mNodes.at(i);
+		bool const isActivity = node.element() == "ActivityDiagram_Activity";
+		foreach (Id const link, outgoing.value(node)) {
+			if (!isControlFlow(link))
+				continue;
+			Id const target = api.otherEntityFromLink(link, node);
+			QString const guard = flowGuard(api, link);
+			mSources.insert(link, node);
+			mTargets.insert(link, target);
+			mGuards.insert(link, guard);
+			if (isActivity && guard != "")
+				mExceptions[i].append(link);
+			else
+				mOutgoing[i].append(link);
+			int const targetIndex = index(target);
+			if (targetIndex != -1)
+				mIncoming[targetIndex].append(link);
+		}
+	}
+
+	// Both trees are built with an extra virtual node: the entry, linked to every node without
+	// incoming links, and the exit, reached from every node without outgoing ones.
+	QVector<QVector<int> > successors(count + 1);
+	QVector<QVector<int> > predecessors(count + 1);
+	for (int i = 0; i < count; ++i) {
+		foreach (Id const link, mOutgoing.at(i) + mExceptions.at(i)) {
+			int const targetIndex = index(mTargets.value(link));
+			if (targetIndex == -1)
+				continue;
+			successors[i].append(targetIndex);
+			predecessors[targetIndex].append(i);
+		}
+	}
+	for (int i = 0; i < count; ++i) {
+		if (predecessors.at(i).isEmpty())
+			successors[count].append(i);
+		if (successors.at(i).isEmpty())
+			predecessors[count].append(i);
+	}
+
+	mDominators.build(successors, count);
+	mPostDominators.build(predecessors, count);
+
+	for (int i = 0; i < count; ++i) {
+		foreach (Id const link, mOutgoing.at(i)) {
+			int const targetIndex = index(mTargets.value(link));
+			if (targetIndex != -1 && mDominators.dominates(targetIndex, i))
+				mLoopHeaders.insert(targetIndex);
+		}
+	}
+}
+
+bool ControlFlowGraph::contains(Id const &node) const
+{
+	return mIndices.contains(node);
+}
+
+IdList ControlFlowGraph::outgoingLinks(Id const &node) const
+{
+	int const i = index(node);
+	return i == -1 ? IdList() : mOutgoing.at(i);
+}
+
+IdList ControlFlowGraph::incomingLinks(Id const &node) const
+{
+	int const i = index(node);
+	return i == -1 ? IdList() : mIncoming.at(i);
+}
+
+IdList ControlFlowGraph::exceptionLinks(Id const &node) const
+{
+	int const i = index(node);
+	return i == -1 ? IdList() : mExceptions.at(i);
+}
+
+Id ControlFlowGraph::source(Id const &link) const
+{
+	return mSources.value(link);
+}
+
+Id ControlFlowGraph::target(Id const &link) const
+{
+	return mTargets.value(link);
+}
+
+QString ControlFlowGraph::guard(Id const &link) const
+{
+	return mGuards.value(link);
+}
+
+Id ControlFlowGraph::immediateDominator(Id const &node) const
+{
+	int const i = index(node);
+	if (i == -1)
+		return Id();
+	int const dominator = mDominators.idom.at(i);
+	return dominator == -1 || dominator == mNodes.size() ? Id() : mNodes.at(dominator);
+}
+
+Id ControlFlowGraph::immediatePostDominator(Id const &node) const
+{
+	int const i = index(node);
+	if (i == -1)
+		return Id();
+	int const postDominator = mPostDominators.idom.at(i);
+	return postDominator == -1 || postDominator == mNodes.size() ? Id() : mNodes.at(postDominator);
+}
+
+bool ControlFlowGraph::dominates(Id const &dominator, Id const &node) const
+{
+	int const i = index(dominator);
+	int const j = index(node);
+	return i != -1 && j != -1 && mDominators.dominates(i, j);
+}
+
+bool ControlFlowGraph::postDominates(Id const &postDominator, Id const &node) const
+{
+	int const i = index(postDominator);
+	int const j = index(node);
+	return i != -1 && j != -1 && mPostDominators.dominates(i, j);
+}
+
+bool ControlFlowGraph::isLoopHeader(Id const &node) const
+{
+	return mLoopHeaders.contains(index(node));
+}
+
+QString ControlFlowGraph::flowGuard(qrRepo::LogicalRepoApi const &api, Id const &link)
+{
+	QString result = "";
+
+	if (api.hasProperty(link, "guard")) {
+		QString guard = api.stringProperty(link, "guard");
+		//TODO: delete it!!! That is just because QReal's sh~
+		guard.replace("&lt;", "<");
+		guard.replace("&rt;", ">");
+
+		result = guard.simplified(); //delete whitespaces from the start and the end and internal whitespaces replace with a single space
+	}
+
+	return result;
+}
+
+bool ControlFlowGraph::isControlFlow(Id const &link)
+{
+	return link.element() != "ActivityDiagram_CommentLink" && link.element() != "ClassDiagram_CommentLink"
+			&& link.element() != "UseCaseDiagram_CommentLink" && link.element() != "ActivityDiagram_ConstraintEdge";
+}
+
+int ControlFlowGraph::index(Id const &node) const
+{
+	return mIndices.value(node, -1);
+}
+
+// Cooper, Harvey, Kennedy. "A Simple, Fast Dominance Algorithm".
+void ControlFlowGraph::DominatorTree::build(QVector<QVector<int> > const &successors, int root)
+{
+	int const count = successors.size();
+
+	// Postorder numbers of nodes reachable from the root, -1 for the rest.
+	QVector<int> order(count, -1);
+	QVector<int> postorder;
+	QVector<bool> visited(count, false);
+	QVector<QPair<int, int> > stack;
+	stack.append(qMakePair(root, 0));
+	visited[root] = true;
+	while (!stack.isEmpty()) {
+		int const node = stack.last().first;
+		int const next = stack.last().second;
+		if (next < successors.at(node).size()) {
+			++stack.last().second;
+			int const successor = successors.at(node).at(next);
+			if (!visited.at(successor)) {
+				visited[successor] = true;
+				stack.append(qMakePair(successor, 0));
+			}
+		} else {
+			order[node] = postorder.size();
+			postorder.append(node);
+			stack.pop_back();
+		}
+	}
+
+	QVector<QVector<int> > predecessors(count);
+	for (int i = 0; i < count; ++i) {
+		foreach (int const successor, successors.at(i)) {
+			predecessors[successor].append(i);
+		}
+	}
+
+	idom.fill(-1, count);
+	idom[root] = root;
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = postorder.size() - 2; i >= 0; --i) {
+			int const node = postorder.at(i);
+			int newIdom = -1;
+			foreach (int predecessor, predecessors.at(node)) {
+				if (idom.at(predecessor) == -1)
+					continue;
+				if (newIdom == -1) {
+					newIdom = predecessor;
+					continue;
+				}
+				int finger = predecessor;
+				while (finger != newIdom) {
+					while (order.at(finger) < order.at(newIdom))
+						finger = idom.at(finger);
+					while (order.at(newIdom) < order.at(finger))
+						newIdom = idom.at(newIdom);
+				}
+			}
+			if (idom.at(node) != newIdom) {
+				idom[node] = newIdom;
+				changed = true;
+			}
+		}
+	}
+
+	// Number the tree in depth-first order: d dominates n iff n's interval lies inside d's.
+	QVector<QVector<int> > children(count);
+	for (int i = 0; i < count; ++i) {
+		if (i != root && idom.at(i) != -1)
+			children[idom.at(i)].append(i);
+	}
+	enter.fill(-1, count);
+	leave.fill(-1, count);
+	int time = 0;
+	stack.clear();
+	stack.append(qMakePair(root, 0));
+	enter[root] = time++;
+	while (!stack.isEmpty()) {
+		int const node = stack.last().first;
+		int const next = stack.last().second;
+		if (next < children.at(node).size()) {
+			++stack.last().second;
+			int const child = children.at(node).at(next);
+			enter[child] = time++;
+			stack.append(qMakePair(child, 0));
+		} else {
+			leave[node] = time++;
+			stack.pop_back();
+		}
+	}
+}
+
+bool ControlFlowGraph::DominatorTree::dominates(int dominator, int node) const
+{
+	return enter.at(dominator) != -1 && enter.at(node) != -1
+			&& enter.at(dominator) <= enter.at(node) && leave.at(node) <= leave.at(dominator);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+#include "../../kernel/ids.h"
+#include "../../../qrrepo/logicalRepoApi.h"
+
+namespace qReal {
+
+	namespace generators {
+
+		/// Control flow of one activity diagram (or Activity node), read from the repository once.
+		/// Besides cached links, guards and link ends it keeps dominator and post-dominator trees,
+		/// so that merge points and loop headers are found without walking the diagram again.
+		class ControlFlowGraph
+		{
+		public:
+			ControlFlowGraph(qrRepo::LogicalRepoApi const &api, Id const &container);
+
+			bool contains(Id const &node) const;
+
+			/// Outgoing control flow links, without comment links, constraint edges
+			/// and, for Activity nodes, "exception" links.
+			IdList outgoingLinks(Id const &node) const;
+			IdList incomingLinks(Id const &node) const;
+			/// Guarded links leaving an Activity node, in the order of the repository.
+			IdList exceptionLinks(Id const &node) const;
+
+			Id source(Id const &link) const;
+			Id target(Id const &link) const;
+			QString guard(Id const &link) const;
+
+			/// Returns Id() for entry nodes and for nodes not reachable from any of them.
+			Id immediateDominator(Id const &node) const;
+			/// Returns Id() for nodes that are immediately followed by the end of the flow.
+			Id immediatePostDominator(Id const &node) const;
+			bool dominates(Id const &dominator, Id const &node) const;
+			bool postDominates(Id const &postDominator, Id const &node) const;
+
+			/// A loop header is a node that is the target of a link from a node it dominates.
+			bool isLoopHeader(Id const &node) const;
+
+			/// Guard of a link as it goes to the generated code.
+			static QString flowGuard(qrRepo::LogicalRepoApi const &api, Id const &link);
+
+		private:
+			/// Immediate dominator tree plus pre/post numbering of it, for O(1) dominance checks.
+			struct DominatorTree
+			{
+				QVector<int> idom;
+				QVector<int> enter;
+				QVector<int> leave;
+
+				void build(QVector<QVector<int> > const &successors, int root);
+				bool dominates(int dominator, int node) const;
+			};
+
+			static bool isControlFlow(Id const &link);
+			int index(Id const &node) const;
+
+			IdList mNodes;
+			QHash<Id, int> mIndices;
+			QVector<IdList> mOutgoing;
+			QVector<IdList> mIncoming;
+			QVector<IdList> mExceptions;
+			QHash<Id, Id> mSources;
+			QHash<Id, Id> mTargets;
+			QHash<Id, QString> mGuards;
+			QSet<int> mLoopHeaders;
+
+			DominatorTree mDominators;
+			DominatorTree mPostDominators;
+		};
+
+	}
+}
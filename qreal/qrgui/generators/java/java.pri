@@ -1,3 +1,5 @@
 HEADERS += generators/java/javaHandler.h \
+	generators/java/controlFlowGraph.h \
 
 SOURCES += generators/java/javaHandler.cpp \
+	generators/java/controlFlowGraph.cpp \
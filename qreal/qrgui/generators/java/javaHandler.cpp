@@ -2,6 +2,8 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSet>
 
 #include <QtCore/QDebug>
 
@@ -9,15 +11,23 @@
 #include <QDir>
 
 #include "../../kernel/roles.h"
+#include "controlFlowGraph.h"
+#include "../../../utils/outFile.h"
 
 using namespace qReal;
 using namespace generators;
+using utils::OutFile;
 
 JavaHandler::JavaHandler(qrRepo::LogicalRepoApi const &api)
-	: mApi(api)
+	: mApi(api), mOut(NULL)
 {
 }
 
+JavaHandler::~JavaHandler()
+{
+	clearControlFlowCache();
+}
+
 //Parsing Java Libraries
 
 QString JavaHandler::parseJavaLibraries(QString const &pathToDir)
@@ -83,6 +93,7 @@ QString JavaHandler::generateToJava(QString const &pathToDir)
 {
 	mErrorText = "";
 	this->pathToDir = pathToDir;
+	clearControlFlowCache();
 
 	Id repoId = Id::rootId();
 
@@ -384,6 +395,9 @@ bool JavaHandler::commentAndConstraintChecking(IdList const &idList, QString con
 
 Id JavaHandler::findMergeNode(Id const &idDecisionNode)
 {
+	if (mMergeNodes.contains(idDecisionNode))
+		return mMergeNodes.value(idDecisionNode);
+
 	Id mergeNode = Id();
 
 	//look for Merge Nodes connected with this Decision Node
@@ -396,13 +410,18 @@ Id JavaHandler::findMergeNode(Id const &idDecisionNode)
 	}
 
 	if (mergeNodes.length() == 0) {
-		mergeNode = Id();
+		//not connected explicitly: the branches meet where the Decision Node is post-dominated
+		Id postDominator = controlFlowGraph(idDecisionNode).immediatePostDominator(idDecisionNode);
+		if (postDominator.element() == "ActivityDiagram_MergeNode") {
+			mergeNode = postDominator;
+		}
 	} else if (mergeNodes.length() == 1) {
 		mergeNode = mergeNodes.at(0);
 	} else {
 		addError("Unable to serialize object " + objectType(idDecisionNode) + " with id: " + idDecisionNode.toString() + ". Is has to many connected Merge Nodes.");
 	}
 
+	mMergeNodes.insert(idDecisionNode, mergeNode);
 	return mergeNode;
 }
 
@@ -410,12 +429,13 @@ Id JavaHandler::findNonBodyLink(Id const &idDecisionNode)
 {
 	Id linkId = Id();
 
-	IdList outgoingLinks = mApi.outgoingLinks(idDecisionNode);
+	ControlFlowGraph const &graph = controlFlowGraph(idDecisionNode);
+	IdList outgoingLinks = graph.outgoingLinks(idDecisionNode);
 	if (outgoingLinks.length() != 2) {
 		addError("Unable to serialize object " + objectType(idDecisionNode) + " with id: " + idDecisionNode.toString() + ". May be you forget a Merge Node before this Decision Node.");
 	} else {
-		QString guard1 = getFlowGuard(outgoingLinks.at(0));
-		QString guard2 = getFlowGuard(outgoingLinks.at(1));
+		QString guard1 = graph.guard(outgoingLinks.at(0));
+		QString guard2 = graph.guard(outgoingLinks.at(1));
 
 		//they can't be equal "" at the same time; one of them ought to be "" or to be "else"
 		if (guard1 != "" || guard2 != "") {
@@ -438,122 +458,82 @@ Id JavaHandler::findNonBodyLink(Id const &idDecisionNode)
 	return linkId;
 }
 
-//Returns "importaint" nodes between startNode (including) and untilNode (excluding)
-IdList JavaHandler::findIntermediateNodes(Id const &startNode, Id const &untilNode, bool const closesMethod)
+//Returns "importaint" nodes between startNode (including) and untilNode (excluding).
+//Results are memoized, so nested branches are walked once per generation.
+IdList JavaHandler::findIntermediateNodes(Id const &startNode, Id const &untilNode)
 {
-	IdList children;
+	NodeRange const range(startNode, untilNode);
+	if (mIntermediateNodes.contains(range)) {
+		return mIntermediateNodes.value(range);
+	}
+	//empty until the walk finishes, so that a malformed cycle stops here
+	mIntermediateNodes.insert(range, IdList());
 
-	if (startNode != untilNode) {
-		children.append(startNode);
-
-		if (startNode.element() == "ActivityDiagram_DecisionNode") {
-//            int isControlFlow = -1; //for checking in and outgoing links connected to DecisionNode
-			if (!mApi.links(startNode).isEmpty()) {
-				IdList outgoingLinks = mApi.outgoingLinks(startNode);
-				if (!outgoingLinks.isEmpty()) {
-//                    // Very arched way to check:
-//                    // [Superstructure 09-02-02.pdf][2] The edges coming into and out of a DecisionNode, other than the decisionInputFlow (if any), must be either all ObjectFlows or all ControlFlows.
-//                    foreach (Id const aLink, outgoingLinks) {
-//                        if (aLink.element() == "ActivityDiagram_ControlFlow") {
-//                            if (isControlFlow == 0) {
-//                                addError("Unable to serialize object " + objectType(startNode) + " with id: " + startNode.toString() + ". The edges coming out must be either all Object Flows or all Control Flows.");
-//                            }
-//                            isControlFlow = 1;
-//                        } else if (aLink.element() == "ActivityDiagram_ObjectFlow") {
-//                            if (isControlFlow == 1) {
-//                                addError("Unable to serialize object " + objectType(startNode) + " with id: " + startNode.toString() + ". The edges coming out must be either all Object Flows or all Control Flows.");
-//                            }
-//                            isControlFlow = 0;
-//                        } //TODO: To check if the link is not Control Flow or Object Flow and fail the generation if it is.
-//                    }
-
-					//"if" or "while"?
-					IdList incomingLinks = mApi.incomingLinks(startNode);
-					deleteCommentLinks(incomingLinks);
-					deleteConstraintEdges(incomingLinks);
-					if (incomingLinks.length() == 1) { //"if"
-						Id mergeNode = findMergeNode(startNode);
-
-						if (mergeNode != Id()) {
-							children.append(findIntermediateNodes(mergeNode, untilNode, closesMethod));
-						}
-					} else if (incomingLinks.length() == 2) { //"while"
-						Id nonBodyLink = findNonBodyLink(startNode);
-
-						if (nonBodyLink != Id()) {
-							Id firstNonBodyElement = mApi.otherEntityFromLink(nonBodyLink, startNode);
-							if (firstNonBodyElement != Id()) {
-								children.append(findIntermediateNodes(firstNonBodyElement, untilNode, closesMethod));
-							} else { //wrong end of the link
-								addError("Unable to serialize object " + objectType(nonBodyLink) + " with id: " + nonBodyLink.toString() + ". A decision Node has one or two incoming edges.");
-							}
+	IdList children;
+	QSet<Id> visited;
+	Id node = startNode;
+
+	//straight sequences are followed in a loop, recursion is left for nodes with several outgoing links
+	while (node != untilNode && node != Id()) {
+		children.append(node);
+		visited.insert(node);
+
+		ControlFlowGraph const &graph = controlFlowGraph(node);
+		IdList nextNodes;
+
+		if (node.element() == "ActivityDiagram_DecisionNode") {
+			if (!graph.outgoingLinks(node).isEmpty()) {
+				//"if" or "while"?
+				int incomingCount = graph.incomingLinks(node).length();
+				if (incomingCount < 1 || incomingCount > 2) { //[Superstructure 09-02-02][1] A decision node has one or two incoming edges.
+					addError("Unable to serialize object " + objectType(node) + " with id: " + node.toString() + ". A decision Node has one or two incoming edges.");
+				} else if (graph.isLoopHeader(node)) { //"while"
+					Id nonBodyLink = findNonBodyLink(node);
+
+					if (nonBodyLink != Id()) {
+						Id firstNonBodyElement = graph.target(nonBodyLink);
+						if (firstNonBodyElement != Id()) {
+							nextNodes.append(firstNonBodyElement);
+						} else { //wrong end of the link
+							addError("Unable to serialize object " + objectType(nonBodyLink) + " with id: " + nonBodyLink.toString() + ". A decision Node has one or two incoming edges.");
 						}
-					} else { //[Superstructure 09-02-02][1] A decision node has one or two incoming edges.
-						addError("Unable to serialize object " + objectType(startNode) + " with id: " + startNode.toString() + ". A decision Node has one or two incoming edges.");
 					}
+				} else { //"if"
+					Id mergeNode = findMergeNode(node);
 
-				} else {
-					addError("Unable to serialize object " + objectType(startNode) + " with id: " + startNode.toString() + ". Is must have at least one outgoing edge.");
+					if (mergeNode != Id()) {
+						nextNodes.append(mergeNode);
+					}
 				}
 			} else {
-				addError("Unable to serialize object " + objectType(startNode) + " with id: " + startNode.toString() + ". Is must have at least one outgoing edge.");
+				addError("Unable to serialize object " + objectType(node) + " with id: " + node.toString() + ". Is must have at least one outgoing edge.");
 			}
-		} else if (startNode.element() == "ActivityDiagram_MergeNode") {
-			//TODO: fill this
-			IdList outgoingLinks = mApi.outgoingLinks(startNode);
-			deleteCommentLinks(outgoingLinks);
-			deleteConstraintEdges(outgoingLinks);
-
-			foreach (Id aLink, outgoingLinks) {
-				Id nextElement = mApi.otherEntityFromLink(aLink, startNode);
+		} else if (node.element() != "ActivityDiagram_ActivityFinalNode") {
+			//Merge Node, Activity (its "exception"-links are serialized by the Activity itself), Action, Initial.
+			//TODO: add other "importaint" nodes
+			foreach (Id aLink, graph.outgoingLinks(node)) {
+				Id nextElement = graph.target(aLink);
 				if (nextElement != Id()) {
-					children.append(findIntermediateNodes(nextElement, untilNode, closesMethod));;
+					nextNodes.append(nextElement);
 				} else {
 					addError("Unable to serialize object " + objectType(aLink) + " with id: " + aLink.toString() + ". It does not have the target-node.");
 				}
 			}
-		} else if (startNode.element() == "ActivityDiagram_ActivityFinalNode") {
-			if (!closesMethod) {
-				Id returnNode = children.at(children.length() - 1);
-				addError("Node: " + returnNode.toString() + ". If you want \"return;\" you should write it in the Action before this Final Node.");
-			}
-		} else if (startNode.element() == "ActivityDiagram_Activity") { //"try-catch" or just Activity
-			IdList outgoingLinks = mApi.outgoingLinks(startNode);
-			deleteCommentLinks(outgoingLinks);
-			deleteConstraintEdges(outgoingLinks);
-
-			//Delete all "exception"-links from the list. They will be serialized by the Activity itself.
-			foreach (Id aLink, outgoingLinks) {
-				if (getFlowGuard(aLink) != "") {
-					outgoingLinks.removeAll(aLink);
-				}
-			}
+		}
 
-			foreach (Id aLink, outgoingLinks) {
-				Id nextElement = mApi.otherEntityFromLink(aLink, startNode);
-				if (nextElement != Id()) {
-					children.append(findIntermediateNodes(nextElement, untilNode, closesMethod));
-				} else {
-					addError("Unable to serialize object " + objectType(aLink) + " with id: " + aLink.toString() + ". It does not have the target-node.");
-				}
-			}
-		} //TODO: add other "importaint" nodes
-		else { //Think, that it is Action, Initial, Final.
-			IdList outgoingLinks = mApi.outgoingLinks(startNode);
-			deleteCommentLinks(outgoingLinks);
-			deleteConstraintEdges(outgoingLinks);
-
-			foreach (Id aLink, outgoingLinks) {
-				Id nextElement = mApi.otherEntityFromLink(aLink, startNode);
-				if (nextElement != Id()) {
-					children.append(findIntermediateNodes(nextElement, untilNode, closesMethod));
-				} else {
-					addError("Unable to serialize object " + objectType(aLink) + " with id: " + aLink.toString() + ". It does not have the target-node.");
+		if (nextNodes.length() == 1 && !visited.contains(nextNodes.at(0))) {
+			node = nextNodes.at(0);
+		} else {
+			foreach (Id aNode, nextNodes) {
+				if (!visited.contains(aNode)) {
+					children.append(findIntermediateNodes(aNode, untilNode));
 				}
 			}
+			break;
 		}
 	}
 
+	mIntermediateNodes.insert(range, children);
 	return children;
 }
 
@@ -596,7 +576,14 @@ IdList JavaHandler::getActivityChildren(Id const &idStartNode, Id const &idUntil
 	//if the Final Node, that we will find closes the Method
 	bool closesMethod = idStartNode != Id() && idStartNode.element() == "ActivityDiagram_InitialNode";
 
-	result.append(findIntermediateNodes(idStartNode, idUntilNode, closesMethod));
+	result.append(findIntermediateNodes(idStartNode, idUntilNode));
+	if (!closesMethod) {
+		foreach (Id returnNode, result) {
+			if (returnNode.element() == "ActivityDiagram_ActivityFinalNode") {
+				addError("Node: " + returnNode.toString() + ". If you want \"return;\" you should write it in the Action before this Final Node.");
+			}
+		}
+	}
 	if (idUntilNode != Id()) {
 		result.append(idUntilNode);
 	}
@@ -604,9 +591,8 @@ IdList JavaHandler::getActivityChildren(Id const &idStartNode, Id const &idUntil
 	return result;
 }
 
-QString JavaHandler::serializeChildren(Id const &idParent)
+void JavaHandler::serializeChildren(Id const &idParent)
 {
-	QString result = "";
 	IdList childElems, allChildren = mApi.children(idParent);
 
 	if (objectType(idParent) == "ActivityDiagram_ActivityDiagramNode" || objectType(idParent) == "ActivityDiagram_Activity") {
@@ -649,30 +635,30 @@ QString JavaHandler::serializeChildren(Id const &idParent)
 
 
 	foreach (Id const id, childElems) {
-		result += serializeObject(id);
+		serializeObject(id);
 	}
-
-	return result;
 }
 
-QString JavaHandler::serializeObject(Id const &id)
+void JavaHandler::serializeObject(Id const &id)
 {
-	QString result = "";
-
 	// class diagram
 
 	if ((objectType(id) == "ClassDiagram_Class")||(objectType(id) == "ClassDiagram_Interface")) {
 
-		mIndent = 0;
-
 		//-----------
 		QString const pathToFile = pathToDir + "/" + mApi.name(id) + ".java";
 
-		QFile file(pathToFile);
-		if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-			return "";
-
-		QTextStream out(&file);
+		OutFile *file = NULL;
+		try {
+			file = new OutFile(pathToFile);
+		} catch (char const *) {
+			addError("unable to open file " + pathToFile + " for writing");
+			return;
+		}
+		QScopedPointer<OutFile> fileGuard(file);
+		OutFile &out = *file;
+		OutFile *outerOut = mOut;
+		mOut = &out;
 		//-----------
 
 		QString visibility = getVisibility(id);
@@ -687,10 +673,10 @@ QString JavaHandler::serializeObject(Id const &id)
 			addError("unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". \"abstract final\" declaration doesn't make sense");
 		}
 
-		out << getComments(id);
-		out << imports;
-		out << indent() + visibility + isAbstractField + isFinalField + "class " + mApi.name(id) + parents + interfaces +  " {" + "\n";
-		mIndent++;
+		out.stream() << getComments(id);
+		out.stream() << imports;
+		out() << visibility + isAbstractField + isFinalField + "class " + mApi.name(id) + parents + interfaces +  " {" + "\n";
+		out.incIndent();
 
 		if (!mApi.links(id).isEmpty()) {
 			// search for the Class-typed attrbutes
@@ -709,8 +695,8 @@ QString JavaHandler::serializeObject(Id const &id)
 						addError("unable to serialize object " + objectType(id) + " with id: " + aLink.toString() + ". \"final volatile\" declaration doesn't make sense");
 					}
 
-					out << indent() + isFinalField + visibility + isStaticField + isVolatileField + isTransientField + type + mApi.name(aLink);
-					out << ";\n";
+					out() << isFinalField + visibility + isStaticField + isVolatileField + isTransientField + type + mApi.name(aLink);
+					out.stream() << ";\n";
 				}
 			}
 
@@ -730,15 +716,16 @@ QString JavaHandler::serializeObject(Id const &id)
 						addError("unable to serialize object " + objectType(id) + " with id: " + aLink.toString() + ". \"final volatile\" declaration doesn't make sense");
 					}
 
-					out << indent() + isFinalField + visibility + isStaticField + isVolatileField + isTransientField + type + mApi.name(aLink);
-					out << ";\n";
+					out() << isFinalField + visibility + isStaticField + isVolatileField + isTransientField + type + mApi.name(aLink);
+					out.stream() << ";\n";
 				}
 			}
 		}
 
-		out << serializeChildren(id);
-		mIndent--;
-		out << indent() + "} //end of class\n";
+		serializeChildren(id);
+		out.decIndent();
+		out() << "} //end of class\n";
+		mOut = outerOut;
 	} else if (objectType(id) == "ClassDiagram_View") {
 		//	    to do someting
 	} else if (objectType(id) == "ClassDiagram_ClassMethod") {
@@ -764,11 +751,11 @@ QString JavaHandler::serializeObject(Id const &id)
 					}
 				}
 
-				QString methodBody = getMethodCode(id);
-
-				result += getComments(id);
-				result += indent() + visibility + isAbstractField + isStaticField + isFinalField + isSynchronizedField + isNativeField +
-						  type  + mApi.name(id) + "(" + operationFactors + ") " + methodBody + "\n";
+				mOut->stream() << getComments(id);
+				(*mOut)() << visibility + isAbstractField + isStaticField + isFinalField + isSynchronizedField + isNativeField +
+						  type  + mApi.name(id) + "(" + operationFactors + ") ";
+				serializeMethodCode(id);
+				mOut->stream() << "\n";
 			} else {
 				addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". Move it inside some Class or Interface.");
 			}
@@ -791,12 +778,12 @@ QString JavaHandler::serializeObject(Id const &id)
 					addError("unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". \"final volatile\" declaration doesn't make sense");
 				}
 
-				result += getComments(id);
-				result += indent() +  visibility + isStaticField + isFinalField + isVolatileField + isTransientField + type + mApi.name(id);
+				mOut->stream() << getComments(id);
+				(*mOut)() << visibility + isStaticField + isFinalField + isVolatileField + isTransientField + type + mApi.name(id);
 				if (defaultValue != "") {
-					result += " = " + defaultValue;
+					mOut->stream() << " = " + defaultValue;
 				}
-				result += ";\n";
+				mOut->stream() << ";\n";
 			} else {
 				addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". Move it inside some Class or Interface.");
 			}
@@ -821,7 +808,7 @@ QString JavaHandler::serializeObject(Id const &id)
 			}
 		}
 
-		result += getConstraints(id);
+		mOut->stream() << getConstraints(id);
 	} else if (objectType(id) == "ActivityDiagram_Action") {
 		IdList outgoingConnections = mApi.outgoingConnections(id);
 		IdList activityDiagrams;
@@ -835,22 +822,22 @@ QString JavaHandler::serializeObject(Id const &id)
 			addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". There are too many Activity Diagrams connected.");
 		}
 
-		result += getComments(id);
+		mOut->stream() << getComments(id);
 		QString code = getConstraints(id);
 
 		if (activityDiagrams.isEmpty() && code == "") {
-			result += indent() + mApi.name(id).replace("<br/>", "\n" + indent()) + "\n";
+			(*mOut)() << mApi.name(id).replace("<br/>", "\n" + mOut->indent()) + "\n";
 		} else {
 			if (activityDiagrams.isEmpty() && code != "") {
-				result += code;
+				mOut->stream() << code;
 			} else if (!activityDiagrams.isEmpty() && code == "") {
-				result += serializeChildren(activityDiagrams.at(0));
+				serializeChildren(activityDiagrams.at(0));
 			} else {
 				addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". You can not set code into the Constraints and Activity Diagram at the same time.");
 			}
 		}
 	} else if (objectType(id) == "ActivityDiagram_ActivityFinalNode") {
-		result += getComments(id) + getConstraints(id);
+		mOut->stream() << getComments(id) + getConstraints(id);
 
 		//[Superstructure 09-02-02][1] A final node has no outgoing edges.
 		IdList outgoingLinks = mApi.outgoingLinks(id);
@@ -858,45 +845,34 @@ QString JavaHandler::serializeObject(Id const &id)
 			addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". A final node has no outgoing edges.");
 		}
 	} else if (objectType(id) == "ActivityDiagram_DecisionNode") {
-		result += getComments(id);
+		mOut->stream() << getComments(id);
 		//"if" or "while"?
-		IdList incomingLinks = mApi.incomingLinks(id);
-		deleteCommentLinks(incomingLinks);
-		deleteConstraintEdges(incomingLinks);
-		if (incomingLinks.length() == 1) { //"if"
-			result += ifStatement(id);
-		} else if (incomingLinks.length() == 2) { //"while"
-			result += whileDoLoop(id);
+		ControlFlowGraph const &graph = controlFlowGraph(id);
+		int incomingCount = graph.incomingLinks(id).length();
+		if (graph.isLoopHeader(id)) { //"while"
+			whileDoLoop(id);
+		} else if (incomingCount == 1 || incomingCount == 2) { //"if"
+			ifStatement(id);
 		}
 
-		result += indent() + "\n";
+		(*mOut)() << "\n";
 	} else if (objectType(id) == "ActivityDiagram_MergeNode") {
-		result += getComments(id);
+		mOut->stream() << getComments(id);
 	} else if (objectType(id) == "ActivityDiagram_Activity") {
-		result += getComments(id) + getConstraints(id);
+		mOut->stream() << getComments(id) + getConstraints(id);
 		//search for "exception"-links
-		IdList outgoingLinks = mApi.outgoingLinks(id);
-		IdList exceptions;
-		foreach (Id aLink, outgoingLinks) {
-			if (getFlowGuard(aLink) != "") {
-				exceptions.append(aLink);
-			}
-		}
+		IdList exceptions = controlFlowGraph(id).exceptionLinks(id);
 
 		if (exceptions.isEmpty()) { //if it is just an Activity
-			result += serializeChildren(id);
+			serializeChildren(id);
 		} else { //if it is "try-catch"
-			result += tryCatch(id);
+			tryCatch(id);
 		}
 	}
-
-	return result;
 }
 
-QString JavaHandler::serializeActivity(Id const &idStartNode, Id const &idUntilNode)
+void JavaHandler::serializeActivity(Id const &idStartNode, Id const &idUntilNode)
 {
-	QString result = "";
-
 	IdList childElems = getActivityChildren(idStartNode, idUntilNode);
 
 	if (!childElems.isEmpty()) {
@@ -910,81 +886,66 @@ QString JavaHandler::serializeActivity(Id const &idStartNode, Id const &idUntilN
 
 	foreach (Id id, childElems) {
 	   if (id != Id()) {
-			result += serializeObject(id);
+			serializeObject(id);
 		}
 	}
-
-	return result;
 }
 
-QString JavaHandler::tryCatch(Id const &id)
+void JavaHandler::tryCatch(Id const &id)
 {
-	QString result = "";
 	int existFinally = 0; //for checking that there is no 2 outgoing links with "finally" as a guard
 
 	//search for "exception"-links
-	IdList outgoingLinks = mApi.outgoingLinks(id);
-	IdList exceptions;
-	foreach (Id aLink, outgoingLinks) {
-		if (getFlowGuard(aLink) != "") {
-			exceptions.append(aLink);
-		}
-	}
+	ControlFlowGraph const &graph = controlFlowGraph(id);
+	IdList exceptions = graph.exceptionLinks(id);
 
 	//move "finally"-link to the end of the list
 	foreach (Id aLink, exceptions) {
 		//if this link represent "finally" case than change it with the last link in the serialization sequence
-		if (getFlowGuard(aLink) == "finally") {
+		if (graph.guard(aLink) == "finally") {
 			if (existFinally == 1) {
 				addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". There are two objects with \"finally\" as guard.");
 			}
 			existFinally = 1;
-			outgoingLinks.swap(outgoingLinks.indexOf(aLink), outgoingLinks.length()-1);
+			exceptions.swap(exceptions.indexOf(aLink), exceptions.length()-1);
 		}
 	}
 
-	result += indent() + "try {\n";
-	mIndent++;
-	result += serializeChildren(id);
-	mIndent--;
-	result += indent() + "}";
+	(*mOut)() << "try {\n";
+	mOut->incIndent();
+	serializeChildren(id);
+	mOut->decIndent();
+	(*mOut)() << "}";
 
 	foreach (Id anException, exceptions) {
-		if (getFlowGuard(anException) != "finally") {
-			result += " catch (" + getFlowGuard(anException) + ") {\n";
+		if (graph.guard(anException) != "finally") {
+			mOut->stream() << " catch (" + graph.guard(anException) + ") {\n";
 		} else {
-			result += " finally {\n";
+			mOut->stream() << " finally {\n";
 		}
-		mIndent++;
-		Id exceptionHandler = mApi.otherEntityFromLink(anException, id);
-		result += serializeActivity(exceptionHandler, Id());
-		mIndent--;
-		result += indent() + "}";
+		mOut->incIndent();
+		Id exceptionHandler = graph.target(anException);
+		serializeActivity(exceptionHandler, Id());
+		mOut->decIndent();
+		(*mOut)() << "}";
 	}
 
-	result += "\n";
-
-	return result;
+	mOut->stream() << "\n";
 }
 
-QString JavaHandler::ifStatement(Id const &id)
+void JavaHandler::ifStatement(Id const &id)
 {
-	QString result = indent() + "";
+	(*mOut)();
 
 	Id untilMergeNode = findMergeNode(id);
 	int existElse = 0; //for checking that there is no 2 outgoing links with "else" as a guard
 
-	//move "else" link to the end of the list and delete Constraint Edges.
-	IdList outgoingLinks = mApi.outgoingLinks(id);
-	deleteCommentLinks(outgoingLinks);
-	deleteConstraintEdges(outgoingLinks);
+	//move "else" link to the end of the list; comment links and Constraint Edges are not in the graph
+	ControlFlowGraph const &graph = controlFlowGraph(id);
+	IdList outgoingLinks = graph.outgoingLinks(id);
 	foreach (Id aLink, outgoingLinks) {
-		if (aLink.element() == "ActivityDiagram_ConstraintEdge") {
-			outgoingLinks.removeAll(aLink);
-			break;
-		}
 		//if this link represent "else" case than change it with the last link in the serialization sequence
-		if (getFlowGuard(aLink) == "else" || getFlowGuard(aLink) == "") {
+		if (graph.guard(aLink) == "else" || graph.guard(aLink) == "") {
 			if (existElse == 1) {
 				addError("Unable to serialize object " + objectType(id) + " with id: " + id.toString() + ". There are two objects with \"else\" as guard.");
 			}
@@ -995,55 +956,55 @@ QString JavaHandler::ifStatement(Id const &id)
 
 	//serialization
 	foreach (Id aLink, outgoingLinks) {
-		Id caseBody = mApi.otherEntityFromLink(aLink, id);
+		Id caseBody = graph.target(aLink);
 		if (caseBody != untilMergeNode) {
 			if (aLink != outgoingLinks.at(0)) { //if it is not the first link, connected to the Decision Node
-				result += " else ";
+				mOut->stream() << " else ";
 			}
 
-			QString guard = getFlowGuard(aLink);
+			QString guard = graph.guard(aLink);
 			if (guard != "else" && guard != "") {
-				result += "if (" + guard + ") ";
+				mOut->stream() << "if (" + guard + ") ";
 			}
-			result += "{\n";
-			mIndent++;
-			result += serializeActivity(caseBody, untilMergeNode);
-			mIndent--;
-			result += indent() + "}";
+			mOut->stream() << "{\n";
+			mOut->incIndent();
+			serializeActivity(caseBody, untilMergeNode);
+			mOut->decIndent();
+			(*mOut)() << "}";
 
 		}
 	}
 
 	//if there is no merge node than we must close the function
 	if (untilMergeNode == Id()) {
-		mIndent--;
-		result += indent() + "}\n";
+		mOut->decIndent();
+		(*mOut)() << "}\n";
 	}
-
-	return result;
 }
 
-QString JavaHandler::whileDoLoop(Id const &id)
+void JavaHandler::whileDoLoop(Id const &id)
 {
-	QString result = indent() + "";
+	(*mOut)();
 
 	//get the "body" link
+	ControlFlowGraph const &graph = controlFlowGraph(id);
 	Id nonBodyLink = findNonBodyLink(id);
-	IdList outgoingLinks = mApi.outgoingLinks(id);
+	IdList outgoingLinks = graph.outgoingLinks(id);
 	outgoingLinks.removeAll(nonBodyLink);
+	if (outgoingLinks.isEmpty()) {
+		return;
+	}
 	Id bodyLink = outgoingLinks.at(0);
 
-	result += "while (" + getFlowGuard(bodyLink) + ") {\n";
-	mIndent++;
+	mOut->stream() << "while (" + graph.guard(bodyLink) + ") {\n";
+	mOut->incIndent();
 
 	//Serialization of the loop's body
-	Id nextElement = mApi.otherEntityFromLink(bodyLink, id);
-	result += serializeActivity(nextElement, id);
-\
-	mIndent--;
-	result += indent() + "}\n";
+	Id nextElement = graph.target(bodyLink);
+	serializeActivity(nextElement, id);
 
-	return result;
+	mOut->decIndent();
+	(*mOut)() << "}\n";
 }
 
 QString JavaHandler::getVisibility(Id const &id)
@@ -1074,26 +1035,6 @@ QString JavaHandler::getVisibility(Id const &id)
 	return result;
 }
 
-QString JavaHandler::getFlowGuard(Id const &id)
-{
-	QString result = "";
-
-	if (mApi.hasProperty(id, "guard")) {
-		QString guard = mApi.stringProperty(id, "guard");
-		//TODO: delete it!!! That is just because QReal's sh~
-		guard.replace("&lt;", "<");
-		guard.replace("&rt;", ">");
-
-		result = guard.simplified(); //delete whitespaces from the start and the end and internal whitespaces replace with a single space
-
-//        if (guard == "") {
-//            addError("Object " + objectType(id) + " with id  " + id.toString() + " has empty guard property.");
-//        }
-	}
-
-	return result;
-}
-
 QString JavaHandler::getMultiplicity(Id const &id)
 {
 	QString result = "";
@@ -1176,10 +1117,10 @@ QString JavaHandler::getInterfaces(Id const &id)
 	return result;
 }
 
-QString JavaHandler::getMethodCode(Id const &id)
+void JavaHandler::serializeMethodCode(Id const &id)
 {
-	QString result = "{\n";
-	mIndent++;
+	mOut->stream() << "{\n";
+	mOut->incIndent();
 
 	if (!mApi.outgoingConnections(id).isEmpty()) {
 		IdList outgoingConnections = mApi.outgoingConnections(id);
@@ -1194,7 +1135,7 @@ QString JavaHandler::getMethodCode(Id const &id)
 		}
 
 		if (realizationsCount == 1) { //if everything is ok
-			result += serializeChildren(realizationDiagram);
+			serializeChildren(realizationDiagram);
 		} else if (realizationsCount == 0) { //if there is no realization
 			addError("Method " + objectType(id) + " with id " + id.toString() + " will be empty.");
 		} else { //if there is more than one ActivityDiagram connected
@@ -1205,9 +1146,8 @@ QString JavaHandler::getMethodCode(Id const &id)
 		addError("Method " + objectType(id) + " with id " + id.toString() + " will be empty.");
 	}
 
-	mIndent--;
-	result += indent() + "}\n";
-	return result;
+	mOut->decIndent();
+	(*mOut)() << "}\n";
 }
 
 QString JavaHandler::hasModifier(Id const &id, QString const &modifier)
@@ -1383,11 +1323,26 @@ void JavaHandler::addError(QString const &errorText)
 	mErrorText += errorText + "\n";
 }
 
-QString JavaHandler::indent()
+ControlFlowGraph const &JavaHandler::controlFlowGraph(Id const &node)
 {
-	QString result;
+	Id const container = mApi.parent(node);
+	ControlFlowGraph *graph = mControlFlowGraphs.value(container);
+	if (graph == NULL) {
+		graph = new ControlFlowGraph(mApi, container);
+		mControlFlowGraphs.insert(container, graph);
+	}
+	return *graph;
+}
 
-	for (int i = 0; i < mIndent; ++i)
-		result += "\t";
-	return result;
+void JavaHandler::clearControlFlowCache()
+{
+	qDeleteAll(mControlFlowGraphs);
+	mControlFlowGraphs.clear();
+	mIntermediateNodes.clear();
+	mMergeNodes.clear();
+}
+
+QString JavaHandler::indent()
+{
+	return mOut != NULL ? mOut->indent() : QString();
 }
@@ -1,18 +1,27 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
 
 #include "../../kernel/ids.h"
 #include "../../../qrrepo/logicalRepoApi.h"
 
+namespace utils {
+	class OutFile;
+}
+
 namespace qReal {
 
 	namespace generators {
 
+		class ControlFlowGraph;
+
 		class JavaHandler
 		{
 		public:
 			explicit JavaHandler(qrRepo::LogicalRepoApi const &api);
+			~JavaHandler();
 
 			QString generateToJava(QString const &pathToDir);
 			QString parseJavaLibraries(QString const &pathToDir);
@@ -22,9 +31,10 @@ namespace qReal {
 
 			IdList getActivityChildren(Id const &idStartNode, Id const &untilNode);
 
-			QString serializeObject(Id const &id);
-			QString serializeChildren(Id const &id);
-			QString serializeActivity(Id const &idStartNode, Id const &idUntilNode);
+			// Serializers write straight into mOut, the file of the class being generated.
+			void serializeObject(Id const &id);
+			void serializeChildren(Id const &id);
+			void serializeActivity(Id const &idStartNode, Id const &idUntilNode);
 
 			QString getVisibility(Id const &id);
 			QString getMultiplicity(Id const &id);
@@ -39,31 +49,39 @@ namespace qReal {
 			QString hasModifier(Id const &id, QString const &modifier);
 			QString getSuperclass(Id const &id);
 			QString getInterfaces(Id const &id);
-			QString getMethodCode(Id const &id);
-			QString getFlowGuard(Id const &id);
+			void serializeMethodCode(Id const &id);
 			QString serializeMultiplicity(Id const &id, QString const &multiplicity) const;
 
 			bool isTypeSuitable(QString const &type) const;
 			bool isVisibilitySuitable(QString const &type) const;
 
 			QString objectType(Id const &id);
-			QString tryCatch(Id const &id);
-			QString ifStatement(Id const &id);
-			QString whileDoLoop(Id const &id);
+			void tryCatch(Id const &id);
+			void ifStatement(Id const &id);
+			void whileDoLoop(Id const &id);
 
 			Id findMergeNode(Id const &idDecisionNode);
 			Id findNonBodyLink(Id const &idDecisionNode);
-			IdList findIntermediateNodes(Id const &id, Id const &untilNode, bool const closesFunction);
+			IdList findIntermediateNodes(Id const &id, Id const &untilNode);
 			IdList deleteCommentLinks(IdList &idList);
 			IdList deleteConstraintEdges(IdList &idList);
 
 			void addError(QString const &errorText);
 
+			/// Control flow graph of the diagram that holds the node, built on first request.
+			ControlFlowGraph const &controlFlowGraph(Id const &node);
+			void clearControlFlowCache();
+
 			qrRepo::LogicalRepoApi const &mApi;
 			QString mErrorText;
 			QString pathToDir;
 
-			int mIndent;
+			utils::OutFile *mOut;
+
+			typedef QPair<Id, Id> NodeRange;
+			QHash<Id, ControlFlowGraph *> mControlFlowGraphs;  // Owns graphs, keyed by diagram.
+			QHash<NodeRange, IdList> mIntermediateNodes;
+			QHash<Id, Id> mMergeNodes;
 			QString indent();
 
 			//Parsing Java Libraries
@@ -1,20 +1,18 @@
 #include "xmiHandler.h"
 
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
 #include <QtCore/QVariant>
+#include <QtCore/QXmlStreamWriter>
 
 #include <QtCore/QDebug>
 
 #include "../../kernel/roles.h"
-#include "../../../utils/outFile.h"
 
 using namespace qReal;
 using namespace generators;
-using namespace utils;
 
 XmiHandler::XmiHandler(qrRepo::LogicalRepoApi const &api)
-	: mApi(api)
+	: mApi(api), mWriter(NULL)
 {
 }
 
@@ -22,63 +20,75 @@ QString XmiHandler::exportToXmi(QString const &pathToFile)
 {
 	mErrorText = "";
 
-	QDomElement header = mDocument.createElement("xmi:XMI");
-	header.setAttribute("xmlns:xmi", "http://schema.omg.org/spec/XMI/2.1");
-	header.setAttribute("xmlns:uml", "http://schema.omg.org/spec/UML/2.0");
-	header.setAttribute("xmi:version", "2.1");
-	mDocument.appendChild(header);
+	QFile file(pathToFile);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		addError("unable to open file " + pathToFile);
+		return mErrorText;
+	}
+
+	QXmlStreamWriter writer(&file);
+	writer.setCodec("UTF-8");
+	writer.setAutoFormatting(true);
+	writer.setAutoFormattingIndent(4);
+	mWriter = &writer;
+
+	writer.writeStartDocument();
+	writer.writeStartElement("xmi:XMI");
+	writer.writeAttribute("xmlns:xmi", "http://schema.omg.org/spec/XMI/2.1");
+	writer.writeAttribute("xmlns:uml", "http://schema.omg.org/spec/UML/2.0");
+	writer.writeAttribute("xmi:version", "2.1");
 
-	QDomElement documentation = mDocument.createElement("xmi:Documentation");
-	documentation.setAttribute("exporter", "QReal");
-	mDocument.appendChild(documentation);
+	writer.writeEmptyElement("xmi:Documentation");
+	writer.writeAttribute("exporter", "QReal");
 
 	//  --------------  content --------------- //
 	Id repoId = Id::rootId();
 	IdList rootDiagrams = mApi.children(repoId);
 
 	foreach (Id const typeDiagram, rootDiagrams) {
-		QDomElement package = createDomElement("uml:Package", typeDiagram.toString());
-		package.setAttribute("name", mApi.name(typeDiagram));
-		mDocument.appendChild(package);
+		startElement("uml:Package", typeDiagram.toString());
+		writer.writeAttribute("name", mApi.name(typeDiagram));
 
-		initPrimitiveTypes(package);
-		serializeChildren(package, typeDiagram);
+		initPrimitiveTypes();
+		serializeChildren(typeDiagram);
+		writer.writeEndElement();
 	}
 
-	OutFile out(pathToFile);
-	out() << "<?xml version='1.0' encoding='utf-8'?>\n";
-	out() << mDocument.toString(4);
+	writer.writeEndElement();
+	writer.writeEndDocument();
+	mWriter = NULL;
 
 	qDebug() << "XMI generation done.";
 
 	return mErrorText;
 }
 
-void XmiHandler::serializeLinks(QDomElement &parent, bool direction, Id const &idParent)
+void XmiHandler::serializeLinks(bool direction, Id const &idParent)
 {
 	IdList links = direction ? mApi.outgoingLinks(idParent) : mApi.incomingLinks(idParent);
 
 	foreach (Id const id, links) {
-		QDomElement link = direction ? serializeOutcomingLink(id) : serializeIncomingLink(id);
-		if (!link.isNull())
-			parent.appendChild(link);
+		if (direction)
+			serializeOutcomingLink(id);
+		else
+			serializeIncomingLink(id);
 	}
 }
 
-void XmiHandler::serializeChildren(QDomElement &parent, Id const &idParent)
+void XmiHandler::serializeChildren(Id const &idParent)
 {
 	IdList childElems = mApi.children(idParent);
 
 	foreach (Id const id, childElems)
-		serializeObject(parent, id, idParent);
+		serializeObject(id, idParent);
 
 	if (idParent != Id::rootId()) {
-		serializeLinks(parent, true, idParent);
-		serializeLinks(parent, false, idParent);
+		serializeLinks(true, idParent);
+		serializeLinks(false, idParent);
 	}
 }
 
-void XmiHandler::serializeObject(QDomElement &parent, Id const &id, Id const &parentId)
+void XmiHandler::serializeObject(Id const &id, Id const &parentId)
 {
 	typedef QPair<QString, QString> StringPair;
 
@@ -170,97 +180,100 @@ void XmiHandler::serializeObject(QDomElement &parent, Id const &id, Id const &pa
 	}
 
 	if (!typeOfElem.isEmpty() && !typeOfTag.isEmpty()) {
-		QDomElement object = createDomElement(typeOfTag, id.toString(), typeOfElem);
-		object.setAttribute("xmi:name", mApi.name(id));
+		startElement(typeOfTag, id.toString(), typeOfElem);
+		mWriter->writeAttribute("xmi:name", mApi.name(id));
 
 		foreach (StringPair nameValuePair, additionalParams)
-			object.setAttribute(nameValuePair.first, nameValuePair.second);
+			mWriter->writeAttribute(nameValuePair.first, nameValuePair.second);
 
-		serializeChildren(object, id);
+		serializeChildren(id);
 
-		parent.appendChild(object);
-		serializeLinkBodies(parent, id);
+		mWriter->writeEndElement();
+		serializeLinkBodies(id);
 	}
 }
 
-QDomElement XmiHandler::serializeOutcomingLink(Id const &id)
+void XmiHandler::serializeOutcomingLink(Id const &id)
 {
 	QString linkType = mApi.typeName(id);
-	QDomElement result;
 
 	// kernel diagram
 	if (linkType == "krnePackageImport") {
-		result = createDomElement("packageImport", id.toString(), "uml:PackageImport");
-		result.setAttribute("importedPackage", mApi.to(id).toString());
+		startElement("packageImport", id.toString(), "uml:PackageImport");
+		mWriter->writeAttribute("importedPackage", mApi.to(id).toString());
+		mWriter->writeEndElement();
 	} else if (linkType == "krneElementImport") {
-		result = createDomElement("elementImport", id.toString(), "uml:ElementImport");
-		result.setAttribute("importedElement", mApi.to(id).toString());
+		startElement("elementImport", id.toString(), "uml:ElementImport");
+		mWriter->writeAttribute("importedElement", mApi.to(id).toString());
+		mWriter->writeEndElement();
 	} else if (linkType == "krneGeneralization") {
-		result = createDomElement("generalization", id.toString(), "uml:Generalization");
-		result.setAttribute("general", mApi.to(id).toString());
+		startElement("generalization", id.toString(), "uml:Generalization");
+		mWriter->writeAttribute("general", mApi.to(id).toString());
+		mWriter->writeEndElement();
 	} else if (linkType == "krneDirRelationship") {
-		result = createDomElement("ownedAttribute", id.toString(), "uml:Property");
-		result.setAttribute("visibility", "protected");
-		result.setAttribute("type", mApi.to(id).toString());
+		startElement("ownedAttribute", id.toString(), "uml:Property");
+		mWriter->writeAttribute("visibility", "protected");
+		mWriter->writeAttribute("type", mApi.to(id).toString());
 
 		QString toMult = mApi.stringProperty(id, "toMultiplicity");
-		serializeMultiplicity(result, id, toMult);
+		serializeMultiplicity(id, toMult);
 
-		createDomElementWithIdRef(result, "association", id.toString());
+		writeElementWithIdRef("association", id.toString());
+		mWriter->writeEndElement();
 	}
 
 	// class diagram
 	else if (linkType == "ceDependency")
-		result = createDomElementWithIdRef("clientDependency",  id.toString());
+		writeElementWithIdRef("clientDependency",  id.toString());
 
 	// use case diagram
 	else if (linkType == "uscaExtend") {
-		result = createDomElement("extend", id.toString(), "uml:Extend");
-		result.setAttribute("extendedCase", mApi.to(id).toString());
+		startElement("extend", id.toString(), "uml:Extend");
+		mWriter->writeAttribute("extendedCase", mApi.to(id).toString());
 
-		createDomElementWithIdRef(result, "extension",  mApi.from(id).toString());
+		writeElementWithIdRef("extension",  mApi.from(id).toString());
+		mWriter->writeEndElement();
 	} else if (linkType == "uscaInclude") {
-		result = createDomElement("include", id.toString(), "uml:Include");
-		result.setAttribute("addition", mApi.to(id).toString());
+		startElement("include", id.toString(), "uml:Include");
+		mWriter->writeAttribute("addition", mApi.to(id).toString());
+		mWriter->writeEndElement();
 	}
-
-	return result;
 }
 
-QDomElement XmiHandler::serializeIncomingLink(Id const &id)
+void XmiHandler::serializeIncomingLink(Id const &id)
 {
-	QDomElement result;
 	if (mApi.typeName(id) == "ceDependency")
-		result = createDomElementWithIdRef("supplierDependency", id.toString());
-	return result;
+		writeElementWithIdRef("supplierDependency", id.toString());
 }
 
-QDomElement XmiHandler::createOwnedEnd(QString const &direction, Id const &id, Id const &target)
+void XmiHandler::serializeOwnedEnd(QString const &direction, Id const &id, Id const &target
+		, QString const &aggregation)
 {
-	QDomElement result = createDomElement("ownedEnd", direction + "End" + id.toString(), "uml:Property");
-	result.setAttribute("visibility", "protected");
-	result.setAttribute("type", target.toString());
+	startElement("ownedEnd", direction + "End" + id.toString(), "uml:Property");
+	mWriter->writeAttribute("visibility", "protected");
+	mWriter->writeAttribute("type", target.toString());
+	if (!aggregation.isEmpty())
+		mWriter->writeAttribute("aggregation", aggregation);
 
-	QDomElement endAssociation = createDomElementWithIdRef("association", id.toString());
+	mWriter->writeStartElement("association");
+	mWriter->writeAttribute("xmi:idref", id.toString());
 
 	QString multiplicityDirection = direction;
 	multiplicityDirection[0] = multiplicityDirection[0].toLower();
 
 	QString mult = mApi.stringProperty(id, multiplicityDirection + "Multiplicity");
-	serializeMultiplicity(endAssociation, id, mult);
-	result.appendChild(endAssociation);
+	serializeMultiplicity(id, mult);
+	mWriter->writeEndElement();
 
-	createDomElementWithIdRef(result, "association", id.toString());
-	return result;
+	writeElementWithIdRef("association", id.toString());
+	mWriter->writeEndElement();
 }
 
-QDomElement XmiHandler::serializeLink(Id const &id)
+void XmiHandler::serializeLink(Id const &id)
 {
 	QString visibility = "";
 	QString linkType = mApi.typeName(id);
 
-	QDomElement result = createDomElement("ownedMember", id.toString());
-
 	if (!mApi.stringProperty(id, "visibility").isEmpty())
 		visibility = mApi.property(id, "visibility").toString();
 
@@ -268,61 +281,57 @@ QDomElement XmiHandler::serializeLink(Id const &id)
 		|| linkType == "krneRelationship" || linkType == "ceRelation"
 		|| linkType == "krneDirRelationship")
 	{
-		result.setAttribute("xmi:type", "uml:Association");
+		startElement("ownedMember", id.toString());
+		mWriter->writeAttribute("xmi:type", "uml:Association");
 		if (!visibility.isEmpty())
-			result.setAttribute("visibility", visibility);
+			mWriter->writeAttribute("visibility", visibility);
 
 		// FromEnd
-		createDomElementWithIdRef(result, "memberEnd", "FromEnd" + id.toString());
+		writeElementWithIdRef("memberEnd", "FromEnd" + id.toString());
 
-		QDomElement fromOwnedEnd = createOwnedEnd("From", id, mApi.from(id));
-		result.appendChild(fromOwnedEnd);
+		serializeOwnedEnd("From", id, mApi.from(id));
 
 		// ToEnd
-		createDomElementWithIdRef(result, "memberEnd", "ToEnd" + id.toString());
+		writeElementWithIdRef("memberEnd", "ToEnd" + id.toString());
 
 		if (linkType != "krneDirRelationship") {
-			QDomElement toOwnedEnd = createOwnedEnd("To", id, mApi.to(id));
-
+			QString aggregation;
 			if (linkType == "ceComposition")
-				toOwnedEnd.setAttribute("aggregation", "composite");
+				aggregation = "composite";
 			else if (linkType == "ceAggregation")
-				toOwnedEnd.setAttribute("aggregation", "shared");
+				aggregation = "shared";
 
-			result.appendChild(toOwnedEnd);
+			serializeOwnedEnd("To", id, mApi.to(id), aggregation);
 		}
+		mWriter->writeEndElement();
 	} else if (linkType == "ceDependency"){
-		result.setAttribute("xmi:type", "uml:Dependency");
+		startElement("ownedMember", id.toString());
+		mWriter->writeAttribute("xmi:type", "uml:Dependency");
 
 		if (!visibility.isEmpty())
-			result.setAttribute("visibility", visibility);
+			mWriter->writeAttribute("visibility", visibility);
 
-		createDomElementWithIdRef(result, "supplier", mApi.to(id).toString());
-		createDomElementWithIdRef(result, "client", mApi.from(id).toString());
-	} else
-		result = QDomElement();
-
-	return result;
+		writeElementWithIdRef("supplier", mApi.to(id).toString());
+		writeElementWithIdRef("client", mApi.from(id).toString());
+		mWriter->writeEndElement();
+	}
 }
 
-void XmiHandler::serializeLinkBodies(QDomElement &parent, Id const &id)
+void XmiHandler::serializeLinkBodies(Id const &id)
 {
-	foreach (Id const id, mApi.incomingLinks(id)) {
-		QDomElement link = serializeLink(id);
-		if (!link.isNull())
-			parent.appendChild(link);
-	}
+	foreach (Id const id, mApi.incomingLinks(id))
+		serializeLink(id);
 }
 
-QDomElement XmiHandler::createMultiplicityNode(QString const &tagName, Id const &id, QString const &value)
+void XmiHandler::serializeMultiplicityNode(QString const &tagName, Id const &id, QString const &value)
 {
-	QDomElement result = createDomElement(tagName, tagName + "To" + id.toString(), "uml:LiteralString");
-	result.setAttribute("visibility", "public");
-	result.setAttribute("value", value);
-	return result;
+	startElement(tagName, tagName + "To" + id.toString(), "uml:LiteralString");
+	mWriter->writeAttribute("visibility", "public");
+	mWriter->writeAttribute("value", value);
+	mWriter->writeEndElement();
 }
 
-void XmiHandler::serializeMultiplicity(QDomElement &parent, Id const &id, QString const &multiplicity)
+void XmiHandler::serializeMultiplicity(Id const &id, QString const &multiplicity)
 {
 	if (!multiplicity.isEmpty()) {
 		QString valueLower;
@@ -343,57 +352,48 @@ void XmiHandler::serializeMultiplicity(QDomElement &parent, Id const &id, QStrin
 		}
 
 		if (!valueLower.isEmpty() && !valueUpper.isEmpty()) {
-			parent.appendChild(createMultiplicityNode("lowerValue", id, valueLower));
-			parent.appendChild(createMultiplicityNode("upperValue", id, valueUpper));
+			serializeMultiplicityNode("lowerValue", id, valueLower);
+			serializeMultiplicityNode("upperValue", id, valueUpper);
 		}
 	}
 }
 
-QDomElement XmiHandler::createPrimitiveType(QString const &typeName)
+void XmiHandler::serializePrimitiveType(QString const &typeName)
 {
-	QDomElement result = createDomElement("ownedMember", typeName, "uml:PrimitiveType");
-	result.setAttribute("xmi:name", typeName);
-	result.setAttribute("xmi:visibility", "public");
-	return result;
+	startElement("ownedMember", typeName, "uml:PrimitiveType");
+	mWriter->writeAttribute("xmi:name", typeName);
+	mWriter->writeAttribute("xmi:visibility", "public");
+	mWriter->writeEndElement();
 }
 
-void XmiHandler::initPrimitiveTypes(QDomElement &parent)
+void XmiHandler::initPrimitiveTypes()
 {
-	parent.appendChild(createPrimitiveType("int"));
-	parent.appendChild(createPrimitiveType("float"));
-	parent.appendChild(createPrimitiveType("double"));
+	serializePrimitiveType("int");
+	serializePrimitiveType("float");
+	serializePrimitiveType("double");
 
-	parent.appendChild(createPrimitiveType("char"));
-	parent.appendChild(createPrimitiveType("boolean"));
-	parent.appendChild(createPrimitiveType("byte"));
-}
-
-QDomElement XmiHandler::createDomElement(QString const &tagName, QString const &id)
-{
-	QDomElement result = mDocument.createElement(tagName);
-	result.setAttribute("xmi:id", id);
-	result.setAttribute("xmi:uuid", id);
-	return result;
+	serializePrimitiveType("char");
+	serializePrimitiveType("boolean");
+	serializePrimitiveType("byte");
 }
 
-QDomElement XmiHandler::createDomElement(QString const &tagName, QString const &id, QString const &type)
+void XmiHandler::startElement(QString const &tagName, QString const &id)
 {
-	QDomElement result = createDomElement(tagName, id);
-	result.setAttribute("xmi:type", type);
-	return result;
+	mWriter->writeStartElement(tagName);
+	mWriter->writeAttribute("xmi:id", id);
+	mWriter->writeAttribute("xmi:uuid", id);
 }
 
-QDomElement XmiHandler::createDomElementWithIdRef(QString const &tagName, QString const &idRef)
+void XmiHandler::startElement(QString const &tagName, QString const &id, QString const &type)
 {
-	QDomElement result = mDocument.createElement(tagName);
-	result.setAttribute("xmi:idref", idRef);
-	return result;
+	startElement(tagName, id);
+	mWriter->writeAttribute("xmi:type", type);
 }
 
-void XmiHandler::createDomElementWithIdRef(QDomElement &parent, QString const &tagName, QString const &idRef)
+void XmiHandler::writeElementWithIdRef(QString const &tagName, QString const &idRef)
 {
-	QDomElement result = createDomElementWithIdRef(tagName, idRef);
-	parent.appendChild(result);
+	mWriter->writeEmptyElement(tagName);
+	mWriter->writeAttribute("xmi:idref", idRef);
 }
 
 bool XmiHandler::isTypeSuitable(QString const &type) const
@@ -1,12 +1,12 @@
 #pragma once
 
 #include <QtCore/QString>
-#include <QtXml/QDomDocument>
-#include <QtXml/QDomElement>
 
 #include "../../kernel/ids.h"
 #include "../../../qrrepo/logicalRepoApi.h"
 
+class QXmlStreamWriter;
+
 namespace qReal {
 
 	namespace generators {
@@ -16,26 +16,27 @@ namespace qReal {
 		public:
 			explicit XmiHandler(qrRepo::LogicalRepoApi const &api);
 
+			/// Writes the model to a file element by element, without building a document in memory.
 			QString exportToXmi(QString const &pathToFile);
 		private:
-			void serializeLinks(QDomElement &parent, bool direction, Id const &idParent);
-			void serializeChildren(QDomElement &parent, Id const &idParent);
-			void serializeObject(QDomElement &parent, Id const &id, Id const &parentId);
-			QDomElement serializeOutcomingLink(Id const &id);
-			QDomElement serializeIncomingLink(Id const &id);
-			QDomElement createOwnedEnd(QString const &direction, Id const &id, Id const &target);
-			QDomElement serializeLink(Id const &id);
-			void serializeLinkBodies(QDomElement &parent, Id const &id);
-
-			QDomElement createPrimitiveType(QString const &typeName);
-			void initPrimitiveTypes(QDomElement &parent);
-			QDomElement createMultiplicityNode(QString const &tagName, Id const &id, QString const &value);
-			void serializeMultiplicity(QDomElement &parent, Id const &id, QString const &multiplicity);
-
-			QDomElement createDomElement(QString const &tagName, QString const &id);
-			QDomElement createDomElement(QString const &tagName, QString const &id, QString const &type);
-			void createDomElementWithIdRef(QDomElement &parent, QString const &tagName, QString const &idRef);
-			QDomElement createDomElementWithIdRef(QString const &tagName, QString const &idRef);
+			void serializeLinks(bool direction, Id const &idParent);
+			void serializeChildren(Id const &idParent);
+			void serializeObject(Id const &id, Id const &parentId);
+			void serializeOutcomingLink(Id const &id);
+			void serializeIncomingLink(Id const &id);
+			void serializeOwnedEnd(QString const &direction, Id const &id, Id const &target
+					, QString const &aggregation = QString());
+			void serializeLink(Id const &id);
+			void serializeLinkBodies(Id const &id);
+
+			void serializePrimitiveType(QString const &typeName);
+			void initPrimitiveTypes();
+			void serializeMultiplicityNode(QString const &tagName, Id const &id, QString const &value);
+			void serializeMultiplicity(Id const &id, QString const &multiplicity);
+
+			void startElement(QString const &tagName, QString const &id);
+			void startElement(QString const &tagName, QString const &id, QString const &type);
+			void writeElementWithIdRef(QString const &tagName, QString const &idRef);
 
 			bool isTypeSuitable(QString const &type) const;
 			bool isVisibilitySuitable(QString const &type) const;
@@ -43,7 +44,7 @@ namespace qReal {
 			void addError(QString const &errorText);
 
 			qrRepo::LogicalRepoApi const &mApi;
-			QDomDocument mDocument;
+			QXmlStreamWriter *mWriter;
 			QString mErrorText;
 		};
 
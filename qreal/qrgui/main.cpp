@@ -3,9 +3,65 @@
 
 #include <QtPlugin>
 #include <QApplication>
+#include <QtCore/QDebug>
 
 using namespace qReal;
 
+namespace {
+
+void printExportUsage()
+{
+	qDebug() << "Usage: qrgui --export <output directory> [--save <save directory>]"
+			<< "[--format svg|png|svg,png] [--diagram <name>]... [--threads <count>]";
+}
+
+/// Command line mode for batch export of diagrams, e.g. for documentation builds.
+/// The main window is created but never shown.
+int exportDiagrams(QStringList const &arguments)
+{
+	QString outputDirectory;
+	QString saveDirectory;
+	QStringList formats("svg");
+	QStringList diagrams;
+	int threads = 0;
+
+	for (int i = 1; i < arguments.size(); ++i) {
+		QString const argument = arguments[i];
+		bool const hasValue = i + 1 < arguments.size();
+		if (!hasValue) {
+			printExportUsage();
+			return 1;
+		}
+		QString const value = arguments[++i];
+		if (argument == "--export")
+			outputDirectory = value;
+		else if (argument == "--save")
+			saveDirectory = value;
+		else if (argument == "--format")
+			formats = value.split(",", QString::SkipEmptyParts);
+		else if (argument == "--diagram")
+			diagrams << value;
+		else if (argument == "--threads")
+			threads = value.toInt();
+		else {
+			printExportUsage();
+			return 1;
+		}
+	}
+
+	foreach (QString const &format, formats) {
+		if (format != "svg" && format != "png") {
+			printExportUsage();
+			return 1;
+		}
+	}
+
+	MainWindow window(false, saveDirectory);
+	return window.exportDiagrams(outputDirectory, formats, diagrams, threads);
+}
+
+}
+
 int main(int argc, char *argv[])
 {
 	QApplication app(argc, argv);
@@ -14,6 +70,9 @@ int main(int argc, char *argv[])
 	appTranslator.load(":/qrgui_" + QLocale::system().name());
 	app.installTranslator(&appTranslator);
 
+	if (app.arguments().contains("--export"))
+		return exportDiagrams(app.arguments());
+
 #ifndef NO_STYLE_WINDOWSMODERN
 	app.setStyle(new WindowsModernStyle());
 #endif
@@ -0,0 +1,115 @@
+#include "diagramExporter.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QRegExp>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtSvg/QSvgGenerator>
+
+using namespace qReal;
+
+class DiagramExporter::Job : public QRunnable
+{
+public:
+	Job(DiagramExporter &exporter, QPicture const &picture, QString const &file, QString const &format)
+		: mExporter(exporter), mPicture(picture), mFile(file), mFormat(format)
+	{
+	}
+
+	virtual void run()
+	{
+		QRect const bounds = mPicture.boundingRect();
+		bool const ok = mFormat == "svg" ? writeSvg(bounds) : writePng(bounds);
+		if (!ok)
+			mExporter.reportFailure(mFile);
+	}
+
+private:
+	bool writeSvg(QRect const &bounds)
+	{
+		QSvgGenerator generator;
+		generator.setFileName(mFile);
+		generator.setSize(bounds.size());
+		generator.setViewBox(QRect(QPoint(0, 0), bounds.size()));
+
+		QPainter painter;
+		if (!painter.begin(&generator))
+			return false;
+		painter.drawPicture(-bounds.topLeft(), mPicture);
+		return painter.end();
+	}
+
+	bool writePng(QRect const &bounds)
+	{
+		QImage image(bounds.size().expandedTo(QSize(1, 1)), QImage::Format_ARGB32_Premultiplied);
+		image.fill(Qt::white);
+
+		QPainter painter(&image);
+		painter.setRenderHint(QPainter::Antialiasing);
+		painter.drawPicture(-bounds.topLeft(), mPicture);
+		painter.end();
+
+		return image.save(mFile, "PNG");
+	}
+
+	DiagramExporter &mExporter;
+	QPicture mPicture;
+	QString mFile;
+	QString mFormat;
+};
+
+DiagramExporter::DiagramExporter(QString const &outputDirectory, QStringList const &formats, int threads)
+	: mOutputDirectory(outputDirectory), mFormats(formats), mThreads(threads)
+{
+}
+
+void DiagramExporter::addDiagram(QString const &name, QPicture const &picture)
+{
+	Diagram diagram;
+	diagram.name = name;
+	diagram.picture = picture;
+	mDiagrams.append(diagram);
+}
+
+QStringList DiagramExporter::run()
+{
+	QDir dir;
+	dir.mkpath(mOutputDirectory);
+
+	QThreadPool pool;
+	if (mThreads > 0)
+		pool.setMaxThreadCount(mThreads);
+
+	QStringList usedNames;
+	foreach (Diagram const &diagram, mDiagrams) {
+		// Diagrams may have equal names, file names must not.
+		QString name = fileName(diagram.name);
+		QString const baseName = name;
+		for (int i = 2; usedNames.contains(name); ++i)
+			name = baseName + "_" + QString::number(i);
+		usedNames << name;
+
+		foreach (QString const &format, mFormats) {
+			QString const file = QDir(mOutputDirectory).absoluteFilePath(name + "." + format);
+			pool.start(new Job(*this, diagram.picture, file, format));
+		}
+	}
+	pool.waitForDone();
+
+	return mFailed;
+}
+
+QString DiagramExporter::fileName(QString const &name)
+{
+	QString result = name.trimmed();
+	result.replace(QRegExp("[^\\w\\-]+"), "_");
+	return result.isEmpty() ? "diagram" : result;
+}
+
+void DiagramExporter::reportFailure(QString const &file)
+{
+	QMutexLocker locker(&mFailedMutex);
+	mFailed << file;
+}
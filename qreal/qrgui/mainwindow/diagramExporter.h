@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtGui/QPicture>
+
+namespace qReal {
+
+/// Writes recorded diagrams to SVG and PNG files using a pool of worker threads.
+/// Scenes can be painted only in GUI thread, so they are recorded into QPicture
+/// there, while replaying pictures and encoding images is done by workers.
+class DiagramExporter
+{
+public:
+	/// @param formats List of "svg" and "png".
+	/// @param threads Number of worker threads, 0 means number of processor cores.
+	DiagramExporter(QString const &outputDirectory, QStringList const &formats, int threads = 0);
+
+	/// Adds recorded diagram to export. Name is used as a file name without extension.
+	void addDiagram(QString const &name, QPicture const &picture);
+
+	/// Renders all added diagrams and waits for the workers to finish.
+	/// @returns List of files which could not be written.
+	QStringList run();
+
+private:
+	struct Diagram {
+		QString name;
+		QPicture picture;
+	};
+
+	class Job;
+
+	static QString fileName(QString const &name);
+	void reportFailure(QString const &file);
+
+	QString mOutputDirectory;
+	QStringList mFormats;
+	int mThreads;
+	QList<Diagram> mDiagrams;
+	QStringList mFailed;
+	QMutex mFailedMutex;
+};
+
+}
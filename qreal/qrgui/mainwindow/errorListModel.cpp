@@ -0,0 +1,257 @@
+#include "errorListModel.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <QtGui/QIcon>
+
+using namespace qReal;
+using namespace gui;
+
+ErrorListModel::ErrorListModel(QObject *parent)
+	: QAbstractListModel(parent)
+	, mSeverityIndex(severitiesCount)
+	, mVisibleSeverities(severitiesCount, true)
+	, mClearRequested(false)
+	, mUpdateScheduled(false)
+{
+	mUpdateTimer.setSingleShot(true);
+	mUpdateTimer.setInterval(updateInterval);
+	connect(&mUpdateTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+void ErrorListModel::append(Error const &error)
+{
+	Entry const entry = { error, false };
+	enqueue(QList<Entry>() << entry);
+}
+
+void ErrorListModel::append(QList<Error> const &errors)
+{
+	QList<Entry> entries;
+	foreach (Error const &error, errors) {
+		Entry const entry = { error, false };
+		entries << entry;
+	}
+	enqueue(entries);
+}
+
+void ErrorListModel::appendText(QString const &text)
+{
+	Entry const entry = { Error(text, Error::information, Id()), true };
+	enqueue(QList<Entry>() << entry);
+}
+
+void ErrorListModel::clear()
+{
+	{
+		QMutexLocker locker(&mPendingMutex);
+		mPending.clear();
+		mClearRequested = true;
+	}
+
+	// Request is handled by flush(), so messages queued after it are inserted after the reset.
+	if (QThread::currentThread() == thread())
+		flush();
+	else
+		QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+}
+
+void ErrorListModel::removeAll()
+{
+	beginResetModel();
+	mEntries.clear();
+	mVisibleRows.clear();
+	for (int i = 0; i < severitiesCount; ++i)
+		mSeverityIndex[i].clear();
+	mElementIndex.clear();
+	mElementFilter = Id();
+	endResetModel();
+}
+
+int ErrorListModel::rowCount(QModelIndex const &parent) const
+{
+	return parent.isValid() ? 0 : mVisibleRows.size();
+}
+
+QVariant ErrorListModel::data(QModelIndex const &index, int role) const
+{
+	if (!index.isValid() || index.row() >= mVisibleRows.size())
+		return QVariant();
+
+	Entry const &entry = mEntries.at(mVisibleRows.at(index.row()));
+	switch (role) {
+	case Qt::DisplayRole:
+		if (entry.isText)
+			return entry.error.message();
+		return " " + (severityMessage(entry.error.severity()) + " " + entry.error.message()).trimmed();
+	case Qt::DecorationRole: {
+		if (entry.isText)
+			return QVariant();
+		static QIcon const icons[severitiesCount] = {
+			QIcon(":/icons/information.png")
+			, QIcon(":/icons/warning.png")
+			, QIcon(":/icons/error.png")
+			, QIcon(":/icons/critical.png")
+		};
+		return icons[entry.error.severity()];
+	}
+	case Qt::ToolTipRole:
+		return entry.isText ? QVariant() : entry.error.position().toString();
+	case Qt::TextAlignmentRole:
+		return int(Qt::AlignVCenter);
+	case positionRole:
+		return entry.error.position().toVariant();
+	case severityRole:
+		return entry.error.severity();
+	default:
+		return QVariant();
+	}
+}
+
+void ErrorListModel::setSeverityVisible(Error::Severity severity, bool visible)
+{
+	if (mVisibleSeverities[severity] == visible)
+		return;
+	mVisibleSeverities[severity] = visible;
+	rebuildVisibleRows();
+}
+
+bool ErrorListModel::isSeverityVisible(Error::Severity severity) const
+{
+	return mVisibleSeverities.at(severity);
+}
+
+void ErrorListModel::setElementFilter(Id const &element)
+{
+	if (mElementFilter == element)
+		return;
+	mElementFilter = element;
+	rebuildVisibleRows();
+}
+
+Id ErrorListModel::elementFilter() const
+{
+	return mElementFilter;
+}
+
+int ErrorListModel::count(Error::Severity severity) const
+{
+	return mSeverityIndex.at(severity).size();
+}
+
+QList<Error> ErrorListModel::errors(Id const &element) const
+{
+	QList<Error> result;
+	foreach (int const row, mElementIndex.value(element))
+		result << mEntries.at(row).error;
+	return result;
+}
+
+QString ErrorListModel::severityMessage(Error::Severity severity)
+{
+	switch (severity) {
+	case Error::information:
+		return tr("INFORMATION:");
+	case Error::warning:
+		return tr("WARNING:");
+	case Error::error:
+		return tr("ERROR:");
+	case Error::critical:
+		return tr("CRITICAL:");
+	default:
+		return QString();
+	}
+}
+
+void ErrorListModel::flush()
+{
+	mUpdateTimer.stop();
+
+	QList<Entry> batch;
+	bool clearRequested = false;
+	{
+		QMutexLocker locker(&mPendingMutex);
+		batch = mPending;
+		mPending.clear();
+		mUpdateScheduled = false;
+		clearRequested = mClearRequested;
+		mClearRequested = false;
+	}
+	if (clearRequested)
+		removeAll();
+	if (batch.isEmpty())
+		return;
+
+	QVector<int> shown;
+	foreach (Entry const &entry, batch) {
+		int const row = mEntries.size();
+		mEntries << entry;
+		if (!entry.isText) {
+			mSeverityIndex[entry.error.severity()] << row;
+			mElementIndex[entry.error.position()] << row;
+		}
+		if (accepts(entry))
+			shown << row;
+	}
+
+	if (!shown.isEmpty()) {
+		beginInsertRows(QModelIndex(), mVisibleRows.size(), mVisibleRows.size() + shown.size() - 1);
+		mVisibleRows += shown;
+		endInsertRows();
+	}
+	emit messagesAdded();
+}
+
+void ErrorListModel::startUpdateTimer()
+{
+	if (!mUpdateTimer.isActive())
+		mUpdateTimer.start();
+}
+
+void ErrorListModel::enqueue(QList<Entry> const &entries)
+{
+	if (entries.isEmpty())
+		return;
+
+	bool schedule = false;
+	{
+		QMutexLocker locker(&mPendingMutex);
+		mPending += entries;
+		schedule = !mUpdateScheduled;
+		mUpdateScheduled = true;
+	}
+	if (!schedule)
+		return;
+
+	// The timer lives in the thread of the model, so it is started there.
+	if (QThread::currentThread() == thread())
+		startUpdateTimer();
+	else
+		QMetaObject::invokeMethod(this, "startUpdateTimer", Qt::QueuedConnection);
+}
+
+bool ErrorListModel::accepts(Entry const &entry) const
+{
+	if (entry.isText)
+		return mElementFilter == Id();
+	return mVisibleSeverities.at(entry.error.severity())
+			&& (mElementFilter == Id() || entry.error.position() == mElementFilter);
+}
+
+void ErrorListModel::rebuildVisibleRows()
+{
+	beginResetModel();
+	mVisibleRows.clear();
+	if (mElementFilter != Id()) {
+		foreach (int const row, mElementIndex.value(mElementFilter)) {
+			if (accepts(mEntries.at(row)))
+				mVisibleRows << row;
+		}
+	} else {
+		for (int row = 0; row < mEntries.size(); ++row) {
+			if (accepts(mEntries.at(row)))
+				mVisibleRows << row;
+		}
+	}
+	endResetModel();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "../kernel/ids.h"
+#include "error.h"
+
+namespace qReal {
+namespace gui {
+
+/// Messages shown in the error dock. Messages may be appended from any thread: they are queued
+/// and inserted into the model in batches, at most once per update interval, so that tens of
+/// thousands of messages do not mean tens of thousands of view updates.
+/// Rows are indexed by severity and by element, filtering does not touch the messages themselves.
+class ErrorListModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	enum Roles {
+		positionRole = Qt::UserRole
+		, severityRole
+	};
+
+	explicit ErrorListModel(QObject *parent = NULL);
+
+	/// Thread-safe.
+	void append(Error const &error);
+	/// Thread-safe.
+	void append(QList<Error> const &errors);
+	/// Appends a line shown as is, without severity and icon (build output and such). Thread-safe.
+	void appendText(QString const &text);
+	/// Removes all messages, including queued ones, and the element filter. Thread-safe: the
+	/// model is reset in its own thread, at once if it is the calling one, messages appended
+	/// after the call are kept.
+	void clear();
+
+	int rowCount(QModelIndex const &parent = QModelIndex()) const;
+	QVariant data(QModelIndex const &index, int role) const;
+
+	void setSeverityVisible(Error::Severity severity, bool visible);
+	bool isSeverityVisible(Error::Severity severity) const;
+	/// Shows only messages about the given element, Id() shows messages about all elements.
+	void setElementFilter(Id const &element);
+	Id elementFilter() const;
+
+	/// Number of messages of the given severity, whether they are filtered out or not.
+	int count(Error::Severity severity) const;
+	/// Messages about the given element.
+	QList<Error> errors(Id const &element) const;
+
+	static QString severityMessage(Error::Severity severity);
+
+signals:
+	/// Emitted after a batch of messages has been inserted.
+	void messagesAdded();
+
+public slots:
+	/// Inserts queued messages right now.
+	void flush();
+
+private slots:
+	void startUpdateTimer();
+
+private:
+	struct Entry
+	{
+		Error error;
+		bool isText;
+	};
+
+	void enqueue(QList<Entry> const &entries);
+	void removeAll();
+	bool accepts(Entry const &entry) const;
+	void rebuildVisibleRows();
+
+	static int const updateInterval = 100;  // Milliseconds.
+	static int const severitiesCount = Error::critical + 1;
+
+	QList<Entry> mEntries;
+	QVector<int> mVisibleRows;  // Indexes of shown entries in mEntries.
+	QVector<QList<int> > mSeverityIndex;
+	QHash<Id, QList<int> > mElementIndex;
+	QVector<bool> mVisibleSeverities;
+	Id mElementFilter;
+
+	QMutex mPendingMutex;
+	QList<Entry> mPending;
+	bool mClearRequested;
+	bool mUpdateScheduled;
+	QTimer mUpdateTimer;
+};
+
+}
+}
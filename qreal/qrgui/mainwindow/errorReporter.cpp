@@ -1,4 +1,6 @@
 #include "errorReporter.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
 #include <QtGui/QMessageBox>
 #include "errorlistwidget.h"
 #include "../kernel/exception/exception.h"
@@ -20,44 +22,42 @@ ErrorReporter::ErrorReporter(ErrorListWidget* const errorListWidget, QDockWidget
 
 void ErrorReporter::addInformation(QString const &message, Id const &position)
 {
-	Error error(message, Error::information, position);
-	mErrors.append(error);
-	showError(error, mErrorListWidget);
+	add(Error(message, Error::information, position));
 }
 
 void ErrorReporter::addWarning(QString const &message, Id const &position)
 {
-	Error error(message, Error::warning, position);
-	mErrors.append(error);
-	showError(error, mErrorListWidget);
+	add(Error(message, Error::warning, position));
 }
 
 void ErrorReporter::addError(QString const &message, Id const &position)
 {
-	Error error(message, Error::error, position);
-	mErrors.append(error);
-	showError(error, mErrorListWidget);
+	add(Error(message, Error::error, position));
 }
 
 void ErrorReporter::addCritical(QString const &message, Id const &position)
 {
-	Error error(message, Error::critical, position);
-	mErrors.append(error);
-	showError(error, mErrorListWidget);
+	add(Error(message, Error::critical, position));
 }
 
 bool ErrorReporter::showErrors(ErrorListWidget* const errorListWidget, QDockWidget* const errorList) const
 {
 	errorListWidget->clear();
 
-	if (mErrors.isEmpty()) {
+	QList<Error> errors;
+	{
+		QMutexLocker locker(&mErrorsMutex);
+		errors = mErrors;
+	}
+
+	if (errors.isEmpty()) {
 		errorList->setVisible(false);
 		return true;
 	}
 
 	errorList->setVisible(true);
-	foreach (Error error, mErrors)
-		showError(error, errorListWidget);
+	errorListWidget->errorModel()->append(errors);
+	errorListWidget->errorModel()->flush();
 	return false;
 }
 
@@ -70,54 +70,26 @@ void ErrorReporter::clear()
 }
 
 void ErrorReporter::clearErrors() {
+	QMutexLocker locker(&mErrorsMutex);
 	mErrors.clear();
 }
 
-void ErrorReporter::showError(Error const &error, ErrorListWidget* const errorListWidget) const
+void ErrorReporter::add(Error const &error)
 {
-	if (!errorListWidget)
-		return;
-
-	if (mErrorList && !mErrorList->isVisible())
-		mErrorList->setVisible(true);
-
-	QListWidgetItem* item = new QListWidgetItem(errorListWidget);
-	QString message = severityMessage(error) + " ";
-	message += error.message();
-	switch (error.severity()) {
-	case Error::information:
-		item->setIcon(QIcon(":/icons/information.png"));
-		break;
-	case Error::warning:
-		item->setIcon(QIcon(":/icons/warning.png"));
-		break;
-	case Error::error:
-		item->setIcon(QIcon(":/icons/error.png"));
-		break;
-	case Error::critical:
-		item->setIcon(QIcon(":/icons/critical.png"));
-		break;
-	default:
-		throw new Exception("Incorrect total severity");
+	{
+		QMutexLocker locker(&mErrorsMutex);
+		mErrors.append(error);
 	}
-	item->setText(" " + message.trimmed());
-	item->setTextAlignment(Qt::AlignVCenter);
-	item->setToolTip(error.position().toString());
-	errorListWidget->addItem(item);
-}
 
-QString ErrorReporter::severityMessage(Error const &error)
-{
-	switch (error.severity()) {
-	case Error::information:
-		return tr("INFORMATION:");
-	case Error::warning:
-		return tr("WARNING:");
-	case Error::error:
-		return tr("ERROR:");
-	case Error::critical:
-		return tr("CRITICAL:");
-	default:
-		throw new Exception("Incorrect severity of an error");
+	if (!mErrorListWidget)
+		return;
+
+	mErrorListWidget->errorModel()->append(error);
+	if (mErrorList && !mErrorList->isVisible()) {
+		// Widgets may be touched only from the GUI thread.
+		if (QThread::currentThread() == mErrorList->thread())
+			mErrorList->setVisible(true);
+		else
+			QMetaObject::invokeMethod(mErrorList, "setVisible", Qt::QueuedConnection, Q_ARG(bool, true));
 	}
 }
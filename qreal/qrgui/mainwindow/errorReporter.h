@@ -2,6 +2,7 @@
 
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
 
 #include"mainwindow.h"
 #include "../kernel/ids.h"
@@ -12,6 +13,8 @@
 namespace qReal {
 namespace gui {
 
+/// Collects messages of a generator, parser or checker. Adding messages is thread-safe, so
+/// background jobs may report directly; the dock gets them in batches through ErrorListModel.
 class ErrorReporter : public QObject {
 	Q_OBJECT
 
@@ -28,14 +31,14 @@ public:
 	void clear();
 	void clearErrors();
 private:
+	void add(Error const &error);
+
 	QList<Error> mErrors;
+	mutable QMutex mErrorsMutex;
 
 	ErrorListWidget* const mErrorListWidget;  // Doesn't have ownership
 	QDockWidget* const mErrorList;  // Doesn't have ownership
 
-	static QString severityMessage(Error const &error);
-	void showError(Error const &error, ErrorListWidget* const errorListWidget) const;
-
 };
 
 }
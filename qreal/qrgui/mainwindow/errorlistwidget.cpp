@@ -1,21 +1,37 @@
 #include "errorlistwidget.h"
 #include"mainwindow.h"
 
+#include <QtGui/QMenu>
+#include <QtGui/QScrollBar>
+
+using namespace qReal::gui;
+
 ErrorListWidget::ErrorListWidget(QWidget *parent)
+	: QListView(parent)
+	, mMainWindow(NULL)
+	, mModel(new ErrorListModel(this))
+	, mFollowLast(false)
 {
-	Q_UNUSED(parent);
+	setModel(mModel);
+	setUniformItemSizes(true);
+	setLayoutMode(QListView::Batched);
+	setContextMenuPolicy(Qt::CustomContextMenu);
 	connect(this, SIGNAL(clicked(QModelIndex)), this, SLOT(clickList()));
+	connect(this, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showContextMenu(QPoint)));
+	connect(mModel, SIGNAL(messagesAdded()), this, SLOT(scrollToLast()));
 }
 
 void ErrorListWidget::clickList()
 {
-	highlightElement(currentItem());
+	highlightElement(currentIndex());
 }
 
-void ErrorListWidget::highlightElement(QListWidgetItem* const item)
+void ErrorListWidget::highlightElement(QModelIndex const &index)
 {
-	qReal::Id const id = qReal::Id::loadFromString(item->data(Qt::ToolTipRole).toString());
-	if (item->isSelected())
+	if (!index.isValid() || !mMainWindow)
+		return;
+	qReal::Id const id = index.data(ErrorListModel::positionRole).value<qReal::Id>();
+	if (id != qReal::Id() && selectionModel()->isSelected(index))
 		mMainWindow->selectItemWithError(id);
 }
 
@@ -23,3 +39,71 @@ void ErrorListWidget::init(qReal::MainWindow* mainWindow)
 {
 	mMainWindow = mainWindow;
 }
+
+ErrorListModel *ErrorListWidget::errorModel() const
+{
+	return mModel;
+}
+
+void ErrorListWidget::clear()
+{
+	mModel->clear();
+	mFollowLast = false;
+}
+
+void ErrorListWidget::addItem(QString const &text)
+{
+	mModel->appendText(text);
+	mFollowLast = true;
+}
+
+void ErrorListWidget::scrollToLast()
+{
+	if (mFollowLast)
+		scrollToBottom();
+}
+
+void ErrorListWidget::showContextMenu(QPoint const &position)
+{
+	QMenu menu;
+	for (int i = Error::information; i <= Error::critical; ++i) {
+		Error::Severity const severity = static_cast<Error::Severity>(i);
+		QAction * const action = menu.addAction(ErrorListModel::severityMessage(severity)
+				+ QString(" %1").arg(mModel->count(severity)));
+		action->setCheckable(true);
+		action->setChecked(mModel->isSeverityVisible(severity));
+		action->setData(i);
+		connect(action, SIGNAL(toggled(bool)), this, SLOT(toggleSeverity(bool)));
+	}
+
+	menu.addSeparator();
+	qReal::Id const element = indexAt(position).data(ErrorListModel::positionRole).value<qReal::Id>();
+	if (element != qReal::Id() && element != mModel->elementFilter()) {
+		QAction * const action = menu.addAction(tr("Only messages about this element")
+				+ QString(" %1").arg(mModel->errors(element).size()));
+		action->setData(element.toVariant());
+		connect(action, SIGNAL(triggered()), this, SLOT(filterByElement()));
+	}
+	if (mModel->elementFilter() != qReal::Id())
+		menu.addAction(tr("Messages about all elements"), this, SLOT(showAllElements()));
+	menu.exec(viewport()->mapToGlobal(position));
+}
+
+void ErrorListWidget::toggleSeverity(bool visible)
+{
+	QAction * const action = qobject_cast<QAction *>(sender());
+	if (action)
+		mModel->setSeverityVisible(static_cast<Error::Severity>(action->data().toInt()), visible);
+}
+
+void ErrorListWidget::filterByElement()
+{
+	QAction * const action = qobject_cast<QAction *>(sender());
+	if (action)
+		mModel->setElementFilter(action->data().value<qReal::Id>());
+}
+
+void ErrorListWidget::showAllElements()
+{
+	mModel->setElementFilter(qReal::Id());
+}
@@ -1,27 +1,40 @@
 #pragma once
 
-#include <QtGui/QListWidget>
+#include <QtGui/QListView>
 #include "../kernel/ids.h"
 #include "error.h"
+#include "errorListModel.h"
 
 namespace qReal {
   class MainWindow;
 }
 
-class ErrorListWidget : public QListWidget
+/// View of the error dock. Rows come from ErrorListModel, so only visible ones cost anything.
+class ErrorListWidget : public QListView
 {
 	Q_OBJECT
 
 private slots:
 	void clickList();
+	void scrollToLast();
+	void showContextMenu(QPoint const &position);
+	void toggleSeverity(bool visible);
+	void filterByElement();
+	void showAllElements();
 
 public:
 	explicit ErrorListWidget(QWidget *parent = NULL);
 	void init(qReal::MainWindow* mainWindow);
-	void highlightElement(QListWidgetItem* const item);
+	void highlightElement(QModelIndex const &index);
+
+	qReal::gui::ErrorListModel *errorModel() const;
+	void clear();
+	/// Appends a line without severity, such as compiler output.
+	void addItem(QString const &text);
 
 private:
 	qReal::MainWindow* mMainWindow;
+	qReal::gui::ErrorListModel *mModel;  // Has ownership.
+	bool mFollowLast;
 
 };
-
@@ -11,6 +11,7 @@
 #include <QtGui/QMessageBox>
 #include <QtGui/QPrintDialog>
 #include <QtGui/QProgressBar>
+#include <QtGui/QPushButton>
 #include <QtGui/QListWidgetItem>
 
 #include <QtSvg/QSvgGenerator>
@@ -20,6 +21,7 @@
 #include <QtCore/QPluginLoader>
 
 #include "errorReporter.h"
+#include "diagramExporter.h"
 
 #include "../pluginInterface/editorInterface.h"
 #include "preferencesDialog.h"
@@ -29,7 +31,9 @@
 #include "gesturesShow/gestureswidget.h"
 
 #include "../models/models.h"
+#include "../../qrrepo/repoCommand.h"
 #include "../view/editorview.h"
+#include "../view/diagramNotificationRouter.h"
 #include "../umllib/uml_element.h"
 #include "../dialogs/plugindialog.h"
 #include "../parsers/xml/xmlParser.h"
@@ -46,13 +50,56 @@
 
 using namespace qReal;
 
-MainWindow::MainWindow()
+namespace {
+
+QString exportToXmiFile(qrRepo::LogicalRepoApi const &api, QString const &fileName)
+{
+	generators::XmiHandler xmi(api);
+	return xmi.exportToXmi(fileName);
+}
+
+QString generateJavaCode(qrRepo::LogicalRepoApi const &api, QString const &dirName)
+{
+	generators::JavaHandler java(api);
+	return java.generateToJava(dirName);
+}
+
+/// Generates sources of an editor by qrmc when its build starts, so make of a previous
+/// build in the same directory never sees them half-written
+class QrmcPreparation : public EditorBuilder::Preparation
+{
+public:
+	explicit QrmcPreparation(QString const &metamodelName)
+		: mMetamodelName(metamodelName)
+	{
+	}
+
+	bool prepare(QString &error)
+	{
+		qrmc::MetaCompiler metaCompiler("../qrmc", "./save");
+		// Generated sources which did not change are not rewritten, so make rebuilds only what is needed.
+		if (!metaCompiler.compile(mMetamodelName)) {
+			error = QObject::tr("cannot generate source code for editor %1").arg(mMetamodelName);
+			return false;
+		}
+		return true;
+	}
+
+private:
+	QString const mMetamodelName;
+};
+
+}
+
+MainWindow::MainWindow(bool interactive, QString const &saveDirectory)
 	: mUi(new Ui::MainWindowUi())
 	, mListenerManager(NULL)
 	, mPropertyModel(mEditorManager)
+	, mInteractive(interactive)
+	, mInitialized(false)
 {
 	QSettings settings("SPbSU", "QReal");
-	bool showSplash = settings.value("Splashscreen", true).toBool();
+	bool showSplash = interactive && settings.value("Splashscreen", true).toBool();
 	QSplashScreen* splash =
 			new QSplashScreen(QPixmap(":/icons/kroki3.PNG"), Qt::SplashScreen | Qt::WindowStaysOnTopHint);
 
@@ -92,6 +139,15 @@ MainWindow::MainWindow()
 
 	connect(mUi->actionQuit, SIGNAL(triggered()), this, SLOT(close()));
 
+	QMenu * const editMenu = new QMenu(tr("&Edit"), this);
+	QAction * const undoAction = mUndoStack.createUndoAction(this);
+	undoAction->setShortcut(QKeySequence::Undo);
+	QAction * const redoAction = mUndoStack.createRedoAction(this);
+	redoAction->setShortcut(QKeySequence::Redo);
+	editMenu->addAction(undoAction);
+	editMenu->addAction(redoAction);
+	menuBar()->insertMenu(mUi->menu_View->menuAction(), editMenu);
+
 	connect(mUi->actionShowSplash, SIGNAL(toggled(bool)), this, SLOT (toggleShowSplash(bool)));
 
 	connect(mUi->actionOpen, SIGNAL(triggered()), this, SLOT(open()));
@@ -175,23 +231,31 @@ MainWindow::MainWindow()
 	// Step 4: Property editor and model explorers are initialized.
 	progress->setValue(60);
 	loadPlugins();
-	showMaximized();
+	if (interactive) {
+		showMaximized();
+
+		settings.beginGroup("MainWindow");
+		if (!settings.value("maximized", true).toBool()) {
+			showNormal();
+			resize(settings.value("size", QSize(1024, 800)).toSize());
+			move(settings.value("pos", QPoint(0, 0)).toPoint());
+		}
+		settings.endGroup();
+	}
 
 	// Step 5: Plugins are loaded.
 	progress->setValue(70);
 
-	settings.beginGroup("MainWindow");
-	if (!settings.value("maximized", true).toBool()) {
-		showNormal();
-		resize(settings.value("size", QSize(1024, 800)).toSize());
-		move(settings.value("pos", QPoint(0, 0)).toPoint());
-	}
-	settings.endGroup();
-
-	QString workingDir = settings.value("workingDir", ".").toString();
+	QString const workingDir = saveDirectory.isEmpty()
+			? settings.value("workingDir", ".").toString()
+			: saveDirectory;
 
 	mRootIndex = QModelIndex();
 	mModels = new models::Models(workingDir, mEditorManager);
+	mModels->setUndoStack(&mUndoStack);
+	mNotificationRouter = new DiagramNotificationRouter(mModels->graphicalModel(), this);
+	connect(mModels->logicalModel(), SIGNAL(propertyRejected(QString, qReal::Id))
+			, this, SLOT(propertyRejected(QString, qReal::Id)));
 
 	// Step 6: Save loaded, models initialized.
 	progress->setValue(80);
@@ -204,7 +268,10 @@ MainWindow::MainWindow()
 		QString text = "These plugins are not present, but needed to load the save:\n";
 		foreach (Id const id, missingPlugins)
 			text += id.editor() + "\n";
-		QMessageBox::warning(this, tr("Some plugins are missing"), text);
+		if (interactive)
+			QMessageBox::warning(this, tr("Some plugins are missing"), text);
+		else
+			qDebug() << text;
 		close();
 		return;
 	}
@@ -223,6 +290,32 @@ MainWindow::MainWindow()
 	connect(mDebuggerConnector, SIGNAL(readyReadStdOutput(QString)), this, SLOT(drawDebuggerStdOutput(QString)));
 	connect(mDebuggerConnector, SIGNAL(readyReadErrOutput(QString)), this, SLOT(drawDebuggerErrOutput(QString)));
 
+	mEditorBuildProgress = new QProgressBar(this);
+	mEditorBuildProgress->setFixedWidth(160);
+	mEditorBuildProgress->hide();
+	mCancelEditorBuildButton = new QPushButton(tr("Cancel build"), this);
+	mCancelEditorBuildButton->hide();
+	statusBar()->addPermanentWidget(mEditorBuildProgress);
+	statusBar()->addPermanentWidget(mCancelEditorBuildButton);
+	connect(mCancelEditorBuildButton, SIGNAL(clicked()), &mEditorBuilder, SLOT(cancel()));
+	connect(&mEditorBuilder, SIGNAL(aboutToBuild(QString, QString)), this, SLOT(editorBuildStarted(QString, QString)));
+	connect(&mEditorBuilder, SIGNAL(output(QString)), this, SLOT(editorBuildOutput(QString)));
+	connect(&mEditorBuilder, SIGNAL(progress(int, int)), this, SLOT(editorBuildProgress(int, int)));
+	connect(&mEditorBuilder, SIGNAL(built(QString, QString)), this, SLOT(editorBuilt(QString, QString)));
+	connect(&mEditorBuilder, SIGNAL(failed(QString, QString)), this, SLOT(editorBuildFailed(QString, QString)));
+	connect(&mEditorBuilder, SIGNAL(finished()), this, SLOT(editorBuildFinished()));
+	connect(&mBackgroundGenerator, SIGNAL(finished(QString, QString)), this, SLOT(generationFinished(QString, QString)));
+
+	// Edits go to the journal of the save as they are made, the save itself is rewritten
+	// in background. Changes made before a crash are restored when the save is opened again.
+	if (interactive && settings.value("Autosave", true).toBool()) {
+		mModels->repoControlApi().setAutosaveEnabled(true);
+		connect(&mAutosaveTimer, SIGNAL(timeout()), this, SLOT(autosave()));
+		mAutosaveTimer.start(settings.value("AutosaveInterval", 60).toInt() * 1000);
+	}
+	if (mModels->repoControlApi().wasRecovered())
+		statusBar()->showMessage(tr("Unsaved changes were restored after the crash"));
+
 	mDelegate.init(this, &mModels->logicalModelAssistApi());
 
 	// Step 7: Save consistency checked, interface is initialized with models.
@@ -234,7 +327,8 @@ MainWindow::MainWindow()
 	if (mModels->graphicalModel()->rowCount() > 0)
 		openNewTab(mModels->graphicalModel()->index(0, 0, QModelIndex()));
 
-	if (settings.value("diagramCreateSuggestion", true).toBool())
+	mInitialized = true;
+	if (interactive && settings.value("diagramCreateSuggestion", true).toBool())
 		suggestToCreateDiagram();
 }
 
@@ -256,7 +350,9 @@ void MainWindow::keyPressEvent(QKeyEvent *keyEvent)
 
 MainWindow::~MainWindow()
 {
-	saveAll();
+	// Export only reads the save, which may be in a source tree
+	if (mInteractive)
+		saveAll();
 //	delete mListenerManager;
 }
 
@@ -265,6 +361,16 @@ EditorManager* MainWindow::manager()
 	return &mEditorManager;
 }
 
+PropertyEditorModel &MainWindow::propertyModel()
+{
+	return mPropertyModel;
+}
+
+models::Models *MainWindow::models() const
+{
+	return mModels;
+}
+
 void MainWindow::finalClose()
 {
 	mCloseEvent->accept();
@@ -474,6 +580,44 @@ void MainWindow::makeSvg()
 	getCurrentTab()->scene()->render(&painter);
 }
 
+int MainWindow::exportDiagrams(QString const &outputDirectory, QStringList const &formats
+		, QStringList const &diagrams, int threads)
+{
+	if (!mInitialized)
+		return 1;
+
+	DiagramExporter exporter(outputDirectory, formats, threads);
+	QAbstractItemModel * const model = mModels->graphicalModel();
+	int exported = 0;
+	for (int i = 0; i < model->rowCount(); ++i) {
+		QModelIndex const index = model->index(i, 0, QModelIndex());
+		QString const name = index.data().toString();
+		if (!diagrams.isEmpty() && !diagrams.contains(name))
+			continue;
+
+		openNewTab(index);
+		EditorViewScene * const scene = static_cast<EditorViewScene *>(getCurrentTab()->scene());
+		scene->setNeedDrawGrid(false);
+		QRectF const bounds = scene->itemsBoundingRect().adjusted(-10, -10, 10, 10);
+
+		QPicture picture;
+		QPainter painter(&picture);
+		scene->render(&painter, QRectF(QPointF(0, 0), bounds.size()), bounds);
+		painter.end();
+
+		exporter.addDiagram(name, picture);
+		closeTab(mUi->tabs->currentIndex());
+		++exported;
+	}
+
+	QStringList const failed = exporter.run();
+	foreach (QString const &file, failed)
+		qDebug() << "cannot write" << file;
+	qDebug() << "exported" << exported << "diagrams to" << outputDirectory;
+
+	return failed.isEmpty() ? 0 : 1;
+}
+
 void MainWindow::settingsPlugins()
 {
 	PluginDialog dialog(mEditorManager , this);
@@ -529,6 +673,8 @@ void MainWindow::deleteFromScene(QGraphicsItem *target)
 
 void MainWindow::deleteFromDiagram()
 {
+	// Removal from one model is propagated to the other, it shall be undone at once.
+	qrRepo::RepoCommand command(mModels->mutableLogicalRepoApi(), tr("Delete"));
 	bool isLogicalModel = false;
 	if (mModels->graphicalModel()) {
 		if (mUi->graphicalModelExplorer->hasFocus()) {
@@ -617,38 +763,43 @@ void MainWindow::doCommit()
 
 void MainWindow::exportToXmi()
 {
-	generators::XmiHandler xmi(mModels->logicalRepoApi());
-
 	QString const fileName = QFileDialog::getSaveFileName(this);
 	if (fileName.isEmpty())
 		return;
 
-	QString const errors = xmi.exportToXmi(fileName);
-
-	if (!errors.isEmpty()) {
-		QMessageBox::warning(this, tr("errors"), "Some errors occured. Export may be incorrect. Errors list: \n" + errors);
-	} else {
-		QMessageBox::information(this, tr("finished"), "Export is finished");
-	}
+	mBackgroundGenerator.generate(tr("Export to XMI"), exportToXmiFile, mModels->repoControlApi(), fileName);
+	statusBar()->showMessage(tr("Exporting to XMI..."));
 }
 
 void MainWindow::generateToJava()
 {
-	generators::JavaHandler java(mModels->logicalRepoApi());
-
 	QString const dirName = QFileDialog::getExistingDirectory(this);
 	if (dirName.isEmpty())
 		return;
 
-	QString const errors = java.generateToJava(dirName);
+	mBackgroundGenerator.generate(tr("Generation to Java"), generateJavaCode, mModels->repoControlApi(), dirName);
+	statusBar()->showMessage(tr("Generating Java..."));
+}
 
+void MainWindow::propertyRejected(QString const &message, qReal::Id const &element)
+{
+	mErrorReporter->addError(message, element);
+}
+
+void MainWindow::generationFinished(QString const &name, QString const &errors)
+{
 	if (!errors.isEmpty()) {
-		QMessageBox::warning(this, tr("errors"), "Some errors occured. Export may be incorrect. Errors list: \n" + errors);
+		QMessageBox::warning(this, name, "Some errors occured. Export may be incorrect. Errors list: \n" + errors);
 	} else {
-		QMessageBox::information(this, tr("finished"), "Export is finished");
+		statusBar()->showMessage(tr("%1 is finished").arg(name));
 	}
 }
 
+void MainWindow::autosave()
+{
+	mModels->repoControlApi().checkpoint();
+}
+
 void MainWindow::parseJavaLibraries()
 {
 	generators::JavaHandler java(mModels->logicalRepoApi());
@@ -700,6 +851,8 @@ void MainWindow::generateEditor()
 	foreach (Id const key, metamodelList.keys()) {
 		dir.mkdir(directoryXml.absolutePath() + "/qrxml/" + metamodelList[key]);
 		gui::ErrorReporter& errors = editorGenerator.generateEditor(key, directoryName + "/qrxml/" + metamodelList[key] + "/" + metamodelList[key]);
+		statusBar()->showMessage(tr("Editor %1: %2 of %3 generated files changed").arg(metamodelList[key])
+				.arg(editorGenerator.changedFilesCount()).arg(editorGenerator.generatedFilesCount()));
 
 		if (errors.showErrors(mUi->errorListWidget, mUi->errorDock)) {
 			if (QMessageBox::question(this, tr("loading.."), QString("Do you want to load generated editor %1?").arg(metamodelList[key]),
@@ -714,104 +867,43 @@ void MainWindow::generateEditor()
 
 void MainWindow::generateEditorWithQRMC()
 {
-	qrmc::MetaCompiler metaCompiler("../qrmc", "./save");
-
 	IdList const metamodels = mModels->logicalRepoApi().children(Id::rootId());
 
 	QSettings settings("SPbSU", "QReal");
+	QString const qmake = settings.value("pathToQmake", "").toString();
+	QString const make = settings.value("pathToMake", "").toString();
+	QString const extension = settings.value("pluginExtension", "").toString();
+	QString const prefix = settings.value("prefix", "").toString();
 
-	QProgressBar *progress = new QProgressBar(this);
-	progress->show();
-	int const progressBarWidth = 240;
-	int const progressBarHeight = 20;
-
-	QApplication::processEvents();
-	QRect screenRect = qApp->desktop()->availableGeometry();
-	progress->move(screenRect.width() / 2 - progressBarWidth / 2, screenRect.height() / 2 - progressBarHeight / 2);
-	progress->setFixedWidth(progressBarWidth);
-	progress->setFixedHeight(progressBarHeight);
-	progress->setRange(0, 100);
-
-	int forEditor = 60 / metamodels.size();
+	if (qmake.isEmpty() || make.isEmpty() || extension.isEmpty()) {
+		QMessageBox::warning(this, tr("error"), "please, fill compiler settings");
+		return;
+	}
 
 	foreach (Id const key, metamodels) {
 		QString const objectType = mModels->logicalRepoApi().typeName(key);
 		if (objectType == "MetamodelDiagram") {
 			QString name = mModels->logicalRepoApi().stringProperty(key, "name of the directory");
+			if (name.isEmpty())
+				continue;
 			if (QMessageBox::question(this, tr("loading.."), QString("Do you want to compile and load editor %1?").arg(name),
 									  QMessageBox::Yes, QMessageBox::No) == QMessageBox::No)
 			{
 				continue;
 			}
 
-			progress->setValue(5);
-
-			if (!metaCompiler.compile(name)) { // generating source code for all metamodels
-				QMessageBox::warning(this, "error", "cannot generate source code for editor " + name);
-				qDebug() << "compilation failed";
-				continue;
-			}
-			progress->setValue(20);
-
-			QProcess builder;
-			builder.setWorkingDirectory("../qrmc/plugins");
-			builder.start(settings.value("pathToQmake", "").toString());
-			qDebug()  << "qmake";
-			if ((builder.waitForFinished()) && (builder.exitCode() == 0)) {
-				progress->setValue(40);
-
-				builder.start(settings.value("pathToMake", "").toString());
-
-				bool finished = builder.waitForFinished(100000);
-				qDebug()  << "make";
-				if (finished && (builder.exitCode() == 0)) {
-					qDebug()  << "make ok";
-
-					progress->setValue(progress->value() + forEditor/2);
-
-					QString normalizedName = name.at(0).toUpper() + name.mid(1);
-					if (!name.isEmpty()) {
-						if (mEditorManager.editors().contains(Id(normalizedName))) {
-							foreach (Id const diagram, mEditorManager.diagrams(Id(normalizedName)))
-								mUi->paletteToolbox->deleteDiagramType(diagram);
-
-							if (!mEditorManager.unloadPlugin(normalizedName)) {
-								QMessageBox::warning(this, "error", "cannot unload plugin " + normalizedName);
-								progress->close();
-								delete progress;
-								continue;
-							}
-						}
-						if (mEditorManager.loadPlugin(settings.value("prefix", "").toString() + name + "." + settings.value("pluginExtension", "").toString())) {
-							foreach (Id const diagram, mEditorManager.diagrams(Id(normalizedName))) {
-								mUi->paletteToolbox->addDiagramType(diagram, mEditorManager.friendlyName(diagram));
-
-								foreach (Id const element, mEditorManager.elements(diagram))
-									mUi->paletteToolbox->addItemType(element, mEditorManager.friendlyName(element), mEditorManager.description(element), mEditorManager.icon(element));
-							}
-						}
-					}
-					progress->setValue(progress->value() + forEditor/2);
-				}
-			}
-			mUi->paletteToolbox->initDone();
-			progress->setValue(100);
-
+			// All editors are built in ../qrmc/plugins, so sources are generated in turn with the builds
+			QString const normalizedName = name.at(0).toUpper() + name.mid(1);
+			mEditorBuilder.build(normalizedName, "../qrmc/plugins", qmake, make, prefix + name + "." + extension
+					, new QrmcPreparation(name));
 		}
 	}
-	if (progress->value() != 100)
-		QMessageBox::warning(this, tr("error"), "cannot load new editor");
-	progress->setValue(100);
-	progress->close();
-	delete progress;
+	showEditorBuildProgress();
 }
 
 void MainWindow::loadNewEditor(const QString &directoryName, const QString &metamodelName,
 		const QString &commandFirst, const QString &commandSecond, const QString &extension, const QString &prefix)
 {
-	int const progressBarWidth = 240;
-	int const progressBarHeight = 20;
-
 	if ((commandFirst == "") || (commandSecond == "") || (extension == "")) {
 		QMessageBox::warning(this, tr("error"), "please, fill compiler settings");
 		return;
@@ -819,56 +911,100 @@ void MainWindow::loadNewEditor(const QString &directoryName, const QString &meta
 
 	QString normalizeDirName = metamodelName.at(0).toUpper() + metamodelName.mid(1);
 
-	QProgressBar *progress = new QProgressBar(this);
-	progress->show();
+	// Old version of the editor is unloaded when its build starts, see editorBuildStarted().
+	mEditorBuilder.build(normalizeDirName, directoryName + "/" + metamodelName, commandFirst, commandSecond
+			, prefix + metamodelName + "." + extension);
+	showEditorBuildProgress();
+}
 
-	QApplication::processEvents();
+void MainWindow::showEditorBuildProgress()
+{
+	if (!mEditorBuilder.isRunning())
+		return;
 
-	QRect screenRect = qApp->desktop()->availableGeometry();
-	progress->move(screenRect.width() / 2 - progressBarWidth / 2, screenRect.height() / 2 - progressBarHeight / 2);
-	progress->setFixedWidth(progressBarWidth);
-	progress->setFixedHeight(progressBarHeight);
-	progress->setRange(0, 100);
-	progress->setValue(5);
+	mEditorBuildProgress->show();
+	mCancelEditorBuildButton->show();
+}
 
-	if (mEditorManager.editors().contains(Id(normalizeDirName))) {
-		foreach (Id const diagram, mEditorManager.diagrams(Id(normalizeDirName)))
-			mUi->paletteToolbox->deleteDiagramType(diagram);
+void MainWindow::editorBuildProgress(int step, int steps)
+{
+	mEditorBuildProgress->setRange(0, qMax(steps, 1));
+	mEditorBuildProgress->setValue(step);
+}
 
-		if (!mEditorManager.unloadPlugin(normalizeDirName)) {
-			QMessageBox::warning(this, "error", "cannot unload plugin");
-			progress->close();
-			delete progress;
-			return;
-		}
+void MainWindow::editorBuildOutput(QString const &line)
+{
+	mUi->errorListWidget->addItem(line);
+	mUi->errorListWidget->scrollToBottom();
+	mUi->errorDock->setVisible(true);
+}
+
+void MainWindow::editorBuildStarted(QString const &editorName, QString const &pluginFileName)
+{
+	// A loaded plugin keeps its file locked on some platforms, so make could not replace it
+	Id const editor(editorName);
+	if (!mEditorManager.editors().contains(editor))
+		return;
+
+	foreach (Id const diagram, mEditorManager.diagrams(editor))
+		mUi->paletteToolbox->deleteDiagramType(diagram);
+
+	if (!mEditorManager.unloadPlugin(editorName))
+		mErrorReporter->addError("cannot unload plugin " + editorName);
+	mPropertyModel.dropLayouts();
+	mUnloadedEditors.insert(editorName, pluginFileName);
+}
+
+void MainWindow::editorBuilt(QString const &editorName, QString const &pluginFileName)
+{
+	mUnloadedEditors.remove(editorName);
+
+	bool const loaded = loadEditor(editorName, pluginFileName);
+	// Layouts are built from the schemas of the new plugin, or without them if it failed to load
+	mPropertyModel.dropLayouts();
+	if (!loaded) {
+		mErrorReporter->addError("cannot load new editor " + editorName);
+		return;
 	}
-	progress->setValue(20);
+	mErrorReporter->addInformation("Editor " + editorName + " is built and loaded");
+}
 
-	QProcess builder;
-	builder.setWorkingDirectory(directoryName + "/" + metamodelName);
-	builder.start(commandFirst);
-	if ((builder.waitForFinished()) && (builder.exitCode() == 0)) {
-		progress->setValue(60);
-		builder.start(commandSecond);
-		if (builder.waitForFinished() && (builder.exitCode() == 0)) {
-			progress->setValue(80);
-			if (mEditorManager.loadPlugin(prefix + metamodelName + "." + extension)) {
-				foreach (Id const diagram, mEditorManager.diagrams(Id(normalizeDirName))) {
-					mUi->paletteToolbox->addDiagramType(diagram, mEditorManager.friendlyName(diagram));
-
-					foreach (Id const element, mEditorManager.elements(diagram))
-						mUi->paletteToolbox->addItemType(element, mEditorManager.friendlyName(element), mEditorManager.description(element), mEditorManager.icon(element));
-				}
-				mUi->paletteToolbox->initDone();
-				progress->setValue(100);
-			}
-		}
+void MainWindow::editorBuildFailed(QString const &editorName, QString const &reason)
+{
+	mErrorReporter->addError("cannot build editor " + editorName + ": " + reason);
+
+	if (!mUnloadedEditors.contains(editorName))
+		return;
+
+	// The old version of the plugin is still there unless make got to linking
+	bool const loaded = loadEditor(editorName, mUnloadedEditors.take(editorName));
+	mPropertyModel.dropLayouts();
+	if (!loaded)
+		mErrorReporter->addError("cannot load previous version of editor " + editorName);
+}
+
+bool MainWindow::loadEditor(QString const &editorName, QString const &pluginFileName)
+{
+	if (!mEditorManager.loadPlugin(pluginFileName))
+		return false;
+
+	foreach (Id const diagram, mEditorManager.diagrams(Id(editorName))) {
+		mUi->paletteToolbox->addDiagramType(diagram, mEditorManager.friendlyName(diagram));
+
+		foreach (Id const element, mEditorManager.elements(diagram))
+			mUi->paletteToolbox->addItemType(element, mEditorManager.friendlyName(element), mEditorManager.description(element), mEditorManager.icon(element));
 	}
-	if (progress->value() != 100)
-		QMessageBox::warning(this, tr("error"), "cannot load new editor");
-	progress->setValue(100);
-	progress->close();
-	delete progress;
+	mUi->paletteToolbox->initDone();
+	return true;
+}
+
+void MainWindow::editorBuildFinished()
+{
+	mEditorBuildProgress->hide();
+	mCancelEditorBuildButton->hide();
+	// Messages of the build are already in the dock, in between the output of the build.
+	// Showing them again would clear the output.
+	mErrorReporter->clearErrors();
 }
 
 void MainWindow::parseEditorXml()
@@ -912,11 +1048,11 @@ void MainWindow::changeMiniMapSource(int index)
 		EditorView *editorView = getCurrentTab();
 		setConnectActionZoomTo(mUi->tabs->currentWidget());
 
+		// Views are bound to the models once in initCurrentTab() and keep their scenes,
+		// so only the minimap has to follow the current tab.
 		if (editorView != NULL && (static_cast<EditorViewScene*>(editorView->scene()))->mainWindow() != NULL)
 		{
 			mUi->minimapView->setScene(editorView->scene());
-			getCurrentTab()->mvIface()->setModel(mModels->graphicalModel());
-			getCurrentTab()->mvIface()->setLogicalModel(mModels->logicalModel());
 			mRootIndex = editorView->mvIface()->rootIndex();
 		}
 	} else
@@ -1101,6 +1237,10 @@ void MainWindow::openNewTab(const QModelIndex &arg)
 	while (index.parent() != QModelIndex())
 		index = index.parent();
 
+	// Diagram is read from repository when it is opened for the first time
+	if (mModels->graphicalModel()->canFetchMore(index))
+		mModels->graphicalModel()->fetchMore(index);
+
 	int tabNumber = -1;
 	for (int i = 0; i < mUi->tabs->count(); i++) {
 		EditorView *tab = (dynamic_cast<EditorView *>(mUi->tabs->widget(i)));
@@ -1147,6 +1287,7 @@ void MainWindow::initCurrentTab(const QModelIndex &rootIndex)
 	connect(mUi->actionAntialiasing, SIGNAL(toggled(bool)), getCurrentTab(), SLOT(toggleAntialiasing(bool)));
 	connect(mUi->actionOpenGL_Renderer, SIGNAL(toggled(bool)), getCurrentTab(), SLOT(toggleOpenGL(bool)));
 
+	getCurrentTab()->mvIface()->setNotificationRouter(mNotificationRouter);
 	getCurrentTab()->mvIface()->setModel(mModels->graphicalModel());
 	getCurrentTab()->mvIface()->setLogicalModel(mModels->logicalModel());
 	getCurrentTab()->mvIface()->setRootIndex(index);
@@ -1269,6 +1410,7 @@ void MainWindow::setSwitchAlignment(bool isChecked)
 
 void MainWindow::showGestures()
 {
+	mGesturesView = getCurrentTab();
 	mGesturesWidget = new GesturesWidget();
 	mUi->tabs->addTab(mGesturesWidget, tr("Gestures Show"));
 	mUi->tabs->setCurrentWidget(mGesturesWidget);
@@ -1281,6 +1423,11 @@ IGesturesPainter * MainWindow::gesturesPainter()
 	return mGesturesWidget;
 }
 
+EditorView *MainWindow::gesturesView() const
+{
+	return mGesturesView;
+}
+
 void MainWindow::suggestToCreateDiagram()
 {
 	if (mModels->logicalModel()->rowCount() > 0)
@@ -3,10 +3,13 @@
 #include <QtGui/QMainWindow>
 #include <QtSql/QSqlDatabase>
 #include <QtCore/QDir>
+#include <QtCore/QPointer>
 #include <QSplashScreen>
 #include <QtGui>
 
 #include "../editorManager/editorManager.h"
+#include "../editorManager/editorBuilder.h"
+#include "../generators/backgroundGenerator.h"
 #include "propertyeditorproxymodel.h"
 #include "propertyeditordelegate.h"
 #include "igesturespainter.h"
@@ -23,6 +26,7 @@ namespace qReal {
 class EditorView;
 class ListenerManager;
 class VisualDebugger;
+class DiagramNotificationRouter;
 
 namespace models {
 class Models;
@@ -33,16 +37,31 @@ class MainWindow : public QMainWindow, public qReal::gui::MainWindowInterpreters
 	Q_OBJECT
 
 public:
-	MainWindow();
+	/// @param interactive If false, the window is not shown and never asks anything, as needed
+	/// for command line export. The save is not written back then.
+	/// @param saveDirectory Save to open instead of the one opened last time.
+	explicit MainWindow(bool interactive = true, QString const &saveDirectory = QString());
 	~MainWindow();
 
 	EditorManager* manager();
+	models::Models *models() const;
+	PropertyEditorModel &propertyModel();
 	EditorView *getCurrentTab();
 	ListenerManager *listenerManager();
 	IGesturesPainter *gesturesPainter();
+	/// Diagram whose gestures are shown by "Gestures Show" tab, NULL if the tab is not open or the
+	/// diagram is closed. Its tab is not current while gestures are shown.
+	EditorView *gesturesView() const;
 	QModelIndex rootIndex() const;
 
 	QAction *actionDeleteFromDiagram() const;
+
+	/// Renders root diagrams of the save to image files without user interaction.
+	/// @param formats List of "svg" and "png".
+	/// @param diagrams Names of diagrams to export, all diagrams if empty.
+	/// @param threads Number of threads used for writing files, 0 for number of cores.
+	/// @returns Process exit code.
+	int exportDiagrams(QString const &outputDirectory, QStringList const &formats, QStringList const &diagrams, int threads);
 	
 	virtual void highlight(Id const &graphicalId, bool exclusive = true);
 	virtual void dehighlight(Id const &graphicalId);
@@ -145,6 +164,17 @@ private slots:
 
 	void on_actionNew_Diagram_triggered();
 
+	void editorBuildStarted(QString const &editorName, QString const &pluginFileName);
+	void editorBuildProgress(int step, int steps);
+	void editorBuildOutput(QString const &line);
+	void editorBuilt(QString const &editorName, QString const &pluginFileName);
+	void editorBuildFailed(QString const &editorName, QString const &reason);
+	void editorBuildFinished();
+
+	void generationFinished(QString const &name, QString const &errors);
+	void propertyRejected(QString const &message, qReal::Id const &element);
+	void autosave();
+
 private:
 	Ui::MainWindowUi *mUi;
 
@@ -155,6 +185,7 @@ private:
 	PropertyEditorModel mPropertyModel;
 	PropertyEditorDelegate mDelegate;
 	GesturesWidget *mGesturesWidget;
+	QPointer<EditorView> mGesturesView;
 
 	QVector<bool> mSaveListChecked;
 	bool mDiagramCreateFlag;
@@ -165,11 +196,28 @@ private:
 	gui::ErrorReporter *mErrorReporter;
 	VisualDebugger *mVisualDebugger;
 	DebuggerConnector *mDebuggerConnector;
+	EditorBuilder mEditorBuilder;
+	QUndoStack mUndoStack;
+	DiagramNotificationRouter *mNotificationRouter;
+	QProgressBar *mEditorBuildProgress;
+	QPushButton *mCancelEditorBuildButton;
+	/// Plugin files of editors unloaded for their builds, reloaded if a build fails
+	QMap<QString, QString> mUnloadedEditors;
+	QTimer mAutosaveTimer;
+	bool const mInteractive;
+	/// False if the save could not be loaded, e.g. plugins it needs are missing.
+	bool mInitialized;
+	/// Declared last to be destroyed first: running generation reads defaults through models.
+	generators::BackgroundGenerator mBackgroundGenerator;
 
 	void createDiagram(const QString &idString);
 	void loadNewEditor(QString const &directoryName, QString const &metamodelName,
 					   QString const &commandFirst, QString const &commandSecond, QString const &extension, QString const &prefix);
 
+	void showEditorBuildProgress();
+	/// Loads a plugin and adds its diagrams to the palette
+	bool loadEditor(QString const &editorName, QString const &pluginFileName);
+
 	void loadPlugins();
 
 	QListWidget* createSaveListWidget();
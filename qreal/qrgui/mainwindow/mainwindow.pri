@@ -3,9 +3,11 @@ HEADERS += mainwindow/mainwindow.h \
 	mainwindow/propertyeditorproxymodel.h \
 	mainwindow/propertyeditordelegate.h \
 	mainwindow/errorReporter.h \
+	mainwindow/diagramExporter.h \
 	mainwindow/openShapeEditorButton.h \
 	mainwindow/shapeEdit/shapeEdit.h \
 	mainwindow/shapeEdit/scene.h \
+	mainwindow/shapeEdit/sceneCommands.h \
 	mainwindow/shapeEdit/arch.h \
 	mainwindow/shapeEdit/line.h \
 	mainwindow/shapeEdit/item.h \
@@ -30,6 +32,7 @@ HEADERS += mainwindow/mainwindow.h \
 	mainwindow/shapeEdit/image.h \
 	mainwindow/error.h \
 	mainwindow/errorlistwidget.h \
+	mainwindow/errorListModel.h \
 	mainwindow/mainWindowInterpretersInterface.h \
 
 SOURCES += mainwindow/mainwindow.cpp \
@@ -37,9 +40,11 @@ SOURCES += mainwindow/mainwindow.cpp \
 	mainwindow/propertyeditorproxymodel.cpp \
 	mainwindow/propertyeditordelegate.cpp \
 	mainwindow/errorReporter.cpp \
+	mainwindow/diagramExporter.cpp \
 	mainwindow/openShapeEditorButton.cpp \
 	mainwindow/shapeEdit/shapeEdit.cpp \
 	mainwindow/shapeEdit/scene.cpp \
+	mainwindow/shapeEdit/sceneCommands.cpp \
 	mainwindow/shapeEdit/arch.cpp \
 	mainwindow/shapeEdit/line.cpp \
 	mainwindow/shapeEdit/item.cpp \
@@ -61,7 +66,8 @@ SOURCES += mainwindow/mainwindow.cpp \
 	mainwindow/shapeEdit/textPicture.cpp \
 	mainwindow/shapeEdit/image.cpp \
 	mainwindow/error.cpp \
-	mainwindow/errorlistwidget.cpp
+	mainwindow/errorlistwidget.cpp \
+	mainwindow/errorListModel.cpp
 FORMS += mainwindow/mainwindow.ui \
 	mainwindow/shapeEdit/shapeEdit.ui \
 	mainwindow/gesturesShow/gestureswidget.ui \
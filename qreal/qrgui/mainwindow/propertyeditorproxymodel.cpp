@@ -15,6 +15,8 @@ PropertyEditorModel::PropertyEditorModel(qReal::EditorManager const &editorManag
 	, mTargetLogicalModel(NULL)
 	, mTargetGraphicalModel(NULL)
 	, mEditorManager(editorManager)
+	, mUpdatesDeferred(false)
+	, mUpdatePending(false)
 {
 }
 
@@ -77,30 +79,35 @@ QVariant PropertyEditorModel::data(QModelIndex const &index, int role) const
 	if (role != Qt::DisplayRole)
 		return QVariant();
 
-	if (index.column() == 0) {
+	if (index.column() == 0)
 		return mFields[index.row()].fieldName;
-	} else if (index.column() == 1) {
-		switch (mFields[index.row()].attributeClass) {
-		case logicalAttribute:
-			return mTargetLogicalObject.data(mFields[index.row()].role);
-		case graphicalAttribute:
-			return mTargetGraphicalObject.data(mFields[index.row()].role);
-		case graphicalIdPseudoattribute:
-			return mTargetGraphicalObject.data(roles::idRole).value<Id>().id();
-		case logicalIdPseudoattribute:
-			return mTargetLogicalObject.data(roles::idRole).value<Id>().id();
-		case metatypePseudoattribute: {
-			Id const id = mTargetLogicalObject.data(roles::idRole).value<Id>();
-			return QVariant(id.editor() + "/" + id.diagram() + "/" + id.element());
-		}
-		case namePseudoattribute:
-			return mTargetLogicalObject.data(Qt::DisplayRole);
-		}
-		return QVariant();
-	} else
+	else if (index.column() == 1)
+		return value(index.row());
+	else
 		return QVariant();
 }
 
+QVariant PropertyEditorModel::value(int row) const
+{
+	switch (mFields[row].attributeClass) {
+	case logicalAttribute:
+		return mTargetLogicalObject.data(mFields[row].role);
+	case graphicalAttribute:
+		return mTargetGraphicalObject.data(mFields[row].role);
+	case graphicalIdPseudoattribute:
+		return mTargetGraphicalObject.data(roles::idRole).value<Id>().id();
+	case logicalIdPseudoattribute:
+		return mTargetLogicalObject.data(roles::idRole).value<Id>().id();
+	case metatypePseudoattribute: {
+		Id const id = mTargetLogicalObject.data(roles::idRole).value<Id>();
+		return QVariant(id.editor() + "/" + id.diagram() + "/" + id.element());
+	}
+	case namePseudoattribute:
+		return mTargetLogicalObject.data(Qt::DisplayRole);
+	}
+	return QVariant();
+}
+
 bool PropertyEditorModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
 	bool modelChanged = true;
@@ -126,8 +133,10 @@ bool PropertyEditorModel::setData(const QModelIndex &index, const QVariant &valu
 	else
 		modelChanged = false;
 
-	if (modelChanged)
-		dataChanged(index, index);
+	if (modelChanged) {
+		mValues[index.row()] = value(index.row());
+		emit dataChanged(index, index);
+	}
 
 	return modelChanged;
 }
@@ -157,9 +166,65 @@ QStringList PropertyEditorModel::enumValues(const QModelIndex &index) const
 //	return QString();
 //}
 
-void PropertyEditorModel::rereadData()
+void PropertyEditorModel::rereadData(QModelIndex const &topLeft, QModelIndex const &bottomRight)
 {
-	reset();
+	if (!isValid())
+		return;
+
+	// Changes of other elements are of no interest.
+	bool affected = false;
+	foreach (QPersistentModelIndex const &target, QList<QPersistentModelIndex>()
+			<< mTargetLogicalObject << mTargetGraphicalObject)
+	{
+		if (target.isValid() && target.parent() == topLeft.parent()
+				&& target.row() >= topLeft.row() && target.row() <= bottomRight.row())
+		{
+			affected = true;
+		}
+	}
+	if (!affected)
+		return;
+
+	if (mUpdatesDeferred)
+		mUpdatePending = true;
+	else
+		updateValues();
+}
+
+void PropertyEditorModel::setUpdatesDeferred(bool deferred)
+{
+	mUpdatesDeferred = deferred;
+	if (!deferred && mUpdatePending) {
+		mUpdatePending = false;
+		if (isValid())
+			updateValues();
+	}
+}
+
+void PropertyEditorModel::dropLayouts()
+{
+	mLayouts.clear();
+	setModelIndexes(mTargetLogicalObject, mTargetGraphicalObject);
+}
+
+void PropertyEditorModel::updateValues()
+{
+	int firstChanged = -1;
+	for (int row = 0; row <= mFields.size(); ++row) {
+		bool changed = false;
+		if (row < mFields.size()) {
+			QVariant const current = value(row);
+			changed = current != mValues[row];
+			if (changed)
+				mValues[row] = current;
+		}
+		if (changed && firstChanged == -1) {
+			firstChanged = row;
+		} else if (!changed && firstChanged != -1) {
+			emit dataChanged(index(firstChanged, 1), index(row - 1, 1));
+			firstChanged = -1;
+		}
+	}
 }
 
 void PropertyEditorModel::setSourceModels(QAbstractItemModel * const sourceLogicalModel
@@ -172,48 +237,76 @@ void PropertyEditorModel::setSourceModels(QAbstractItemModel * const sourceLogic
 
 	if (mTargetLogicalModel)
 		connect(mTargetLogicalModel, SIGNAL(dataChanged(QModelIndex const &, QModelIndex const &)),
-				this, SLOT(rereadData()));
+				this, SLOT(rereadData(QModelIndex const &, QModelIndex const &)));
 
 	if (mTargetGraphicalModel)
 		connect(mTargetGraphicalModel, SIGNAL(dataChanged(QModelIndex const &, QModelIndex const &)),
-				this, SLOT(rereadData()));
+				this, SLOT(rereadData(QModelIndex const &, QModelIndex const &)));
 
+	mLayoutKey.clear();
+	mValues.clear();
 	reset();
 }
 
 void PropertyEditorModel::setModelIndexes(QModelIndex const &logicalModelIndex
 		, QModelIndex const &graphicalModelIndex)
 {
-	mFields.clear();
-
 	mTargetLogicalObject = logicalModelIndex;
 	mTargetGraphicalObject = graphicalModelIndex;
+	mUpdatePending = false;
 
-	if (!isValid())
+	QString const key = isValid() ? layoutKey() : QString();
+	if (!key.isEmpty() && key == mLayoutKey && mLayouts.contains(key)) {
+		// Same rows for another element: only values change.
+		updateValues();
 		return;
+	}
+
+	beginResetModel();
+	mLayoutKey = key;
+	mFields = key.isEmpty() ? QList<Field>() : layout(key);
+	mValues.fill(QVariant(), mFields.size());
+	for (int row = 0; row < mFields.size(); ++row)
+		mValues[row] = value(row);
+	endResetModel();
+}
 
-	mFields << Field(tr("Name"), namePseudoattribute);
+QString PropertyEditorModel::layoutKey() const
+{
+	QString const logicalType = mTargetLogicalObject.isValid()
+			? mTargetLogicalObject.data(roles::idRole).value<Id>().type().toString()
+			: QString();
+	return logicalType + (mTargetGraphicalObject.isValid() ? "+graphical" : "+logical");
+}
 
-	if (logicalModelIndex != QModelIndex()) {
+QList<PropertyEditorModel::Field> const &PropertyEditorModel::layout(QString const &key)
+{
+	if (mLayouts.contains(key))
+		return mLayouts[key];
+
+	QList<Field> fields;
+	fields << Field(tr("Name"), namePseudoattribute);
+
+	if (mTargetLogicalObject.isValid()) {
 		Id const logicalId = mTargetLogicalObject.data(roles::idRole).value<Id>();
-		QStringList const logicalProperties = mEditorManager.getPropertyNames(logicalId.type());
-		int role = roles::customPropertiesBeginRole;
-		foreach (QString property, logicalProperties) {
-			mFields << Field(property, logicalAttribute, role);
-			++role;
+		QSharedPointer<PropertySchema const> const schema = mEditorManager.propertySchema(logicalId.type());
+		// Plugin of the type may be unloaded for a rebuild, layouts are dropped when it is back
+		for (int slot = 0; schema && slot < schema->count(); ++slot) {
+			fields << Field(schema->name(slot), logicalAttribute, roles::customPropertiesBeginRole + slot);
 		}
-		mFields << Field(tr("Logical Id"), logicalIdPseudoattribute);
+		fields << Field(tr("Logical Id"), logicalIdPseudoattribute);
 	}
 
 	// There are no custom attributes for graphical objects, but they shall be
 	// added soon.
-	if (graphicalModelIndex != QModelIndex()) {
-		mFields << Field(tr("Graphical Id"), graphicalIdPseudoattribute);
+	if (mTargetGraphicalObject.isValid()) {
+		fields << Field(tr("Graphical Id"), graphicalIdPseudoattribute);
 	}
 
-	mFields << Field(tr("Metatype"), metatypePseudoattribute);
+	fields << Field(tr("Metatype"), metatypePseudoattribute);
 
-	reset();
+	mLayouts.insert(key, fields);
+	return mLayouts[key];
 }
 
 void PropertyEditorModel::clearModelIndexes()
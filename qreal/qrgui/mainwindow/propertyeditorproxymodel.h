@@ -5,6 +5,8 @@
 
 #include <QAbstractTableModel>
 #include <QtCore/QStringList>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 
 #include "../editorManager/editorManager.h"
 #include "../../qrrepo/logicalRepoApi.h"
@@ -51,8 +53,14 @@ public:
 
 	bool isCurrentIndex(QModelIndex const &index) const;
 
+	/// While deferred (e. g. an element is being dragged), changes of the source models are
+	/// only remembered and shown when updates are enabled again.
+	void setUpdatesDeferred(bool deferred);
+	/// Forgets cached row layouts, needed when metamodels are reloaded.
+	void dropLayouts();
+
 private slots:
-	void rereadData();
+	void rereadData(QModelIndex const &topLeft, QModelIndex const &bottomRight);
 
 private:
 	enum AttributeClassEnum {
@@ -80,12 +88,24 @@ private:
 		}
 	};
 
+	/// Rows of the current indexes; the same list is reused for all elements of a type.
+	QList<Field> const &layout(QString const &key);
+	QString layoutKey() const;
+	QVariant value(int row) const;
+	/// Re-reads values and emits dataChanged() only for rows whose values have changed.
+	void updateValues();
+
 	QAbstractItemModel *mTargetLogicalModel;
 	QAbstractItemModel *mTargetGraphicalModel;
 	QPersistentModelIndex mTargetLogicalObject;
 	QPersistentModelIndex mTargetGraphicalObject;
 
 	QList<Field> mFields;
+	QString mLayoutKey;
+	QHash<QString, QList<Field> > mLayouts;
+	QVector<QVariant> mValues;  // Shown values, to find out which rows have changed.
+	bool mUpdatesDeferred;
+	bool mUpdatePending;
 
 	qReal::EditorManager const &mEditorManager;
 
@@ -139,6 +139,17 @@ void  Curve::calcResizeItem(QGraphicsSceneMouseEvent *event)
 		setCXandCY(x, y);
 }
 
+QList<QPointF> Curve::keyPoints() const
+{
+	return Item::keyPoints() << mC1;
+}
+
+void Curve::setKeyPoints(QList<QPointF> const &points)
+{
+	Item::setKeyPoints(points);
+	setCXandCY(points.at(2).x(), points.at(2).y());
+}
+
 QPair<QDomElement, Item::DomElementTypes> Curve::generateItem(QDomDocument &document, QPoint const &topLeftPicture)
 {
 	QDomElement curve = setPenBrushToDoc(document, "curve");
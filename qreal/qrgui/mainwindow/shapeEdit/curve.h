@@ -22,6 +22,8 @@ public:
 
 	virtual void changeDragState(qreal x, qreal y);
 	virtual void calcResizeItem(QGraphicsSceneMouseEvent *event);
+	virtual QList<QPointF> keyPoints() const;
+	virtual void setKeyPoints(QList<QPointF> const &points);
 
 	virtual QPair<QDomElement, Item::DomElementTypes> generateItem(QDomDocument &document, QPoint const &topLeftPicture);
 
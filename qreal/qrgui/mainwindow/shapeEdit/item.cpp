@@ -341,6 +341,17 @@ void Item::resizeItem(QGraphicsSceneMouseEvent *event)
 		setFlag(QGraphicsItem::ItemIsMovable, true);
 }
 
+QList<QPointF> Item::keyPoints() const
+{
+	return QList<QPointF>() << QPointF(mX1, mY1) << QPointF(mX2, mY2);
+}
+
+void Item::setKeyPoints(QList<QPointF> const &points)
+{
+	setX1andY1(points.at(0).x(), points.at(0).y());
+	setX2andY2(points.at(1).x(), points.at(1).y());
+}
+
 QString Item::setScaleForDoc(int i, QRect const &rect)
 {
 	QString text = "";
@@ -94,6 +94,10 @@ public:
 	virtual void calcResizeItem(QGraphicsSceneMouseEvent *event);
 	virtual void resizeItem(QGraphicsSceneMouseEvent *event);
 
+	//for undo: the points that are changed by dragging the resize fields
+	virtual QList<QPointF> keyPoints() const;
+	virtual void setKeyPoints(QList<QPointF> const &points);
+
 	//for save to xml
 	QString setScaleForDoc(int i, QRect const &rect);
 	QString setSingleScaleForDoc(int i, int x, int y);
@@ -7,7 +7,7 @@
 #include <QtCore/QDir>
 
 Scene::Scene(View *view, QObject * parent)
-	:  QGraphicsScene(parent), mItemType(none), mWaitMove(false), mCount(0), mGraphicsItem(NULL), mSelectedTextPicture(NULL)
+	:  QGraphicsScene(parent), mItemType(none), mWaitMove(false), mCount(0), mGraphicsItem(NULL), mSelectedTextPicture(NULL), mGeometryCommand(NULL)
 {
 	mView = view;
 	setItemIndexMethod(NoIndex);
@@ -271,26 +271,26 @@ void Scene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 	case text:
 		setX1andY1(event);
 		mText = new Text(mX1, mY1, "text", false);
-		addItem(mText);
 		setZValue(mText);
+		addItems(QList<Item *>() << mText);
 		break;
 	case dynamicText :
 		setX1andY1(event);
 		mText = new Text(mX1, mY1, "name", true);
-		addItem(mText);
 		setZValue(mText);
+		addItems(QList<Item *>() << mText);
 		break;
 	case textPicture:
 		setX1andY1(event);
 		mTextPicture = new TextPicture(mX1, mY1, "text");
-		addItem(mTextPicture);
 		setZValue(mTextPicture);
+		addItems(QList<Item *>() << mTextPicture);
 		break;
 	case pointPort :
 		setX1andY1(event);
 		mPointPort = new PointPort(mX1, mY1, NULL);
-		addItem(mPointPort);
 		setZValue(mPointPort);
+		addItems(QList<Item *>() << mPointPort);
 		break;
 	case linePort :
 		setX1andY1(event);
@@ -303,8 +303,8 @@ void Scene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 	case image :
 		setX1andY1(event);
 		mImage = new Image(mFileName, mX1, mY1, NULL);
-		addItem(mImage);
 		setZValue(mImage);
+		addItems(QList<Item *>() << mImage);
 		break;
 	default:  // if we wait some resize
 		setX1andY1(event);
@@ -320,6 +320,7 @@ void Scene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 			}
 		}
 		setZValueSelectedItems();
+		startGeometryChange();
 		break;
 	}
 }
@@ -375,8 +376,8 @@ void Scene::mouseReleaseEvent ( QGraphicsSceneMouseEvent * event )
 			setX2andY2(event);
 			mCurve = new Curve(QPointF(mX1, mY1), QPointF(mX2, mY2), QPointF(mX1, mY1));
 			mCurve->setPenBrush(mPenStyleItems, mPenWidthItems, mPenColorItems, mBrushStyleItems, mBrushColorItems);
-			addItem(mCurve);
 			setZValue(mCurve);
+			addItems(QList<Item *>() << mCurve);
 		} else if (mCount == 3)
 			reshapeCurveSecond(event);
 		else if (mCount == 4) {
@@ -386,21 +387,28 @@ void Scene::mouseReleaseEvent ( QGraphicsSceneMouseEvent * event )
 		break;
 	case stylus :
 		reshapeStylus(event);
+		mStylus->simplify(QSettings("SPbSU", "QReal").value("StylusSimplificationTolerance", 1.0).toDouble());
+		addItems(QList<Item *>() << mStylus);
 		break;
 	case line :
 		reshapeLine(event);
+		addItems(QList<Item *>() << mLine);
 		break;
 	case ellipse :
 		reshapeEllipse(event);
+		addItems(QList<Item *>() << mEllipse);
 		break;
 	case rectangle :
 		reshapeRectangle(event);
+		addItems(QList<Item *>() << mRectangle);
 		break;
 	case linePort :
 		reshapeLinePort(event);
+		addItems(QList<Item *>() << mLinePort);
 		break;
 	default:  // if we wait some resize
 		reshapeItem(event);
+		finishGeometryChange();
 		break;
 	}
 	mWaitMove = false;
@@ -410,6 +418,26 @@ void Scene::mouseReleaseEvent ( QGraphicsSceneMouseEvent * event )
 	mView->setDragMode(QGraphicsView::RubberBandDrag);
 }
 
+void Scene::startGeometryChange()
+{
+	delete mGeometryCommand;
+	QList<Item *> list = selectedSceneItems();
+	if (mGraphicsItem != NULL && !list.contains(mGraphicsItem))
+		list.push_back(mGraphicsItem);
+	mGeometryCommand = new ChangeGeometryCommand(list);
+}
+
+void Scene::finishGeometryChange()
+{
+	if (mGeometryCommand == NULL)
+		return;
+	if (mGeometryCommand->storeNewGeometry())
+		mUndoStack.push(mGeometryCommand);
+	else
+		delete mGeometryCommand;
+	mGeometryCommand = NULL;
+}
+
 void Scene::initListSelectedItemsForPaste()
 {
 	mListSelectedItemsForPaste.clear();
@@ -419,7 +447,11 @@ void Scene::initListSelectedItemsForPaste()
 void Scene::keyPressEvent(QKeyEvent *keyEvent)
 {
 	QGraphicsScene::keyPressEvent(keyEvent);
-	if (keyEvent->matches(QKeySequence::Cut)) {
+	if (keyEvent->matches(QKeySequence::Undo))
+		mUndoStack.undo();
+	else if (keyEvent->matches(QKeySequence::Redo))
+		mUndoStack.redo();
+	else if (keyEvent->matches(QKeySequence::Cut)) {
 		initListSelectedItemsForPaste();
 		mCopyPaste = cut;
 	} else if (keyEvent->matches(QKeySequence::Copy)) {
@@ -431,21 +463,31 @@ void Scene::keyPressEvent(QKeyEvent *keyEvent)
 		posCursor = mView->mapToScene(posCursor.toPoint());
 		QPointF topLeftSelection(selectedItemsBoundingRect().topLeft());
 		switch (mCopyPaste) {
-		case copy:
+		case copy: {
+			QList<Item *> newItems;
 			foreach(Item *item, mListSelectedItemsForPaste) {
 				Item* newItem = item->clone();
 				newItem->setPos(posCursor - topLeftSelection + item->scenePos());
-				addItem(newItem);
 				setZValue(newItem);
+				newItems << newItem;
 			}
+			if (!newItems.isEmpty())
+				addItems(newItems);
 			break;
-		case cut:
+		}
+		case cut: {
+			ChangeGeometryCommand *command = new ChangeGeometryCommand(mListSelectedItemsForPaste);
 			foreach(Item *item, mListSelectedItemsForPaste) {
 				item->setPos(posCursor - topLeftSelection + item->scenePos());
 				setZValue(item);
-				mListSelectedItemsForPaste.clear();
 			}
+			mListSelectedItemsForPaste.clear();
+			if (command->storeNewGeometry())
+				mUndoStack.push(command);
+			else
+				delete command;
 			break;
+		}
 		default:
 			break;
 		}
@@ -535,20 +577,37 @@ void Scene::addImage(QString const &fileName)
 	QFile::copy(fileName, mFileName);
 }
 
+void Scene::addItems(QList<Item *> const &items)
+{
+	mUndoStack.push(new AddItemsCommand(this, items));
+}
+
+QUndoStack *Scene::undoStack()
+{
+	return &mUndoStack;
+}
+
 void Scene::deleteItem()
 {
-	QList<QGraphicsItem *> list = selectedItems();
-	foreach (QGraphicsItem *graphicsItem, list) {
-		removeItem(graphicsItem);
-		delete graphicsItem;
-	}
+	QList<Item *> list = selectedSceneItems();
+	if (list.isEmpty())
+		return;
+	foreach (Item *item, list)
+		mListSelectedItemsForPaste.removeAll(item);
+	mUndoStack.push(new RemoveItemsCommand(this, list));
 }
 
 void Scene::clearScene()
 {
-	clear();
-	mEmptyRect = addRect(0, 0, sizeEmptyRectX, sizeEmptyRectY, QPen(Qt::white));
-	mZValue = 0;
+	QList<Item *> list;
+	foreach (QGraphicsItem *graphicsItem, items()) {
+		Item *item = dynamic_cast<Item *>(graphicsItem);
+		if (item != NULL && item->parentItem() == NULL)
+			list << item;
+	}
+	mListSelectedItemsForPaste.clear();
+	if (!list.isEmpty())
+		mUndoStack.push(new RemoveItemsCommand(this, list));
 }
 
 bool Scene::compareItems(Item* first, Item* second)
@@ -556,6 +615,14 @@ bool Scene::compareItems(Item* first, Item* second)
 	return first->zValue() < second->zValue();
 }
 
+QList<Item *> Scene::itemsOf(QList<TextPicture *> const &list)
+{
+	QList<Item *> resList;
+	foreach (TextPicture *item, list)
+		resList.push_back(item);
+	return resList;
+}
+
 QList<Item *> Scene::selectedSceneItems()
 {
 	QList<Item *> resList;
@@ -584,40 +651,59 @@ QList<TextPicture *> Scene::selectedTextPictureItems()
 void Scene::changePenStyle(const QString &text)
 {
 	mPenStyleItems = text;
-	foreach (Item *item, selectedSceneItems())
+	QList<Item *> const list = selectedSceneItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(list, ChangeStyleCommand::penStyle);
+	foreach (Item *item, list)
 		item->setPenStyle(text);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changePenWidth(int width)
 {
 	mPenWidthItems = width;
-	foreach (Item *item, selectedSceneItems())
+	QList<Item *> const list = selectedSceneItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(list, ChangeStyleCommand::penWidth);
+	foreach (Item *item, list)
 		item->setPenWidth(width);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changePenColor(const QString &text)
 {
 	mPenColorItems = text;
-	foreach (Item *item, selectedSceneItems())
+	QList<Item *> const list = selectedSceneItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(list, ChangeStyleCommand::penColor);
+	foreach (Item *item, list)
 		item->setPenColor(text);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeBrushStyle(const QString &text)
 {
 	mBrushStyleItems = text;
-	foreach (Item *item, selectedSceneItems())
+	QList<Item *> const list = selectedSceneItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(list, ChangeStyleCommand::brushStyle);
+	foreach (Item *item, list)
 		item->setBrushStyle(text);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeBrushColor(const QString &text)
 {
 	mBrushColorItems = text;
-	foreach (Item *item, selectedSceneItems())
+	QList<Item *> const list = selectedSceneItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(list, ChangeStyleCommand::brushColor);
+	foreach (Item *item, list)
 		item->setBrushColor(text);
+	pushStyleCommand(command);
+}
+
+void Scene::pushStyleCommand(ChangeStyleCommand *command)
+{
+	if (command->storeNewStyle())
+		mUndoStack.push(command);
+	else
+		delete command;
 	update();
 }
 
@@ -705,44 +791,56 @@ void Scene::changeFontPalette()
 
 void Scene::changeFontFamily(const QFont& font)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontFamily(font);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeFontPixelSize(int size)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontPixelSize(size);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeFontColor(const QString & text)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontColor(text);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeFontItalic(bool isChecked)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontItalic(isChecked);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeFontBold(bool isChecked)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontBold(isChecked);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeFontUnderline(bool isChecked)
 {
-	foreach (TextPicture *item, selectedTextPictureItems())
+	QList<TextPicture *> const list = selectedTextPictureItems();
+	ChangeStyleCommand *command = new ChangeStyleCommand(itemsOf(list), ChangeStyleCommand::font);
+	foreach (TextPicture *item, list)
 		item->setFontUnderline(isChecked);
-	update();
+	pushStyleCommand(command);
 }
 
 void Scene::changeTextName(const QString &name)
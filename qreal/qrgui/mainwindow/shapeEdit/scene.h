@@ -4,6 +4,7 @@
 #include <QtGui/QGraphicsItem>
 #include <QtGui/QGraphicsSceneMouseEvent>
 #include <QtGui/QGraphicsView>
+#include <QtGui/QUndoStack>
 #include <QtCore/QList>
 
 #include "view.h"
@@ -20,6 +21,7 @@
 #include "path.h"
 #include "curve.h"
 #include "image.h"
+#include "sceneCommands.h"
 #include "../umllib/elementTitle.h"
 
 using namespace UML;
@@ -38,6 +40,9 @@ public:
 	void changeTextName(const QString &name);
 	void setZValue(Item* item);
 	void addImage(QString const &fileName);
+	/// Adds items as one undoable step
+	void addItems(QList<Item *> const &items);
+	QUndoStack *undoStack();
 
 signals:
 	void noSelectedItems();
@@ -125,6 +130,8 @@ private:
 	QList<TextPicture *> mListSelectedTextPictureItems;
 	TextPicture *mSelectedTextPicture;
 	QPair<bool, Item *> mNeedResize;
+	QUndoStack mUndoStack;
+	ChangeGeometryCommand *mGeometryCommand;  // the drag that is in progress
 
 	QString mPenStyleItems;
 	int mPenWidthItems;
@@ -133,6 +140,7 @@ private:
 	QString mBrushColorItems;
 
 	static bool compareItems(Item* first, Item* second);
+	static QList<Item *> itemsOf(QList<TextPicture *> const &list);
 
 	void initListSelectedItemsForPaste();
 	QRectF selectedItemsBoundingRect() const;
@@ -142,6 +150,7 @@ private:
 	QString convertBrushToString(QBrush const &brush);
 	void setPenBrushItems(QPen const &pen, QBrush const &brush);
 	void setEmptyPenBrushItems();
+	void pushStyleCommand(ChangeStyleCommand *command);
 	void setX1andY1(QGraphicsSceneMouseEvent *event);
 	void setX2andY2(QGraphicsSceneMouseEvent *event);
 	QPointF setCXandCY(QGraphicsSceneMouseEvent *event);
@@ -158,6 +167,9 @@ private:
 	void removeMoveFlag(QGraphicsSceneMouseEvent *event, QGraphicsItem* item);
 	void setMoveFlag(QGraphicsSceneMouseEvent *event);
 	void setZValueSelectedItems();
+	// a drag of the selected items is recorded as one command
+	void startGeometryChange();
+	void finishGeometryChange();
 	void setNullZValueItems();
 	QPair<bool, Item *> checkOnResize(qreal x, qreal y);
 
@@ -0,0 +1,167 @@
+#include "sceneCommands.h"
+#include "scene.h"
+
+AddItemsCommand::AddItemsCommand(Scene *scene, QList<Item *> const &items, QUndoCommand *parent)
+	: QUndoCommand(QObject::tr("Add"), parent), mScene(scene), mItems(items), mDone(false)
+{
+}
+
+AddItemsCommand::~AddItemsCommand()
+{
+	if (!mDone)
+		qDeleteAll(mItems);
+}
+
+void AddItemsCommand::redo()
+{
+	foreach (Item *item, mItems) {
+		if (item->scene() != mScene)
+			mScene->addItem(item);
+	}
+	mDone = true;
+}
+
+void AddItemsCommand::undo()
+{
+	foreach (Item *item, mItems)
+		mScene->removeItem(item);
+	mDone = false;
+}
+
+RemoveItemsCommand::RemoveItemsCommand(Scene *scene, QList<Item *> const &items, QUndoCommand *parent)
+	: QUndoCommand(QObject::tr("Remove"), parent), mScene(scene), mItems(items), mDone(false)
+{
+}
+
+RemoveItemsCommand::~RemoveItemsCommand()
+{
+	if (mDone)
+		qDeleteAll(mItems);
+}
+
+void RemoveItemsCommand::redo()
+{
+	foreach (Item *item, mItems)
+		mScene->removeItem(item);
+	mDone = true;
+}
+
+void RemoveItemsCommand::undo()
+{
+	foreach (Item *item, mItems)
+		mScene->addItem(item);
+	mDone = false;
+}
+
+ChangeGeometryCommand::ChangeGeometryCommand(QList<Item *> const &items, QUndoCommand *parent)
+	: QUndoCommand(QObject::tr("Move"), parent), mItems(items)
+{
+	foreach (Item *item, mItems)
+		mOldGeometries << geometry(item);
+}
+
+bool ChangeGeometryCommand::Geometry::operator==(Geometry const &other) const
+{
+	return pos == other.pos && keyPoints == other.keyPoints;
+}
+
+ChangeGeometryCommand::Geometry ChangeGeometryCommand::geometry(Item *item)
+{
+	Geometry result;
+	result.pos = item->pos();
+	result.keyPoints = item->keyPoints();
+	return result;
+}
+
+bool ChangeGeometryCommand::storeNewGeometry()
+{
+	mNewGeometries.clear();
+	foreach (Item *item, mItems)
+		mNewGeometries << geometry(item);
+	return mNewGeometries != mOldGeometries;
+}
+
+void ChangeGeometryCommand::setGeometry(QList<Geometry> const &geometries)
+{
+	for (int i = 0; i < mItems.size(); ++i) {
+		mItems[i]->setPos(geometries[i].pos);
+		mItems[i]->setKeyPoints(geometries[i].keyPoints);
+	}
+}
+
+void ChangeGeometryCommand::redo()
+{
+	setGeometry(mNewGeometries);
+}
+
+void ChangeGeometryCommand::undo()
+{
+	setGeometry(mOldGeometries);
+}
+
+ChangeStyleCommand::ChangeStyleCommand(QList<Item *> const &items, Property property, QUndoCommand *parent)
+	: QUndoCommand(QObject::tr("Change style"), parent), mItems(items), mProperty(property)
+{
+	foreach (Item *item, mItems)
+		mOldStyles << style(item);
+}
+
+bool ChangeStyleCommand::Style::operator==(Style const &other) const
+{
+	return pen == other.pen && brush == other.brush && font == other.font;
+}
+
+ChangeStyleCommand::Style ChangeStyleCommand::style(Item *item)
+{
+	Style result;
+	result.pen = item->pen();
+	result.brush = item->brush();
+	TextPicture *textPicture = dynamic_cast<TextPicture *>(item);
+	if (textPicture != NULL)
+		result.font = textPicture->font();
+	return result;
+}
+
+bool ChangeStyleCommand::storeNewStyle()
+{
+	mNewStyles.clear();
+	foreach (Item *item, mItems)
+		mNewStyles << style(item);
+	return mNewStyles != mOldStyles;
+}
+
+void ChangeStyleCommand::setStyle(QList<Style> const &styles)
+{
+	for (int i = 0; i < mItems.size(); ++i) {
+		mItems[i]->setPen(styles[i].pen);
+		mItems[i]->setBrush(styles[i].brush);
+		TextPicture *textPicture = dynamic_cast<TextPicture *>(mItems[i]);
+		if (textPicture != NULL)
+			textPicture->setFont(styles[i].font);
+		mItems[i]->update();
+	}
+}
+
+void ChangeStyleCommand::redo()
+{
+	setStyle(mNewStyles);
+}
+
+void ChangeStyleCommand::undo()
+{
+	setStyle(mOldStyles);
+}
+
+int ChangeStyleCommand::id() const
+{
+	return mProperty;
+}
+
+bool ChangeStyleCommand::mergeWith(QUndoCommand const *other)
+{
+	ChangeStyleCommand const *command = static_cast<ChangeStyleCommand const *>(other);
+	if (command->mItems != mItems)
+		return false;
+	mNewStyles = command->mNewStyles;
+	return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QtGui/QUndoCommand>
+#include <QtGui/QPen>
+#include <QtGui/QBrush>
+#include <QtGui/QFont>
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+
+class Scene;
+class Item;
+
+/// Items that are not in the scene are owned by the command that took them out of it
+class AddItemsCommand : public QUndoCommand
+{
+public:
+	/// Items may already be in the scene, e.g. the ones that are drawn by mouse
+	AddItemsCommand(Scene *scene, QList<Item *> const &items, QUndoCommand *parent = 0);
+	virtual ~AddItemsCommand();
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	Scene *mScene;
+	QList<Item *> mItems;
+	bool mDone;
+};
+
+class RemoveItemsCommand : public QUndoCommand
+{
+public:
+	RemoveItemsCommand(Scene *scene, QList<Item *> const &items, QUndoCommand *parent = 0);
+	virtual ~RemoveItemsCommand();
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	Scene *mScene;
+	QList<Item *> mItems;
+	bool mDone;
+};
+
+/// Positions and key points of items, taken before and after a drag, so that
+/// a whole drag is undone at once
+class ChangeGeometryCommand : public QUndoCommand
+{
+public:
+	ChangeGeometryCommand(QList<Item *> const &items, QUndoCommand *parent = 0);
+
+	/// Returns false if the items were not moved or reshaped since the command was created
+	bool storeNewGeometry();
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	struct Geometry
+	{
+		QPointF pos;
+		QList<QPointF> keyPoints;
+
+		bool operator==(Geometry const &other) const;
+	};
+
+	static Geometry geometry(Item *item);
+	void setGeometry(QList<Geometry> const &geometries);
+
+	QList<Item *> mItems;
+	QList<Geometry> mOldGeometries;
+	QList<Geometry> mNewGeometries;
+};
+
+/// Pen, brush and font of items. Successive changes of the same property of the same items,
+/// e.g. by a spin box, are merged into one command
+class ChangeStyleCommand : public QUndoCommand
+{
+public:
+	enum Property {
+		penStyle,
+		penWidth,
+		penColor,
+		brushStyle,
+		brushColor,
+		font
+	};
+
+	ChangeStyleCommand(QList<Item *> const &items, Property property, QUndoCommand *parent = 0);
+
+	/// Returns false if the style of the items was not changed since the command was created
+	bool storeNewStyle();
+
+	virtual void redo();
+	virtual void undo();
+	virtual int id() const;
+	virtual bool mergeWith(QUndoCommand const *other);
+
+private:
+	struct Style
+	{
+		QPen pen;
+		QBrush brush;
+		QFont font;
+
+		bool operator==(Style const &other) const;
+	};
+
+	static Style style(Item *item);
+	void setStyle(QList<Style> const &styles);
+
+	QList<Item *> mItems;
+	Property mProperty;
+	QList<Style> mOldStyles;
+	QList<Style> mNewStyles;
+};
@@ -265,6 +265,8 @@ void ShapeEdit::load(const QString &text)
 		return;
 	XmlLoader loader(mScene);
 	loader.readString(text);
+	// the shape the editor is opened with can't be undone
+	mScene->undoStack()->clear();
 }
 
 void ShapeEdit::addImage(bool checked)
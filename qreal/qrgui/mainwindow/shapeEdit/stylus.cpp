@@ -1,14 +1,51 @@
 #include "stylus.h"
 
+#include <QtCore/QPair>
+#include <QtCore/QTextStream>
+#include <QtGui/QPainterPathStroker>
+
+namespace {
+
+/// Distance from the point to the segment, not to the whole line through it.
+qreal distanceToSegment(QPointF const &point, QPointF const &start, QPointF const &end)
+{
+	QPointF const segment = end - start;
+	qreal const lengthSquared = segment.x() * segment.x() + segment.y() * segment.y();
+	if (lengthSquared == 0)
+		return Item::length(point, start);
+	qreal const t = qBound(qreal(0), ((point.x() - start.x()) * segment.x()
+			+ (point.y() - start.y()) * segment.y()) / lengthSquared, qreal(1));
+	return Item::length(point, start + t * segment);
+}
+
+}
+
 Stylus::Stylus(qreal x1, qreal y1, Item* parent):Item(parent)
 {
 	mNeedScalingRect = false;
 	mPen.setColor(Qt::black);
 	mX1 = x1;
 	mY1 = y1;
-	mTmpX1 = x1;
-	mTmpY1 = y1;
+	mX2 = x1;
+	mY2 = y1;
+	mDomElementType = pictureType;
+	mPoints.append(QPointF(x1, y1));
+	updatePath();
+}
+
+Stylus::Stylus(QVector<QPointF> const &points, Item* parent):Item(parent)
+{
+	mNeedScalingRect = false;
+	mPen.setColor(Qt::black);
 	mDomElementType = pictureType;
+	mPoints = points;
+	if (!mPoints.isEmpty()) {
+		mX1 = mPoints.first().x();
+		mY1 = mPoints.first().y();
+		mX2 = mPoints.last().x();
+		mY2 = mPoints.last().y();
+	}
+	updatePath();
 }
 
 Stylus::Stylus(Stylus const &other)
@@ -22,13 +59,11 @@ Stylus::Stylus(Stylus const &other)
 	mX2 = other.mX2;
 	mY1 = other.mY1;
 	mY2 = other.mY2;
-	mTmpX1 = other.mTmpX1;
-	mTmpY1 = other.mTmpY1;
 	mListScalePoint = other.mListScalePoint;
-	foreach (Line *line, other.mListLine) {
-		Line *newLine = new Line(*line);
-		mListLine.append(newLine);
-	}
+	mPoints = other.mPoints;
+	mBoundingRect = other.mBoundingRect;
+	mPath = other.mPath;
+	mShape = other.mShape;
 	setPos(other.x(), other.y());
 }
 
@@ -40,57 +75,115 @@ Item* Stylus::clone()
 
 void Stylus::addLine(qreal x2, qreal y2)
 {
+	QPointF const point(x2, y2);
+	if (!mPoints.isEmpty() && mPoints.last() == point)
+		return;
+
+	prepareGeometryChange();
 	mX2 = x2;
 	mY2 = y2;
-	Line *line = new Line(mTmpX1, mTmpY1, mX2, mY2, NULL);
-	line->setPen(mPen);
-	line->setBrush(mBrush);
-	mListLine.push_back(line);
-	mTmpX1 = mX2;
-	mTmpY1 = mY2;
-}
-
-QRectF Stylus::searchMaxMinCoord() const
-{
-	if(!mListLine.isEmpty()) {
-		qreal maxX = (mListLine.at(0))->realBoundingRect().right();
-		qreal minX = (mListLine.at(0))->realBoundingRect().left();
-		qreal maxY = (mListLine.at(0))->realBoundingRect().bottom();
-		qreal minY = (mListLine.at(0))->realBoundingRect().top();
-		foreach (Line *line, mListLine) {
-			minX = qMin(line->realBoundingRect().left(), minX);
-			minY = qMin(line->realBoundingRect().top(), minY);
-			maxX = qMax(line->realBoundingRect().right(), maxX);
-			maxY = qMax(line->realBoundingRect().bottom(), maxY);
+	if (mPoints.isEmpty()) {
+		mPath.moveTo(point);
+		mBoundingRect = QRectF(point, QSizeF(0, 0));
+	} else {
+		mPath.lineTo(point);
+		mBoundingRect.setLeft(qMin(mBoundingRect.left(), x2));
+		mBoundingRect.setRight(qMax(mBoundingRect.right(), x2));
+		mBoundingRect.setTop(qMin(mBoundingRect.top(), y2));
+		mBoundingRect.setBottom(qMax(mBoundingRect.bottom(), y2));
+	}
+	mPoints.append(point);
+	mShape = QPainterPath();
+}
+
+void Stylus::simplify(qreal tolerance)
+{
+	int const count = mPoints.size();
+	if (tolerance <= 0 || count < 3)
+		return;
+
+	QVector<bool> kept(count, false);
+	kept[0] = true;
+	kept[count - 1] = true;
+
+	// Explicit stack instead of recursion: a long stroke may have thousands of points.
+	QVector<QPair<int, int> > ranges;
+	ranges.append(qMakePair(0, count - 1));
+	while (!ranges.isEmpty()) {
+		QPair<int, int> const range = ranges.last();
+		ranges.pop_back();
+
+		qreal maxDistance = 0;
+		int farthest = -1;
+		for (int i = range.first + 1; i < range.second; ++i) {
+			qreal const distance = distanceToSegment(mPoints.at(i), mPoints.at(range.first), mPoints.at(range.second));
+			if (distance > maxDistance) {
+				maxDistance = distance;
+				farthest = i;
+			}
+		}
+
+		if (farthest != -1 && maxDistance > tolerance) {
+			kept[farthest] = true;
+			ranges.append(qMakePair(range.first, farthest));
+			ranges.append(qMakePair(farthest, range.second));
 		}
-		return QRectF(minX, minY, maxX - minX, maxY - minY);
 	}
-	else
-		return QRectF(0, 0, 0, 0);
+
+	QVector<QPointF> points;
+	for (int i = 0; i < count; ++i) {
+		if (kept.at(i))
+			points.append(mPoints.at(i));
+	}
+	if (points.size() == count)
+		return;
+
+	prepareGeometryChange();
+	mPoints = points;
+	updatePath();
+}
+
+QVector<QPointF> const &Stylus::points() const
+{
+	return mPoints;
+}
+
+void Stylus::updatePath()
+{
+	mPath = QPainterPath();
+	mShape = QPainterPath();
+	if (mPoints.isEmpty()) {
+		mBoundingRect = QRectF(0, 0, 0, 0);
+		return;
+	}
+
+	mPath.moveTo(mPoints.first());
+	for (int i = 1; i < mPoints.size(); ++i)
+		mPath.lineTo(mPoints.at(i));
+	mBoundingRect = mPath.boundingRect();
 }
 
 QPainterPath Stylus::shape() const
 {
-	QPainterPath path;
-	path.setFillRule(Qt::WindingFill);
-	foreach (Line *line, mListLine) {
-		path.addPath(line->shape());
+	if (mShape.isEmpty() && mPoints.size() > 1) {
+		QPainterPathStroker ps;
+		ps.setWidth(drift);
+		mShape = ps.createStroke(mPath);
+		mShape.setFillRule(Qt::WindingFill);
 	}
-	return path;
+	return mShape;
 }
 
 QRectF Stylus::boundingRect() const
 {
-	return searchMaxMinCoord();
+	return mBoundingRect;
 }
 
 void Stylus::drawItem(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
-	foreach (Line *line, mListLine) {
-		painter->setPen(line->pen());
-		painter->setBrush(line->brush());
-		line->drawItem(painter, option, widget);
-	}
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+	painter->drawPolyline(mPoints.constData(), mPoints.size());
 }
 
 void Stylus::drawExtractionForItem(QPainter* painter)
@@ -116,47 +209,27 @@ void Stylus::drawScalingRects(QPainter* painter)
 	Q_UNUSED(painter);
 }
 
-void Stylus::setPenStyle(const QString& text)
-{
-	Item::setPenStyle(text);
-	foreach (Line *line, mListLine)
-		line->setPenStyle(text);
-}
-
-void Stylus::setPenWidth(int width)
-{
-	Item::setPenWidth(width);
-	foreach (Line *line, mListLine)
-		line->setPenWidth(width);
-}
-
-void Stylus::setPenColor(const QString& text)
-{
-	Item::setPenColor(text);
-	foreach (Line *line, mListLine)
-		line->setPenColor(text);
-}
-
-void Stylus::setBrushStyle(const QString& text)
-{
-	Item::setBrushStyle(text);
-	foreach (Line *line, mListLine)
-		line->setBrushStyle(text);
-}
-
-void Stylus::setBrushColor(const QString& text)
-{
-	Item::setBrushColor(text);
-	foreach (Line *line, mListLine)
-		line->setBrushColor(text);
-}
-
 QPair<QDomElement, Item::DomElementTypes> Stylus::generateItem(QDomDocument &document, QPoint const &topLeftPicture)
 {
 	QDomElement stylus = document.createElement("stylus");
-	foreach (Line *line, mListLine) {
-		QDomElement item = (line->generateItem(document, topLeftPicture - QPoint(static_cast<int>(scenePos().x()), static_cast<int>(scenePos().y())))).first;
-		stylus.appendChild(item);
+	QDomElement path = setPenBrushToDoc(document, "path");
+
+	// Coordinates are whole pixels, as they were when every segment was saved as a line,
+	// so points that round to the previous one are dropped.
+	QPointF const shift = scenePos() - topLeftPicture;
+	QString text;
+	QTextStream out(&text);
+	QPoint previous;
+	for (int i = 0; i < mPoints.size(); ++i) {
+		QPoint const point = (mPoints.at(i) + shift).toPoint();
+		if (i > 0 && point == previous)
+			continue;
+		out << (i == 0 ? " M " : " L ") << point.x() << " " << point.y();
+		previous = point;
 	}
+	out.flush();
+	path.setAttribute("d", text);
+	stylus.appendChild(path);
+
 	return QPair<QDomElement, Item::DomElementTypes>(stylus, mDomElementType);
 }
@@ -1,21 +1,20 @@
 #pragma once
 #include "item.h"
-#include "line.h"
-#include <QtCore/QList>
+#include <QtCore/QVector>
 
+/// Freehand stroke: one polyline with cached bounds and painter path, so painting and
+/// hit-testing cost does not grow with the number of mouse moves it was drawn with.
 class Stylus : public Item
 {
-private:
-	qreal mTmpX1;
-	qreal mTmpY1;
-	QRectF searchMaxMinCoord() const;
-
 public:
-	QList<Line *> mListLine;
 	Stylus(qreal x1, qreal y1, Item* parent);
+	Stylus(QVector<QPointF> const &points, Item* parent);
 	Stylus(Stylus const &other);
 	virtual Item* clone();
 	void addLine(qreal x2, qreal y2);
+	/// Ramer-Douglas-Peucker: removes points that are closer than tolerance to the stroke without them.
+	void simplify(qreal tolerance);
+	QVector<QPointF> const &points() const;
 
 	virtual QRectF boundingRect() const;
 	QPainterPath shape() const;
@@ -23,10 +22,13 @@ public:
 	virtual void drawExtractionForItem(QPainter* painter);
 	virtual void drawFieldForResizeItem(QPainter* painter);
 	virtual void drawScalingRects(QPainter* painter);
-	virtual void setPenStyle(const QString& text);
-	virtual void setPenWidth(int width);
-	virtual void setPenColor(const QString& text);
-	virtual void setBrushStyle(const QString& text);
-	virtual void setBrushColor(const QString& text);
+	/// Saved as a single path of "M x y L x y ..." inside a stylus element.
 	virtual QPair<QDomElement, Item::DomElementTypes> generateItem(QDomDocument &document, QPoint const &topLeftPicture);
+
+private:
+	void updatePath();
+
+	QVector<QPointF> mPoints;
+	QPainterPath mPath;
+	mutable QPainterPath mShape;  // Stroked on demand, empty while stale.
 };
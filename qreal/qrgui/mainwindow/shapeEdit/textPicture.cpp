@@ -92,6 +92,11 @@ QFont TextPicture::font() const
 	return mFont;
 }
 
+void TextPicture::setFont(QFont const &font)
+{
+	mFont = font;
+}
+
 QString TextPicture::name() const
 {
 	return mText.toPlainText();
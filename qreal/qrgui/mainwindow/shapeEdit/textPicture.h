@@ -17,6 +17,7 @@ public:
 	void setFontUnderline(bool isChecked);
 	void setPoint(QPoint const &point);
 	QFont font() const;
+	void setFont(QFont const &font);
 	QString name() const;
 	virtual void setIsDynamicText(bool isDynamic);
 	void drawForPictureText(QPainter* painter, QRectF rect);
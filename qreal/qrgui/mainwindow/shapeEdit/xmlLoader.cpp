@@ -1,5 +1,6 @@
 #include "xmlLoader.h"
 #include "../../../utils/xmlUtils.h"
+#include "../../umllib/sdfPathParser.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QSettings>
@@ -49,6 +50,16 @@ void XmlLoader::readDocument()
 		QDomElement graphic = graphics.at(i).toElement();
 		readGraphics(graphic);
 	}
+
+	if (!mItems.isEmpty())
+		mScene->addItems(mItems);
+	mItems.clear();
+}
+
+void XmlLoader::addItem(Item *item)
+{
+	mScene->setZValue(item);
+	mItems.push_back(item);
 }
 
 void XmlLoader::readGraphics(QDomElement const &graphic)
@@ -144,23 +155,21 @@ void XmlLoader::readPorts(QDomElement const &port)
 	}
 }
 
-QPair<QString, bool> XmlLoader::readScaleCoord(QString point, QDomElement const &docItem)
+QPair<qreal, bool> XmlLoader::readScaleCoord(QString point, QDomElement const &docItem)
 {
 	QString text = docItem.attribute(point, "0");
-	if (text.endsWith("a")) {
-		text.truncate(text.size() - 1);
-		return QPair<QString, bool>(text, true);
-	}
-	return QPair<QString, bool>(text, false);
+	bool const scaled = text.endsWith("a");
+	if (scaled)
+		text.chop(1);
+	return QPair<qreal, bool>(text.toDouble(), scaled);
 }
 
 void XmlLoader::changeScaleColor(int i)
 {
-	mListScalePoint.insert(i, QPair<Item::ScalingPointState, QColor>(mListScalePoint.at(i).first, QColor(Qt::red)));
-	mListScalePoint.removeAt(i + 1);
+	mListScalePoint[i].second = QColor(Qt::red);
 }
 
-void XmlLoader::checkScale(QPair<QString, bool> pointX1, QPair<QString, bool> pointX2, QPair<QString, bool> pointY1, QPair<QString, bool> pointY2)
+void XmlLoader::checkScale(QPair<qreal, bool> pointX1, QPair<qreal, bool> pointX2, QPair<qreal, bool> pointY1, QPair<qreal, bool> pointY2)
 {
 	if (pointX1.second)
 		changeScaleColor(0);
@@ -175,27 +184,27 @@ void XmlLoader::checkScale(QPair<QString, bool> pointX1, QPair<QString, bool> po
 QRectF XmlLoader::readRectOfXandY(QDomElement const &docItem)
 {
 	initListScalePoint();
-	QPair<QString, bool> pointX1 = readScaleCoord("x1", docItem);
-	QPair<QString, bool> pointX2 = readScaleCoord("x2", docItem);
-	QPair<QString, bool> pointY1 = readScaleCoord("y1", docItem);
-	QPair<QString, bool> pointY2 = readScaleCoord("y2", docItem);
+	QPair<qreal, bool> pointX1 = readScaleCoord("x1", docItem);
+	QPair<qreal, bool> pointX2 = readScaleCoord("x2", docItem);
+	QPair<qreal, bool> pointY1 = readScaleCoord("y1", docItem);
+	QPair<qreal, bool> pointY2 = readScaleCoord("y2", docItem);
 
-	qreal x1 = pointX1.first.toDouble() + mDrift.x();
-	qreal x2 = pointX2.first.toDouble() + mDrift.x();
-	qreal y1 = pointY1.first.toDouble() + mDrift.y();
-	qreal y2 = pointY2.first.toDouble() + mDrift.y();
+	qreal x1 = pointX1.first + mDrift.x();
+	qreal x2 = pointX2.first + mDrift.x();
+	qreal y1 = pointY1.first + mDrift.y();
+	qreal y2 = pointY2.first + mDrift.y();
 
 	checkScale(pointX1, pointX2, pointY1, pointY2);
 
 	return QRectF(x1, y1, x2 - x1, y2 - y1);
 }
 
-QPair<QPointF, QPointF> XmlLoader::calcLineOfXandY(QPair<QString, bool> pointX1, QPair<QString, bool> pointX2, QPair<QString, bool> pointY1, QPair<QString, bool> pointY2)
+QPair<QPointF, QPointF> XmlLoader::calcLineOfXandY(QPair<qreal, bool> pointX1, QPair<qreal, bool> pointX2, QPair<qreal, bool> pointY1, QPair<qreal, bool> pointY2)
 {
-	qreal x1 = pointX1.first.toDouble() + mDrift.x();
-	qreal x2 = pointX2.first.toDouble() + mDrift.x();
-	qreal y1 = pointY1.first.toDouble() + mDrift.y();
-	qreal y2 = pointY2.first.toDouble() + mDrift.y();
+	qreal x1 = pointX1.first + mDrift.x();
+	qreal x2 = pointX2.first + mDrift.x();
+	qreal y1 = pointY1.first + mDrift.y();
+	qreal y2 = pointY2.first + mDrift.y();
 
 	if (x2 > x1) {
 		if (y2 > y1) {
@@ -244,33 +253,33 @@ QPair<QPointF, QPointF> XmlLoader::calcLineOfXandY(QPair<QString, bool> pointX1,
 QPair<QPointF, QPointF> XmlLoader::readLineOfXandY(QDomElement const &docItem)
 {
 	initListScalePoint();
-	QPair<QString, bool> pointX1 = readScaleCoord("x1", docItem);
-	QPair<QString, bool> pointX2 = readScaleCoord("x2", docItem);
-	QPair<QString, bool> pointY1 = readScaleCoord("y1", docItem);
-	QPair<QString, bool> pointY2 = readScaleCoord("y2", docItem);
+	QPair<qreal, bool> pointX1 = readScaleCoord("x1", docItem);
+	QPair<qreal, bool> pointX2 = readScaleCoord("x2", docItem);
+	QPair<qreal, bool> pointY1 = readScaleCoord("y1", docItem);
+	QPair<qreal, bool> pointY2 = readScaleCoord("y2", docItem);
 	return calcLineOfXandY(pointX1, pointX2, pointY1, pointY2);
 }
 
 QPair<QPointF, QPointF> XmlLoader::readLinePortOfXandY(QDomElement const &start, QDomElement const &end)
 {
 	initListScalePoint();
-	QPair<QString, bool> pointX1 = readScaleCoord("startx", start);
-	QPair<QString, bool> pointX2 = readScaleCoord("endx", end);
-	QPair<QString, bool> pointY1 = readScaleCoord("starty", start);
-	QPair<QString, bool> pointY2 = readScaleCoord("endy", end);
+	QPair<qreal, bool> pointX1 = readScaleCoord("startx", start);
+	QPair<qreal, bool> pointX2 = readScaleCoord("endx", end);
+	QPair<qreal, bool> pointY1 = readScaleCoord("starty", start);
+	QPair<qreal, bool> pointY2 = readScaleCoord("endy", end);
 	return calcLineOfXandY(pointX1, pointX2, pointY1, pointY2);
 }
 
 QPointF XmlLoader::readXandY(QDomElement const &docItem)
 {
 	initListScalePoint();
-	QPair<QString, bool> pointX = readScaleCoord("x", docItem);
-	QPair<QString, bool> pointY = readScaleCoord("y", docItem);
+	QPair<qreal, bool> pointX = readScaleCoord("x", docItem);
+	QPair<qreal, bool> pointY = readScaleCoord("y", docItem);
 
-	qreal x = pointX.first.toDouble() + mDrift.x();
-	qreal y = pointY.first.toDouble() + mDrift.y();
+	qreal x = pointX.first + mDrift.x();
+	qreal y = pointY.first + mDrift.y();
 
-	checkScale(pointX, QPair<QString, bool>("", false), pointY, QPair<QString, bool>("", false));
+	checkScale(pointX, QPair<qreal, bool>(0, false), pointY, QPair<qreal, bool>(0, false));
 	return QPointF(x, y);
 }
 
@@ -280,8 +289,7 @@ void XmlLoader::readLine(QDomElement const &line)
 	Line* item = new Line(rect.first.x(), rect.first.y(), rect.second.x(), rect.second.y(), NULL);
 	item->readPenBrush(line);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readEllipse(QDomElement const &ellipse)
@@ -290,8 +298,7 @@ void XmlLoader::readEllipse(QDomElement const &ellipse)
 	Ellipse* item = new Ellipse(rect.left(), rect.top(), rect.right(), rect.bottom(), NULL);
 	item->readPenBrush(ellipse);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readArch(QDomElement const &arch)
@@ -300,8 +307,7 @@ void XmlLoader::readArch(QDomElement const &arch)
 	int spanAngle = arch.attribute("spanAngle", "0").toInt();
 	int startAngle = arch.attribute("startAngle", "0").toInt();
 	Arch* item = new Arch(rect, startAngle, spanAngle, NULL);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readRectangle(QDomElement const &rectangle)
@@ -310,8 +316,7 @@ void XmlLoader::readRectangle(QDomElement const &rectangle)
 	Rectangle* item = new Rectangle(rect.left(), rect.top(), rect.right(), rect.bottom(), NULL);
 	item->readPenBrush(rectangle);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readImage(QDomElement const &image)
@@ -324,193 +329,45 @@ void XmlLoader::readImage(QDomElement const &image)
 	Image* item = new Image(fullFileName, rect.left(), rect.top(), NULL);
 	item->setX2andY2(rect.right(), rect.bottom());
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readStylus(QDomElement const &stylus)
 {
 	QDomNodeList stylusAttributes = stylus.childNodes();
 
-	Stylus* stylusItem = new Stylus(0, 0, NULL);
+	QVector<QPointF> points;
+	QDomElement styleElement;
 	for (unsigned i = 0; i < stylusAttributes.length(); ++i) {
 		QDomElement type = stylusAttributes.at(i).toElement();
-		if (type.tagName() == "line") {
+		if (type.tagName() == "path") {
+			points += SdfPathParser::toPolyline(type.attribute("d")
+					, QTransform::fromTranslate(mDrift.x(), mDrift.y()));
+			styleElement = type;
+		} else if (type.tagName() == "line") {
+			// Strokes saved segment by segment
 			QRectF rect = readRectOfXandY(type);
-			Line* item = new Line(rect.left(), rect.top(), rect.right(), rect.bottom(), NULL);
-			item->readPenBrush(type);
-			stylusItem->mListLine.push_back(item);
-			stylusItem->setPen(item->pen());
-			stylusItem->setBrush(item->brush());
+			if (points.isEmpty() || points.last() != rect.topLeft())
+				points.append(rect.topLeft());
+			points.append(rect.bottomRight());
+			styleElement = type;
 		}
 		else
 			qDebug() << "Incorrect stylus tag";
 	}
-	mScene->addItem(stylusItem);
-	mScene->setZValue(stylusItem);
-}
 
-bool XmlLoader::isNotLCMZ(QString str, int i)
-{
-	return (i != str.length()) && (str[i] != 'L') && (str[i] != 'C') && (str[i] != 'M')
-		&& (str[i] != 'Z');
+	Stylus* stylusItem = new Stylus(points, NULL);
+	if (!styleElement.isNull())
+		stylusItem->readPenBrush(styleElement);
+	addItem(stylusItem);
 }
 
 void XmlLoader::readPath(QDomElement const &element)
 {
-	QString tempStr;
-	QPointF endPoint;
-	QPointF c1;
-	QPointF c2;
-	QDomElement elem = element;
-	QPainterPath path;
-
-	if (!elem.isNull())
-	{
-		QString dCont;
-		dCont = elem.attribute("d").remove(0, 1);
-		dCont.append(" Z");
-
-		for (int i = 0; i < dCont.length() - 1;)
-		{
-			int j = 0;
-			if (dCont[i] == 'M')
-			{
-				j = i + 2;
-				while (isNotLCMZ(dCont, j))
-				{
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					endPoint.setX(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					endPoint.setY(tempStr.toFloat());
-					++j;
-					tempStr.clear();
-				}
-
-				path.moveTo(endPoint);
-				i = j;
-			}
-			else if (dCont[i] == 'L')
-			{
-				j = i + 2;
-				while (isNotLCMZ(dCont, j))
-				{
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					endPoint.setX(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-					endPoint.setY(tempStr.toFloat());
-					++j;
-					tempStr.clear();
-				}
-
-				 path.lineTo(endPoint);
-				 i = j;
-			}
-			 else if (dCont[i] == 'C')
-			{
-				j = i + 2;
-				while(isNotLCMZ(dCont, j))
-				{
-					while (!(dCont[j] == ' '))
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					c1.setX(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					c1.setY(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					c2.setX(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					c2.setY(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					endPoint.setX(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-
-					while (dCont[j] != ' ')
-					{
-						tempStr.append(dCont[j]);
-						++j;
-					}
-
-					endPoint.setY(tempStr.toFloat());
-					tempStr.clear();
-					++j;
-				}
-
-				path.cubicTo(c1, c2, endPoint);
-				i = j;
-
-			} else if (dCont[i] == 'Z')
-			{
-				path.closeSubpath();
-			}
-		}
-	}
-	Path *item = new Path(path);
+	Path *item = new Path(SdfPathParser::toPath(element.attribute("d")));
 	item->translate(mDrift.x(), mDrift.y());
-	item->readPenBrush(elem);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	item->readPenBrush(element);
+	addItem(item);
 }
 
 void XmlLoader::readCurve(QDomElement const &curve)
@@ -540,8 +397,7 @@ void XmlLoader::readCurve(QDomElement const &curve)
 	}
 	Curve* item = new Curve(QPointF(x1, y1), QPointF(x2, y2), QPointF(x3, y3));
 	item->readPenBrush(curve);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readText(QDomElement const &text)
@@ -553,8 +409,7 @@ void XmlLoader::readText(QDomElement const &text)
 	TextPicture* item = new TextPicture(x, y, str);
 	item->readFont(text);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readLabel(QDomElement const &label)
@@ -571,8 +426,7 @@ void XmlLoader::readLabel(QDomElement const &label)
 	else
 		qDebug() << "Incorrect label tag";
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readLinePort(QDomElement const &linePort)
@@ -592,8 +446,7 @@ void XmlLoader::readLinePort(QDomElement const &linePort)
 	QPair<QPointF, QPointF> rect = readLinePortOfXandY(start, end);
 	LinePort* item = new LinePort(rect.first.x(), rect.first.y(), rect.second.x(), rect.second.y(), NULL);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
 
 void XmlLoader::readPointPort(QDomElement const &pointPort)
@@ -601,6 +454,5 @@ void XmlLoader::readPointPort(QDomElement const &pointPort)
 	QPointF point = readXandY(pointPort);
 	PointPort* item = new PointPort(point.x(), point.y(), NULL);
 	item->setListScalePoint(mListScalePoint);
-	mScene->addItem(item);
-	mScene->setZValue(item);
+	addItem(item);
 }
@@ -18,6 +18,8 @@ private:
 	QDomDocument mDocument;
 	Scene *mScene;
 	QPoint mDrift;
+	// the document is added to the scene as one undoable step
+	QList<Item *> mItems;
 	QList<QPair<Item::ScalingPointState, QColor> > mListScalePoint;
 	int mStrY;
 	int mStrX;
@@ -26,15 +28,16 @@ private:
 
 	void initListScalePoint();
 	void readDocument();
+	void addItem(Item *item);
 	void readGraphics(QDomElement const &graphic);
 	void readPicture(QDomElement const &picture);
 	void readLabels(QDomElement const &label);
 	void readPorts(QDomElement const &port);
 	void readImage(QDomElement const &image);
 	void changeScaleColor(int i);
-	void checkScale(QPair<QString, bool> pointX1, QPair<QString, bool> pointX2, QPair<QString, bool> pointY1, QPair<QString, bool> pointY2);
-	QPair<QString, bool> readScaleCoord(QString point, QDomElement const &docItem);
-	QPair<QPointF, QPointF> calcLineOfXandY(QPair<QString, bool> pointX1, QPair<QString, bool> pointX2, QPair<QString, bool> pointY1, QPair<QString, bool> pointY2);
+	void checkScale(QPair<qreal, bool> pointX1, QPair<qreal, bool> pointX2, QPair<qreal, bool> pointY1, QPair<qreal, bool> pointY2);
+	QPair<qreal, bool> readScaleCoord(QString point, QDomElement const &docItem);
+	QPair<QPointF, QPointF> calcLineOfXandY(QPair<qreal, bool> pointX1, QPair<qreal, bool> pointX2, QPair<qreal, bool> pointY1, QPair<qreal, bool> pointY2);
 	QPair<QPointF, QPointF> readLineOfXandY(QDomElement const &docItem);
 	QPair<QPointF, QPointF> readLinePortOfXandY(QDomElement const &start, QDomElement const &end);
 	QRectF readRectOfXandY(QDomElement const &docItem);
@@ -50,6 +53,4 @@ private:
 	void readLabel(QDomElement const &label);
 	void readLinePort(QDomElement const &linePort);
 	void readPointPort(QDomElement const &pointPort);
-
-	bool isNotLCMZ(QString str, int i);
 };
@@ -1,6 +1,7 @@
 #include "graphicalModel.h"
 
 #include "logicalModel.h"
+#include "../../../qrrepo/repoCommand.h"
 
 #include <QtCore/QUuid>
 #include <QtCore/QDebug>
@@ -26,21 +27,26 @@ GraphicalModel::~GraphicalModel()
 
 void GraphicalModel::init()
 {
+	mGraphicalIds.clear();
+	mRenamedLogicalIds.clear();
 	mModelItems.insert(Id::rootId(), mRootItem);
-	mApi.setName(Id::rootId(), Id::rootId().toString());
 	// Turn off view notification while loading. Model can be inconsistent during a process,
 	// so views shall not update themselves before time. It is important for
 	// scene, where adding edge before adding nodes may lead to disconnected edge.	blockSignals(true);
 	blockSignals(true);
-	loadSubtreeFromClient(static_cast<GraphicalModelItem *>(mRootItem));
+	// Diagrams are loaded by fetchMore() when they are opened or expanded in explorer
+	foreach (Id childId, mApi.children(Id::rootId())) {
+		if (mApi.isGraphicalElement(childId))
+			mUnfetchedItems.insert(loadElement(static_cast<GraphicalModelItem *>(mRootItem), childId));
+	}
 	blockSignals(false);
 }
 
-void GraphicalModel::loadSubtreeFromClient(GraphicalModelItem * const parent)
+void GraphicalModel::loadSubtreeFromClient(AbstractModelItem * const parent)
 {
 	foreach (Id childId, mApi.children(parent->id())) {
-		if (mApi.isGraphicalElement(childId)) {
-			GraphicalModelItem *child = loadElement(parent, childId);
+		if (mApi.isGraphicalElement(childId) && !mModelItems.contains(childId)) {
+			GraphicalModelItem *child = loadElement(static_cast<GraphicalModelItem *>(parent), childId);
 			loadSubtreeFromClient(child);
 		}
 	}
@@ -55,11 +61,46 @@ GraphicalModelItem *GraphicalModel::loadElement(GraphicalModelItem *parentItem,
 	GraphicalModelItem *item = new GraphicalModelItem(id, logicalId, parentItem);
 	parentItem->addChild(item);
 	mModelItems.insert(id, item);
+	mGraphicalIds[logicalId].insert(id);
 	endInsertRows();
 
+	// Logical element was renamed before the diagram was read
+	if (mRenamedLogicalIds.contains(logicalId) && mApi.name(id) != mApi.name(logicalId))
+		mApi.setName(id, mApi.name(logicalId));
+
 	return item;
 }
 
+QList<GraphicalModelItem *> GraphicalModel::itemsWithLogicalId(Id const &logicalId) const
+{
+	QHash<Id, QSet<Id> >::iterator const ids = mGraphicalIds.find(logicalId);
+	if (ids == mGraphicalIds.end())
+		return QList<GraphicalModelItem *>();
+
+	QList<GraphicalModelItem *> items;
+	QMutableSetIterator<Id> iterator(ids.value());
+	while (iterator.hasNext()) {
+		GraphicalModelItem * const item = static_cast<GraphicalModelItem *>(mModelItems.value(iterator.next()));
+		if (item && item->logicalId() == logicalId)
+			items << item;
+		else
+			iterator.remove();
+	}
+	if (ids.value().isEmpty())
+		mGraphicalIds.erase(ids);
+	return items;
+}
+
+bool GraphicalModel::isModelElement(Id const &id) const
+{
+	return mApi.isGraphicalElement(id);
+}
+
+AbstractModelItem *GraphicalModel::loadItem(AbstractModelItem *parentItem, Id const &id)
+{
+	return loadElement(static_cast<GraphicalModelItem *>(parentItem), id);
+}
+
 void GraphicalModel::connectToLogicalModel(LogicalModel * const logicalModel)
 {
 	mLogicalModelView.setModel(logicalModel);
@@ -73,17 +114,17 @@ AbstractModelItem *GraphicalModel::createModelItem(Id const &id, AbstractModelIt
 
 void GraphicalModel::updateElements(Id const &logicalId, QString const &name)
 {
-	foreach (AbstractModelItem *item,  mModelItems.values()) {
-		GraphicalModelItem *graphicalItem = static_cast<GraphicalModelItem *>(item);
-		if (graphicalItem->logicalId() == logicalId) {
-			mApi.setName(graphicalItem->id(), name);
-			emit dataChanged(index(graphicalItem), index(graphicalItem));
-		}
+	foreach (GraphicalModelItem *item, itemsWithLogicalId(logicalId)) {
+		mApi.setName(item->id(), name);
+		emit dataChanged(index(item), index(item));
 	}
+	if (!mUnfetchedItems.isEmpty())
+		mRenamedLogicalIds.insert(logicalId);
 }
 
 void GraphicalModel::addElementToModel(const Id &parent, const Id &id, const Id &logicalId, const QString &name, const QPointF &position)
 {
+	qrRepo::RepoCommand command(mApi, tr("Create element"));
 	Q_ASSERT_X(mModelItems.contains(parent), "addElementToModel", "Adding element to non-existing parent");
 	AbstractModelItem *parentItem = mModelItems[parent];
 
@@ -118,6 +159,7 @@ void GraphicalModel::initializeElement(const Id &id, const Id &logicalId, models
 	mApi.setPosition(id, position);
 	mApi.setConfiguration(id, QVariant(QPolygon()));
 	mModelItems.insert(id, item);
+	mGraphicalIds[logicalId].insert(id);
 	endInsertRows();
 }
 
@@ -162,6 +204,7 @@ QVariant GraphicalModel::data(const QModelIndex &index, int role) const
 bool GraphicalModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
 	if (index.isValid()) {
+		qrRepo::RepoCommand command(mApi, tr("Change element"));
 		AbstractModelItem *item = static_cast<AbstractModelItem *>(index.internalPointer());
 		switch (role) {
 		case Qt::DisplayRole:
@@ -210,6 +253,7 @@ void GraphicalModel::changeParent(QModelIndex const &element, QModelIndex const
 	int destinationRow = parentAbstractItem(parent)->children().size();
 
 	if (beginMoveRows(element.parent(), element.row(), element.row(), parent, destinationRow)) {
+		qrRepo::RepoCommand command(mApi, tr("Move element"));
 		AbstractModelItem *elementItem = static_cast<AbstractModelItem*>(element.internalPointer());
 		QVariant configuration = mApi.configuration(elementItem->id());
 		elementItem->parent()->removeChild(elementItem);
@@ -247,6 +291,7 @@ bool GraphicalModel::removeRows(int row, int count, QModelIndex const &parent)
 	if (parentItem->children().size() < row + count)
 		return false;
 	else {
+		qrRepo::RepoCommand command(mApi, tr("Remove element"));
 		for (int i = row; i < row + count; ++i) {
 			AbstractModelItem *child = parentItem->children().at(i);
 			removeModelItems(child);
@@ -277,10 +322,8 @@ void GraphicalModel::removeModelItemFromApi(details::modelsImplementation::Abstr
 QList<QPersistentModelIndex> GraphicalModel::indexesWithLogicalId(Id const &logicalId) const
 {
 	QList<QPersistentModelIndex> indexes;
-	foreach (AbstractModelItem *item, mModelItems.values()) {
-		if (static_cast<GraphicalModelItem *>(item)->logicalId() == logicalId)
-			indexes.append(index(item));
-	}
+	foreach (GraphicalModelItem *item, itemsWithLogicalId(logicalId))
+		indexes.append(index(item));
 	return indexes;
 }
 
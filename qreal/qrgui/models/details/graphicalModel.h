@@ -25,14 +25,17 @@ namespace qReal {
 				virtual ~GraphicalModel();
 
 				void connectToLogicalModel(LogicalModel * const logicalModel);
+				/// Renames graphical elements of a logical one. Elements on diagrams that are not read
+				/// yet are renamed when their diagrams are read.
 				void updateElements(Id const &logicalId, QString const &name);
 				void addElementToModel(Id const &parent, Id const &id,Id const &logicalId, QString const &name, QPointF const &position);
 				virtual QVariant data(const QModelIndex &index, int role) const;
 				virtual bool setData(const QModelIndex &index, const QVariant &value, int role);
 				virtual void changeParent(QModelIndex const &element, QModelIndex const &parent, QPointF const &position);
-				qrRepo::GraphicalRepoApi const &api() const;
+				virtual qrRepo::GraphicalRepoApi const &api() const;
 				qrRepo::GraphicalRepoApi &mutableApi() const;
 				virtual bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex());
+				/// Graphical elements of a logical one on diagrams read so far, diagrams are not read for that.
 				QList<QPersistentModelIndex> indexesWithLogicalId(Id const &logicalId) const;
 				virtual ModelsAssistApi* modelAssistApi() const;
 				GraphicalModelAssistApi &graphicalModelAssistApi() const;
@@ -44,10 +47,17 @@ namespace qReal {
 				LogicalModelView mLogicalModelView;
 				qrRepo::GraphicalRepoApi &mApi;
 				GraphicalModelAssistApi *mGraphicalAssistApi;
+				/// Ids of read graphical elements by their logical ids. Ids of removed items are dropped when met.
+				mutable QHash<Id, QSet<Id> > mGraphicalIds;
+				/// Logical elements changed while some diagrams were not read.
+				QSet<Id> mRenamedLogicalIds;
 
 				virtual void init();
-				void loadSubtreeFromClient(modelsImplementation::GraphicalModelItem * const parent);
+				virtual void loadSubtreeFromClient(modelsImplementation::AbstractModelItem * const parent);
+				virtual bool isModelElement(Id const &id) const;
+				virtual modelsImplementation::AbstractModelItem *loadItem(modelsImplementation::AbstractModelItem *parentItem, Id const &id);
 				modelsImplementation::GraphicalModelItem *loadElement(modelsImplementation::GraphicalModelItem *parentItem, Id const &id);
+				QList<modelsImplementation::GraphicalModelItem *> itemsWithLogicalId(Id const &logicalId) const;
 
 				virtual modelsImplementation::AbstractModelItem *createModelItem(Id const &id, modelsImplementation::AbstractModelItem *parentItem) const;
 				void initializeElement(const Id &id, const Id &logicalId, modelsImplementation::AbstractModelItem *parentItem,
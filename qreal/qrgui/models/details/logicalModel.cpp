@@ -1,5 +1,7 @@
 #include "logicalModel.h"
 #include "graphicalModel.h"
+#include "../../../qrrepo/repoCommand.h"
+#include "../../kernel/exception/exception.h"
 
 #include <QtCore/QUuid>
 
@@ -25,18 +27,21 @@ LogicalModel::~LogicalModel()
 void LogicalModel::init()
 {
 	mModelItems.insert(Id::rootId(), mRootItem);
-	mApi.setName(Id::rootId(), Id::rootId().toString());
 	// Turn off view notification while loading.
 	blockSignals(true);
-	loadSubtreeFromClient(static_cast<LogicalModelItem *>(mRootItem));
+	// Contents of top-level elements are loaded by fetchMore()
+	foreach (Id childId, mApi.children(Id::rootId())) {
+		if (mApi.isLogicalElement(childId))
+			mUnfetchedItems.insert(loadElement(static_cast<LogicalModelItem *>(mRootItem), childId));
+	}
 	blockSignals(false);
 }
 
-void LogicalModel::loadSubtreeFromClient(LogicalModelItem * const parent)
+void LogicalModel::loadSubtreeFromClient(AbstractModelItem * const parent)
 {
 	foreach (Id childId, mApi.children(parent->id())) {
-		if (mApi.isLogicalElement(childId)) {
-			LogicalModelItem *child = loadElement(parent, childId);
+		if (mApi.isLogicalElement(childId) && !mModelItems.contains(childId)) {
+			LogicalModelItem *child = loadElement(static_cast<LogicalModelItem *>(parent), childId);
 			loadSubtreeFromClient(child);
 		}
 	}
@@ -52,7 +57,6 @@ LogicalModelItem *LogicalModel::loadElement(LogicalModelItem *parentItem, Id con
 
 	beginInsertRows(index(parentItem), newRow, newRow);
 	LogicalModelItem *item = new LogicalModelItem(id, parentItem);
-	checkProperties(id);
 	parentItem->addChild(item);
 	mModelItems.insert(id, item);
 	endInsertRows();
@@ -60,18 +64,14 @@ LogicalModelItem *LogicalModel::loadElement(LogicalModelItem *parentItem, Id con
 	return item;
 }
 
-void LogicalModel::checkProperties(Id const &id)
+bool LogicalModel::isModelElement(Id const &id) const
 {
-	if (!mEditorManager.hasElement(id.type()))
-		return;
-	QStringList const propertiesThatShallBe = mEditorManager.getPropertyNames(id.type());
-	foreach (QString const property, propertiesThatShallBe)
-		if (!api().hasProperty(id, property))
-			mApi.setProperty(id, property, "");  // There shall be default value.
-	if (!mApi.hasProperty(id, "outgoingUsages"))
-		mApi.setProperty(id, "outgoingUsages", IdListHelper::toVariant(IdList()));
-	if (!mApi.hasProperty(id, "incomingUsages"))
-		mApi.setProperty(id, "incomingUsages", IdListHelper::toVariant(IdList()));
+	return mApi.isLogicalElement(id);
+}
+
+AbstractModelItem *LogicalModel::loadItem(AbstractModelItem *parentItem, Id const &id)
+{
+	return loadElement(static_cast<LogicalModelItem *>(parentItem), id);
 }
 
 void LogicalModel::connectToGraphicalModel(GraphicalModel * const graphicalModel)
@@ -135,9 +135,11 @@ QString LogicalModel::pathToItem(AbstractModelItem const *item) const
 
 void LogicalModel::addElementToModel(const Id &parent, const Id &id, const Id &logicalId, const QString &name, const QPointF &position)
 {
-	if (mModelItems.contains(id))
+	// Element may be in a diagram that is not read yet
+	if (fetchedItem(id))
 		return;
 	Q_ASSERT_X(mModelItems.contains(parent), "addElementToModel", "Adding element to non-existing parent");
+	qrRepo::RepoCommand command(mApi, tr("Create element"));
 	AbstractModelItem *parentItem = mModelItems[parent];
 	AbstractModelItem *newItem = NULL;
 	if ((logicalId != Id::rootId()) && (mModelItems.contains(logicalId))) {
@@ -160,19 +162,9 @@ void LogicalModel::initializeElement(const Id &id, modelsImplementation::Abstrac
 	beginInsertRows(index(parentItem), newRow, newRow);
 	parentItem->addChild(item);
 	mApi.addChild(parentItem->id(), id);
+	// Links and properties described in metamodel are read from defaults of the type
+	// (see Models::defaultPropertyValue()) until they are changed.
 	mApi.setProperty(id, "name", name);
-	mApi.setProperty(id, "from", Id::rootId().toVariant());
-	mApi.setProperty(id, "to", Id::rootId().toVariant());
-	mApi.setProperty(id, "links", IdListHelper::toVariant(IdList()));
-	mApi.setProperty(id, "outgoingConnections", IdListHelper::toVariant(IdList()));
-	mApi.setProperty(id, "incomingConnections", IdListHelper::toVariant(IdList()));
-	mApi.setProperty(id, "outgoingUsages", IdListHelper::toVariant(IdList()));
-	mApi.setProperty(id, "incomingUsages", IdListHelper::toVariant(IdList()));
-
-	QStringList const properties = mEditorManager.getPropertyNames(id.type());
-	foreach (QString const property, properties)
-	// for those properties that doesn't have default values, plugin will return empty string
-		mApi.setProperty(id, property, mEditorManager.getDefaultPropertyValue(id, property));
 
 	mModelItems.insert(id, item);
 	endInsertRows();
@@ -211,6 +203,7 @@ QVariant LogicalModel::data(const QModelIndex &index, int role) const
 bool LogicalModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
 	if (index.isValid()) {
+		qrRepo::RepoCommand command(mApi, tr("Change element"));
 		AbstractModelItem *item = static_cast<AbstractModelItem *>(index.internalPointer());
 		switch (role) {
 		case Qt::DisplayRole:
@@ -226,7 +219,12 @@ bool LogicalModel::setData(const QModelIndex &index, const QVariant &value, int
 		default:
 			if (role >= roles::customPropertiesBeginRole) {
 				QString selectedProperty = findPropertyName(item->id(), role);
-				mApi.setProperty(item->id(), selectedProperty, value);
+				try {
+					mApi.setProperty(item->id(), selectedProperty, value);
+				} catch (Exception const &e) {
+					emit propertyRejected(e.message(), item->id());
+					return false;
+				}
 				break;
 			}
 			Q_ASSERT(role < Qt::UserRole);
@@ -247,6 +245,7 @@ void LogicalModel::changeParent(QModelIndex const &element, QModelIndex const &p
 	int destinationRow = parentAbstractItem(parent)->children().size();
 
 	if (beginMoveRows(element.parent(), element.row(), element.row(), parent, destinationRow)) {
+		qrRepo::RepoCommand command(mApi, tr("Move element"));
 		AbstractModelItem *elementItem = static_cast<AbstractModelItem*>(element.internalPointer());
 		elementItem->parent()->removeChild(elementItem);
 		AbstractModelItem *parentItem = parentAbstractItem(parent);
@@ -281,6 +280,7 @@ bool LogicalModel::removeRows(int row, int count, QModelIndex const &parent)
 	if (parentItem->children().size() < row + count)
 		return false;
 	else {
+		qrRepo::RepoCommand command(mApi, tr("Remove element"));
 		for (int i = row; i < row + count; ++i) {
 			AbstractModelItem *child = parentItem->children().at(i);
 			removeModelItems(child);
@@ -34,21 +34,26 @@ namespace qReal {
 				virtual QVariant data(const QModelIndex &index, int role) const;
 				virtual bool setData(const QModelIndex &index, const QVariant &value, int role);
 				virtual void changeParent(QModelIndex const &element, QModelIndex const &parent, QPointF const &position);
-				qrRepo::LogicalRepoApi const &api() const;
+				virtual qrRepo::LogicalRepoApi const &api() const;
 				qrRepo::LogicalRepoApi &mutableApi() const;
 				virtual bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex());
 				virtual ModelsAssistApi* modelAssistApi() const;
 				LogicalModelAssistApi &logicalModelAssistApi() const;
 
+			signals:
+				/// Value set through setData was rejected by the repository, e.g. failed validation.
+				void propertyRejected(QString const &message, qReal::Id const &element);
+
 		private:
 				GraphicalModelView mGraphicalModelView;
 				qrRepo::LogicalRepoApi &mApi;
 				LogicalModelAssistApi *mLogicalAssistApi;
 
 				virtual void init();
-				void loadSubtreeFromClient(modelsImplementation::LogicalModelItem * const parent);
+				virtual void loadSubtreeFromClient(modelsImplementation::AbstractModelItem * const parent);
+				virtual bool isModelElement(Id const &id) const;
+				virtual modelsImplementation::AbstractModelItem *loadItem(modelsImplementation::AbstractModelItem *parentItem, Id const &id);
 				modelsImplementation::LogicalModelItem *loadElement(modelsImplementation::LogicalModelItem *parentItem, Id const &id);
-				void checkProperties(Id const &id);
 
 				virtual modelsImplementation::AbstractModelItem *createModelItem(Id const &id, modelsImplementation::AbstractModelItem *parentItem) const;
 				void initializeElement(const Id &id, modelsImplementation::AbstractModelItem *parentItem,
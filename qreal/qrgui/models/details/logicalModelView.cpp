@@ -25,6 +25,8 @@ void LogicalModelView::dataChanged(QModelIndex const &topLeft, QModelIndex const
 
 void LogicalModelView::rowsAboutToBeRemoved(QModelIndex const &parent, int start, int end)
 {
+	// Graphical elements on diagrams that are not read yet must go as well
+	static_cast<GraphicalModel *>(mModel)->fetchAll();
 	for (int row = start; row <= end; ++row) {
 		QModelIndex current = model()->index(row, 0, parent);
 		if (current.isValid()) {
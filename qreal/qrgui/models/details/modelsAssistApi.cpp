@@ -41,8 +41,7 @@ QVariant ModelsAssistApi::property(Id const &elem, int const role) const
 
 int ModelsAssistApi::roleIndexByName(Id const &elem, QString const &roleName) const
 {
-	QStringList const properties = editorManager().getPropertyNames(elem.type());
-	return properties.indexOf(roleName) + roles::customPropertiesBeginRole;
+	return editorManager().propertySchema(elem.type())->slot(roleName) + roles::customPropertiesBeginRole;
 }
 
 QModelIndex ModelsAssistApi::indexById(Id const &id) const
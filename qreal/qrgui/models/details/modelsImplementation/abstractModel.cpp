@@ -41,6 +41,49 @@ int AbstractModel::columnCount(const QModelIndex &parent) const
 	return 1;
 }
 
+bool AbstractModel::hasChildren(const QModelIndex &parent) const
+{
+	AbstractModelItem * const item = parentAbstractItem(parent);
+	return mUnfetchedItems.contains(item) || !item->children().isEmpty();
+}
+
+bool AbstractModel::canFetchMore(const QModelIndex &parent) const
+{
+	return mUnfetchedItems.contains(parentAbstractItem(parent));
+}
+
+void AbstractModel::fetchMore(const QModelIndex &parent)
+{
+	fetchSubtree(parentAbstractItem(parent));
+}
+
+void AbstractModel::fetchAll()
+{
+	foreach (AbstractModelItem *item, mUnfetchedItems)
+		fetchSubtree(item);
+}
+
+void AbstractModel::fetchSubtree(AbstractModelItem *item)
+{
+	if (mUnfetchedItems.remove(item))
+		loadSubtreeFromClient(item);
+}
+
+AbstractModelItem *AbstractModel::fetchedItem(Id const &id)
+{
+	AbstractModelItem * const item = mModelItems.value(id);
+	if (item || mUnfetchedItems.isEmpty() || !api().exist(id))
+		return item;
+
+	Id topLevel = id;
+	for (Id parent = api().parent(id); parent != Id::rootId() && api().exist(parent); parent = api().parent(parent))
+		topLevel = parent;
+	AbstractModelItem * const topLevelItem = mModelItems.value(topLevel);
+	if (topLevelItem)
+		fetchSubtree(topLevelItem);
+	return mModelItems.value(id);
+}
+
 QModelIndex AbstractModel::index(int row, int column, const QModelIndex &parent) const
 {
 	AbstractModelItem *parentItem = parentAbstractItem(parent);
@@ -100,9 +143,7 @@ QString AbstractModel::findPropertyName(Id const &id, int const role) const
 	//In case of a property described in element itself (in metamodel),
 	// role is simply an index of a property in a list of propertires.
 	// This convention must be obeyed everywhere, otherwise roles will shift.
-	QStringList properties = mEditorManager.getPropertyNames(id.type());
-	Q_ASSERT(role - roles::customPropertiesBeginRole < properties.count());
-	return properties[role - roles::customPropertiesBeginRole];
+	return mEditorManager.propertySchema(id.type())->name(role - roles::customPropertiesBeginRole);
 }
 
 Qt::DropActions AbstractModel::supportedDropActions() const
@@ -124,10 +165,9 @@ EditorManager const &AbstractModel::editorManager() const
 
 QModelIndex AbstractModel::indexById(Id const &id) const
 {
-	if (mModelItems.keys().contains(id)) {
-		return index(mModelItems.find(id).value());
-	}
-	return QModelIndex();
+	// Reading a diagram changes only how much of repository the model shows
+	AbstractModelItem * const item = const_cast<AbstractModel *>(this)->fetchedItem(id);
+	return item ? index(item) : QModelIndex();
 }
 
 Id AbstractModel::idByIndex(QModelIndex const &index) const
@@ -171,12 +211,88 @@ bool AbstractModel::dropMimeData(QMimeData const *data, Qt::DropAction action, i
 
 void AbstractModel::reinit()
 {
+	// Views are notified when the new items are loaded, so that they can find their diagrams again
+	beginResetModel();
 	cleanupTree(mRootItem);
 	mModelItems.clear();
+	mUnfetchedItems.clear();
 	delete mRootItem;
 	mRootItem = createModelItem(Id::rootId(), NULL);
-	reset();
 	init();
+	endResetModel();
+}
+
+void AbstractModel::notifyDataChanged(IdList const &ids)
+{
+	foreach (Id const &id, ids) {
+		AbstractModelItem * const item = mModelItems.value(id);
+		if (item) {
+			QModelIndex const changed = index(item);
+			emit dataChanged(changed, changed);
+		}
+	}
+}
+
+void AbstractModel::updateStructure(IdList const &ids)
+{
+	// Removed elements go first, so that restored ones may take their places
+	foreach (Id const &id, ids) {
+		AbstractModelItem * const item = mModelItems.value(id);
+		if (item && item != mRootItem && !api().exist(id))
+			removeItem(item);
+	}
+
+	foreach (Id const &id, ids) {
+		if (id == Id::rootId() || !api().exist(id) || !isModelElement(id))
+			continue;
+
+		AbstractModelItem * const item = mModelItems.value(id);
+		AbstractModelItem * const parentItem = mModelItems.value(api().parent(id));
+		if (!parentItem || mUnfetchedItems.contains(parentItem)) {
+			// Element is now in a diagram that is not read yet, it will be loaded with the diagram
+			if (item)
+				removeItem(item);
+		} else if (!item) {
+			AbstractModelItem * const newItem = loadItem(parentItem, id);
+			// Restored diagrams are read on demand as on start, other elements come with their contents
+			if (parentItem == mRootItem)
+				mUnfetchedItems.insert(newItem);
+			else
+				loadSubtreeFromClient(newItem);
+		} else if (item->parent() != parentItem) {
+			moveItem(item, parentItem);
+		}
+	}
+}
+
+void AbstractModel::removeItem(AbstractModelItem *item)
+{
+	AbstractModelItem * const parentItem = item->parent();
+	int const row = item->row();
+	beginRemoveRows(index(parentItem), row, row);
+	parentItem->removeChild(item);
+	QList<AbstractModelItem *> subtree;
+	subtree << item;
+	for (int i = 0; i < subtree.size(); ++i) {
+		mModelItems.remove(subtree[i]->id());
+		mUnfetchedItems.remove(subtree[i]);
+		subtree << subtree[i]->children();
+	}
+	cleanupTree(item);
+	delete item;
+	endRemoveRows();
+}
+
+void AbstractModel::moveItem(AbstractModelItem *item, AbstractModelItem *newParent)
+{
+	AbstractModelItem * const oldParent = item->parent();
+	int const row = item->row();
+	if (beginMoveRows(index(oldParent), row, row, index(newParent), newParent->children().size())) {
+		oldParent->removeChild(item);
+		item->setParent(newParent);
+		newParent->addChild(item);
+		endMoveRows();
+	}
 }
 
 void AbstractModel::cleanupTree(modelsImplementation::AbstractModelItem * item)
@@ -190,6 +306,7 @@ void AbstractModel::cleanupTree(modelsImplementation::AbstractModelItem * item)
 
 void AbstractModel::removeModelItems(details::modelsImplementation::AbstractModelItem *const root)
 {
+	fetchSubtree(root);
 	foreach (AbstractModelItem *child, root->children()) {
 		removeModelItems(child);
 		int childRow = child->row();
@@ -3,6 +3,7 @@
 #include <QtCore/QAbstractItemModel>
 #include <QMimeData>
 #include <QModelIndexList>
+#include <QtCore/QSet>
 
 #include "../modelsAssistApi.h"
 #include "../../../qrrepo/repoApi.h"
@@ -26,6 +27,13 @@ namespace qReal {
 					virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 					virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
 					virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+					virtual bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+					/// Diagrams are read from repository with their contents when they are
+					/// expanded in explorer or opened, see init().
+					virtual bool canFetchMore(const QModelIndex &parent) const;
+					virtual void fetchMore(const QModelIndex &parent);
+					/// Reads all diagrams, for walks over all items of the model.
+					void fetchAll();
 					virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
 					virtual QModelIndex parent(const QModelIndex &index) const;
 					virtual Qt::ItemFlags flags(QModelIndex const &index) const;
@@ -45,10 +53,20 @@ namespace qReal {
 
 					void reinit();
 
+					virtual qrRepo::CommonRepoApi const &api() const = 0;
+
+					/// Notifies views that data of given elements was changed directly in repository, e.g. by undo.
+					void notifyDataChanged(IdList const &ids);
+					/// Adds, removes and moves items of given elements after their existence or parents were
+					/// changed directly in repository, e.g. by undo. Repository itself is not changed.
+					void updateStructure(IdList const &ids);
+
 				protected:
 					EditorManager const &mEditorManager;
 					QHash<Id, AbstractModelItem *> mModelItems;
 					AbstractModelItem *mRootItem;
+					/// Top-level items loaded without their children.
+					QSet<AbstractModelItem *> mUnfetchedItems;
 
 					QString findPropertyName(Id const &id, int const role) const;
 					QModelIndex index(AbstractModelItem const * const item) const;
@@ -58,9 +76,23 @@ namespace qReal {
 					AbstractModelItem * parentAbstractItem(QModelIndex const &parent) const;
 					void removeModelItems(details::modelsImplementation::AbstractModelItem *const root);
 
+					/// Item of an element, read with its diagram if needed. NULL if the element is not in the model.
+					AbstractModelItem *fetchedItem(Id const &id);
+					void fetchSubtree(AbstractModelItem *item);
+
+					/// Removes the item with its subtree from the model only, leaving repository as is.
+					void removeItem(AbstractModelItem *item);
+					void moveItem(AbstractModelItem *item, AbstractModelItem *newParent);
+
 				private:
 					virtual AbstractModelItem *createModelItem(Id const &id, AbstractModelItem *parentItem) const = 0;
 					virtual void init() = 0;
+					/// True if the element is shown by this model, i.e. is logical or graphical.
+					virtual bool isModelElement(Id const &id) const = 0;
+					/// Creates an item of the element without its children and notifies views.
+					virtual AbstractModelItem *loadItem(AbstractModelItem *parentItem, Id const &id) = 0;
+					/// Loads children of the item recursively, skipping elements that already have items.
+					virtual void loadSubtreeFromClient(AbstractModelItem * const parent) = 0;
 					virtual void removeModelItemFromApi(details::modelsImplementation::AbstractModelItem *const root, details::modelsImplementation::AbstractModelItem *child) = 0;
 				};
 
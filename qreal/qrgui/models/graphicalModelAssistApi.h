@@ -52,6 +52,7 @@ public:
 	QString toolTip(Id const &elem) const;
 
 	Id logicalId(Id const &elem) const;
+	/// Graphical elements on diagrams read so far, see GraphicalModel::indexesWithLogicalId().
 	IdList graphicalIdsByLogicalId(Id const &logicalId) const;
 
 	bool isGraphicalId(Id const &id) const;
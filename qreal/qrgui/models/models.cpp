@@ -1,11 +1,18 @@
 #include "models.h"
+#include "repoUndoCommand.h"
+
+#include <QtGui/QUndoStack>
 
 using namespace qReal;
 using namespace models;
 
 Models::Models(QString const &workingCopy, EditorManager const &editorManager)
+	: mEditorManager(editorManager)
+	, mUndoStack(NULL)
 {
 	qrRepo::RepoApi *repoApi = new qrRepo::RepoApi(workingCopy);
+	repoApi->setDefaultPropertiesProvider(this);
+	repoApi->setPropertyValidator(this);
 	mGraphicalModel = new models::details::GraphicalModel(repoApi, editorManager);
 	mLogicalModel = new models::details::LogicalModel(repoApi, editorManager);
 	mRepoApi = repoApi;
@@ -14,10 +21,14 @@ Models::Models(QString const &workingCopy, EditorManager const &editorManager)
 	mGraphicalModel->connectToLogicalModel(mLogicalModel);
 
 	mRepoApi = repoApi;
+	mRepoApi->setJournalListener(this);
 }
 
 Models::~Models()
 {
+	mRepoApi->setJournalListener(NULL);
+	mRepoApi->setDefaultPropertiesProvider(NULL);
+	mRepoApi->setPropertyValidator(NULL);
 	delete mGraphicalModel;
 	delete mLogicalModel;
 	delete mRepoApi;
@@ -68,3 +79,94 @@ void Models::reinit()
 	mLogicalModel->reinit();
 	mGraphicalModel->reinit();
 }
+
+void Models::setUndoStack(QUndoStack *undoStack)
+{
+	mUndoStack = undoStack;
+}
+
+void Models::undo()
+{
+	bool structureChanged = false;
+	IdList const changed = mRepoApi->undo(structureChanged);
+	update(changed, structureChanged);
+}
+
+void Models::redo()
+{
+	bool structureChanged = false;
+	IdList const changed = mRepoApi->redo(structureChanged);
+	update(changed, structureChanged);
+}
+
+void Models::update(IdList const &changedElements, bool structureChanged)
+{
+	// Views may write to repository while following the models, e.g. when a restored
+	// element is placed on a scene. Such writes must keep the history, since this is
+	// called from the undo stack itself.
+	mRepoApi->beginInternalChanges();
+	if (structureChanged) {
+		mLogicalModel->updateStructure(changedElements);
+		mGraphicalModel->updateStructure(changedElements);
+	}
+	mLogicalModel->notifyDataChanged(changedElements);
+	mGraphicalModel->notifyDataChanged(changedElements);
+	mRepoApi->endInternalChanges();
+}
+
+void Models::commandAdded(QString const &description)
+{
+	if (mUndoStack)
+		mUndoStack->push(new RepoUndoCommand(*this, description));
+}
+
+void Models::historyCleared()
+{
+	if (mUndoStack)
+		mUndoStack->clear();
+}
+
+QVariant Models::defaultPropertyValue(Id const &type, QString const &name) const
+{
+	if (name == "from" || name == "to")
+		return Id::rootId().toVariant();
+	if (name == "links" || name == "outgoingConnections" || name == "incomingConnections"
+			|| name == "outgoingUsages" || name == "incomingUsages")
+	{
+		return IdListHelper::toVariant(IdList());
+	}
+
+	// Asked from generators' worker threads too, where the plugin may be unloaded meanwhile
+	if (type.idSize() != 3)
+		return QVariant();
+	QSharedPointer<PropertySchema const> const schema = mEditorManager.propertySchema(type);
+	if (!schema)
+		return QVariant();
+	int const slot = schema->slot(name);
+	return slot >= 0 ? QVariant(schema->defaultValue(slot)) : QVariant();
+}
+
+QStringList Models::defaultPropertyNames(Id const &type) const
+{
+	QStringList result;
+	result << "from" << "to" << "links" << "outgoingConnections" << "incomingConnections"
+			<< "outgoingUsages" << "incomingUsages";
+	if (type.idSize() != 3)
+		return result;
+	QSharedPointer<PropertySchema const> const schema = mEditorManager.propertySchema(type);
+	if (schema)
+		result << schema->names();
+	return result;
+}
+
+bool Models::validate(Id const &type, QString const &name, QVariant const &value
+		, QString &error) const
+{
+	if (type.idSize() != 3 || value.type() != QVariant::String)
+		return true;
+	QSharedPointer<PropertySchema const> const schema = mEditorManager.propertySchema(type);
+	if (!schema)
+		return true;
+	int const slot = schema->slot(name);
+	return slot < 0 || schema->type(slot).checkString(value.toString(), &error);
+}
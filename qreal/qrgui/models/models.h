@@ -4,17 +4,41 @@
 #include "details/logicalModel.h"
 #include "graphicalModelAssistApi.h"
 #include "logicalModelAssistApi.h"
+#include "../../qrrepo/journalListener.h"
+#include "../../qrrepo/defaultPropertiesProvider.h"
+#include "../../qrrepo/propertyValidator.h"
+
+class QUndoStack;
 
 namespace qReal {
 
 namespace models {
 
-class Models
+class Models : public qrRepo::JournalListener, public qrRepo::DefaultPropertiesProvider
+		, public qrRepo::PropertyValidator
 {
 public:
 	explicit Models(QString const &workingCopy, EditorManager const &editorManager);
 	~Models();
 
+	/// Stack which receives a command for every undoable change of the repository.
+	void setUndoStack(QUndoStack *undoStack);
+
+	/// Reverts last change in repository and updates models accordingly.
+	void undo();
+	void redo();
+
+	virtual void commandAdded(QString const &description);
+	virtual void historyCleared();
+
+	/// Defaults of properties every logical element has and of properties described in metamodel.
+	virtual QVariant defaultPropertyValue(Id const &type, QString const &name) const;
+	virtual QStringList defaultPropertyNames(Id const &type) const;
+
+	/// Checks values of properties described in metamodel against their compiled types.
+	virtual bool validate(Id const &type, QString const &name, QVariant const &value
+			, QString &error) const;
+
 	QAbstractItemModel* graphicalModel() const;
 	QAbstractItemModel* logicalModel() const;
 
@@ -31,9 +55,13 @@ public:
 	void reinit();
 
 private:
+	void update(IdList const &changedElements, bool structureChanged);
+
 	models::details::GraphicalModel *mGraphicalModel;
 	models::details::LogicalModel *mLogicalModel;
 	qrRepo::RepoControlInterface *mRepoApi;
+	EditorManager const &mEditorManager;
+	QUndoStack *mUndoStack;
 };
 
 }
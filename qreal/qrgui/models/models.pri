@@ -10,6 +10,7 @@ HEADERS += \
 	models/details/modelsImplementation/abstractView.h \
 	models/details/modelsAssistApi.h \
 	models/models.h \
+	models/repoUndoCommand.h \
 	models/graphicalModelAssistApi.h \
 	models/logicalModelAssistApi.h
 
@@ -24,5 +25,6 @@ SOURCES += models/details/graphicalModel.cpp \
 	models/details/modelsImplementation/abstractView.cpp \
 	models/details/modelsAssistApi.cpp \
 	models/models.cpp \
+	models/repoUndoCommand.cpp \
 	models/graphicalModelAssistApi.cpp \
 	models/logicalModelAssistApi.cpp
@@ -0,0 +1,23 @@
+#include "repoUndoCommand.h"
+#include "models.h"
+
+using namespace qReal;
+using namespace models;
+
+RepoUndoCommand::RepoUndoCommand(Models &models, QString const &text)
+	: QUndoCommand(text), mModels(models), mDone(true)
+{
+}
+
+void RepoUndoCommand::undo()
+{
+	mModels.undo();
+	mDone = false;
+}
+
+void RepoUndoCommand::redo()
+{
+	if (!mDone)
+		mModels.redo();
+	mDone = true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QtGui/QUndoCommand>
+
+namespace qReal {
+
+namespace models {
+
+class Models;
+
+/// Item of main window undo stack, corresponds to a command in repository journal.
+/// The change is already made when the command is pushed, so the first redo() does nothing.
+class RepoUndoCommand : public QUndoCommand
+{
+public:
+	RepoUndoCommand(Models &models, QString const &text);
+
+	virtual void undo();
+	virtual void redo();
+
+private:
+	Models &mModels;
+	bool mDone;
+};
+
+}
+
+}
@@ -1,35 +1,74 @@
 #include "hascolParser.h"
 
 #include "../../editorManager/editorManager.h"
+#include "../../kernel/exception/exception.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QUuid>
-#include <QtXml/QDomDocument>
 #include <QtCore/QProcess>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtCore/QThread>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QCryptographicHash>
 
 #include "math.h"
 
-#include "../../../utils/xmlUtils.h"
+#include "../../../qrrepo/repoCommand.h"
 
 using namespace qReal;
 using namespace parsers;
 using gui::ErrorReporter;
 
 HascolParser::HascolParser(qrRepo::LogicalRepoApi &api, EditorManager const &editorManager)
-	: mApi(api), mEditorManager(editorManager), mErrorReporter()
+	: mUnchangedProcesses(0), mImportedProcesses(0)
+	, mApi(api), mEditorManager(editorManager), mErrorReporter()
 {
 }
 
 ErrorReporter &HascolParser::parse(QStringList const &files)
 {
+	qrRepo::RepoCommand command(mApi, "Import Hascol");
+
 	mImportedPortMappingDiagramId = initDiagram("Imported port mapping", "HascolPortMapping_HascolPortMappingDiagram");
 	mImportedStructureDiagramId = initDiagram("Imported structure", "HascolStructure_HascolStructureDiagram");
 	mApi.setProperty(mImportedStructureDiagramId, "output directory", "");
+	collectImportedProcesses();
+
+	// Preprocessors of next files run while output of the oldest one is imported,
+	// so processes are imported in the order of files.
+	int const maxJobs = qMax(1, QThread::idealThreadCount());
+	QList<QPair<QString, QProcess *> > running;
+	int next = 0;
+	bool allPreprocessed = true;
+	while (next < files.size() || !running.isEmpty()) {
+		while (running.size() < maxJobs && next < files.size()) {
+			running << qMakePair(files[next], startPreprocessor(files[next]));
+			++next;
+		}
+		QPair<QString, QProcess *> const job = running.takeFirst();
+		if (finishPreprocessing(job.second, job.first))
+			parseFile(job.first + ".xml");
+		else
+			allPreprocessed = false;
+	}
 
-	foreach (QString file, files) {
-		preprocessFile(file);
-		parseFile(file + ".xml");
+	// Processes of a file that was not preprocessed are not met, but they are not gone
+	int removed = 0;
+	if (allPreprocessed) {
+		foreach (Id const &process, mOldProcessesOnAPortMap)
+			removeProcess(mImportedPortMappingDiagramId, process);
+		foreach (Id const &process, mOldProcessesOnAStructure)
+			removeProcess(mImportedStructureDiagramId, process);
+		removed = mOldProcessesOnAStructure.size();
+	} else {
+		mErrorReporter.addError("Some files were not preprocessed, processes not met are kept");
 	}
+	mErrorReporter.addInformation(QString("Imported %1 processes, %2 of them unchanged, %3 removed")
+			.arg(mImportedProcesses).arg(mUnchangedProcesses).arg(removed));
+	mOldProcessesOnAPortMap.clear();
+	mOldProcessesOnAStructure.clear();
 
 	doPortMappingLayout();
 	doStructureLayout();
@@ -37,31 +76,66 @@ ErrorReporter &HascolParser::parse(QStringList const &files)
 	return mErrorReporter;
 }
 
-void HascolParser::preprocessFile(QString const &fileName)
+QProcess *HascolParser::startPreprocessor(QString const &fileName)
 {
-	QProcess preprocessor;
-	QStringList args;
+	QFileInfo const source(fileName);
+	QFileInfo const output(fileName + ".xml");
+	if (output.exists() && output.lastModified() >= source.lastModified())
+		return NULL;
 
+	QStringList args;
 	QString const coolRoot = QProcessEnvironment::systemEnvironment().value("COOL_ROOT", ".");
 	args << "-I" << coolRoot + "/signature";
 	args << fileName;
 	args << "-o" << fileName + ".xml";
 
-	preprocessor.start("hascolStructur2xml.byte.exe", args);
-	preprocessor.waitForFinished();
+	QSettings settings("SPbSU", "QReal");
+	QString const program = settings.value("hascolPreprocessor", "hascolStructur2xml.byte.exe").toString();
+
+	QProcess *preprocessor = new QProcess();
+	preprocessor->start(program, args);
+	return preprocessor;
+}
+
+bool HascolParser::finishPreprocessing(QProcess *preprocessor, QString const &fileName)
+{
+	if (!preprocessor) {
+		mErrorReporter.addInformation(QString("File %1 was not changed since last preprocessing").arg(fileName));
+		return true;
+	}
 
-	if (preprocessor.exitStatus() == QProcess::CrashExit)
+	QSettings settings("SPbSU", "QReal");
+	int const timeout = settings.value("hascolPreprocessorTimeout", 60000).toInt();
+	bool const finished = preprocessor->waitForFinished(timeout);
+	bool succeeded = false;
+	if (preprocessor->error() == QProcess::FailedToStart) {
+		mErrorReporter.addError("Hascol preprocessor could not be started.");
+	} else if (!finished) {
+		preprocessor->kill();
+		preprocessor->waitForFinished(1000);
+		mErrorReporter.addError(QString("Hascol preprocessor did not finish %1 in %2 ms").arg(fileName).arg(timeout));
+	} else if (preprocessor->exitStatus() == QProcess::CrashExit) {
 		mErrorReporter.addError("Hascol preprocessor crashed.");
-	else if (preprocessor.exitCode() != 0)
-		mErrorReporter.addError(QString("Hascol preprocessor finished with error code %1").arg(preprocessor.exitCode()));
+	} else if (preprocessor->exitCode() != 0) {
+		mErrorReporter.addError(QString("Hascol preprocessor finished with error code %1").arg(preprocessor->exitCode()));
+	} else {
+		succeeded = true;
+		mErrorReporter.addInformation(QString("Preprocessed file %1").arg(fileName));
+	}
 
-	mErrorReporter.addInformation(QString("Preprocessed file %1").arg(fileName));
-	QByteArray standardOutput = preprocessor.readAllStandardOutput();
+	// Output left by a failed run must not look up to date next time
+	if (!succeeded)
+		QFile::remove(fileName + ".xml");
+
+	QByteArray standardOutput = preprocessor->readAllStandardOutput();
 	if (!standardOutput.isEmpty())
 		mErrorReporter.addInformation(QString("Output stream: %1").arg(standardOutput.data()));
-	QByteArray standardError = preprocessor.readAllStandardError();
+	QByteArray standardError = preprocessor->readAllStandardError();
 	if (!standardError.isEmpty())
 		mErrorReporter.addInformation(QString("Error stream: %1").arg(standardError.data()));
+
+	delete preprocessor;
+	return succeeded;
 }
 
 Id HascolParser::initDiagram(QString const &diagramName, QString const &diagramType)
@@ -70,12 +144,8 @@ Id HascolParser::initDiagram(QString const &diagramName, QString const &diagramT
 	Id const diagramTypeId = Id("HascolMetamodel", "HascolPortMapping", diagramType);
 
 	foreach(Id element, mApi.children(Id::rootId())) {
-		if (element.type() == diagramTypeId && mApi.name(element) == diagramName) {
+		if (element.type() == diagramTypeId && mApi.name(element) == diagramName)
 			result = element;
-			// full exterminatus
-			// should track changed elements, but it's tricky
-			mApi.removeChildren(result);
-		}
 	}
 
 	if (result == Id())
@@ -83,121 +153,200 @@ Id HascolParser::initDiagram(QString const &diagramName, QString const &diagramT
 	return result;
 }
 
-Id HascolParser::addElement(Id const &parent, Id const &elementType, QString const &name)
+void HascolParser::collectImportedProcesses()
+{
+	foreach (Id const &process, mApi.children(mImportedPortMappingDiagramId))
+		mOldProcessesOnAPortMap.insert(mApi.name(process), process);
+	foreach (Id const &process, mApi.children(mImportedStructureDiagramId))
+		mOldProcessesOnAStructure.insert(mApi.name(process), process);
+}
+
+void HascolParser::removeProcess(Id const &diagram, Id const &process)
+{
+	mApi.removeChild(diagram, process);
+	mApi.removeElement(process);
+}
+
+Id HascolParser::addElement(Id const &parent, Id const &elementType, QString const &name
+		, QMap<QString, QVariant> properties)
 {
 	Id element(elementType, QUuid::createUuid().toString());
 
-	mApi.addChild(parent, element);
-	mApi.setProperty(element, "name", name);
-	mApi.setProperty(element, "from", Id::rootId().toVariant());
-	mApi.setProperty(element, "to", Id::rootId().toVariant());
-	mApi.setProperty(element, "fromPort", 0.0);
-	mApi.setProperty(element, "toPort", 0.0);
-	mApi.setProperty(element, "links", IdListHelper::toVariant(IdList()));
+	properties.insert("name", name);
+	properties.insert("from", Id::rootId().toVariant());
+	properties.insert("to", Id::rootId().toVariant());
+	properties.insert("fromPort", 0.0);
+	properties.insert("toPort", 0.0);
+	properties.insert("links", IdListHelper::toVariant(IdList()));
 
-	mApi.setProperty(element, "position", QPointF(0,0));
-	mApi.setProperty(element, "configuration", QVariant(QPolygon()));
+	properties.insert("position", QPointF(0,0));
+	properties.insert("configuration", QVariant(QPolygon()));
+
+	mApi.addChild(parent, element);
+	try {
+		mApi.setProperties(element, properties);
+	} catch (Exception const &e) {
+		// Element stays with default properties, the rest of the import goes on
+		mErrorReporter.addError(e.message());
+	}
 
 	return element;
 }
 
 void HascolParser::parseFile(QString const& fileName)
 {
-	QDomDocument doc = utils::xmlUtils::loadDocument(fileName);
-
-	QDomNodeList list = doc.elementsByTagName("md");
-	for (unsigned i = 0; i < list.length(); ++i) {
-		QDomElement md = list.at(i).toElement();
-		QDomNodeList children = md.childNodes();
-		for(unsigned j = 0; j < children.length(); ++j) {
-			QDomElement child = children.at(j).toElement();
-			if (child.isElement()) {
-				parseProcess(child.toElement());
-			}
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		mErrorReporter.addError(QString("Can not open preprocessed file %1").arg(fileName));
+		return;
+	}
+
+	QXmlStreamReader reader(&file);
+	while (!reader.atEnd()) {
+		reader.readNext();
+		if (reader.isStartElement() && reader.name() == "md") {
+			while (reader.readNextStartElement())
+				importProcess(readProcess(reader));
 		}
 	}
+
+	if (reader.hasError()) {
+		mErrorReporter.addError(QString("%1, line %2: %3").arg(fileName)
+				.arg(reader.lineNumber()).arg(reader.errorString()));
+	}
+}
+
+HascolParser::Process HascolParser::readProcess(QXmlStreamReader &reader) const
+{
+	Process process;
+	process.name = reader.name().toString();
+	process.functor = reader.attributes().value("isFunctor") == "1";
+
+	// Port lists may be nested anywhere inside of a process element.
+	int depth = 1;
+	while (depth > 0 && !reader.atEnd()) {
+		reader.readNext();
+		if (reader.isEndElement()) {
+			--depth;
+		} else if (reader.isStartElement()) {
+			if (reader.name() == "ins")
+				process.ins << readPorts(reader);
+			else if (reader.name() == "outs")
+				process.outs << readPorts(reader);
+			else
+				++depth;
+		}
+	}
+	return process;
+}
+
+QList<HascolParser::Port> HascolParser::readPorts(QXmlStreamReader &reader) const
+{
+	QList<Port> result;
+	while (reader.readNextStartElement()) {
+		Port port;
+		port.name = reader.name().toString();
+		QStringList parameters;
+		foreach (QXmlStreamAttribute const &attribute, reader.attributes()) {
+			QString paramValue = attribute.value().toString();
+			// removing explicit qualification for bincompl since it's included automatically
+			paramValue = paramValue.remove("bincompl::");
+			parameters << paramValue;
+		}
+		port.parameters = parameters.join(", ");
+		result << port;
+		reader.skipCurrentElement();
+	}
+	return result;
 }
 
-void HascolParser::initClassifierFields(Id const &classifier)
+QString HascolParser::Process::sourceHash() const
+{
+	QStringList description;
+	description << name << (functor ? "functor" : "process");
+	foreach (Port const &port, ins)
+		description << "in " + port.name + "(" + port.parameters + ")";
+	foreach (Port const &port, outs)
+		description << "out " + port.name + "(" + port.parameters + ")";
+	return QCryptographicHash::hash(description.join("\n").toUtf8(), QCryptographicHash::Md5).toHex();
+}
+
+void HascolParser::addClassifierFields(QMap<QString, QVariant> &properties)
 {
 	// TODO: remove from here. make something like auto-completion of fields
-	mApi.setProperty(classifier, "clientDependency", "");
-	mApi.setProperty(classifier, "elementImport", "");
-	mApi.setProperty(classifier, "generalization", "");
-	mApi.setProperty(classifier, "implementation", "");
-	mApi.setProperty(classifier, "isAbstract", "");
-	mApi.setProperty(classifier, "redefinedClassifier", "");
-	mApi.setProperty(classifier, "substitution", "");
-	mApi.setProperty(classifier, "powertypeExtent", "");
-	mApi.setProperty(classifier, "isLeaf", "");
-	mApi.setProperty(classifier, "ownedRule", "");
-	mApi.setProperty(classifier, "packageImport", "");
-	mApi.setProperty(classifier, "visibility", "");
-	mApi.setProperty(classifier, "ownedComment", "");
+	properties.insert("clientDependency", "");
+	properties.insert("elementImport", "");
+	properties.insert("generalization", "");
+	properties.insert("implementation", "");
+	properties.insert("isAbstract", "");
+	properties.insert("redefinedClassifier", "");
+	properties.insert("substitution", "");
+	properties.insert("powertypeExtent", "");
+	properties.insert("isLeaf", "");
+	properties.insert("ownedRule", "");
+	properties.insert("packageImport", "");
+	properties.insert("visibility", "");
+	properties.insert("ownedComment", "");
 }
 
-void HascolParser::parseProcess(QDomElement const &element)
+void HascolParser::importProcess(Process const &process)
 {
-	QString const name = element.nodeName();
-	bool const functor = element.attribute("isFunctor", "0") == "1";
+	QString const name = process.name;
+	QString const nameOnAPortMap = "a" + name + " : " + name;
+	QString const hash = process.sourceHash();
+	++mImportedProcesses;
+
+	Id const oldOnAPortMap = mOldProcessesOnAPortMap.take(nameOnAPortMap);
+	Id const oldOnAStructure = mOldProcessesOnAStructure.take(name);
+	if (oldOnAPortMap != Id() && oldOnAStructure != Id()
+			&& mApi.hasProperty(oldOnAStructure, "sourceHash")
+			&& mApi.stringProperty(oldOnAStructure, "sourceHash") == hash)
+	{
+		++mUnchangedProcesses;
+		return;
+	}
+	if (oldOnAPortMap != Id())
+		removeProcess(mImportedPortMappingDiagramId, oldOnAPortMap);
+	if (oldOnAStructure != Id())
+		removeProcess(mImportedStructureDiagramId, oldOnAStructure);
 
 	Id const portMappingBaseId = Id("HascolMetamodel", "HascolPortMapping");
 	Id const structureBaseId = Id("HascolMetamodel", "HascolPortMapping");
 
-	Id portMappingElementType = functor ? Id(portMappingBaseId, "HascolPortMapping_FunctorInstance")
+	Id portMappingElementType = process.functor ? Id(portMappingBaseId, "HascolPortMapping_FunctorInstance")
 		: Id(portMappingBaseId, "HascolPortMapping_ProcessInstance");
 
-	Id structureElementType = functor ? Id(structureBaseId, "HascolStructure_Functor")
+	Id structureElementType = process.functor ? Id(structureBaseId, "HascolStructure_Functor")
 		: Id(structureBaseId, "HascolStructure_Process");
 
-	Id processOnAPortMap = addElement(mImportedPortMappingDiagramId, portMappingElementType, "a" + name + " : " + name);
-	Id processOnAStructure = addElement(mImportedStructureDiagramId, structureElementType, name);
-	initClassifierFields(processOnAStructure);
+	Id processOnAPortMap = addElement(mImportedPortMappingDiagramId, portMappingElementType, nameOnAPortMap);
 
-	QDomNodeList insList = element.elementsByTagName("ins");
-	for (unsigned i = 0; i < insList.length(); ++i) {
-		QDomElement ins = insList.at(i).toElement();
-		parsePorts(ins.childNodes(), "in", processOnAPortMap, processOnAStructure);
-	}
+	QMap<QString, QVariant> structureProperties;
+	addClassifierFields(structureProperties);
+	structureProperties.insert("sourceHash", hash);
+	Id processOnAStructure = addElement(mImportedStructureDiagramId, structureElementType, name, structureProperties);
 
-	QDomNodeList outsList = element.elementsByTagName("outs");
-	for (unsigned i = 0; i < outsList.length(); ++i) {
-		QDomElement outs = outsList.at(i).toElement();
-		parsePorts(outs.childNodes(), "out", processOnAPortMap, processOnAStructure);
-	}
+	importPorts(process.ins, "in", processOnAPortMap, processOnAStructure);
+	importPorts(process.outs, "out", processOnAPortMap, processOnAStructure);
 }
 
-void HascolParser::parsePorts(QDomNodeList const &ports, QString const &direction
+void HascolParser::importPorts(QList<Port> const &ports, QString const &direction
 	, Id const &parentOnAPortMap, Id const &parentOnAStructure)
 {
-	for (unsigned i = 0; i < ports.length(); ++i) {
-		Id const portMappingBaseId = Id("HascolMetamodel", "HascolPortMapping");
-		Id const structureBaseId = Id("HascolMetamodel", "HascolPortMapping");
-
-		QDomElement port =  ports.at(i).toElement();
-		QString portName = port.nodeName();
-		QString parameters;
-		QDomNamedNodeMap attrs = port.attributes();
-		for (int i = 0; i < attrs.count(); ++i) {
-			QDomAttr param = attrs.item(i).toAttr();
-			QString paramValue = param.value();
-			// removing explicit qualification for bincompl since it's included automatically
-			paramValue = paramValue.remove("bincompl::");
-			parameters += paramValue + ", ";
-		}
-		parameters.chop(2);
+	Id const portMappingBaseId = Id("HascolMetamodel", "HascolPortMapping");
+	Id const structureBaseId = Id("HascolMetamodel", "HascolPortMapping");
+
+	foreach (Port const &port, ports) {
+		QMap<QString, QVariant> properties;
+		properties.insert("direction", direction);
 
 		// ports should be without arguments here
 		Id attrType = Id(portMappingBaseId, "HascolPortMapping_Port");
-		Id portId = addElement(parentOnAPortMap, attrType, portName);
-		mApi.setProperty(portId, "direction", direction);
-
-		portName += "(" + parameters + ")";
+		addElement(parentOnAPortMap, attrType, port.name, properties);
 
+		addClassifierFields(properties);
 		Id structureAttrType = Id(structureBaseId, "HascolStructure_ProcessOperation");
-		Id plugId = addElement(parentOnAStructure, structureAttrType, portName);
-		mApi.setProperty(plugId, "direction", direction);
-		initClassifierFields(plugId);
+		addElement(parentOnAStructure, structureAttrType, port.name + "(" + port.parameters + ")", properties);
 	}
 }
 
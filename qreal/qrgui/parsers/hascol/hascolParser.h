@@ -1,12 +1,17 @@
 #pragma once
 
 #include <QtCore/QString>
-#include <QtXml/QDomElement>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QVariant>
 
 #include "../../kernel/ids.h"
 #include "../../mainwindow/errorReporter.h"
 #include "../../../qrrepo/logicalRepoApi.h"
 
+class QProcess;
+class QXmlStreamReader;
+
 namespace qReal {
 
 	class EditorManager;
@@ -18,23 +23,59 @@ namespace qReal {
 		public:
 			explicit HascolParser(qrRepo::LogicalRepoApi &api, EditorManager const &editorManager);
 
+			/// Preprocesses files by a pool of preprocessor processes and imports processes
+			/// described in them. Processes imported earlier are kept untouched if their
+			/// description has not changed and removed if they are not described anymore.
 			gui::ErrorReporter &parse(QStringList const &files);
 		private:
+			struct Port
+			{
+				QString name;
+				QString parameters;
+			};
+
+			struct Process
+			{
+				QString name;
+				bool functor;
+				QList<Port> ins;
+				QList<Port> outs;
+
+				QString sourceHash() const;
+			};
+
 			Id mImportedPortMappingDiagramId;
 			Id mImportedStructureDiagramId;
 
+			/// Processes imported earlier and not met in current import yet, by their names.
+			QHash<QString, Id> mOldProcessesOnAPortMap;
+			QHash<QString, Id> mOldProcessesOnAStructure;
+			int mUnchangedProcesses;
+			int mImportedProcesses;
+
 			qrRepo::LogicalRepoApi &mApi;
 			EditorManager const &mEditorManager;
 			gui::ErrorReporter mErrorReporter;
 
 			Id initDiagram(QString const &diagramName, QString const &diagramType);
-			Id addElement(Id const &parent, Id const &elementType, QString const &name);
-			void preprocessFile(QString const &fileName);
+			void collectImportedProcesses();
+			void removeProcess(Id const &diagram, Id const &process);
+			Id addElement(Id const &parent, Id const &elementType, QString const &name
+					, QMap<QString, QVariant> properties = QMap<QString, QVariant>());
+
+			/// Starts preprocessor for a file, returns NULL if its output is newer than the file.
+			QProcess *startPreprocessor(QString const &fileName);
+			/// Waits for the preprocessor a time set by "hascolPreprocessorTimeout" setting,
+			/// returns false if the output of the file shall not be parsed.
+			bool finishPreprocessing(QProcess *preprocessor, QString const &fileName);
+
 			void parseFile(QString const &fileName);
-			void parseProcess(QDomElement const &element);
-			void parsePorts(QDomNodeList const &ports, QString const &direction
+			Process readProcess(QXmlStreamReader &reader) const;
+			QList<Port> readPorts(QXmlStreamReader &reader) const;
+			void importProcess(Process const &process);
+			void importPorts(QList<Port> const &ports, QString const &direction
 				, Id const &parentOnAPortMap, Id const &parentOnAStructure);
-			void initClassifierFields(Id const &classifier);
+			static void addClassifierFields(QMap<QString, QVariant> &properties);
 
 			void doLayout(Id const &diagram, unsigned cellWidth, unsigned cellHeight);
 			void doPortMappingLayout();
@@ -0,0 +1,58 @@
+#!/bin/sh
+# Offline stand-in for hascolStructur2xml.byte.exe, for testing Hascol import without
+# the COOL toolchain. Point the "hascolPreprocessor" setting of QReal to this script.
+#
+# Usage: hascolStructur2xml.sh -I <signature dir> <file> -o <output file>
+#
+# Understands a tiny subset of Hascol, one declaration per line:
+#   process Name        functor Name
+#   in port Type...     out port Type...
+# HASCOL_STUB_DELAY=<seconds> makes it sleep first, to emulate slow preprocessing.
+
+input=""
+output=""
+while [ $# -gt 0 ]; do
+	case "$1" in
+		-I) shift ;;
+		-o) shift; output="$1" ;;
+		*) input="$1" ;;
+	esac
+	shift
+done
+
+if [ -z "$input" ] || [ -z "$output" ]; then
+	echo "usage: $0 -I <signature dir> <file> -o <output file>" >&2
+	exit 2
+fi
+if [ ! -r "$input" ]; then
+	echo "can not read $input" >&2
+	exit 1
+fi
+
+[ -n "$HASCOL_STUB_DELAY" ] && sleep "$HASCOL_STUB_DELAY"
+
+awk '
+function closeProcess() {
+	if (process == "")
+		return
+	print "<" process " isFunctor=\"" functor "\"><ins>" ins "</ins><outs>" outs "</outs></" process ">"
+	process = ""
+}
+function port(    result, i) {
+	result = "<" $2
+	for (i = 3; i <= NF; ++i)
+		result = result " p" (i - 2) "=\"" $i "\""
+	return result "/>"
+}
+BEGIN { print "<md>" }
+$1 == "process" || $1 == "functor" {
+	closeProcess()
+	process = $2
+	functor = $1 == "functor" ? 1 : 0
+	ins = ""
+	outs = ""
+}
+$1 == "in" && process != "" { ins = ins port() }
+$1 == "out" && process != "" { outs = outs port() }
+END { closeProcess(); print "</md>" }
+' "$input" > "$output"
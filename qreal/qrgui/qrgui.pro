@@ -32,6 +32,9 @@ if (equals(QMAKE_CXX, "g++") : !macx) {
 # Путь до библиотеки с АПИ. Где-нибудь она найдётся...Path to the API library
 LIBS += -Ldebug -lqrrepo -Lrelease -lqrrepo -L. -lqrrepo -lqrmc
 
+# Types and constraints of properties
+LIBS += -L../typelib -ltypelib
+
 # Graphical elements
 include (umllib/umllib.pri)
 
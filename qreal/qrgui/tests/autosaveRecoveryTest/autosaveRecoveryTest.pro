@@ -0,0 +1,19 @@
+# Regression test: changes made with autosave enabled survive a crash of the application.
+# Usage: autosaveRecoveryTest [ELEMENTS=2000]
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT += xml
+QT -= gui
+OBJECTS_DIR = .obj
+
+QRGUI = ../..
+
+LIBS += -L$$QRGUI -lqrrepo
+
+!macx {
+	QMAKE_LFLAGS="-Wl,-O1,-rpath,$$QRGUI"
+}
+
+SOURCES += \
+	main.cpp \
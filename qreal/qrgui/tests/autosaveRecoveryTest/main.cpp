@@ -0,0 +1,125 @@
+#include "../../../qrrepo/repoApi.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+
+#include <cstdlib>
+
+using namespace qReal;
+
+namespace {
+
+bool check(bool condition, QString const &message)
+{
+	if (!condition)
+		qDebug() << "FAILED:" << message;
+	return condition;
+}
+
+/// Edits the save with autosave enabled and crashes without saving, a background
+/// checkpoint may be interrupted as well.
+void editAndCrash(QString const &repoDir)
+{
+	qrRepo::RepoApi repo(repoDir);
+	repo.setAutosaveEnabled(true);
+	IdList const elements = repo.children(repo.children(Id::rootId()).first());
+
+	repo.beginCommand("rename");
+	repo.setName(elements.at(0), "renamed");
+	repo.endCommand();
+
+	repo.beginCommand("add");
+	Id const added = Id::createElementId("Editor", "Diagram", "Node");
+	repo.addChild(repo.parent(elements.at(0)), added);
+	repo.setName(added, "added");
+	repo.endCommand();
+
+	repo.checkpoint();
+
+	repo.beginCommand("remove");
+	repo.removeChild(repo.parent(elements.at(1)), elements.at(1));
+	repo.removeElement(elements.at(1));
+	repo.endCommand();
+
+	repo.beginCommand("rename after checkpoint");
+	repo.setName(elements.last(), "renamed after checkpoint");
+	repo.endCommand();
+
+	repo.flushJournal();
+	abort();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	if (arguments.size() > 2 && arguments[1] == "--crash") {
+		editAndCrash(arguments[2]);
+		return 1;
+	}
+	int const elementsCount = arguments.size() > 1 ? arguments[1].toInt() : 2000;
+
+	QString const repoDir = QDir::temp().absoluteFilePath("qrealAutosaveRecoveryTestRepo");
+	IdList elements;
+	{
+		qrRepo::RepoApi repo(repoDir);
+		repo.exterminate();
+		Id const diagram = Id::createElementId("Editor", "Diagram", "DiagramNode");
+		repo.addChild(Id::rootId(), diagram);
+		for (int i = 0; i < elementsCount; ++i) {
+			Id const element = Id::createElementId("Editor", "Diagram", "Node");
+			repo.addChild(diagram, element);
+			repo.setName(element, "node" + QString::number(i));
+			elements << element;
+		}
+		repo.saveAll();
+	}
+
+	QProcess::execute(app.applicationFilePath(), QStringList() << "--crash" << repoDir);
+
+	bool ok = true;
+	{
+		qrRepo::RepoApi repo(repoDir);
+		ok &= check(repo.wasRecovered(), "changes are not restored from the journal");
+		ok &= check(repo.name(elements.first()) == "renamed", "change made before the checkpoint is lost");
+		ok &= check(repo.name(elements.last()) == "renamed after checkpoint", "change made after the checkpoint is lost");
+		ok &= check(!repo.exist(elements.at(1)), "removed element is restored");
+
+		IdList const children = repo.children(repo.parent(elements.first()));
+		ok &= check(children.size() == elementsCount, "expected " + QString::number(elementsCount)
+				+ " elements on the diagram, got " + QString::number(children.size()));
+		ok &= check(!children.contains(elements.at(1)), "removed element is still a child of the diagram");
+		ok &= check(repo.name(children.last()) == "added", "added element is lost");
+
+		// Files of version control and such live in the working dir next to the tree
+		QDir().mkpath(repoDir + "/save/.svn");
+		QFile entries(repoDir + "/save/.svn/entries");
+		entries.open(QIODevice::WriteOnly);
+		entries.close();
+		repo.saveAll();
+	}
+	ok &= check(QFile::exists(repoDir + "/save/.svn/entries"), "save removes other contents of the working dir");
+
+	// Crash between the renames of a checkpoint leaves the new tree in the staging dir
+	QDir().mkpath(repoDir + "/save/checkpoint");
+	QDir().rename(repoDir + "/save/tree", repoDir + "/save/checkpoint/tree");
+	{
+		qrRepo::RepoApi repo(repoDir);
+		ok &= check(repo.elementsCount() == elementsCount + 2, "save is lost after an interrupted checkpoint");
+		ok &= check(!repo.wasRecovered(), "saved changes are replayed again");
+		ok &= check(repo.name(elements.first()) == "renamed", "recovered change is not saved");
+		repo.exterminate();
+	}
+	ok &= check(QDir(repoDir + "/save.journal").entryList(QStringList("*.wal"), QDir::Files).isEmpty()
+			, "journal is not dropped after a save");
+	QFile::remove(repoDir + "/save/.svn/entries");
+	QDir().rmdir(repoDir + "/save/.svn");
+
+	qDebug() << (ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+# Regression test: Java generation of deeply nested if/while activity diagrams.
+# Usage: javaGeneratorTest [DEPTH=300]
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT += xml
+QT -= gui
+OBJECTS_DIR = .obj
+
+QRGUI = ../..
+
+LIBS += -L$$QRGUI -lqrrepo
+
+!macx {
+	QMAKE_LFLAGS="-Wl,-O1,-rpath,$$QRGUI"
+}
+
+HEADERS += \
+	$$QRGUI/generators/java/javaHandler.h \
+	$$QRGUI/generators/java/controlFlowGraph.h \
+	$$QRGUI/../utils/outFile.h \
+
+SOURCES += \
+	main.cpp \
+	$$QRGUI/generators/java/javaHandler.cpp \
+	$$QRGUI/generators/java/controlFlowGraph.cpp \
+	$$QRGUI/../utils/outFile.cpp \
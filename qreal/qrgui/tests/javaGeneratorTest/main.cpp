@@ -0,0 +1,192 @@
+#include "../../generators/java/javaHandler.h"
+#include "../../../qrrepo/repoApi.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTime>
+
+using namespace qReal;
+
+namespace {
+
+/// Link properties the editor resolves from defaults. Elements built here never store them.
+class LinkDefaults : public qrRepo::DefaultPropertiesProvider
+{
+public:
+	virtual QVariant defaultPropertyValue(Id const &type, QString const &name) const
+	{
+		if (name == "from" || name == "to")
+			return Id::rootId().toVariant();
+		if (defaultPropertyNames(type).contains(name))
+			return IdListHelper::toVariant(IdList());
+		return QVariant();
+	}
+
+	virtual QStringList defaultPropertyNames(Id const &type) const
+	{
+		Q_UNUSED(type)
+		QStringList result;
+		result << "from" << "to" << "links" << "outgoingConnections" << "incomingConnections"
+				<< "outgoingUsages" << "incomingUsages";
+		return result;
+	}
+};
+
+// Activity diagram of one method: ifs and while loops nested into each other in turn.
+// Merge Nodes are not connected to their Decision Nodes, the generator has to find them itself.
+class DiagramBuilder
+{
+public:
+	DiagramBuilder(qrRepo::RepoApi &repo, Id const &diagram)
+		: mRepo(repo), mDiagram(diagram), mIfs(0), mLoops(0)
+	{
+	}
+
+	Id node(QString const &type, QString const &name)
+	{
+		Id const id = Id::createElementId("Editor", "ActivityDiagram", type);
+		mRepo.addChild(mDiagram, id);
+		mRepo.setName(id, name);
+		return id;
+	}
+
+	void link(Id const &from, Id const &to, QString const &guard)
+	{
+		Id const id = Id::createElementId("Editor", "ActivityDiagram", "ActivityDiagram_ControlFlow");
+		mRepo.addChild(mDiagram, id);
+		mRepo.setFrom(id, from);
+		mRepo.setTo(id, to);
+		mRepo.setProperty(id, "guard", guard);
+	}
+
+	/// Builds a construct of the given depth after previous, returns the node the flow leaves it from.
+	Id build(Id const &previous, QString const &guard, int depth)
+	{
+		if (depth == 0) {
+			Id const action = node("ActivityDiagram_Action", "i++;");
+			link(previous, action, guard);
+			return action;
+		}
+
+		Id const decision = node("ActivityDiagram_DecisionNode", "");
+		link(previous, decision, guard);
+		if (depth % 2 == 1) {
+			++mIfs;
+			Id const thenEnd = build(decision, "i > " + QString::number(depth), depth - 1);
+			Id const elseAction = node("ActivityDiagram_Action", "i--;");
+			link(decision, elseAction, "else");
+			Id const merge = node("ActivityDiagram_MergeNode", "");
+			link(thenEnd, merge, "");
+			link(elseAction, merge, "");
+			return merge;
+		}
+
+		++mLoops;
+		Id const bodyEnd = build(decision, "i < " + QString::number(depth), depth - 1);
+		link(bodyEnd, decision, "");
+		return decision;
+	}
+
+	int ifs() const
+	{
+		return mIfs;
+	}
+
+	int loops() const
+	{
+		return mLoops;
+	}
+
+private:
+	qrRepo::RepoApi &mRepo;
+	Id const mDiagram;
+	int mIfs;
+	int mLoops;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	int const depth = arguments.size() > 1 ? arguments[1].toInt() : 300;
+
+	QDir const temp = QDir::temp();
+	QString const outputDir = temp.absoluteFilePath("qrealJavaGeneratorTest");
+	temp.mkpath(outputDir);
+	LinkDefaults defaults;
+	qrRepo::RepoApi repo(temp.absoluteFilePath("qrealJavaGeneratorTestRepo"));
+	repo.exterminate();
+	repo.setDefaultPropertiesProvider(&defaults);
+
+	Id const classDiagram = Id::createElementId("Editor", "ClassDiagram", "ClassDiagram_ClassDiagramNode");
+	repo.addChild(Id::rootId(), classDiagram);
+	Id const classId = Id::createElementId("Editor", "ClassDiagram", "ClassDiagram_Class");
+	repo.addChild(classDiagram, classId);
+	repo.setName(classId, "Nested");
+	Id const method = Id::createElementId("Editor", "ClassDiagram", "ClassDiagram_ClassMethod");
+	repo.addChild(classId, method);
+	repo.setName(method, "run");
+	repo.setProperty(method, "type", "void");
+
+	Id const activityDiagram = Id::createElementId("Editor", "ActivityDiagram", "ActivityDiagram_ActivityDiagramNode");
+	repo.addChild(Id::rootId(), activityDiagram);
+	repo.connect(method, activityDiagram);
+
+	DiagramBuilder builder(repo, activityDiagram);
+	Id const initial = builder.node("ActivityDiagram_InitialNode", "");
+	Id const last = builder.build(initial, "", depth);
+	builder.link(last, builder.node("ActivityDiagram_ActivityFinalNode", ""), "");
+
+	QTime timer;
+	timer.start();
+	generators::JavaHandler handler(repo);
+	QString const errors = handler.generateToJava(outputDir);
+	int const elapsed = timer.elapsed();
+
+	bool ok = true;
+	if (!errors.isEmpty()) {
+		qDebug() << "FAILED: generator reported errors:" << errors;
+		ok = false;
+	}
+
+	QFile file(outputDir + "/Nested.java");
+	QString code;
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		code = QString::fromUtf8(file.readAll());
+		file.close();
+	}
+	if (code.count("if (") != builder.ifs()) {
+		qDebug() << "FAILED: expected" << builder.ifs() << "if statements, got" << code.count("if (");
+		ok = false;
+	}
+	if (code.count("while (") != builder.loops()) {
+		qDebug() << "FAILED: expected" << builder.loops() << "loops, got" << code.count("while (");
+		ok = false;
+	}
+	if (code.count(" else {") != builder.ifs()) {
+		qDebug() << "FAILED: expected" << builder.ifs() << "else branches, got" << code.count(" else {");
+		ok = false;
+	}
+	if (code.count('{') != code.count('}')) {
+		qDebug() << "FAILED: braces are not balanced";
+		ok = false;
+	}
+	// Class body, method body and one level per construct.
+	QString const deepest = QString(depth + 2, '\t') + "i++;";
+	if (!code.contains(deepest)) {
+		qDebug() << "FAILED: innermost action is not nested" << depth << "levels deep";
+		ok = false;
+	}
+
+	qDebug() << "generation of" << depth << "nested statements took" << elapsed << "ms";
+	qDebug() << (ok ? "OK" : "FAILED");
+
+	QFile::remove(outputDir + "/Nested.java");
+	temp.rmdir(outputDir);
+	repo.exterminate();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+# Regression test: reopened save must read only diagrams that are accessed.
+# Usage: lazyLoadingTest [DIAGRAMS=50] [ELEMENTS_PER_DIAGRAM=200]
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT += xml
+QT -= gui
+OBJECTS_DIR = .obj
+
+QRGUI = ../..
+
+LIBS += -L$$QRGUI -lqrrepo
+
+!macx {
+	QMAKE_LFLAGS="-Wl,-O1,-rpath,$$QRGUI"
+}
+
+SOURCES += \
+	main.cpp \
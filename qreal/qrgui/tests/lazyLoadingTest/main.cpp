@@ -0,0 +1,94 @@
+#include "../../../qrrepo/repoApi.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTime>
+
+using namespace qReal;
+
+namespace {
+
+bool check(bool condition, QString const &message)
+{
+	if (!condition)
+		qDebug() << "FAILED:" << message;
+	return condition;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	int const diagramsCount = arguments.size() > 1 ? arguments[1].toInt() : 50;
+	int const elementsPerDiagram = arguments.size() > 2 ? arguments[2].toInt() : 200;
+	// Root, diagrams and their elements
+	int const total = 1 + diagramsCount * (1 + elementsPerDiagram);
+
+	QString const repoDir = QDir::temp().absoluteFilePath("qrealLazyLoadingTestRepo");
+	IdList diagrams;
+	{
+		qrRepo::RepoApi repo(repoDir);
+		repo.exterminate();
+		for (int i = 0; i < diagramsCount; ++i) {
+			Id const diagram = Id::createElementId("Editor", "Diagram", "DiagramNode");
+			repo.addChild(Id::rootId(), diagram);
+			repo.setName(diagram, "diagram" + QString::number(i));
+			for (int j = 0; j < elementsPerDiagram; ++j) {
+				Id const element = Id::createElementId("Editor", "Diagram", "Node");
+				repo.addChild(diagram, element);
+				repo.setName(element, "node" + QString::number(j));
+			}
+			diagrams << diagram;
+		}
+		repo.saveAll();
+	}
+
+	bool ok = true;
+	QTime timer;
+	timer.start();
+	{
+		qrRepo::RepoApi repo(repoDir);
+		int const openTime = timer.elapsed();
+		qDebug() << "opening" << total << "elements took" << openTime << "ms," << repo.loadedElementsCount() << "read";
+
+		ok &= check(repo.loadedElementsCount() == 1 + diagramsCount
+				, "expected only diagrams to be read, got " + QString::number(repo.loadedElementsCount()));
+		ok &= check(repo.elementsCount() == total
+				, "expected " + QString::number(total) + " elements, got " + QString::number(repo.elementsCount()));
+
+		timer.restart();
+		IdList const children = repo.children(diagrams.first());
+		qDebug() << "opening a diagram took" << timer.elapsed() << "ms";
+		ok &= check(children.size() == elementsPerDiagram, "children of the first diagram are lost");
+		ok &= check(repo.loadedElementsCount() == 1 + diagramsCount + elementsPerDiagram
+				, "expected one diagram to be read, got " + QString::number(repo.loadedElementsCount()));
+		ok &= check(repo.name(children.last()) == "node" + QString::number(elementsPerDiagram - 1)
+				, "properties of a lazily read element are lost");
+
+		// Changes are saved together with the elements that were never read
+		repo.setName(children.first(), "changed");
+		repo.saveAll();
+	}
+
+	{
+		qrRepo::RepoApi repo(repoDir);
+		ok &= check(repo.elementsCount() == total, "elements are lost after saving a partially read repository");
+		ok &= check(repo.name(repo.children(diagrams.first()).first()) == "changed", "change is lost");
+		ok &= check(repo.children(diagrams.last()).size() == elementsPerDiagram, "unread diagram is lost");
+	}
+
+	// Saves without a skeleton, e.g. made by older versions, are read entirely
+	QFile::remove(repoDir + "/save/tree/skeleton.xml");
+	{
+		qrRepo::RepoApi repo(repoDir);
+		ok &= check(repo.loadedElementsCount() == total, "save without a skeleton is not read entirely");
+		repo.exterminate();
+	}
+
+	qDebug() << (ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
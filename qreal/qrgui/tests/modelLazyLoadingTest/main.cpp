@@ -0,0 +1,130 @@
+#include "models/models.h"
+#include "editorManager/editorManager.h"
+#include "kernel/roles.h"
+#include "../../../qrrepo/repoApi.h"
+
+#include <QtGui/QApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+
+using namespace qReal;
+
+namespace {
+
+bool check(bool condition, QString const &message)
+{
+	if (!condition)
+		qDebug() << "FAILED:" << message;
+	return condition;
+}
+
+QModelIndex topLevelIndex(QAbstractItemModel const *model, Id const &id)
+{
+	for (int row = 0; row < model->rowCount(); ++row) {
+		QModelIndex const index = model->index(row, 0);
+		if (index.data(roles::idRole).value<Id>() == id)
+			return index;
+	}
+	return QModelIndex();
+}
+
+int unfetchedCount(QAbstractItemModel const *model)
+{
+	int result = 0;
+	for (int row = 0; row < model->rowCount(); ++row) {
+		if (model->canFetchMore(model->index(row, 0)))
+			++result;
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	int const diagramsCount = arguments.size() > 1 ? qMax(2, arguments[1].toInt()) : 20;
+	int const elementsPerDiagram = arguments.size() > 2 ? qMax(1, arguments[2].toInt()) : 100;
+
+	// Every graphical diagram and element has its logical counterpart, as made by the editor
+	QString const repoDir = QDir::temp().absoluteFilePath("qrealModelLazyLoadingTestRepo");
+	QList<IdList> logicalElements;
+	QList<IdList> graphicalElements;
+	IdList graphicalDiagrams;
+	{
+		qrRepo::RepoApi repo(repoDir);
+		repo.exterminate();
+		for (int i = 0; i < diagramsCount; ++i) {
+			Id const logicalDiagram = Id::createElementId("Editor", "Diagram", "DiagramNode");
+			Id const graphicalDiagram = Id::createElementId("Editor", "Diagram", "DiagramNode");
+			repo.addChild(Id::rootId(), logicalDiagram);
+			repo.addChild(Id::rootId(), graphicalDiagram, logicalDiagram);
+			repo.setName(logicalDiagram, "diagram" + QString::number(i));
+			repo.setName(graphicalDiagram, "diagram" + QString::number(i));
+			graphicalDiagrams << graphicalDiagram;
+
+			IdList logical;
+			IdList graphical;
+			for (int j = 0; j < elementsPerDiagram; ++j) {
+				Id const logicalElement = Id::createElementId("Editor", "Diagram", "Node");
+				Id const graphicalElement = Id::createElementId("Editor", "Diagram", "Node");
+				repo.addChild(logicalDiagram, logicalElement);
+				repo.addChild(graphicalDiagram, graphicalElement, logicalElement);
+				repo.setName(logicalElement, "node" + QString::number(j));
+				repo.setName(graphicalElement, "node" + QString::number(j));
+				logical << logicalElement;
+				graphical << graphicalElement;
+			}
+			logicalElements << logical;
+			graphicalElements << graphical;
+		}
+		repo.saveAll();
+	}
+
+	bool ok = true;
+	{
+		EditorManager editorManager;
+		models::Models models(repoDir, editorManager);
+		QAbstractItemModel * const graphicalModel = models.graphicalModel();
+
+		ok &= check(unfetchedCount(graphicalModel) == diagramsCount, "diagrams are read on start");
+
+		// Lookups done on every change of a logical element and on explorer clicks
+		Id const renamed = logicalElements.last().first();
+		models.graphicalModelAssistApi().graphicalIdsByLogicalId(renamed);
+		ok &= check(unfetchedCount(graphicalModel) == diagramsCount
+				, "looking for graphical elements of a logical one read diagrams");
+
+		QModelIndex const logicalIndex = models.logicalModelAssistApi().indexById(renamed);
+		models.logicalModel()->setData(logicalIndex, "renamed", Qt::DisplayRole);
+		ok &= check(unfetchedCount(graphicalModel) == diagramsCount
+				, "renaming a logical element read diagrams");
+
+		// Element on a diagram read after the change gets the new name
+		QModelIndex const lastDiagram = topLevelIndex(graphicalModel, graphicalDiagrams.last());
+		graphicalModel->fetchMore(lastDiagram);
+		ok &= check(unfetchedCount(graphicalModel) == diagramsCount - 1, "opened diagram is not read");
+		IdList const graphicalIds = models.graphicalModelAssistApi().graphicalIdsByLogicalId(renamed);
+		ok &= check(graphicalIds == (IdList() << graphicalElements.last().first())
+				, "graphical element of a read diagram is not found");
+		ok &= check(models.graphicalRepoApi().name(graphicalElements.last().first()) == "renamed"
+				, "graphical element on a diagram read after renaming has the old name");
+
+		// Removal of a logical element removes its graphical ones on diagrams that were not read
+		Id const removed = logicalElements.first().first();
+		QModelIndex const removedIndex = models.logicalModelAssistApi().indexById(removed);
+		models.logicalModel()->removeRow(removedIndex.row(), removedIndex.parent());
+		ok &= check(!models.graphicalRepoApi().exist(graphicalElements.first().first())
+				, "graphical element of a removed logical one is left on a diagram that was not read");
+
+		// Reset gets back to unread diagrams
+		models.reinit();
+		ok &= check(unfetchedCount(graphicalModel) == diagramsCount, "diagrams are read on reset");
+
+		models.repoControlApi().exterminate();
+	}
+
+	qDebug() << (ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include "../../../qrrepo/repoApi.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTime>
+
+using namespace qReal;
+
+namespace {
+
+/// Walks the snapshot as a generator does and counts elements that don't look as they did
+/// when the snapshot was taken.
+class Reader : public QRunnable
+{
+public:
+	Reader(qrRepo::RepoApi const &snapshot, Id const &diagram, QAtomicInt &mismatches)
+		: mSnapshot(snapshot), mDiagram(diagram), mMismatches(mismatches)
+	{
+	}
+
+	void run()
+	{
+		int index = 0;
+		foreach (Id const &element, mSnapshot.children(mDiagram)) {
+			if (mSnapshot.name(element) != "node" + QString::number(index)
+					|| mSnapshot.parent(element) != mDiagram)
+			{
+				mMismatches.ref();
+			}
+			++index;
+		}
+		if (mSnapshot.elementsByType("Node").size() != index)
+			mMismatches.ref();
+	}
+
+private:
+	qrRepo::RepoApi const &mSnapshot;
+	Id const mDiagram;
+	QAtomicInt &mMismatches;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	int const elementsCount = arguments.size() > 1 ? arguments[1].toInt() : 20000;
+	int const threadsCount = arguments.size() > 2 ? arguments[2].toInt() : 4;
+
+	QString const repoDir = QDir::temp().absoluteFilePath("qrealRepoSnapshotTestRepo");
+	qrRepo::RepoApi repo(repoDir);
+	repo.exterminate();
+	Id const diagram = Id::createElementId("Editor", "Diagram", "DiagramNode");
+	repo.addChild(Id::rootId(), diagram);
+	IdList elements;
+	for (int i = 0; i < elementsCount; ++i) {
+		Id const element = Id::createElementId("Editor", "Diagram", "Node");
+		repo.addChild(diagram, element);
+		repo.setName(element, "node" + QString::number(i));
+		elements << element;
+	}
+
+	QTime timer;
+	timer.start();
+	qrRepo::RepoApi * const snapshot = repo.snapshot();
+	qDebug() << "snapshot of" << elementsCount << "elements took" << timer.elapsed() << "ms";
+
+	QAtomicInt mismatches(0);
+	QThreadPool pool;
+	pool.setMaxThreadCount(threadsCount);
+	for (int i = 0; i < threadsCount; ++i)
+		pool.start(new Reader(*snapshot, diagram, mismatches));
+
+	// Repository is changed while the snapshot is read
+	foreach (Id const &element, elements)
+		repo.setName(element, "changed");
+	for (int i = 0; i < elementsCount / 2; ++i)
+		repo.removeChild(diagram, elements[i]);
+	pool.waitForDone();
+
+	bool ok = true;
+	if (mismatches != 0) {
+		qDebug() << "FAILED:" << int(mismatches) << "elements of the snapshot were changed";
+		ok = false;
+	}
+	if (repo.name(elements.last()) != "changed" || repo.children(diagram).size() != elementsCount - elementsCount / 2) {
+		qDebug() << "FAILED: changes of repository are lost";
+		ok = false;
+	}
+
+	bool saved = true;
+	try {
+		snapshot->saveAll();
+	} catch (...) {
+		saved = false;
+	}
+	if (saved) {
+		qDebug() << "FAILED: snapshot was saved";
+		ok = false;
+	}
+
+	// Snapshot of a save read lazily leaves unread elements on disk, and reads them as they were
+	// when it was taken even if the repository changed and saved them since
+	repo.saveAll();
+	{
+		qrRepo::RepoApi reopened(repoDir);
+		qrRepo::RepoApi * const lazySnapshot = reopened.snapshot();
+		if (lazySnapshot->loadedElementsCount() == lazySnapshot->elementsCount()) {
+			qDebug() << "FAILED: snapshot read the whole save";
+			ok = false;
+		}
+		reopened.setName(elements.last(), "saved");
+		reopened.saveAll();
+		if (lazySnapshot->name(elements.last()) != "changed" || reopened.name(elements.last()) != "saved") {
+			qDebug() << "FAILED: snapshot read an element changed after it was taken";
+			ok = false;
+		}
+		delete lazySnapshot;
+	}
+
+	delete snapshot;
+	repo.exterminate();
+	qDebug() << (ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
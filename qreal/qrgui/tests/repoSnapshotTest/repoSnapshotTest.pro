@@ -0,0 +1,19 @@
+# Regression test: snapshots of repository are read by worker threads while it is changed.
+# Usage: repoSnapshotTest [ELEMENTS=20000] [THREADS=4]
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+QT += xml
+QT -= gui
+OBJECTS_DIR = .obj
+
+QRGUI = ../..
+
+LIBS += -L$$QRGUI -lqrrepo
+
+!macx {
+	QMAKE_LFLAGS="-Wl,-O1,-rpath,$$QRGUI"
+}
+
+SOURCES += \
+	main.cpp \
@@ -0,0 +1,149 @@
+#include "mainwindow/mainwindow.h"
+#include "models/models.h"
+#include "view/editorview.h"
+#include "umllib/uml_nodeelement.h"
+#include "kernel/roles.h"
+
+#include <QtGui/QApplication>
+#include <QtGui/QTabWidget>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QTime>
+#include <QtCore/QUuid>
+
+using namespace qReal;
+
+namespace {
+
+bool findTypes(EditorManager &manager, Id &diagramNode, Id &element)
+{
+	foreach (Id const editor, manager.editors()) {
+		foreach (Id const diagram, manager.diagrams(editor)) {
+			QString const nodeName = manager.editorInterface(editor.editor())->diagramNodeName(diagram.diagram());
+			if (nodeName.isEmpty())
+				continue;
+			foreach (Id const type, manager.elements(diagram)) {
+				if (type.element() == nodeName)
+					continue;
+				UML::Element * const object = manager.graphicalObject(type);
+				bool const isNode = dynamic_cast<UML::NodeElement *>(object) != NULL;
+				delete object;
+				if (isNode) {
+					diagramNode = Id(diagram.editor(), diagram.diagram(), nodeName);
+					element = type;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+QSet<QGraphicsItem *> items(EditorView *view)
+{
+	return view->scene()->items().toSet();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QStringList const arguments = app.arguments();
+	int const elementsCount = arguments.size() > 1 ? arguments[1].toInt() : 5000;
+	int const switchesCount = arguments.size() > 2 ? arguments[2].toInt() : 100;
+
+	// Work in an empty save, so that the user's one is not touched.
+	QString const saveDir = QDir::temp().absoluteFilePath("qrealTabSwitchingTest");
+	QDir().mkpath(saveDir);
+	MainWindow window(false, saveDir);
+	models::Models &models = *window.models();
+	models.repoControlApi().exterminate();
+	models.reinit();
+
+	Id diagramNode;
+	Id elementType;
+	if (!findTypes(*window.manager(), diagramNode, elementType)) {
+		qDebug() << "FAILED: no editor plugin with diagrams is loaded";
+		return 1;
+	}
+
+	QTabWidget * const tabs = window.findChild<QTabWidget *>("tabs");
+	QList<EditorView *> views;
+	for (int i = 0; i < 2; ++i) {
+		Id const diagram = models.graphicalModelAssistApi().createElement(Id::rootId(), diagramNode);
+		for (int j = 0; j < elementsCount; ++j) {
+			models.graphicalModelAssistApi().createElement(diagram, Id(elementType, QUuid::createUuid().toString()), false
+					, "element", QPointF((j % 100) * 50, (j / 100) * 50));
+		}
+		QMetaObject::invokeMethod(&window, "openNewTab", Qt::DirectConnection
+				, Q_ARG(QModelIndex, models.graphicalModelAssistApi().indexById(diagram)));
+		views << window.getCurrentTab();
+	}
+
+	QList<int> resets;
+	QList<QSet<QGraphicsItem *> > sceneItems;
+	foreach (EditorView * const view, views) {
+		resets << view->mvIface()->resetCount();
+		sceneItems << items(view);
+	}
+
+	QTime timer;
+	timer.start();
+	for (int i = 0; i < switchesCount; ++i) {
+		tabs->setCurrentIndex(i % 2);
+		app.processEvents();
+	}
+	int const elapsed = timer.elapsed();
+
+	bool ok = true;
+	for (int i = 0; i < views.size(); ++i) {
+		if (views[i]->mvIface()->resetCount() != resets[i]) {
+			qDebug() << "FAILED: scene of tab" << i << "was rebuilt"
+					<< views[i]->mvIface()->resetCount() - resets[i] << "times";
+			ok = false;
+		}
+		if (items(views[i]) != sceneItems[i]) {
+			qDebug() << "FAILED: elements of tab" << i << "were recreated";
+			ok = false;
+		}
+	}
+
+	// Every view shall be connected to logical model only once.
+	Id const logicalElement = models.graphicalModelAssistApi().logicalId(
+			models.graphicalModelAssistApi().children(views[0]->mvIface()->rootId()).first());
+	QModelIndex const logicalIndex = models.logicalModelAssistApi().indexById(logicalElement);
+	int const notifications = views[0]->mvIface()->logicalNotificationsCount();
+	models.logicalModel()->setData(logicalIndex, "renamed", Qt::DisplayRole);
+	if (views[0]->mvIface()->logicalNotificationsCount() - notifications != 1) {
+		qDebug() << "FAILED: view received"
+				<< views[0]->mvIface()->logicalNotificationsCount() - notifications
+				<< "notifications about one change of logical model";
+		ok = false;
+	}
+
+	// Change of an element shall be delivered only to the view of its diagram.
+	Id const graphicalElement = models.graphicalModelAssistApi().children(views[0]->mvIface()->rootId()).first();
+	QModelIndex const graphicalIndex = models.graphicalModelAssistApi().indexById(graphicalElement);
+	QList<int> routed;
+	foreach (EditorView *view, views) {
+		routed << view->mvIface()->modelNotificationsCount();
+	}
+	models.graphicalModel()->setData(graphicalIndex, QPointF(10, 10), roles::positionRole);
+	if (views[0]->mvIface()->modelNotificationsCount() == routed[0]) {
+		qDebug() << "FAILED: view of changed diagram was not notified";
+		ok = false;
+	}
+	if (views[1]->mvIface()->modelNotificationsCount() != routed[1]) {
+		qDebug() << "FAILED: view of another diagram received"
+				<< views[1]->mvIface()->modelNotificationsCount() - routed[1]
+				<< "notifications";
+		ok = false;
+	}
+
+	qDebug() << switchesCount << "switches between tabs with" << elementsCount << "elements took" << elapsed << "ms";
+	qDebug() << (ok ? "OK" : "FAILED");
+
+	models.repoControlApi().exterminate();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+# Regression test: switching between diagram tabs must not rebuild their scenes.
+# Links all qrgui sources except main.cpp, so they are found through VPATH.
+TEMPLATE = app
+CONFIG += console
+QT += svg xml
+OBJECTS_DIR = .obj
+UI_DIR = .ui
+MOC_DIR = .moc
+RCC_DIR = .moc
+
+QRGUI = ../..
+VPATH += $$QRGUI
+
+INCLUDEPATH += $$QRGUI \
+	$$QRGUI/../qrmc \
+	$$QRGUI/../qrmc/plugins \
+	$$QRGUI/mainwindow \
+	$$QRGUI/mainwindow/shapeEdit
+
+RESOURCES = $$QRGUI/qrgui.qrc
+LIBS += -L$$QRGUI -lqrrepo -lqrmc
+
+!macx {
+	QMAKE_LFLAGS="-Wl,-O1,-rpath,$$QRGUI"
+}
+
+if (equals(QMAKE_CXX, "g++") : !macx) {
+	QMAKE_LFLAGS += -Wl,-E
+}
+
+include ($$QRGUI/umllib/umllib.pri)
+include ($$QRGUI/dialogs/dialogs.pri)
+include ($$QRGUI/mainwindow/mainwindow.pri)
+include ($$QRGUI/view/view.pri)
+include ($$QRGUI/kernel/kernel.pri)
+include ($$QRGUI/generators/generators.pri)
+include ($$QRGUI/parsers/parsers.pri)
+include ($$QRGUI/../utils/utils.pri)
+include ($$QRGUI/thirdparty/thirdparty.pri)
+include ($$QRGUI/editorManager/editorManager.pri)
+include ($$QRGUI/models/models.pri)
+include ($$QRGUI/pluginInterface/pluginInterface.pri)
+include ($$QRGUI/visualDebugger/visualDebugger.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,145 @@
+#include "sdfPathParser.h"
+
+#include <QtCore/QDebug>
+
+SdfPathParser::SdfPathParser(QString const &d)
+	: mData(d), mPos(mData.constData()), mEnd(mData.constData() + mData.size()), mError(false)
+{
+}
+
+bool SdfPathParser::hasError() const
+{
+	return mError;
+}
+
+void SdfPathParser::skipSeparators()
+{
+	while (mPos != mEnd && (mPos->isSpace() || *mPos == ','))
+		++mPos;
+}
+
+bool SdfPathParser::readNumber(qreal &number)
+{
+	skipSeparators();
+	QChar const *start = mPos;
+	if (mPos != mEnd && (*mPos == '-' || *mPos == '+'))
+		++mPos;
+	while (mPos != mEnd && (mPos->isDigit() || *mPos == '.'))
+		++mPos;
+	if (mPos != mEnd && (*mPos == 'e' || *mPos == 'E')) {
+		++mPos;
+		if (mPos != mEnd && (*mPos == '-' || *mPos == '+'))
+			++mPos;
+		while (mPos != mEnd && mPos->isDigit())
+			++mPos;
+	}
+
+	bool ok = false;
+	number = QString::fromRawData(start, mPos - start).toDouble(&ok);
+	if (!ok)
+		mError = true;
+	return ok;
+}
+
+bool SdfPathParser::readPoint(QPointF &point)
+{
+	qreal x = 0;
+	qreal y = 0;
+	if (!readNumber(x) || !readNumber(y))
+		return false;
+	point = QPointF(x, y);
+	return true;
+}
+
+bool SdfPathParser::next(Command &command)
+{
+	skipSeparators();
+	if (mError || mPos == mEnd)
+		return false;
+
+	if (mPos->isLetter()) {
+		mCommand = *mPos;
+		++mPos;
+	} else if (mCommand.isNull() || mCommand.toUpper() == 'Z') {
+		mError = true;
+		return false;
+	}
+
+	bool const relative = mCommand.isLower();
+	QPointF const origin = relative ? mCurrent : QPointF();
+	switch (mCommand.toUpper().toLatin1()) {
+	case 'M':
+		command.type = moveTo;
+		if (!readPoint(command.points[0]))
+			return false;
+		command.points[0] += origin;
+		mSubpathStart = command.points[0];
+		// pairs after the first one are lines
+		mCommand = relative ? 'l' : 'L';
+		break;
+	case 'L':
+		command.type = lineTo;
+		if (!readPoint(command.points[0]))
+			return false;
+		command.points[0] += origin;
+		break;
+	case 'C':
+		command.type = cubicTo;
+		for (int i = 0; i < 3; ++i) {
+			if (!readPoint(command.points[i]))
+				return false;
+			command.points[i] += origin;
+		}
+		break;
+	case 'Z':
+		command.type = closePath;
+		command.points[0] = mSubpathStart;
+		break;
+	default:
+		mError = true;
+		return false;
+	}
+
+	mCurrent = command.points[command.type == cubicTo ? 2 : 0];
+	return true;
+}
+
+QPainterPath SdfPathParser::toPath(QString const &d, QTransform const &transform)
+{
+	QPainterPath path;
+	SdfPathParser parser(d);
+	Command command;
+	while (parser.next(command)) {
+		switch (command.type) {
+		case moveTo:
+			path.moveTo(transform.map(command.points[0]));
+			break;
+		case lineTo:
+			path.lineTo(transform.map(command.points[0]));
+			break;
+		case cubicTo:
+			path.cubicTo(transform.map(command.points[0]), transform.map(command.points[1])
+					, transform.map(command.points[2]));
+			break;
+		case closePath:
+			path.closeSubpath();
+			break;
+		}
+	}
+	path.closeSubpath();
+	if (parser.hasError())
+		qDebug() << "Incorrect path data:" << d;
+	return path;
+}
+
+QPolygonF SdfPathParser::toPolyline(QString const &d, QTransform const &transform)
+{
+	QPolygonF polyline;
+	SdfPathParser parser(d);
+	Command command;
+	while (parser.next(command))
+		polyline << transform.map(command.points[command.type == cubicTo ? 2 : 0]);
+	if (parser.hasError())
+		qDebug() << "Incorrect path data:" << d;
+	return polyline;
+}
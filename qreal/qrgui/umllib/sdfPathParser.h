@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QPointF>
+#include <QtGui/QPainterPath>
+#include <QtGui/QPolygonF>
+#include <QtGui/QTransform>
+
+/** @brief Reads the "d" attribute of SDF paths ("M x y L x y C x1 y1 x2 y2 x y Z")
+ * command by command, straight from the string. Shared by the renderer and the shape editor.
+**/
+class SdfPathParser
+{
+public:
+	enum CommandType {
+		moveTo,
+		lineTo,
+		cubicTo,
+		closePath
+	};
+
+	struct Command
+	{
+		CommandType type;
+		QPointF points[3];  // cubicTo uses all three, the rest only the first one
+	};
+
+	explicit SdfPathParser(QString const &d);
+
+	/// Reads the next command, returns false at the end of the data or on a syntax error
+	bool next(Command &command);
+	bool hasError() const;
+
+	/// Last subpath is always closed, shapes rely on it as on an implicit trailing "Z"
+	static QPainterPath toPath(QString const &d, QTransform const &transform = QTransform());
+	/// End points of all commands, for strokes that are stored as paths of lines
+	static QPolygonF toPolyline(QString const &d, QTransform const &transform = QTransform());
+
+private:
+	void skipSeparators();
+	bool readNumber(qreal &number);
+	bool readPoint(QPointF &point);
+
+	QString mData;
+	QChar const *mPos;
+	QChar const *mEnd;
+	QChar mCommand;  // coordinates without a letter repeat the previous command, as in SVG
+	QPointF mCurrent;
+	QPointF mSubpathStart;
+	bool mError;
+};
@@ -1,4 +1,5 @@
 #include "sdfrenderer.h"
+#include "sdfPathParser.h"
 
 #include <QMessageBox>
 #include <QFont>
@@ -316,162 +317,9 @@ void SdfRenderer::defaultstyle()
 	pen.setWidth(1);
 }
 
-bool SdfRenderer::isNotLCMZ(QString str, int i)
-{
-	return (str[i] != 'L') && (str[i] != 'C') && (str[i] != 'M')
-		&& (str[i] != 'Z') && (i != str.length());
-}
-
 void SdfRenderer::path_draw(QDomElement &element)
 {
-	QPointF end_point;
-	QPointF c1;
-	QPointF c2;
-	QDomElement elem = element;
-	QPainterPath path;
-
-	if (!elem.isNull())
-	{
-		QString d_cont;
-		d_cont = elem.attribute("d").remove(0, 1);
-		d_cont.append(" Z");
-
-		for (i = 0; i < d_cont.length() - 1;)
-		{
-			if (d_cont[i] == 'M')
-			{
-				j = i + 2;
-				while (isNotLCMZ(d_cont, j))
-				{
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					++j;
-					s1.clear();
-				}
-
-				path.moveTo(end_point);
-				i = j;
-			}
-			else if (d_cont[i] == 'L')
-			{
-				j = i + 2;
-				while (isNotLCMZ(d_cont, j))
-				{
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					++j;
-					s1.clear();
-				}
-
-				 path.lineTo(end_point);
-				 i = j;
-			}
-			 else if (d_cont[i] == 'C')
-			{
-				j = i + 2;
-				while(isNotLCMZ(d_cont, j))
-				{
-					while (!(d_cont[j] == ' '))
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c1.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c1.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c2.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c2.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-				}
-
-				path.cubicTo(c1, c2, end_point);
-				i = j;
-
-			} else if (d_cont[i] == 'Z')
-			{
-				path.closeSubpath();
-				logger ("loggerZ.txt", "DONE");
-			}
-		}
-	}
-
+	QPainterPath const path = SdfPathParser::toPath(element.attribute("d"), pathTransform());
 	parsestyle(element);
 	painter->drawPath(path);
 }
@@ -484,7 +332,11 @@ void SdfRenderer::stylus_draw(QDomElement &element)
 		QDomElement elem = node.toElement();
 		if(!elem.isNull())
 		{
-			if (elem.tagName()=="line")
+			if (elem.tagName()=="path")
+			{
+				polyline_draw(elem);
+			}
+			else if (elem.tagName()=="line")
 			{
 				line(elem);
 			}
@@ -493,6 +345,21 @@ void SdfRenderer::stylus_draw(QDomElement &element)
 	}
 }
 
+void SdfRenderer::polyline_draw(QDomElement &element)
+{
+	// drawn open and without filling, unlike path_draw
+	QPolygonF const polyline = SdfPathParser::toPolyline(element.attribute("d"), pathTransform());
+	parsestyle(element);
+	painter->drawPolyline(polyline);
+}
+
+QTransform SdfRenderer::pathTransform() const
+{
+	return QTransform(static_cast<qreal>(current_size_x) / first_size_x, 0
+			, 0, static_cast<qreal>(current_size_y) / first_size_y
+			, mStartX, mStartY);
+}
+
 void SdfRenderer::curve_draw(QDomElement &element)
 {
 	QDomNode node = element.firstChild();
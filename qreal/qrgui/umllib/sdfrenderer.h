@@ -68,6 +68,9 @@ private:
 	void defaultstyle();
 	void path_draw(QDomElement &element);
 	void stylus_draw(QDomElement &element);
+	void polyline_draw(QDomElement &element);
+	/// Scales path coordinates from the picture size to the current one
+	QTransform pathTransform() const;
 	void curve_draw(QDomElement &element);
 	void image_draw(QDomElement &element);
 	float x1_def(QDomElement &element);
@@ -77,9 +80,6 @@ private:
 	float coord_def(QDomElement &element, QString coordName, int current_size,
 		int first_size);
 	void logger(QString path, QString string);
-
-	/** @brief checks that str[i] is not L, C, M or Z*/
-	bool isNotLCMZ(QString str, int i);
 };
 
 class SdfIconEngineV2: public SdfIconEngineV2Interface
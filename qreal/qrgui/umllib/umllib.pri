@@ -2,6 +2,7 @@ HEADERS += umllib/uml_edgeelement.h \
 	umllib/uml_element.h \
 	umllib/uml_nodeelement.h \
 	umllib/sdfrenderer.h \
+	umllib/sdfPathParser.h \
 	umllib/elementTitle.h \
 	umllib/contextMenuAction.h \
 	umllib/embeddedLinker.h \
@@ -12,6 +13,7 @@ SOURCES += umllib/uml_edgeelement.cpp \
 	umllib/uml_element.cpp \
 	umllib/uml_nodeelement.cpp \
 	umllib/sdfrenderer.cpp \
+	umllib/sdfPathParser.cpp \
 	umllib/elementTitle.cpp \
 	umllib/contextMenuAction.cpp \
 	umllib/embeddedLinker.cpp \
@@ -0,0 +1,117 @@
+#include "diagramNotificationRouter.h"
+#include "editorviewmviface.h"
+
+#include <QtCore/QAbstractItemModel>
+
+using namespace qReal;
+
+DiagramNotificationRouter::DiagramNotificationRouter(QAbstractItemModel *model, QObject *parent)
+	: QObject(parent), mModel(model)
+{
+	connect(mModel, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(rowsInserted(QModelIndex, int, int)));
+	connect(mModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int))
+			, this, SLOT(rowsAboutToBeRemoved(QModelIndex, int, int)));
+	connect(mModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(dataChanged(QModelIndex, QModelIndex)));
+	connect(mModel, SIGNAL(modelAboutToBeReset()), this, SLOT(modelAboutToBeReset()));
+	connect(mModel, SIGNAL(modelReset()), this, SLOT(modelReset()));
+}
+
+QAbstractItemModel *DiagramNotificationRouter::model() const
+{
+	return mModel;
+}
+
+void DiagramNotificationRouter::subscribe(EditorViewMViface *view, QModelIndex const &rootDiagram)
+{
+	unsubscribe(view);
+	mViews.insert(rootDiagram.isValid() ? rootDiagram.internalPointer() : NULL, view);
+}
+
+void DiagramNotificationRouter::unsubscribe(EditorViewMViface *view)
+{
+	QMutableHashIterator<void *, EditorViewMViface *> iterator(mViews);
+	while (iterator.hasNext()) {
+		if (iterator.next().value() == view)
+			iterator.remove();
+	}
+}
+
+void DiagramNotificationRouter::rowsInserted(QModelIndex const &parent, int start, int end)
+{
+	foreach (EditorViewMViface * const view, subscribers(parent)) {
+		++view->mModelNotificationsCount;
+		view->rowsInserted(parent, start, end);
+	}
+}
+
+void DiagramNotificationRouter::rowsAboutToBeRemoved(QModelIndex const &parent, int start, int end)
+{
+	foreach (EditorViewMViface * const view, subscribers(parent)) {
+		++view->mModelNotificationsCount;
+		view->rowsAboutToBeRemoved(parent, start, end);
+	}
+}
+
+void DiagramNotificationRouter::dataChanged(QModelIndex const &topLeft, QModelIndex const &bottomRight)
+{
+	foreach (EditorViewMViface * const view, subscribers(topLeft.parent())) {
+		++view->mModelNotificationsCount;
+		view->dataChanged(topLeft, bottomRight);
+	}
+}
+
+void DiagramNotificationRouter::modelAboutToBeReset()
+{
+	mRootIds.clear();
+	foreach (EditorViewMViface * const view, mViews.values()) {
+		bool const hasRoot = view->rootIndex().isValid() && view->mGraphicalAssistApi;
+		mRootIds.insert(view, hasRoot ? view->rootId() : Id());
+	}
+}
+
+void DiagramNotificationRouter::modelReset()
+{
+	// Old root indexes are invalid now, as the views' ones.
+	mViews.clear();
+	QHash<EditorViewMViface *, QPersistentModelIndex> roots;
+	QHashIterator<EditorViewMViface *, Id> iterator(mRootIds);
+	while (iterator.hasNext()) {
+		iterator.next();
+		EditorViewMViface * const view = iterator.key();
+		QModelIndex const root = iterator.value() != Id()
+				? view->mGraphicalAssistApi->indexById(iterator.value())
+				: QModelIndex();
+		// Diagrams are read by the model on demand, the reset dropped the read ones. Nobody is
+		// subscribed yet, so rows read here reach views only through the rebuild below.
+		if (root.isValid() && mModel->canFetchMore(root))
+			mModel->fetchMore(root);
+		roots.insert(view, root);
+	}
+
+	QHashIterator<EditorViewMViface *, QPersistentModelIndex> rootsIterator(roots);
+	while (rootsIterator.hasNext()) {
+		rootsIterator.next();
+		EditorViewMViface * const view = rootsIterator.key();
+		QModelIndex const root = rootsIterator.value();
+		// Views do not reset themselves on modelReset, so every scene is rebuilt once, here.
+		if (root.isValid()) {
+			view->setRootIndex(root);
+		} else {
+			mViews.insert(NULL, view);
+			view->reset();
+		}
+	}
+	mRootIds.clear();
+}
+
+QList<EditorViewMViface *> DiagramNotificationRouter::subscribers(QModelIndex const &index) const
+{
+	if (!index.isValid())
+		return mViews.values();
+
+	QModelIndex diagram = index;
+	while (diagram.parent().isValid())
+		diagram = diagram.parent();
+
+	return mViews.values(diagram.internalPointer()) + mViews.values(NULL);
+}
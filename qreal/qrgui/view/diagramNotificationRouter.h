@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QMultiHash>
+#include <QtCore/QModelIndex>
+
+#include "../kernel/ids.h"
+
+class QAbstractItemModel;
+
+namespace qReal {
+
+	class EditorViewMViface;
+
+	/// Delivers changes of graphical model only to views showing the diagram
+	/// which contains changed elements. Without it every open view receives
+	/// every notification and has to check if it belongs to its diagram.
+	class DiagramNotificationRouter : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		explicit DiagramNotificationRouter(QAbstractItemModel *model, QObject *parent = NULL);
+
+		QAbstractItemModel *model() const;
+
+		/// Starts delivering changes of root diagram subtree to a view, replacing its previous subscription.
+		/// View without root diagram receives all changes.
+		void subscribe(EditorViewMViface *view, QModelIndex const &rootDiagram);
+		void unsubscribe(EditorViewMViface *view);
+
+	private slots:
+		void rowsInserted(QModelIndex const &parent, int start, int end);
+		void rowsAboutToBeRemoved(QModelIndex const &parent, int start, int end);
+		void dataChanged(QModelIndex const &topLeft, QModelIndex const &bottomRight);
+		void modelAboutToBeReset();
+		/// Views get back to their diagrams, which have new indexes after the reset and are read
+		/// again, and are rebuilt by this slot only.
+		void modelReset();
+
+	private:
+		/// Views of a diagram containing given index, plus views without diagram.
+		/// Changes of top level rows, i.e. of diagrams themselves, go to all views.
+		QList<EditorViewMViface *> subscribers(QModelIndex const &index) const;
+
+		QAbstractItemModel *mModel;
+		/// Views by internal pointer of their root diagram index, NULL for views without root.
+		QMultiHash<void *, EditorViewMViface *> mViews;
+		/// Root diagrams of views remembered while the model is being reset.
+		QHash<EditorViewMViface *, Id> mRootIds;
+	};
+
+}
@@ -4,6 +4,7 @@
 #include "editorviewmviface.h"
 #include "editorview.h"
 #include "editorviewscene.h"
+#include "diagramNotificationRouter.h"
 #include "../kernel/definitions.h"
 #include "../umllib/uml_element.h"
 #include "../editorManager/editorManager.h"
@@ -17,6 +18,11 @@ EditorViewMViface::EditorViewMViface(EditorView *view, EditorViewScene *scene)
 	, mView(view)
 	, mGraphicalAssistApi(NULL)
 	, mLogicalAssistApi(NULL)
+	, mLogicalModel(NULL)
+	, mResetCount(0)
+	, mLogicalNotificationsCount(0)
+	, mModelNotificationsCount(0)
+	, mRouter(NULL)
 {
 	mScene->mv_iface = this;
 	mScene->view = mView;
@@ -24,6 +30,8 @@ EditorViewMViface::EditorViewMViface(EditorView *view, EditorViewScene *scene)
 
 EditorViewMViface::~EditorViewMViface()
 {
+	if (mRouter)
+		mRouter->unsubscribe(this);
 	clearItems();
 }
 
@@ -86,6 +94,7 @@ QRegion EditorViewMViface::visualRegionForSelection(const QItemSelection &) cons
 
 void EditorViewMViface::reset()
 {
+	++mResetCount;
 	mScene->clearScene();
 	clearItems();
 
@@ -106,14 +115,52 @@ void EditorViewMViface::setRootIndex(const QModelIndex &index)
 	if (index == rootIndex())
 		return;
 	QAbstractItemView::setRootIndex(index);
+	if (mRouter)
+		mRouter->subscribe(this, index);
 	reset();
 }
 
+void EditorViewMViface::setNotificationRouter(DiagramNotificationRouter *router)
+{
+	mRouter = router;
+}
+
+void EditorViewMViface::setModel(QAbstractItemModel *model)
+{
+	QAbstractItemView::setModel(model);
+	if (!mRouter || model != mRouter->model())
+		return;
+
+	// These changes come from the router, only for the diagram of this view.
+	disconnect(model, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(rowsInserted(QModelIndex, int, int)));
+	disconnect(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int))
+			, this, SLOT(rowsAboutToBeRemoved(QModelIndex, int, int)));
+	disconnect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(dataChanged(QModelIndex, QModelIndex)));
+	// The router restores the root diagram after a reset, which rebuilds the scene anyway.
+	disconnect(model, SIGNAL(modelReset()), this, SLOT(reset()));
+	mRouter->subscribe(this, rootIndex());
+}
+
 Id EditorViewMViface::rootId()
 {
 	return mGraphicalAssistApi->idByIndex(rootIndex());
 }
 
+int EditorViewMViface::resetCount() const
+{
+	return mResetCount;
+}
+
+int EditorViewMViface::logicalNotificationsCount() const
+{
+	return mLogicalNotificationsCount;
+}
+
+int EditorViewMViface::modelNotificationsCount() const
+{
+	return mModelNotificationsCount;
+}
+
 void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int end)
 {
 	for (int row = start; row <= end; ++row) {
@@ -320,12 +367,21 @@ void EditorViewMViface::setAssistApi(models::GraphicalModelAssistApi &graphicalA
 
 void EditorViewMViface::setLogicalModel(QAbstractItemModel * const logicalModel)
 {
-	connect(logicalModel, SIGNAL(dataChanged(QModelIndex, QModelIndex))
-			, this, SLOT(logicalDataChanged(QModelIndex, QModelIndex)));
+	if (logicalModel == mLogicalModel)
+		return;
+
+	if (mLogicalModel)
+		disconnect(mLogicalModel, 0, this, 0);
+	mLogicalModel = logicalModel;
+	if (mLogicalModel) {
+		connect(mLogicalModel, SIGNAL(dataChanged(QModelIndex, QModelIndex))
+				, this, SLOT(logicalDataChanged(QModelIndex, QModelIndex)));
+	}
 }
 
 void EditorViewMViface::logicalDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
+	++mLogicalNotificationsCount;
 	for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
 		QModelIndex const curr = topLeft.sibling(row, 0);
 		Id const logicalId = curr.data(roles::idRole).value<Id>();
@@ -19,6 +19,7 @@ namespace qReal {
 		class LogicalModelAssistApi;
 	}
 	class EditorView;
+	class DiagramNotificationRouter;
 
 	class EditorViewMViface : public QAbstractItemView
 	{
@@ -34,8 +35,18 @@ namespace qReal {
 		bool isDescendentOf(const QModelIndex &descendent, const QModelIndex &ancestor);
 		void setAssistApi(models::GraphicalModelAssistApi &graphicalAssistApi, models::LogicalModelAssistApi &logicalAssistApi);
 		void setLogicalModel(QAbstractItemModel * const logicalModel);
+		/// Shall be set before the model, then changes of other diagrams are not delivered to this view.
+		void setNotificationRouter(DiagramNotificationRouter *router);
+		virtual void setModel(QAbstractItemModel *model);
 		Id rootId();
 
+		/// Number of full rebuilds of the scene, for tests and benchmarks.
+		int resetCount() const;
+		/// Number of notifications about changes of logical model received.
+		int logicalNotificationsCount() const;
+		/// Number of notifications about changes of graphical model delivered by the router.
+		int modelNotificationsCount() const;
+
 		EditorViewScene *scene() const;
 		models::GraphicalModelAssistApi *graphicalAssistApi() const;
 		models::LogicalModelAssistApi *logicalAssistApi() const;
@@ -59,6 +70,11 @@ namespace qReal {
 		qReal::EditorView *mView;
 		models::GraphicalModelAssistApi *mGraphicalAssistApi;
 		models::LogicalModelAssistApi *mLogicalAssistApi;
+		QAbstractItemModel *mLogicalModel;
+		int mResetCount;
+		int mLogicalNotificationsCount;
+		int mModelNotificationsCount;
+		DiagramNotificationRouter *mRouter;
 
 		/** @brief elements on the scene. their indices change SUDDENLY, so don't use maps, hashes etc. */
 		QSet<IndexElementPair> mItems;
@@ -79,6 +95,8 @@ namespace qReal {
 		void removeItem(QPersistentModelIndex const &index);
 
 		void clearItems();
+
+		friend class DiagramNotificationRouter;
 	};
 
 }
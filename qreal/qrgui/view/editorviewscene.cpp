@@ -14,8 +14,11 @@
 
 using namespace qReal;
 
+// Time to start the next stroke of a multistroke gesture, in ms
+static int const gestureStrokesInterval = 700;
+
 EditorViewScene::EditorViewScene(QObject * parent)
-	:  QGraphicsScene(parent), mWindow(NULL), mPrevParent(0)
+	:  QGraphicsScene(parent), mWindow(NULL), mPrevParent(0), mouseMovementManager(NULL)
 {
 	QSettings settings("SPbSU", "QReal");
 	mNeedDrawGrid = settings.value("ShowGrid", true).toBool();
@@ -26,38 +29,58 @@ EditorViewScene::EditorViewScene(QObject * parent)
 	mRightButtonPressed = false;
 
 	mActionSignalMapper = new QSignalMapper(this);
+
+	mGestureTimer.setSingleShot(true);
+	mGestureTimer.setInterval(gestureStrokesInterval);
+	connect(&mGestureTimer, SIGNAL(timeout()), this, SLOT(finishGesture()));
+	connect(this, SIGNAL(selectionChanged()), this, SLOT(finishDeferredUpdates()));
 }
 
 EditorViewScene::~EditorViewScene()
 {
+	delete mouseMovementManager;
 	delete mActionSignalMapper;
 }
 
 void EditorViewScene::drawIdealGesture()
 {
+	if (!mouseMovementManager || !showsGestures())
+		return;
 	mouseMovementManager->drawIdealPath();
 }
 
 void EditorViewScene::printElementsOfRootDiagram()
 {
+	if (!mouseMovementManager || !showsGestures())
+		return;
 	mouseMovementManager->setGesturesPainter(mWindow->gesturesPainter());
 	mouseMovementManager->printElements();
 }
 
+bool EditorViewScene::showsGestures() const
+{
+	// Signals of the main window reach every scene, gestures are shown for one diagram only
+	return mWindow->gesturesView() && mWindow->gesturesView()->scene() == this;
+}
+
 void EditorViewScene::initMouseMoveManager()
 {
 	if (!mv_iface || !mv_iface->graphicalAssistApi())
 		return;
-	qReal::Id diagram = mv_iface->graphicalAssistApi()->idByIndex(mWindow->rootIndex());
-	if (diagram == Id())
-		// Root diagram is not set, for example, current tab is disabled. No need
-		// to do anything with mouse manager.
+	// Every scene keeps a manager for its own diagram, so switching tabs does not rebuild it.
+	qReal::Id const rootElement = mv_iface->graphicalAssistApi()->idByIndex(mv_iface->rootIndex());
+	if (rootElement == Id())
+		// Root diagram is not set yet. No need to do anything with mouse manager.
+		return;
+	qReal::Id const diagram = Id(rootElement.editor(), rootElement.diagram());
+	if (mouseMovementManager && diagram == mMouseMovementManagerDiagram)
 		return;
-	QList<qReal::Id> elements = mWindow->manager()->elements(diagram);
-	mouseMovementManager = new MouseMovementManager(elements,
+
+	mGestureTimer.stop();
+	delete mouseMovementManager;
+	mouseMovementManager = new MouseMovementManager(diagram,
 			mWindow->manager(), mWindow->gesturesPainter());
-	connect(mWindow, SIGNAL(currentIdealGestureChanged()), this, SLOT(drawIdealGesture()));
-	connect(mWindow, SIGNAL(gesturesShowed()), this, SLOT(printElementsOfRootDiagram()));
+	mMouseMovementManagerDiagram = diagram;
 }
 
 void EditorViewScene::drawGrid(QPainter *painter, const QRectF &rect)
@@ -436,11 +459,19 @@ void EditorViewScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 		if (item) {
 			mPrevParent = item->parentItem();
 			mPrevPosition = item->pos();
+			// Geometry is written to the model on every move, the property editor catches up on release.
+			if (mWindow)
+				mWindow->propertyModel().setUpdatesDeferred(true);
 		}
 
 	} else if (event->button() == Qt::RightButton) {
 		UML::Element *e = getElemAt(event->scenePos());
 		//	if (!e) {
+		// A stroke started before the timeout continues the gesture
+		if (!mGestureTimer.isActive())
+			mouseMovementManager->clear();
+		mGestureTimer.stop();
+		mouseMovementManager->newStroke();
 		mouseMovementManager->addPoint(event->scenePos());
 		mRightButtonPressed = true;
 		//		return;
@@ -489,7 +520,7 @@ void EditorViewScene::getObjectByGesture()
 	QPointF end = mouseMovementManager->lastPoint();
 	UML::NodeElement * parent = dynamic_cast <UML::NodeElement * > (getElemAt(start));
 	UML::NodeElement * child = dynamic_cast <UML::NodeElement * > (getElemAt(end));
-	if (parent && child)
+	if (parent && child && mouseMovementManager->strokesCount() == 1)
 	{
 		getLinkByGesture(parent, *child);
 	}
@@ -501,6 +532,19 @@ void EditorViewScene::getObjectByGesture()
 	}
 }
 
+bool EditorViewScene::isLinkGesture()
+{
+	return mouseMovementManager->strokesCount() == 1
+			&& dynamic_cast<UML::NodeElement *>(getElemAt(mouseMovementManager->firstPoint()))
+			&& dynamic_cast<UML::NodeElement *>(getElemAt(mouseMovementManager->lastPoint()));
+}
+
+void EditorViewScene::finishGesture()
+{
+	getObjectByGesture();
+	mouseMovementManager->clear();
+}
+
 void EditorViewScene::getLinkByGesture(UML::NodeElement * parent, const UML::NodeElement &child)
 {
 	EditorInterface const * const editorInterface = mainWindow()->manager()->editorInterface(child.id().editor());
@@ -558,6 +602,9 @@ void EditorViewScene::mouseReleaseEvent ( QGraphicsSceneMouseEvent * event )
 {
 	QGraphicsScene::mouseReleaseEvent(event);
 
+	if (event->button() == Qt::LeftButton)
+		finishDeferredUpdates();
+
 	UML::Element* element = getElemAt(event->scenePos());
 
 	if (event->button() == Qt::RightButton)
@@ -569,11 +616,18 @@ void EditorViewScene::mouseReleaseEvent ( QGraphicsSceneMouseEvent * event )
 				edgeElement->breakPointHandler(element->mapFromScene(event->scenePos()));
 				mRightButtonPressed = false;
 				return;}
+		mRightButtonPressed = false;
+		bool const continued = mouseMovementManager->strokesCount() > 1;
+		if ((continued || mouseMovementManager->wasMoving())
+				&& mouseMovementManager->isMultistroke() && !isLinkGesture())
+		{
+			mGestureTimer.start();
+			return;
+		}
 		if (mouseMovementManager->wasMoving())
 			getObjectByGesture();
 		else if (element)
 			initContextMenu(element, event->scenePos());
-		mRightButtonPressed = false;
 		mouseMovementManager->clear();
 		return;
 	}
@@ -616,6 +670,18 @@ void EditorViewScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 }
 
 
+void EditorViewScene::focusOutEvent(QFocusEvent *event)
+{
+	QGraphicsScene::focusOutEvent(event);
+	finishDeferredUpdates();
+}
+
+void EditorViewScene::finishDeferredUpdates()
+{
+	if (mWindow)
+		mWindow->propertyModel().setUpdatesDeferred(false);
+}
+
 void EditorViewScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
 {
 	if (event->button() == Qt::LeftButton) {
@@ -671,6 +737,8 @@ void EditorViewScene::setMainWindow(qReal::MainWindow *mainWindow)
 {
 	mWindow = mainWindow;
 	connect(mWindow, SIGNAL(rootDiagramChanged()), this, SLOT(initMouseMoveManager()));
+	connect(mWindow, SIGNAL(currentIdealGestureChanged()), this, SLOT(drawIdealGesture()));
+	connect(mWindow, SIGNAL(gesturesShowed()), this, SLOT(printElementsOfRootDiagram()));
 //	connect(this, SIGNAL(elementCreated(qReal::Id)), mainWindow->listenerManager(), SIGNAL(objectCreated(qReal::Id)));
 //	connect(mActionSignalMapper, SIGNAL(mapped(QString)), mainWindow->listenerManager(), SIGNAL(contextMenuActionTriggered(QString)));
 }
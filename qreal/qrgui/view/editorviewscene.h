@@ -3,6 +3,7 @@
 #include <QGraphicsScene>
 #include <QGraphicsLineItem>
 #include <QSignalMapper>
+#include <QTimer>
 #include "../kernel/roles.h"
 #include "../umllib/uml_nodeelement.h"
 #include "gestures/mousemovementmanager.h"
@@ -72,6 +73,9 @@ protected:
 
 	void mouseDoubleClickEvent( QGraphicsSceneMouseEvent *event);
 
+	/// Release of a drag may never come if focus goes to a popup or another window.
+	void focusOutEvent(QFocusEvent *event);
+
 	virtual void drawBackground( QPainter *painter, const QRectF &rect);
 
 private:
@@ -83,6 +87,10 @@ private:
 	double mRealIndexGrid;
 
 	void getObjectByGesture();
+	/// Single stroke from one node to another is drawn to connect them
+	bool isLinkGesture();
+	/// True if the gestures tab shows gestures of the diagram of this scene
+	bool showsGestures() const;
 	void getLinkByGesture(UML::NodeElement * parent, UML::NodeElement const & child);
 	void drawGesture();
 	void deleteGesture();
@@ -121,6 +129,9 @@ private:
 	QPointF mCreatePoint;
 
 	MouseMovementManager * mouseMovementManager;
+	qReal::Id mMouseMovementManagerDiagram;
+	/// Waits for the next stroke of a multistroke gesture
+	QTimer mGestureTimer;
 
 	QSignalMapper *mActionSignalMapper;
 	
@@ -142,5 +153,8 @@ private slots:
 	void printElementsOfRootDiagram();
 	void drawIdealGesture();
 	void initMouseMoveManager();
+	void finishGesture();
 	void createEdge(QString const &);
+	/// Lets the property editor show values written while an element was dragged.
+	void finishDeferredUpdates();
 };
@@ -0,0 +1,115 @@
+#include "gestureindex.h"
+#include "levenshteindistance.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static float const e = 100;
+static float const maxKeyDistance = 100;
+
+GestureIndex::GestureIndex()
+	: mLastComparisons(0)
+{
+}
+
+void GestureIndex::clear()
+{
+	mNodes.clear();
+	mLastComparisons = 0;
+}
+
+int GestureIndex::size() const
+{
+	return mNodes.size();
+}
+
+int GestureIndex::lastComparisons() const
+{
+	return mLastComparisons;
+}
+
+void GestureIndex::insert(QString const & key, qReal::Id const & id)
+{
+	Node node;
+	node.key = key;
+	node.id = id;
+	node.maxChildDistance = 0;
+
+	if (mNodes.isEmpty())
+	{
+		mNodes.append(node);
+		return;
+	}
+
+	int current = 0;
+	forever
+	{
+		int const distance = LevenshteinDistance::getBoundedLevenshteinDistance(mNodes[current].key, key
+				, std::max(mNodes[current].key.size(), key.size()), mRow);
+		if (distance == 0)
+		{
+			mNodes[current].id = id;
+			return;
+		}
+		QMap<int, int>::const_iterator child = mNodes[current].children.constFind(distance);
+		if (child == mNodes[current].children.constEnd())
+		{
+			mNodes[current].children.insert(distance, mNodes.size());
+			mNodes[current].maxChildDistance = std::max(mNodes[current].maxChildDistance, distance);
+			mNodes.append(node);
+			return;
+		}
+		current = child.value();
+	}
+}
+
+qReal::Id GestureIndex::nearest(QString const & key)
+{
+	mLastComparisons = 0;
+	qReal::Id result;
+	if (key.isEmpty() || mNodes.isEmpty())
+		return result;
+
+	// A key is recognized only if its distance is less than the length of the shorter key,
+	// so nothing farther than key.size() - 1 can be an answer.
+	int const radius = key.size() - 1;
+	float min = e;
+	QString resultKey;
+
+	mStack.clear();
+	mStack.append(0);
+	while (!mStack.isEmpty())
+	{
+		Node const &node = mNodes.at(mStack.back());
+		mStack.pop_back();
+
+		// Beyond this limit neither the node nor any of its subtrees can get into the radius.
+		int const limit = radius + node.maxChildDistance;
+		int const distance = LevenshteinDistance::getBoundedLevenshteinDistance(node.key, key, limit, mRow);
+		++mLastComparisons;
+
+		if (distance <= radius)
+		{
+			float const normalized = static_cast<float>(distance * e / std::min(key.size(), node.key.size()));
+			bool const better = normalized < min
+					|| (normalized == min && !resultKey.isEmpty() && node.key < resultKey);
+			if (better && normalized < maxKeyDistance)
+			{
+				min = normalized;
+				result = node.id;
+				resultKey = node.key;
+			}
+		}
+
+		if (distance > limit)
+			continue;
+
+		QMap<int, int>::const_iterator const end = node.children.constEnd();
+		for (QMap<int, int>::const_iterator child = node.children.lowerBound(distance - radius)
+				; child != end && child.key() <= distance + radius; ++child)
+		{
+			mStack.append(child.value());
+		}
+	}
+	return result;
+}
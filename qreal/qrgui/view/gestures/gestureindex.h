@@ -0,0 +1,42 @@
+#pragma once
+#include "../../kernel/ids.h"
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QVector>
+
+/// Recognition index over the keys of ideal gestures. Keys are stored in a BK-tree
+/// (metric tree over Levenshtein distance), so a query compares the drawn key only
+/// with the keys that can still be closer than the recognition threshold instead of
+/// scanning every registered gesture.
+class GestureIndex
+{
+public:
+	GestureIndex();
+
+	void clear();
+	/// Adds a key of an ideal gesture. Adding an existing key replaces its element, as QMap::insert does.
+	void insert(QString const & key, qReal::Id const & id);
+	int size() const;
+
+	/// Returns the element whose key is nearest to the given one, or an empty Id if no key is
+	/// close enough. Gives the same result as a linear scan over the keys in ascending order.
+	qReal::Id nearest(QString const & key);
+
+	/// Number of edit distance computations made by the last nearest() call.
+	int lastComparisons() const;
+
+private:
+	struct Node
+	{
+		QString key;
+		qReal::Id id;
+		int maxChildDistance;
+		QMap<int, int> children;  // distance to the child key -> child node index
+	};
+
+	QVector<Node> mNodes;
+	QVector<int> mRow;
+	QVector<int> mStack;
+	int mLastComparisons;
+};
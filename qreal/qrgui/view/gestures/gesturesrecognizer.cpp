@@ -0,0 +1,46 @@
+#include "gesturesrecognizer.h"
+#include "keystringrecognizer.h"
+#include "gridrecognizers.h"
+
+static QString const comma = ", ";
+static QString const pointDelimeter = " : ";
+static QString const strokeDelimeter = " | ";
+
+QStringList GesturesRecognizer::names()
+{
+	return QStringList() << "keyString" << "rectangle" << "nearestPosGrid" << "sum" << "mixed"
+			<< "squaresCurve";
+}
+
+GesturesRecognizer *GesturesRecognizer::create(QString const & name)
+{
+	if (name == "rectangle")
+		return new RectangleRecognizer();
+	if (name == "nearestPosGrid")
+		return new NearestPosGridRecognizer();
+	if (name == "sum")
+		return new SumRecognizer();
+	if (name == "mixed")
+		return new MixedRecognizer();
+	if (name == "squaresCurve")
+		return new SquaresCurveRecognizer();
+	return new KeyStringRecognizer();
+}
+
+PathVector GesturesRecognizer::stringToGesture(QString const & str)
+{
+	PathVector gesture;
+	foreach (QString const & strokeStr, str.split(strokeDelimeter, QString::SkipEmptyParts))
+	{
+		PointVector stroke;
+		foreach (QString const & pointStr, strokeStr.split(pointDelimeter, QString::SkipEmptyParts))
+		{
+			int const x = pointStr.section(comma, 0, 0).toInt();
+			int const y = pointStr.section(comma, 1, 1).toInt();
+			stroke.push_back(QPoint(x, y));
+		}
+		if (!stroke.isEmpty())
+			gesture.push_back(stroke);
+	}
+	return gesture;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../../kernel/ids.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QPoint>
+
+typedef QList<QPoint> PointVector;
+/// Gesture as it was drawn: one list of points per stroke
+typedef QList<PointVector> PathVector;
+
+/// Recognizes a gesture drawn with the right mouse button as one of the elements of a diagram.
+/// Ideal gestures are turned into keys once, by setIdealGestures, so recognition only builds
+/// the key of the drawn gesture and compares it with the prepared ones.
+class GesturesRecognizer
+{
+public:
+	virtual ~GesturesRecognizer() {}
+
+	/// Replaces ideal gestures of elements
+	virtual void setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures) = 0;
+
+	/// Returns the element whose ideal gesture is nearest to the drawn one, or an empty Id if
+	/// none of them is close enough
+	virtual qReal::Id recognize(PathVector const & gesture) = 0;
+
+	/// Single-stroke recognizers take strokes of a gesture as one path, so the editor does not
+	/// wait for more strokes after the first one
+	virtual bool isMultistroke() const = 0;
+
+	/// Names of available recognizers, the first one is used by default
+	static QStringList names();
+	/// Creates a recognizer by its name, the default one if the name is unknown
+	static GesturesRecognizer *create(QString const & name);
+
+	/// Parses a gesture written as "x, y : x, y : " with strokes separated by " | ",
+	/// as ideal gestures in metamodels and recorded gestures are stored
+	static PathVector stringToGesture(QString const & str);
+};
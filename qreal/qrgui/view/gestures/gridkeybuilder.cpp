@@ -0,0 +1,145 @@
+#include "gridkeybuilder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static int const minMovement = 20;
+// A gesture that is this many times longer than wide is taken as a line
+static int const maxRelation = 8;
+
+static QPoint toCell(QPoint const & point, int left, int upper, int width, int height, int gridSize)
+{
+	QPoint cell;
+	if (height * maxRelation < width)
+		cell = QPoint((point.x() - left) * gridSize / width, 0);
+	else if (width * maxRelation < height)
+		cell = QPoint(0, (point.y() - upper) * gridSize / height);
+	else
+		cell = QPoint((point.x() - left) * gridSize / width, (point.y() - upper) * gridSize / height);
+	return QPoint(std::min(cell.x(), gridSize - 1), std::min(cell.y(), gridSize - 1));
+}
+
+GridKey GridKeyBuilder::getKey(PathVector const & gesture, int gridSize)
+{
+	GridKey key;
+	int left = 0;
+	int right = 0;
+	int upper = 0;
+	int lower = 0;
+	bool first = true;
+	foreach (PointVector const & stroke, gesture)
+	{
+		foreach (QPoint const & point, stroke)
+		{
+			if (first)
+			{
+				left = right = point.x();
+				upper = lower = point.y();
+				first = false;
+				continue;
+			}
+			left = std::min(left, point.x());
+			right = std::max(right, point.x());
+			upper = std::min(upper, point.y());
+			lower = std::max(lower, point.y());
+		}
+	}
+	int const width = right - left;
+	int const height = lower - upper;
+	if (first || (width < minMovement && height < minMovement))
+		return key;
+
+	foreach (PointVector const & stroke, gesture)
+	{
+		QPoint previous;
+		for (int i = 0; i < stroke.size(); ++i)
+		{
+			QPoint const cell = toCell(stroke[i], left, upper, width, height, gridSize);
+			if (i > 0)
+				rasterizeSegment(previous, cell, key);
+			previous = cell;
+		}
+	}
+	return key;
+}
+
+void GridKeyBuilder::rasterizeSegment(QPoint const & from, QPoint const & to, GridKey & key)
+{
+	// Segments of a stroke share their ends, the common cell is taken once
+	if (!key.isEmpty() && key.back() == from)
+		key.pop_back();
+	if (from == to)
+	{
+		key.push_back(from);
+		return;
+	}
+
+	// Bresenham's algorithm, both ends included
+	int x = from.x();
+	int y = from.y();
+	int deltaX = std::abs(to.x() - x);
+	int deltaY = std::abs(to.y() - y);
+	int const signX = to.x() > x ? 1 : (to.x() < x ? -1 : 0);
+	int const signY = to.y() > y ? 1 : (to.y() < y ? -1 : 0);
+	bool const swapped = deltaY > deltaX;
+	if (swapped)
+		std::swap(deltaX, deltaY);
+	int error = 2 * deltaY - deltaX;
+	for (int i = 0; i < deltaX; ++i)
+	{
+		key.push_back(QPoint(x, y));
+		while (error >= 0)
+		{
+			if (swapped)
+				x += signX;
+			else
+				y += signY;
+			error -= 2 * deltaX;
+		}
+		if (swapped)
+			y += signY;
+		else
+			x += signX;
+		error += 2 * deltaY;
+	}
+	key.push_back(to);
+}
+
+void GridKeyBuilder::distanceTransform(GridKey const & key, int gridSize, float * result)
+{
+	int const cellsCount = gridSize * gridSize;
+	if (key.isEmpty())
+	{
+		std::fill(result, result + cellsCount, static_cast<float>(gridSize));
+		return;
+	}
+
+	// Two passes of the city block chamfer give exact distances
+	float const infinity = static_cast<float>(2 * gridSize);
+	std::fill(result, result + cellsCount, infinity);
+	foreach (QPoint const & cell, key)
+		result[cell.x() * gridSize + cell.y()] = 0;
+
+	for (int i = 0; i < gridSize; ++i)
+	{
+		for (int j = 0; j < gridSize; ++j)
+		{
+			float & distance = result[i * gridSize + j];
+			if (i > 0)
+				distance = std::min(distance, result[(i - 1) * gridSize + j] + 1);
+			if (j > 0)
+				distance = std::min(distance, result[i * gridSize + j - 1] + 1);
+		}
+	}
+	for (int i = gridSize - 1; i >= 0; --i)
+	{
+		for (int j = gridSize - 1; j >= 0; --j)
+		{
+			float & distance = result[i * gridSize + j];
+			if (i < gridSize - 1)
+				distance = std::min(distance, result[(i + 1) * gridSize + j] + 1);
+			if (j < gridSize - 1)
+				distance = std::min(distance, result[i * gridSize + j + 1] + 1);
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "gesturesrecognizer.h"
+#include <QVector>
+
+/// Cells of a square grid crossed by a gesture, in the order they were drawn.
+/// A cell may occur several times if strokes cross it more than once.
+typedef QVector<QPoint> GridKey;
+
+/// Builds keys of multistroke gestures: the gesture is scaled to the grid as a whole,
+/// so the key does not depend on the size of the gesture and on the order of strokes.
+class GridKeyBuilder
+{
+public:
+	/// Returns an empty key for gestures smaller than a minimal movement
+	static GridKey getKey(PathVector const & gesture, int gridSize);
+
+	/// Fills result (gridSize * gridSize values, x-major) with the distance from every cell to
+	/// the nearest cell of the key in city block metric, gridSize everywhere for an empty key
+	static void distanceTransform(GridKey const & key, int gridSize, float * result);
+
+private:
+	static void rasterizeSegment(QPoint const & from, QPoint const & to, GridKey & key);
+};
@@ -0,0 +1,227 @@
+#include "gridrecognizers.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Distance to the nearest ideal gesture must be less than this for grid keys to be recognized
+static double const maxGridDistance = 1000;
+// Weight of RectangleRecognizer in MixedRecognizer
+static double const rectangleWeight = 0.2;
+static double const e = 10;
+
+int GridRecognizer::keySize() const
+{
+	return cellsCount;
+}
+
+double GridRecognizer::maxDistance() const
+{
+	return maxGridDistance;
+}
+
+bool GridRecognizer::isMultistroke() const
+{
+	return true;
+}
+
+void GridRecognizer::setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures)
+{
+	int const size = keySize();
+	mIds.clear();
+	mKeys.resize(gestures.size() * size);
+	for (int i = 0; i < gestures.size(); ++i)
+	{
+		mIds << gestures[i].first;
+		getKey(GridKeyBuilder::getKey(gestures[i].second, gridSize), mKeys.data() + i * size);
+	}
+}
+
+qReal::Id GridRecognizer::recognize(PathVector const & gesture)
+{
+	int const size = keySize();
+	mKey.resize(size);
+	getKey(GridKeyBuilder::getKey(gesture, gridSize), mKey.data());
+
+	qReal::Id result;
+	double minDistance = maxDistance();
+	float const * const keys = mKeys.constData();
+	for (int i = 0; i < mIds.size(); ++i)
+	{
+		double const distance = getDistance(mKey.constData(), keys + i * size);
+		if (distance < minDistance)
+		{
+			minDistance = distance;
+			result = mIds[i];
+		}
+	}
+	return result;
+}
+
+double GridRecognizer::getCellsDistance(float const * key1, float const * key2, bool withMaximum)
+{
+	double sum = 0;
+	float maximum = 0;
+	for (int i = 0; i < cellsCount; ++i)
+	{
+		float const difference = std::fabs(key1[i] - key2[i]);
+		sum += difference;
+		maximum = std::max(maximum, difference);
+	}
+	return (withMaximum ? maximum : 0) + sum / cellsCount;
+}
+
+void RectangleRecognizer::getKey(GridKey const & cells, float * key) const
+{
+	// Number of cells of the gesture below and to the right of a cell, by suffix sums
+	// of the histogram of the gesture
+	std::fill(key, key + cellsCount, 0.0f);
+	foreach (QPoint const & cell, cells)
+	{
+		if (cell.x() > 0 && cell.y() > 0)
+			++key[(cell.x() - 1) * gridSize + cell.y() - 1];
+	}
+	for (int i = gridSize - 1; i >= 0; --i)
+	{
+		for (int j = gridSize - 1; j >= 0; --j)
+		{
+			float & value = key[i * gridSize + j];
+			if (i < gridSize - 1)
+				value += key[(i + 1) * gridSize + j];
+			if (j < gridSize - 1)
+				value += key[i * gridSize + j + 1];
+			if (i < gridSize - 1 && j < gridSize - 1)
+				value -= key[(i + 1) * gridSize + j + 1];
+		}
+	}
+	float const size = cells.size();
+	for (int i = 0; i < cellsCount; ++i)
+		key[i] = size - key[i];
+}
+
+double RectangleRecognizer::getDistance(float const * key1, float const * key2) const
+{
+	return getCellsDistance(key1, key2, false);
+}
+
+void NearestPosGridRecognizer::getKey(GridKey const & cells, float * key) const
+{
+	GridKeyBuilder::distanceTransform(cells, gridSize, key);
+}
+
+double NearestPosGridRecognizer::getDistance(float const * key1, float const * key2) const
+{
+	return getCellsDistance(key1, key2, true);
+}
+
+static bool cellLessThan(QPoint const & cell1, QPoint const & cell2)
+{
+	return cell1.x() < cell2.x() || (cell1.x() == cell2.x() && cell1.y() < cell2.y());
+}
+
+void SumRecognizer::getKey(GridKey const & cells, float * key) const
+{
+	GridKey sorted = cells;
+	std::sort(sorted.begin(), sorted.end(), cellLessThan);
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+	std::fill(key, key + cellsCount, 0.0f);
+	for (int i = 0; i < sorted.size(); ++i)
+	{
+		int const begin = sorted[i].x() * gridSize + sorted[i].y();
+		int const end = i < sorted.size() - 1 ? sorted[i + 1].x() * gridSize + sorted[i + 1].y()
+				: cellsCount - 1;
+		std::fill(key + begin, key + end + 1, static_cast<float>(i + 1));
+	}
+}
+
+double SumRecognizer::getDistance(float const * key1, float const * key2) const
+{
+	return getCellsDistance(key1, key2, true);
+}
+
+int MixedRecognizer::keySize() const
+{
+	return 2 * cellsCount;
+}
+
+void MixedRecognizer::getKey(GridKey const & cells, float * key) const
+{
+	mRectangle.getKey(cells, key);
+	mNearestPos.getKey(cells, key + cellsCount);
+}
+
+double MixedRecognizer::getDistance(float const * key1, float const * key2) const
+{
+	return rectangleWeight * getCellsDistance(key1, key2, false)
+			+ (1 - rectangleWeight) * getCellsDistance(key1 + cellsCount, key2 + cellsCount, true);
+}
+
+void SquaresCurveRecognizer::setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures)
+{
+	int const cellsCount = GridRecognizer::gridSize * GridRecognizer::gridSize;
+	mGestures.clear();
+	mDistances.resize(gestures.size() * cellsCount);
+	for (int i = 0; i < gestures.size(); ++i)
+	{
+		IdealGesture gesture;
+		gesture.id = gestures[i].first;
+		gesture.cells = GridKeyBuilder::getKey(gestures[i].second, GridRecognizer::gridSize);
+		gesture.distancesOffset = i * cellsCount;
+		GridKeyBuilder::distanceTransform(gesture.cells, GridRecognizer::gridSize
+				, mDistances.data() + gesture.distancesOffset);
+		mGestures << gesture;
+	}
+}
+
+void SquaresCurveRecognizer::nearestDistances(GridKey const & cells, float const * distances
+		, int otherSize, double & maximum, double & mean)
+{
+	// The original metric takes the size of the other gesture as the distance to an empty one
+	if (otherSize == 0)
+	{
+		maximum = cells.size();
+		mean = cells.size();
+		return;
+	}
+	maximum = 0;
+	double sum = 0;
+	foreach (QPoint const & cell, cells)
+	{
+		float const distance = distances[cell.x() * GridRecognizer::gridSize + cell.y()];
+		sum += distance;
+		maximum = std::max(maximum, static_cast<double>(distance));
+	}
+	mean = cells.isEmpty() ? otherSize : sum / cells.size();
+}
+
+qReal::Id SquaresCurveRecognizer::recognize(PathVector const & gesture)
+{
+	GridKey const key = GridKeyBuilder::getKey(gesture, GridRecognizer::gridSize);
+	mKeyDistances.resize(GridRecognizer::gridSize * GridRecognizer::gridSize);
+	GridKeyBuilder::distanceTransform(key, GridRecognizer::gridSize, mKeyDistances.data());
+
+	qReal::Id result;
+	double minDistance = GridRecognizer::gridSize * e;
+	foreach (IdealGesture const & ideal, mGestures)
+	{
+		double maximum1 = 0;
+		double mean1 = 0;
+		double maximum2 = 0;
+		double mean2 = 0;
+		nearestDistances(key, mDistances.constData() + ideal.distancesOffset, ideal.cells.size()
+				, maximum1, mean1);
+		nearestDistances(ideal.cells, mKeyDistances.constData(), key.size(), maximum2, mean2);
+		double const distance = std::max(maximum1, maximum2) + mean1 + mean2;
+		if (distance < minDistance)
+		{
+			minDistance = distance;
+			result = ideal.id;
+		}
+	}
+	return result;
+}
+
+bool SquaresCurveRecognizer::isMultistroke() const
+{
+	return true;
+}
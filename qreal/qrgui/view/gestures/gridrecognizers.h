@@ -0,0 +1,99 @@
+#pragma once
+#include "gesturesrecognizer.h"
+#include "gridkeybuilder.h"
+#include <QVector>
+
+/// Multistroke recognizers of tools/MouseGestures. A gesture is rasterized on a fine grid
+/// and described by a value per cell, so gestures of any number of strokes are compared
+/// cell by cell. Keys of ideal gestures are kept in one array and the drawn key is built
+/// into a reused buffer, so recognition allocates nothing per ideal gesture.
+class GridRecognizer : public GesturesRecognizer
+{
+public:
+	void setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures);
+	qReal::Id recognize(PathVector const & gesture);
+	bool isMultistroke() const;
+
+	static int const gridSize = 81;
+
+protected:
+	static int const cellsCount = gridSize * gridSize;
+
+	/// Number of values in a key
+	virtual int keySize() const;
+	virtual void getKey(GridKey const & cells, float * key) const = 0;
+	virtual double getDistance(float const * key1, float const * key2) const = 0;
+	/// Gestures farther than this from every ideal one are not recognized
+	virtual double maxDistance() const;
+
+	/// Mean difference of cells, plus the largest one if withMaximum
+	static double getCellsDistance(float const * key1, float const * key2, bool withMaximum);
+
+private:
+	QList<qReal::Id> mIds;
+	QVector<float> mKeys;
+	QVector<float> mKey;
+};
+
+/// Value of a cell is the number of cells of the gesture that are not below and to the right of it
+class RectangleRecognizer : public GridRecognizer
+{
+public:
+	void getKey(GridKey const & cells, float * key) const;
+	double getDistance(float const * key1, float const * key2) const;
+};
+
+/// Value of a cell is the distance to the nearest cell of the gesture
+class NearestPosGridRecognizer : public GridRecognizer
+{
+public:
+	void getKey(GridKey const & cells, float * key) const;
+	double getDistance(float const * key1, float const * key2) const;
+};
+
+/// Cells of the gesture are sorted, value of a cell is the number of cells of the gesture before it
+class SumRecognizer : public GridRecognizer
+{
+public:
+	void getKey(GridKey const & cells, float * key) const;
+	double getDistance(float const * key1, float const * key2) const;
+};
+
+/// Weighted sum of distances of RectangleRecognizer and NearestPosGridRecognizer
+class MixedRecognizer : public GridRecognizer
+{
+public:
+	int keySize() const;
+	void getKey(GridKey const & cells, float * key) const;
+	double getDistance(float const * key1, float const * key2) const;
+
+private:
+	RectangleRecognizer mRectangle;
+	NearestPosGridRecognizer mNearestPos;
+};
+
+/// Compares cells of gestures themselves: the largest and the mean distance from cells of
+/// one gesture to the nearest cells of the other, both ways. Distance transforms of ideal
+/// gestures are prepared once, so a comparison is linear in the number of cells.
+class SquaresCurveRecognizer : public GesturesRecognizer
+{
+public:
+	void setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures);
+	qReal::Id recognize(PathVector const & gesture);
+	bool isMultistroke() const;
+
+private:
+	struct IdealGesture
+	{
+		qReal::Id id;
+		GridKey cells;
+		int distancesOffset;
+	};
+
+	static void nearestDistances(GridKey const & cells, float const * distances, int otherSize
+			, double & maximum, double & mean);
+
+	QList<IdealGesture> mGestures;
+	QVector<float> mDistances;
+	QVector<float> mKeyDistances;
+};
@@ -0,0 +1,33 @@
+#include "keystringrecognizer.h"
+#include "pathcorrector.h"
+
+void KeyStringRecognizer::setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures)
+{
+	mGestureIndex.clear();
+	for (int i = 0; i < gestures.size(); ++i)
+	{
+		PointVector const path = PathCorrector::getMousePath(joinStrokes(gestures[i].second));
+		mGestureIndex.insert(mKeyManager.getKey(path), gestures[i].first);
+	}
+}
+
+qReal::Id KeyStringRecognizer::recognize(PathVector const & gesture)
+{
+	PointVector const path = PathCorrector::correctPath(joinStrokes(gesture));
+	return mGestureIndex.nearest(mKeyManager.getKey(path));
+}
+
+bool KeyStringRecognizer::isMultistroke() const
+{
+	return false;
+}
+
+PointVector KeyStringRecognizer::joinStrokes(PathVector const & gesture)
+{
+	if (gesture.size() == 1)
+		return gesture[0];
+	PointVector path;
+	foreach (PointVector const & stroke, gesture)
+		path << stroke;
+	return path;
+}
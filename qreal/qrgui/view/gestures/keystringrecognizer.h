@@ -0,0 +1,20 @@
+#pragma once
+#include "gesturesrecognizer.h"
+#include "keymanager.h"
+#include "gestureindex.h"
+
+/// Single-stroke recognizer: a gesture is turned into a string of cells of a coarse grid
+/// and compared with ideal keys by Levenshtein distance, using GestureIndex
+class KeyStringRecognizer : public GesturesRecognizer
+{
+public:
+	void setIdealGestures(QList<QPair<qReal::Id, PathVector> > const & gestures);
+	qReal::Id recognize(PathVector const & gesture);
+	bool isMultistroke() const;
+
+private:
+	static PointVector joinStrokes(PathVector const & gesture);
+
+	KeyManager mKeyManager;
+	GestureIndex mGestureIndex;
+};
@@ -1,47 +1,58 @@
 #include "levenshteindistance.h"
 #include <QtCore/QList>
 
+#include <algorithm>
+#include <cstdlib>
+
 int LevenshteinDistance::getLevenshteinDistance(QString const & key1, QString const & key2)
 {
-	int m = key1.size();
-	int n = key2.size();
+	QVector<int> row;
+	return getBoundedLevenshteinDistance(key1, key2, std::max(key1.size(), key2.size()), row);
+}
+
+int LevenshteinDistance::getBoundedLevenshteinDistance(QString const & key1, QString const & key2
+		, int maxDistance, QVector<int> & row)
+{
+	int const m = key1.size();
+	int const n = key2.size();
+	int const outOfBand = maxDistance + 1;
+	if (std::abs(m - n) > maxDistance)
+		return outOfBand;
 	if (m == 0)
 		return n;
 	if (n == 0)
 		return m;
-	QList<QList<int> > matrix;
-	for (int i = 0; i <= m; i++)
-	{
-		QList<int> list;
-		for (int j = 0; j <= n; j++)
-			list << 0;
-		matrix << list;
-	}
 
-	for (int i = 0; i <= m; i++)
-		for (int j = 0; j <= n; j++)
-			if (i == 0 || j == 0)
-				matrix[i][j] = std::max(i, j);
+	// row[j] holds the distance between the first i symbols of key1 and the first j symbols of key2,
+	// cells outside the band are kept at outOfBand.
+	row.resize(n + 1);
+	for (int j = 0; j <= n; j++)
+		row[j] = std::min(j, outOfBand);
 
-	matrix[0][0] = 0;
-	int cost = 0;
+	QChar const *data1 = key1.constData();
+	QChar const *data2 = key2.constData();
 	for (int i = 1; i <= m; ++i)
 	{
-		for(int j = 1; j <= n; ++j)
+		int const low = std::max(1, i - maxDistance);
+		int const high = std::min(n, i + maxDistance);
+
+		int diagonalCell = row[low - 1];
+		row[low - 1] = (low == 1) ? std::min(i, outOfBand) : outOfBand;
+		int rowMin = row[low - 1];
+
+		for (int j = low; j <= high; ++j)
 		{
-			if (key1[i - 1] == key2[j - 1])
-			{
-				cost = 0;
-			}
-			else
-			{
-				cost = 1;
-			}
-			int aboveCell = matrix[i - 1][j];
-			int leftCell = matrix[i][j - 1];
-			int diagonalCell = matrix[i - 1][j - 1];
-			matrix[i][j] = std::min(std::min(aboveCell + 1, leftCell + 1), diagonalCell + cost);
+			int const cost = (data1[i - 1] == data2[j - 1]) ? 0 : 1;
+			int const aboveCell = row[j];
+			int const leftCell = row[j - 1];
+			int const cell = std::min(std::min(std::min(aboveCell + 1, leftCell + 1), diagonalCell + cost)
+					, outOfBand);
+			diagonalCell = aboveCell;
+			row[j] = cell;
+			rowMin = std::min(rowMin, cell);
 		}
+		if (rowMin > maxDistance)
+			return outOfBand;
 	}
-	return matrix[m][n];
+	return row[n];
 }
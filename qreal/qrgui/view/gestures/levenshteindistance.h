@@ -1,9 +1,17 @@
 #pragma once
 #include <QString>
 #include <QList>
+#include <QVector>
 
 class LevenshteinDistance
 {
 public:
 	static int getLevenshteinDistance(QString const & key1, QString const & key2);
+
+	/// Computes the distance only inside a band of width 2 * maxDistance + 1 around the diagonal
+	/// and stops as soon as a whole row exceeds maxDistance. Returns the exact distance if it is
+	/// not greater than maxDistance and maxDistance + 1 otherwise. The row buffer is reused between
+	/// calls, so a caller comparing one key against many others allocates only once.
+	static int getBoundedLevenshteinDistance(QString const & key1, QString const & key2
+			, int maxDistance, QVector<int> & row);
 };
@@ -1,17 +1,17 @@
 #include "mousemovementmanager.h"
 #include "pathcorrector.h"
-#include "levenshteindistance.h"
 
-const QString comma = ", ";
-const QString pointDelimeter = " : ";
-
-MouseMovementManager::MouseMovementManager(QList<qReal::Id> elements, qReal::EditorManager * editorManager,
+MouseMovementManager::MouseMovementManager(qReal::Id const & diagram, qReal::EditorManager * editorManager,
 										   IGesturesPainter *gesturesPaintManager)
+	: mPointsCount(0), mDiagram(diagram)
 {
-	mKeyManager = &mKeyStringManager;
 	mEditorManager = editorManager;
 	mGesturesPaintMan = gesturesPaintManager;
-	setElements(elements);
+	foreach (qReal::Id element, mEditorManager->elements(diagram))
+	{
+		if (!mEditorManager->mouseGesture(element).isEmpty())
+			mElements.push_back(element);
+	}
 }
 
 void MouseMovementManager::setGesturesPainter(IGesturesPainter *gesturesPainter)
@@ -22,7 +22,7 @@ void MouseMovementManager::setGesturesPainter(IGesturesPainter *gesturesPainter)
 void MouseMovementManager::drawIdealPath()
 {
 	QString currentElement = mGesturesPaintMan->currentElement();
-	foreach (qReal::Id element, mGestures.values())
+	foreach (qReal::Id element, mElements)
 	{
 		if (element.element() == currentElement)
 		{
@@ -35,7 +35,7 @@ void MouseMovementManager::drawIdealPath()
 void MouseMovementManager::printElements()
 {
 	QList<QString> elements;
-	foreach (qReal::Id element, mGestures.values())
+	foreach (qReal::Id element, mElements)
 	{
 		elements.push_back(element.element());
 	}
@@ -44,45 +44,34 @@ void MouseMovementManager::printElements()
 
 void MouseMovementManager::clear()
 {
-	mPath.clear();
+	mGesture.clear();
+	mPointsCount = 0;
 }
 
 QLineF MouseMovementManager::newLine()
 {
 	QLineF line;
-	if (mPath.size() > 1)
+	if (!mGesture.isEmpty() && mGesture.back().size() > 1)
 	{
-		line.setP1(mPath[mPath.size() - 2]);
-		line.setP2(mPath.back());
+		PointVector const & stroke = mGesture.back();
+		line.setP1(stroke[stroke.size() - 2]);
+		line.setP2(stroke.back());
 	}
 	return line;
 }
 
-void MouseMovementManager::createMap()
-{
-	mGestures.clear();
-	foreach (qReal::Id element, mElements)
-	{
-		QString pathStr = mEditorManager->mouseGesture(element);
-		if (!pathStr.isEmpty())
-		{
-			QList<QPoint> path = stringToPath(pathStr);
-			QString key = mKeyManager->getKey(path);
-			mGestures.insert(key, element);
-		}
-	}
-}
-
-void MouseMovementManager::setElements(const QList<qReal::Id> &elements)
+void MouseMovementManager::newStroke()
 {
-	mElements = elements;
-	createMap();
+	mGesture.push_back(PointVector());
 }
 
 void MouseMovementManager::addPoint(const QPointF &point)
 {
-	mCentre = ((mPath.count() * mCentre + point) / (mPath.count() + 1));
-	mPath.push_back(QPoint((int)point.x(), (int)point.y()));
+	if (mGesture.isEmpty())
+		newStroke();
+	mCentre = ((mPointsCount * mCentre + point) / (mPointsCount + 1));
+	mGesture.back().push_back(QPoint((int)point.x(), (int)point.y()));
+	++mPointsCount;
 }
 
 QPointF MouseMovementManager::pos()
@@ -92,64 +81,51 @@ QPointF MouseMovementManager::pos()
 
 QList<QPoint> MouseMovementManager::stringToPath(QString const &valueStr)
 {
-	QStringList points = valueStr.split(pointDelimeter, QString::SkipEmptyParts);
 	QList<QPoint> result;
-	foreach (QString str, points)
-	{
-		QPoint point = parsePoint(str);
-		result.push_back(point);
-	}
-	result = PathCorrector::getMousePath(result);
-	return result;
+	foreach (PointVector const & stroke, GesturesRecognizer::stringToGesture(valueStr))
+		result << stroke;
+	return PathCorrector::getMousePath(result);
 }
 
-QPoint MouseMovementManager::parsePoint(QString const &str)
+GesturesRecognizer *MouseMovementManager::recognizer() const
 {
-	bool isInt;
-	int x = str.section(comma, 0, 0).toInt(&isInt, 0);
-	int y = str.section(comma, 1, 1).toInt(&isInt, 0);
-	return QPoint(x, y);
+	return mEditorManager->gesturesRecognizer(mDiagram);
 }
 
 qReal::Id MouseMovementManager::getObject()
 {
-	const float e = 100;
-	const float maxKeyDistance = 100;
-	float min = e;
-	float distance;
-	qReal::Id id;
-	mPath = PathCorrector::correctPath(mPath);
-	QString key = mKeyManager->getKey(mPath);
-	if (key.isEmpty())
-		return id;
-	foreach (QString idealKey, mGestures.keys())
-	{
-		distance = (float)(LevenshteinDistance::getLevenshteinDistance(idealKey, key) * e
-						   / std::min(key.size(), idealKey.size()));
-		if (distance < min && distance < maxKeyDistance)
-		{
-			min = distance;
-			id = mGestures[idealKey];
-		}
-	}
-	return id;
+	GesturesRecognizer * const gesturesRecognizer = recognizer();
+	if (!gesturesRecognizer)
+		return qReal::Id();
+	return gesturesRecognizer->recognize(mGesture);
 }
 
 QPointF MouseMovementManager::firstPoint()
 {
-	if (!mPath.isEmpty())
-		return QPointF(mPath[0]);
+	if (!mGesture.isEmpty() && !mGesture[0].isEmpty())
+		return QPointF(mGesture[0][0]);
 	return QPointF(0, 0);
 }
 
 QPointF MouseMovementManager::lastPoint()
 {
-	if (!mPath.isEmpty())
-		return QPointF(mPath.back());
+	if (!mGesture.isEmpty() && !mGesture.back().isEmpty())
+		return QPointF(mGesture.back().back());
 	return QPointF(0, 0);
 }
 
 bool MouseMovementManager::wasMoving()
 {
-	return (firstPoint() != lastPoint() || mPath.size() > 2);
+	return (firstPoint() != lastPoint() || mPointsCount > 2);
+}
+
+int MouseMovementManager::strokesCount() const
+{
+	return mGesture.size();
+}
+
+bool MouseMovementManager::isMultistroke() const
+{
+	GesturesRecognizer * const gesturesRecognizer = recognizer();
+	return gesturesRecognizer && gesturesRecognizer->isMultistroke();
 }
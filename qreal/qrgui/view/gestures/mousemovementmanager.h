@@ -1,6 +1,5 @@
 #pragma once
-#include "IKeyManager.h"
-#include "keymanager.h"
+#include "gesturesrecognizer.h"
 #include "../../kernel/ids.h"
 #include "../../editorManager/editorManager.h"
 #include "../../mainwindow/igesturespainter.h"
@@ -9,16 +8,16 @@
 #include <QLineF>
 #include <QList>
 #include <QString>
-#include <QMap>
 
 
 class MouseMovementManager
 {
 public:
-	MouseMovementManager(QList<qReal::Id> elements,
+	MouseMovementManager(qReal::Id const & diagram,
 						 qReal::EditorManager * editorManager,
 						 IGesturesPainter * gesturesPaintManager);
-	void setElements(QList<qReal::Id> const & elements);
+	/// Starts a new stroke of the gesture
+	void newStroke();
 	void addPoint(QPointF const & point);
 	void clear();
 	void setGesturesPainter(IGesturesPainter * gesturesPainter);
@@ -31,16 +30,19 @@ public:
 	void printElements();
 	void drawIdealPath();
 	bool wasMoving();
+	int strokesCount() const;
+	/// Whether the gesture may be continued by another stroke
+	bool isMultistroke() const;
 
 private:
-	static QPoint parsePoint(QString const &str);
-	void createMap();
-	QList<QPoint> mPath;
-	IKeyManager * mKeyManager;
-	KeyManager mKeyStringManager;
+	/// Looked up every time, as plugin reloading deletes recognizers.
+	GesturesRecognizer *recognizer() const;
+
+	PathVector mGesture;
+	int mPointsCount;
 	qReal::EditorManager * mEditorManager;
+	qReal::Id mDiagram;
 	QList<qReal::Id> mElements;
-	QMap<QString, qReal::Id> mGestures;
 	QPointF mCentre;
 	IGesturesPainter * mGesturesPaintMan;
 };
@@ -1,16 +1,28 @@
 HEADERS += view/editorview.h \
 	view/editorviewscene.h \
 	view/editorviewmviface.h \
+	view/diagramNotificationRouter.h \
 	view/gestures/pathcorrector.h \
 	view/gestures/mousemovementmanager.h \
 	view/gestures/levenshteindistance.h \
+	view/gestures/gestureindex.h \
+	view/gestures/gesturesrecognizer.h \
+	view/gestures/keystringrecognizer.h \
+	view/gestures/gridkeybuilder.h \
+	view/gestures/gridrecognizers.h \
 	view/gestures/keymanager.h \
 	view/gestures/ikeymanager.h
 
 SOURCES += view/editorview.cpp \
 	view/editorviewscene.cpp \
 	view/editorviewmviface.cpp \
+	view/diagramNotificationRouter.cpp \
 	view/gestures/pathcorrector.cpp \
 	view/gestures/mousemovementmanager.cpp \
 	view/gestures/levenshteindistance.cpp \
+	view/gestures/gestureindex.cpp \
+	view/gestures/gesturesrecognizer.cpp \
+	view/gestures/keystringrecognizer.cpp \
+	view/gestures/gridkeybuilder.cpp \
+	view/gestures/gridrecognizers.cpp \
 	view/gestures/keymanager.cpp
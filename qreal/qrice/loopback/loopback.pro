@@ -0,0 +1,23 @@
+# Loopback benchmark for the qrice server: measures round-trips and latency
+# of fetching a whole model element by element and with the batch API.
+# Run slice2cpp *.ice in the parent directory first.
+SOURCES = main.cpp ../repoclienticeI.cpp ../repoclientice.cpp
+HEADERS = ../repoclienticeI.h ../repoclientice.h
+
+CONFIG += console warn_on debug
+QMAKE_CLEAN += loopback
+
+OBJECTS_DIR     = obj
+MOC_DIR         = moc
+
+INCLUDEPATH += .. ../../qrgui
+
+unix:INCLUDEPATH += /opt/Ice-3.3/include
+win32:INCLUDEPATH += c:/Ice-3.2.1/include
+
+unix:LIBS += -L/opt/Ice-3.3/lib
+win32:LIBS += -L'c:/Ice-3.2.1/lib'
+
+LIBS += -lIce -lIceUtil
+
+LIBS +=  -L../../qrgui -lqrrepo
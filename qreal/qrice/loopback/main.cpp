@@ -0,0 +1,148 @@
+#include "../../qrrepo/repoApi.h"
+#include "../../qrgui/kernel/definitions.h"
+#include <QString>
+#include <QTextStream>
+#include <QDir>
+#include <QCoreApplication>
+
+#include <Ice/Ice.h>
+#include <IceUtil/Time.h>
+#include <repoclienticeI.h>
+
+// Starts the repository servant and a client in separate communicators connected over
+// 127.0.0.1, fills the model with elements through the batch API and then fetches it
+// back twice: element by element (children + name per element, as clients do it now)
+// and with a single fetchSubtree call. Reports round-trips and time for both.
+//
+// Usage: loopback [ELEMENTS_COUNT]
+
+using namespace RepoIce;
+
+namespace {
+
+class CountingObserver : public RepoObserver
+{
+public:
+	CountingObserver() : added(0), changed(0), removed(0) {}
+
+	virtual void propertiesChanged(const PropertyChangeList& changes, const Ice::Current&)
+	{
+		IceUtil::Mutex::Lock lock(mutex);
+		changed += changes.size();
+	}
+
+	virtual void elementsAdded(const ElementDataList& elements, const Ice::Current&)
+	{
+		IceUtil::Mutex::Lock lock(mutex);
+		added += elements.size();
+	}
+
+	virtual void elementsRemoved(const IdList& ids, const Ice::Current&)
+	{
+		IceUtil::Mutex::Lock lock(mutex);
+		removed += ids.size();
+	}
+
+	IceUtil::Mutex mutex;
+	size_t added;
+	size_t changed;
+	size_t removed;
+};
+
+int roundTrips = 0;
+
+void fetchElementwise(RepoApiPrx const &repo, std::string const &id, int &elements)
+{
+	++elements;
+	repo->name(id);
+	++roundTrips;
+	IdList const children = repo->children(id);
+	++roundTrips;
+	for (IdList::const_iterator i = children.begin(); i != children.end(); i++)
+		fetchElementwise(repo, *i, elements);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+	QTextStream out(stdout);
+	int const count = argc > 1 ? QString(argv[1]).toInt() : 10000;
+
+	QString const workingDir = QDir::temp().filePath(QString("qrice-loopback-%1").arg(QCoreApplication::applicationPid()));
+	qrRepo::RepoApi repoApi(workingDir);
+
+	Ice::CommunicatorPtr server = Ice::initialize(argc, argv);
+	Ice::CommunicatorPtr client = Ice::initialize(argc, argv);
+	int status = 0;
+
+	try {
+		Ice::ObjectAdapterPtr adapter = server->createObjectAdapterWithEndpoints("RepoApiAdapter", "tcp -h 127.0.0.1");
+		RepoApiI::_adapter = adapter;
+		Ice::ObjectPrx const serverProxy = adapter->add(new RepoApiI(repoApi), server->stringToIdentity("RepoApi"));
+		adapter->activate();
+
+		RepoApiPrx const repo = RepoApiPrx::checkedCast(client->stringToProxy(server->proxyToString(serverProxy)));
+
+		Ice::ObjectAdapterPtr observerAdapter = client->createObjectAdapterWithEndpoints("ObserverAdapter", "tcp -h 127.0.0.1");
+		CountingObserver *observer = new CountingObserver();
+		Ice::ObjectPtr const observerServant = observer;
+		RepoObserverPrx const observerProxy = RepoObserverPrx::uncheckedCast(
+				observerAdapter->add(observerServant, client->stringToIdentity("Observer")));
+		observerAdapter->activate();
+		repo->subscribe(observerProxy);
+
+		// Model: one diagram with `count` elements, ten children per container.
+		qReal::Id const diagram("LoopbackEditor", "LoopbackDiagram", "Diagram", "diagram");
+		ElementDataList elements;
+		ElementData diagramData;
+		diagramData.id = diagram.toString().toStdString();
+		diagramData.parent = ROOTID;
+		diagramData.properties["name"] = "diagram";
+		elements.push_back(diagramData);
+		for (int i = 0; i < count; ++i) {
+			ElementData element;
+			element.id = qReal::Id("LoopbackEditor", "LoopbackDiagram", "Node", QString::number(i)).toString().toStdString();
+			element.parent = i < 10 ? diagramData.id : elements[i / 10].id;
+			element.properties["name"] = QString("node %1").arg(i).toStdString();
+			element.properties["position"] = "0, 0";
+			elements.push_back(element);
+		}
+
+		IceUtil::Time start = IceUtil::Time::now();
+		repo->createElements(elements);
+		out << "createElements: " << elements.size() << " elements, 1 round-trip, "
+				<< (IceUtil::Time::now() - start).toMilliSecondsDouble() << " ms" << endl;
+
+		int fetched = 0;
+		roundTrips = 0;
+		start = IceUtil::Time::now();
+		fetchElementwise(repo, diagramData.id, fetched);
+		out << "element by element: " << fetched << " elements, " << roundTrips << " round-trips, "
+				<< (IceUtil::Time::now() - start).toMilliSecondsDouble() << " ms" << endl;
+
+		start = IceUtil::Time::now();
+		ElementDataList const subtree = repo->fetchSubtree(diagramData.id);
+		out << "fetchSubtree: " << subtree.size() << " elements with properties, 1 round-trip, "
+				<< (IceUtil::Time::now() - start).toMilliSecondsDouble() << " ms" << endl;
+
+		repo->unsubscribe(observerProxy);
+		// Oneway notifications may still be in flight, give them a moment.
+		IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(500));
+		{
+			IceUtil::Mutex::Lock lock(observer->mutex);
+			out << "notified about " << observer->added << " added elements" << endl;
+		}
+
+		if (static_cast<int>(subtree.size()) != fetched || fetched != count + 1)
+			status = 1;
+	} catch (const Ice::Exception &e) {
+		out << "Ice exception: " << e.what() << endl;
+		status = 1;
+	}
+
+	RepoApiI::_adapter = 0;
+	client->destroy();
+	server->destroy();
+	return status;
+}
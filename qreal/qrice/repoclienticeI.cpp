@@ -19,6 +19,12 @@ void
 RepoIce::RepoApiI::setName(const ::std::string& id, const ::std::string& name, const Ice::Current& )
 {
 	repoApi.setName(qReal::Id::loadFromString(QString::fromStdString(id)),QString::fromStdString(name));
+
+	::RepoIce::PropertyChange change;
+	change.id = id;
+	change.propertyName = "name";
+	change.value = name;
+	notifyPropertiesChanged(::RepoIce::PropertyChangeList(1, change));
 }
 
 ::RepoIce::IdList
@@ -37,6 +43,7 @@ void
 RepoIce::RepoApiI::addChild(const ::std::string& id, const ::std::string& child, const Ice::Current& )
 {
 	repoApi.addChild(toqRealId(id), toqRealId(child));
+	notifyElementsAdded(::RepoIce::ElementDataList(1, elementData(toqRealId(child))));
 }
 
 void
@@ -49,6 +56,7 @@ void
 RepoIce::RepoApiI::removeElement(const ::std::string& id, const Ice::Current& )
 {
 	repoApi.removeElement(toqRealId(id));
+	notifyElementsRemoved(::RepoIce::IdList(1, id));
 }
 
 ::RepoIce::IdList
@@ -133,6 +141,12 @@ void
 RepoIce::RepoApiI::setProperty(const ::std::string& id, const ::std::string& propertyName, const ::std::string& value, const Ice::Current& )
 {
 	repoApi.setProperty(toqRealId(id), QString::fromStdString(propertyName), QString::fromStdString(value));
+
+	::RepoIce::PropertyChange change;
+	change.id = id;
+	change.propertyName = propertyName;
+	change.value = value;
+	notifyPropertiesChanged(::RepoIce::PropertyChangeList(1, change));
 }
 
 void
@@ -212,3 +226,198 @@ RepoIce::RepoApiI::save(const Ice::Current& )
 {
 	repoApi.save();
 }
+
+::RepoIce::PropertyMapList
+RepoIce::RepoApiI::getProperties(const ::RepoIce::IdList& ids, const ::RepoIce::StringList& propertyNames, const Ice::Current& )
+{
+	::RepoIce::PropertyMapList result;
+	result.reserve(ids.size());
+
+	for (::RepoIce::IdList::const_iterator i = ids.begin(); i != ids.end(); i++) {
+		qReal::Id const id = toqRealId(*i);
+		if (propertyNames.empty()) {
+			result.push_back(properties(id));
+			continue;
+		}
+
+		::RepoIce::PropertyMap map;
+		for (::RepoIce::StringList::const_iterator name = propertyNames.begin(); name != propertyNames.end(); name++) {
+			QString const propertyName = QString::fromStdString(*name);
+			if (repoApi.hasProperty(id, propertyName))
+				map[*name] = repoApi.property(id, propertyName).toString().toStdString();
+		}
+		result.push_back(map);
+	}
+
+	return result;
+}
+
+void
+RepoIce::RepoApiI::setProperties(const ::RepoIce::PropertyChangeList& changes, const Ice::Current& )
+{
+	for (::RepoIce::PropertyChangeList::const_iterator i = changes.begin(); i != changes.end(); i++)
+		repoApi.setProperty(toqRealId(i->id), QString::fromStdString(i->propertyName), QString::fromStdString(i->value));
+
+	notifyPropertiesChanged(changes);
+}
+
+::RepoIce::ElementDataList
+RepoIce::RepoApiI::fetchSubtree(const ::std::string& id, const Ice::Current& )
+{
+	::RepoIce::ElementDataList result;
+	collectSubtree(toqRealId(id), result);
+	return result;
+}
+
+void
+RepoIce::RepoApiI::createElements(const ::RepoIce::ElementDataList& elements, const Ice::Current& )
+{
+	for (::RepoIce::ElementDataList::const_iterator i = elements.begin(); i != elements.end(); i++) {
+		qReal::Id const id = toqRealId(i->id);
+		repoApi.addChild(toqRealId(i->parent), id);
+		for (::RepoIce::PropertyMap::const_iterator property = i->properties.begin(); property != i->properties.end(); property++)
+			repoApi.setProperty(id, QString::fromStdString(property->first), QString::fromStdString(property->second));
+	}
+
+	notifyElementsAdded(elements);
+}
+
+void
+RepoIce::RepoApiI::removeElements(const ::RepoIce::IdList& ids, const Ice::Current& )
+{
+	for (::RepoIce::IdList::const_iterator i = ids.begin(); i != ids.end(); i++)
+		repoApi.removeElement(toqRealId(*i));
+
+	notifyElementsRemoved(ids);
+}
+
+void
+RepoIce::RepoApiI::subscribe(const ::RepoIce::RepoObserverPrx& observer, const Ice::Current& )
+{
+	if (!observer)
+		return;
+
+	// Notifications are fire-and-forget, a slow client must not hold up the server.
+	::RepoIce::RepoObserverPrx const oneway = ::RepoIce::RepoObserverPrx::uncheckedCast(observer->ice_oneway());
+
+	IceUtil::Mutex::Lock lock(mObserversMutex);
+	mObservers.push_back(oneway);
+}
+
+void
+RepoIce::RepoApiI::unsubscribe(const ::RepoIce::RepoObserverPrx& observer, const Ice::Current& )
+{
+	if (observer)
+		dropObserver(observer);
+}
+
+::RepoIce::IdList
+RepoIce::RepoApiI::toIceIdList(const ::qReal::IdList& list)
+{
+	::RepoIce::IdList result;
+	result.reserve(list.size());
+
+	for (qReal::IdList::const_iterator i = list.begin(); i != list.end(); i++)
+		result.push_back((*i).toString().toStdString());
+
+	return result;
+}
+
+::RepoIce::PropertyMap
+RepoIce::RepoApiI::properties(const ::qReal::Id& id) const
+{
+	::RepoIce::PropertyMap result;
+	QMapIterator<QString, QVariant> i = repoApi.propertiesIterator(id);
+	while (i.hasNext()) {
+		i.next();
+		result[i.key().toStdString()] = i.value().toString().toStdString();
+	}
+	return result;
+}
+
+::RepoIce::ElementData
+RepoIce::RepoApiI::elementData(const ::qReal::Id& id) const
+{
+	::RepoIce::ElementData result;
+	result.id = id.toString().toStdString();
+	result.parent = repoApi.parent(id).toString().toStdString();
+	result.children = toIceIdList(repoApi.children(id));
+	result.properties = properties(id);
+	return result;
+}
+
+void
+RepoIce::RepoApiI::collectSubtree(const ::qReal::Id& id, ::RepoIce::ElementDataList& result) const
+{
+	result.push_back(elementData(id));
+
+	foreach (qReal::Id const &child, repoApi.children(id))
+		collectSubtree(child, result);
+}
+
+::std::vector< ::RepoIce::RepoObserverPrx>
+RepoIce::RepoApiI::observers()
+{
+	IceUtil::Mutex::Lock lock(mObserversMutex);
+	return mObservers;
+}
+
+void
+RepoIce::RepoApiI::dropObserver(const ::RepoIce::RepoObserverPrx& observer)
+{
+	IceUtil::Mutex::Lock lock(mObserversMutex);
+	for (::std::vector< ::RepoIce::RepoObserverPrx>::iterator i = mObservers.begin(); i != mObservers.end(); ) {
+		if ((*i)->ice_getIdentity() == observer->ice_getIdentity())
+			i = mObservers.erase(i);
+		else
+			i++;
+	}
+}
+
+void
+RepoIce::RepoApiI::notifyPropertiesChanged(const ::RepoIce::PropertyChangeList& changes)
+{
+	if (changes.empty())
+		return;
+
+	::std::vector< ::RepoIce::RepoObserverPrx> const current = observers();
+	for (::std::vector< ::RepoIce::RepoObserverPrx>::const_iterator i = current.begin(); i != current.end(); i++) {
+		try {
+			(*i)->propertiesChanged(changes);
+		} catch (const Ice::Exception &) {
+			dropObserver(*i);
+		}
+	}
+}
+
+void
+RepoIce::RepoApiI::notifyElementsAdded(const ::RepoIce::ElementDataList& elements)
+{
+	if (elements.empty())
+		return;
+
+	::std::vector< ::RepoIce::RepoObserverPrx> const current = observers();
+	for (::std::vector< ::RepoIce::RepoObserverPrx>::const_iterator i = current.begin(); i != current.end(); i++) {
+		try {
+			(*i)->elementsAdded(elements);
+		} catch (const Ice::Exception &) {
+			dropObserver(*i);
+		}
+	}
+}
+
+void
+RepoIce::RepoApiI::notifyElementsRemoved(const ::RepoIce::IdList& ids)
+{
+	if (ids.empty())
+		return;
+
+	::std::vector< ::RepoIce::RepoObserverPrx> const current = observers();
+	for (::std::vector< ::RepoIce::RepoObserverPrx>::const_iterator i = current.begin(); i != current.end(); i++) {
+		try {
+			(*i)->elementsRemoved(ids);
+		} catch (const Ice::Exception &) {
+			dropObserver(*i);
+		}
+	}
+}
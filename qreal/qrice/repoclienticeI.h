@@ -2,6 +2,9 @@
 #define __repoclienticeI_h__
 
 #include <repoclientice.h>
+#include <IceUtil/Mutex.h>
+
+#include <vector>
 
 #include "../qrrepo/repoApi.h"
 #include "../qrgui/kernel/definitions.h"
@@ -70,6 +73,20 @@ public:
     virtual void exterminate(const Ice::Current&);
 
     virtual void save(const Ice::Current&);
+
+    virtual ::RepoIce::PropertyMapList getProperties(const ::RepoIce::IdList&, const ::RepoIce::StringList&, const Ice::Current&);
+
+    virtual void setProperties(const ::RepoIce::PropertyChangeList&, const Ice::Current&);
+
+    virtual ::RepoIce::ElementDataList fetchSubtree(const ::std::string&, const Ice::Current&);
+
+    virtual void createElements(const ::RepoIce::ElementDataList&, const Ice::Current&);
+
+    virtual void removeElements(const ::RepoIce::IdList&, const Ice::Current&);
+
+    virtual void subscribe(const ::RepoIce::RepoObserverPrx&, const Ice::Current&);
+
+    virtual void unsubscribe(const ::RepoIce::RepoObserverPrx&, const Ice::Current&);
 	
 		static Ice::ObjectAdapterPtr _adapter;
 
@@ -79,8 +96,20 @@ public:
 	private:
 		
 		static ::qReal::Id toqRealId(const ::std::string& str);
-		
+		static ::RepoIce::IdList toIceIdList(const ::qReal::IdList& list);
+		::RepoIce::PropertyMap properties(const ::qReal::Id& id) const;
+		::RepoIce::ElementData elementData(const ::qReal::Id& id) const;
+		void collectSubtree(const ::qReal::Id& id, ::RepoIce::ElementDataList& result) const;
+
+		void notifyPropertiesChanged(const ::RepoIce::PropertyChangeList& changes);
+		void notifyElementsAdded(const ::RepoIce::ElementDataList& elements);
+		void notifyElementsRemoved(const ::RepoIce::IdList& ids);
+		::std::vector< ::RepoIce::RepoObserverPrx> observers();
+		void dropObserver(const ::RepoIce::RepoObserverPrx& observer);
+
 		::qrRepo::RepoApi &repoApi;
+		::std::vector< ::RepoIce::RepoObserverPrx> mObservers;
+		IceUtil::Mutex mObserversMutex;
 };
 
 }
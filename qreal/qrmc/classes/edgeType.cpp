@@ -3,6 +3,7 @@
 #include "diagram.h"
 #include "editor.h"
 #include "utils/nameNormalizer.h"
+#include "utils/generatedFile.h"
 
 #include <QDebug>
 
@@ -149,20 +150,14 @@ void EdgeType::generateSdf() const
 	dir.cd(shapesDir);
 
 	QString const fileName = dir.absoluteFilePath(name() + "Class.sdf");
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		qDebug() << "cannot open \"" << fileName << "\"";
-		return;
-	}
 	MetaCompiler *compiler = diagram()->editor()->metaCompiler();
 
 	QString result = compiler->getTemplateUtils(lineSdfTag);
 	result.replace(lineTypeTag, mApi->stringProperty(mId, "lineType"))
 			.replace("\\n", "\n");
 
-	QTextStream out(&file);
-	out << result;
-	file.close();
+	if (!GeneratedFile::save(fileName, result))
+		qDebug() << "cannot open \"" << fileName << "\"";
 }
 
 // copy-pasted from Shape, quick workaround for #349
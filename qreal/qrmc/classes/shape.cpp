@@ -5,6 +5,7 @@
 #include "editor.h"
 #include "graphicType.h"
 #include "utils/nameNormalizer.h"
+#include "utils/generatedFile.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
@@ -192,15 +193,8 @@ void Shape::generateSdf() const
 	changeDir(dir);
 
 	QString const fileName = dir.absoluteFilePath(mNode->name() + "Class.sdf");
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+	if (!GeneratedFile::save(fileName, mPicture))
 		qDebug() << "cannot open \"" << fileName << "\"";
-		return;
-	}
-
-	QTextStream out(&file);
-	out << mPicture;
-	file.close();
 }
 
 void Shape::generatePortsSdf() const
@@ -212,12 +206,6 @@ void Shape::generatePortsSdf() const
 	changeDir(dir);
 
 	QString const fileName = dir.absoluteFilePath(mNode->name() + "Ports.sdf");
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		qDebug() << "cannot open \"" << fileName << "\"";
-		return;
-	}
-	QTextStream out(&file);
 	MetaCompiler *compiler = mNode->diagram()->editor()->metaCompiler();
 	QString portsTemplate = compiler->getTemplateUtils(sdfPortsTag);
 
@@ -232,8 +220,8 @@ void Shape::generatePortsSdf() const
 				.replace(nodeHeightTag, QString::number(mHeight))
 				.replace("\\n", "\n");
 
-	out << portsTemplate;
-	file.close();
+	if (!GeneratedFile::save(fileName, portsTemplate))
+		qDebug() << "cannot open \"" << fileName << "\"";
 }
 
 bool Shape::hasLabels() const
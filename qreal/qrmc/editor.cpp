@@ -4,6 +4,7 @@
 #include "classes/type.h"
 #include "classes/enumType.h"
 #include "utils/nameNormalizer.h"
+#include "utils/generatedFile.h"
 
 #include <QDebug>
 
@@ -191,17 +192,13 @@ bool Editor::generatePluginHeader(QString const &hdrTemplate)
 	dir.cd(mName);
 
 	QString fileName = dir.absoluteFilePath(pluginHeaderName);
-	QFile pluginHeaderFile(fileName);
-	if (!pluginHeaderFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+
+	headerTemplate.replace(metamodelNameTag, NameNormalizer::normalize(mName)); // header requires just plugin name customization
+	if (!GeneratedFile::save(fileName, headerTemplate)) {
 		qDebug() << "cannot open \"" << fileName << "\"";
 		return false;
 	}
 
-	headerTemplate.replace(metamodelNameTag, NameNormalizer::normalize(mName)); // header requires just plugin name customization
-	QTextStream out(&pluginHeaderFile);
-	out << headerTemplate;
-	pluginHeaderFile.close();
-
 	return true;
 }
 
@@ -217,11 +214,6 @@ bool Editor::generatePluginSource()
 	dir.cd(mName);
 
 	QString fileName = dir.absoluteFilePath(pluginSourceName);
-	QFile pluginSourceFile(fileName);
-	if (!pluginSourceFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		qDebug() << "cannot open \"" << fileName << "\"";
-		return false;
-	}
 
 	generateDiagramsMap();
 	generateDiagramNodeNamesMap();
@@ -241,9 +233,10 @@ bool Editor::generatePluginSource()
 	mSourceTemplate.replace(metamodelNameTag,  NameNormalizer::normalize(mName));
 
 	// template is ready, writing it into a file
-	QTextStream out(&pluginSourceFile);
-	out << mSourceTemplate;
-	pluginSourceFile.close();
+	if (!GeneratedFile::save(fileName, mSourceTemplate)) {
+		qDebug() << "cannot open \"" << fileName << "\"";
+		return false;
+	}
 	return true;
 
 }
@@ -260,11 +253,6 @@ bool Editor::generateElementsClasses()
 	dir.cd(mName);
 
 	QString fileName = dir.absoluteFilePath(elementsFileName);
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		qDebug() << "cannot open \"" << fileName << "\"";
-		return false;
-	}
 
 	QString generatedNodes;
 	QString generatedEdges;
@@ -277,9 +265,10 @@ bool Editor::generateElementsClasses()
 	mElementsHeaderTemplate.replace(nodesListTag, generatedNodes)
 						.replace(edgesListTag, generatedEdges);
 	// template is ready, writing it into a file
-	QTextStream out(&file);
-	out << mElementsHeaderTemplate;
-	file.close();
+	if (!GeneratedFile::save(fileName, mElementsHeaderTemplate)) {
+		qDebug() << "cannot open \"" << fileName << "\"";
+		return false;
+	}
 	return true;
 
 }
@@ -299,11 +288,6 @@ bool Editor::generateResourceFile(QString const &resourceTemplate)
 	dir.cd(shapesDir);
 
 	QString fileName = dir.absoluteFilePath(resourceFileName);
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		qDebug() << "cannot open \"" << fileName << "\"";
-		return false;
-	}
 
 	QString resourceBody = "";
 	QString const line = mUtilsTemplate[sdfFileTag];
@@ -315,9 +299,10 @@ bool Editor::generateResourceFile(QString const &resourceTemplate)
 	resourceGenerated.replace(sdfFileTag, resourceBody);
 
 	// template is ready, writing it into a file
-	QTextStream out(&file);
-	out << resourceGenerated;
-	file.close();
+	if (!GeneratedFile::save(fileName, resourceGenerated)) {
+		qDebug() << "cannot open \"" << fileName << "\"";
+		return false;
+	}
 	return true;
 
 }
@@ -335,17 +320,13 @@ bool Editor::generateProjectFile(const QString &proTemplate)
 	dir.cd(mName);
 
 	QString fileName = dir.absoluteFilePath(mName + ".pro");
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+
+	projectTemplate.replace(metamodelNameTag, mName); // .pro-file requires just plugin name customization
+	if (!GeneratedFile::save(fileName, projectTemplate)) {
 		qDebug() << "cannot open \"" << fileName << "\"";
 		return false;
 	}
 
-	projectTemplate.replace(metamodelNameTag, mName); // .pro-file requires just plugin name customization
-	QTextStream out(&file);
-	out << projectTemplate;
-	file.close();
-
 	return true;
 }
 
@@ -1,6 +1,7 @@
 #include "metaCompiler.h"
 #include "editor.h"
 #include "utils/nameNormalizer.h"
+#include "utils/generatedFile.h"
 #include "diagram.h"
 
 #include "classes/type.h"
@@ -174,17 +175,12 @@ void MetaCompiler::generateCode()
 	dir.cd(generatedDir);
 
 	QString const fileName = dir.absoluteFilePath(pluginsProjectFileName);
-	QFile file(fileName);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+	QString projectTemplate = mPluginsProjectTemplate;
+	if (!GeneratedFile::save(fileName, projectTemplate.replace(subdirsTag, pluginNames))) {
 		qDebug() << "cannot open \"" << fileName << "\"";
 		return;
 	}
 
-	QTextStream out(&file);
-	QString projectTemplate = mPluginsProjectTemplate;
-	out << projectTemplate.replace(subdirsTag, pluginNames);
-	file.close();
-
 	return;
 }
 
@@ -0,0 +1,24 @@
+#include "generatedFile.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+bool GeneratedFile::save(QString const &fileName, QString const &content)
+{
+	QFile file(fileName);
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		QTextStream in(&file);
+		bool const unchanged = in.readAll() == content;
+		file.close();
+		if (unchanged)
+			return true;
+	}
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		return false;
+
+	QTextStream out(&file);
+	out << content;
+	file.close();
+	return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QString>
+
+class GeneratedFile
+{
+public:
+	/// Writes content into the file unless the file already has exactly this content.
+	/// Untouched files keep their timestamps, so make rebuilds only what really changed.
+	/// Returns false if the file can not be written.
+	static bool save(QString const &fileName, QString const &content);
+};
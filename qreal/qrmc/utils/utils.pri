@@ -1,5 +1,7 @@
 HEADERS += \
 	utils/nameNormalizer.h \
+	utils/generatedFile.h \
 	utils/defs.h
 SOURCES += \
-	utils/nameNormalizer.cpp
+	utils/nameNormalizer.cpp \
+	utils/generatedFile.cpp
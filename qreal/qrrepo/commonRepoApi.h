@@ -2,6 +2,9 @@
 
 #include "../qrgui/kernel/roles.h"
 
+#include <QtCore/QMap>
+#include <QtCore/QVariant>
+
 namespace qrRepo {
 
 class CommonRepoApi
@@ -13,6 +16,9 @@ public:
 	virtual QString name(qReal::Id const &id) const = 0;
 
 	virtual qReal::IdList children(qReal::Id const &id) const = 0;
+	/// Children without copying the list, for walks over the model that only read it.
+	/// The reference is valid until the element is changed or removed.
+	virtual qReal::IdList const &constChildren(qReal::Id const &id) const = 0;
 	virtual void removeChild(qReal::Id const &id, qReal::Id const &child) = 0;
 	virtual void removeChildren(qReal::Id const &id) = 0;
 
@@ -23,8 +29,17 @@ public:
 	virtual QVariant property(qReal::Id const &id, QString const &propertyName) const = 0;
 	virtual QString stringProperty(qReal::Id const &id, QString const &propertyName) const = 0;
 	virtual void setProperty(qReal::Id const &id, QString const &propertyName, QVariant const &value) = 0;
+	/// Sets several properties of one element at once, e.g. when importing elements.
+	virtual void setProperties(qReal::Id const &id, QMap<QString, QVariant> const &properties) = 0;
+	/// Removes the stored value. A property having a default of the element type reads as that
+	/// default afterwards, so hasProperty() stays true for it.
 	virtual void removeProperty(qReal::Id const &id, QString const &propertyName) = 0;
+	/// True if property() can read the property: it is stored for the element or is a default of
+	/// its type. Stored values are told apart from defaults by constProperties().
 	virtual bool hasProperty(qReal::Id const &id, QString const &propertyName) const = 0;
+	/// Properties stored for the element, valid until the element is changed or removed.
+	/// Unset properties that read as type defaults are not among them.
+	virtual QMap<QString, QVariant> const &constProperties(qReal::Id const &id) const = 0;
 
 	virtual bool exist(qReal::Id const &id) const = 0;
 	virtual void removeElement(qReal::Id const &id) = 0;
@@ -39,6 +54,11 @@ public:
 	virtual void setParent(qReal::Id const &id, qReal::Id const &parent) = 0;
 
 	virtual QString typeName(qReal::Id const &id) const = 0;
+
+	/// Groups following changes into one undoable command, commands may be nested.
+	/// Changes made outside of commands can not be undone and clear undo history.
+	virtual void beginCommand(QString const &description) = 0;
+	virtual void endCommand() = 0;
 };
 
 }
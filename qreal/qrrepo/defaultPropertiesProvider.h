@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include "../qrgui/kernel/ids.h"
+
+namespace qrRepo {
+
+/// Source of default property values of element types. Repository does not keep
+/// properties of logical elements equal to defaults in memory and resolves unset ones
+/// from here. Saves still contain them, as repositories without a provider need them.
+class DefaultPropertiesProvider
+{
+public:
+	virtual ~DefaultPropertiesProvider() {}
+
+	/// Returns invalid QVariant if elements of given type have no such property.
+	virtual QVariant defaultPropertyValue(qReal::Id const &type, QString const &name) const = 0;
+	/// Properties of given type that have defaults.
+	virtual QStringList defaultPropertyNames(qReal::Id const &type) const = 0;
+};
+
+}
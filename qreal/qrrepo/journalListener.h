@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QtCore/QString>
+
+namespace qrRepo {
+
+/// Gets notified when undo history of a repository changes.
+class JournalListener
+{
+public:
+	virtual ~JournalListener() {}
+
+	/// New command can be undone. Commands merged into the previous one are not reported.
+	virtual void commandAdded(QString const &description) = 0;
+
+	/// History was dropped, e.g. after opening other save or a change outside of commands.
+	virtual void historyCleared() = 0;
+};
+
+}
@@ -50,7 +50,12 @@ void Object::removeChild(const Id &child)
 	}
 }
 
-IdList Object::children() const
+void Object::setChildren(IdList const &children)
+{
+	mChildren = children;
+}
+
+IdList const &Object::children() const
 {
 	return mChildren;
 }
@@ -72,8 +77,9 @@ void Object::setProperty(const QString &name, const QVariant &value)
 
 QVariant Object::property(const QString &name) const
 {
-	if (mProperties.contains(name)) {
-		return mProperties[name];
+	QMap<QString, QVariant>::const_iterator const value = mProperties.constFind(name);
+	if (value != mProperties.constEnd()) {
+		return value.value();
 	} else {
 		throw Exception("Object " + mId.toString() + ": requesting nonexistent property " + name);
 	}
@@ -115,11 +121,8 @@ bool Object::hasProperty(const QString &name) const
 
 void Object::removeProperty(const QString &name)
 {
-	if (mProperties.contains(name)) {
-		mProperties.remove(name);
-	} else {
+	if (mProperties.remove(name) == 0)
 		throw Exception("Object " + mId.toString() + ": removing nonexistent property " + name);
-	}
 }
 
 Id Object::id() const
@@ -137,3 +140,8 @@ QMapIterator<QString, QVariant> Object::propertiesIterator()
 	return QMapIterator<QString, QVariant>(mProperties);
 }
 
+QMap<QString, QVariant> const &Object::properties() const
+{
+	return mProperties;
+}
+
@@ -4,12 +4,15 @@
 
 #include <QMap>
 #include <QVariant>
+#include <QSharedData>
 
 namespace qrRepo {
 
 	namespace details {
 
-		class Object
+		/// Objects are shared by the repository, its snapshots and the undo history, so an object
+		/// is changed only by the one who holds the only reference to it, others copy it first.
+		class Object : public QSharedData
 		{
 		public:
 			explicit Object(const qReal::Id &id);
@@ -19,7 +22,8 @@ namespace qrRepo {
 			void removeParent();
 			void addChild(const qReal::Id &child);
 			void removeChild(const qReal::Id &child);
-			qReal::IdList children() const;
+			qReal::IdList const &children() const;
+			void setChildren(qReal::IdList const &children);
 			qReal::Id parent() const;
 			void setProperty(const QString &name, const QVariant &value);
 			QVariant property(const QString &name) const;
@@ -28,6 +32,7 @@ namespace qrRepo {
 			qReal::Id id() const;
 			qReal::Id logicalId() const;
 			QMapIterator<QString, QVariant> propertiesIterator();
+			QMap<QString, QVariant> const &properties() const;
 			void setTemporaryRemovedLinks(QString const &direction, qReal::IdList const &listValue);
 			qReal::IdList temporaryRemovedLinksAt(QString const &direction) const;
 			qReal::IdList temporaryRemovedLinks() const;
@@ -43,6 +48,8 @@ namespace qrRepo {
 			QMap<QString, qReal::IdList> mTemporaryRemovedLinks;
 		};
 
+		typedef QExplicitlySharedDataPointer<Object> ObjectPointer;
+
 	}
 
 }
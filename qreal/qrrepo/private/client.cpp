@@ -2,35 +2,92 @@
 #include "../../qrgui/kernel/exception/exception.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QtConcurrentRun>
 
 using namespace qReal;
 using namespace qrRepo;
 using namespace qrRepo::details;
 
+namespace {
+
+/// QVariant compares values of custom types by address, so ids are compared explicitly.
+bool sameValue(QVariant const &value, QVariant const &defaultValue)
+{
+	if (!defaultValue.isValid() || value.userType() != defaultValue.userType())
+		return false;
+	if (value.userType() == qMetaTypeId<IdList>())
+		return value.value<IdList>() == defaultValue.value<IdList>();
+	if (value.userType() == qMetaTypeId<Id>())
+		return value.value<Id>() == defaultValue.value<Id>();
+	return value == defaultValue;
+}
+
+}
+
 Client::Client(QString const &workingDirectory)
 	: serializer(workingDirectory)
+	, mSaveFiles(new SaveFiles)
+	, mWriteAheadLog(NULL)
+	, mJournalSegment(0)
+	, mCheckpointOutdated(false)
+	, mCheckpointPending(false)
+	, mRecovered(false)
+	, mDefaultProperties(NULL)
+	, mPropertyValidator(NULL)
+	, mIsSnapshot(false)
 {
 	init();
 	loadFromDisk();
 }
 
+Client::Client(Client const &other)
+	: serializer(other.serializer)
+	, mSaveFiles(other.mSaveFiles)
+	, mWriteAheadLog(NULL)
+	, mJournalSegment(0)
+	, mCheckpointOutdated(false)
+	, mCheckpointPending(false)
+	, mRecovered(false)
+	, mDefaultProperties(other.mDefaultProperties)
+	, mPropertyValidator(other.mPropertyValidator)
+	, mIsSnapshot(true)
+{
+	// Nothing is copied here, tables and objects are copied by the client that changes them first
+	QMutexLocker locker(other.lookupMutex());
+	mObjects = other.mObjects;
+	mUnloadedPaths = other.mUnloadedPaths;
+	mPendingSubtrees = other.mPendingSubtrees;
+}
+
 void Client::init()
 {
-	mObjects.insert(Id::rootId(), new Object(Id::rootId()));
-	mObjects[Id::rootId()]->setProperty("name", Id::rootId().toString());
+	ObjectPointer const root(new Object(Id::rootId()));
+	root->setProperty("name", Id::rootId().toString());
+	mObjects.insert(Id::rootId(), root);
 }
 
 Client::~Client()
 {
-	delete mObjects[Id::rootId()];
-	mObjects.remove(Id::rootId());
-	serializer.saveToDisk(mObjects.values());
+	if (mIsSnapshot)
+		return;
+
+	waitForCheckpoint();
+	if (mCheckpointOutdated)
+		writeCheckpoint(false);
+	delete mWriteAheadLog;
 }
 
-IdList Client::children(Id const &id) const
+IdList const &Client::children(Id const &id) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->children();
+	Object const * const object = findObject(id);
+	if (object) {
+		// Children are requested when a diagram is opened or expanded, read all of it at once
+		QMutexLocker locker(lookupMutex());
+		if (mPendingSubtrees.remove(id)) {
+			foreach (Id const &child, object->children())
+				loadSubtree(child);
+		}
+		return object->children();
 	} else {
 		throw Exception("Client: Requesting children of nonexistent object " + id.toString());
 	}
@@ -38,8 +95,9 @@ IdList Client::children(Id const &id) const
 
 Id Client::parent(Id const &id) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->parent();
+	Object const * const object = findObject(id);
+	if (object) {
+		return object->parent();
 	} else {
 		throw Exception("Client: Requesting parents of nonexistent object " + id.toString());
 	}
@@ -47,11 +105,16 @@ Id Client::parent(Id const &id) const
 
 void Client::setParent(Id const &id, Id const &parent)
 {
-	if (mObjects.contains(id)) {
-		if (mObjects.contains(parent)) {
-			mObjects[id]->setParent(parent);
-			if (!mObjects[parent]->children().contains(id))
-				mObjects[parent]->addChild(id);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		Object const * const parentObject = findObject(parent);
+		if (parentObject) {
+			journalParent(id, parent);
+			object->setParent(parent);
+			if (!parentObject->children().contains(id)) {
+				journalChildren(parent, IdList(parentObject->children()) << id);
+				findObjectToChange(parent)->addChild(id);
+			}
 		} else {
 			throw Exception("Client: Adding nonexistent parent " + parent.toString() + " to  object " + id.toString());
 		}
@@ -67,13 +130,24 @@ void Client::addChild(const Id &id, const Id &child)
 
 void Client::addChild(const Id &id, const Id &child, Id const &logicalId)
 {
-	if (mObjects.contains(id)) {
-		if (!mObjects[id]->children().contains(child))
-			mObjects[id]->addChild(child);
-		if (mObjects.contains(child)) {
-			mObjects[child]->setParent(id);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		if (!object->children().contains(child)) {
+			journalChildren(id, IdList(object->children()) << child);
+			object->addChild(child);
+		}
+		Object * const childObject = findObjectToChange(child);
+		if (childObject) {
+			journalParent(child, id);
+			childObject->setParent(id);
 		} else {
-			mObjects.insert(child, new Object(child, id, logicalId));
+			ObjectPointer const object(new Object(child, id, logicalId));
+			mObjects.insert(child, object);
+			markChanged(child);
+			if (mJournal.isRecording())
+				mJournal.objectAdded(object);
+			else
+				mJournal.changedOutsideCommand();
 		}
 	} else {
 		throw Exception("Client: Adding child " + child.toString() + " to nonexistent object " + id.toString());
@@ -82,11 +156,17 @@ void Client::addChild(const Id &id, const Id &child, Id const &logicalId)
 
 void Client::removeParent(const Id &id)
 {
-	if (mObjects.contains(id)) {
-		Id const parent = mObjects[id]->parent();
-		if (mObjects.contains(parent)) {
-			mObjects[id]->removeParent();
-			mObjects[parent]->removeChild(id);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		Id const parent = object->parent();
+		Object * const parentObject = findObjectToChange(parent);
+		if (parentObject) {
+			journalParent(id, Id());
+			object->removeParent();
+			IdList children = parentObject->children();
+			children.removeAll(id);
+			journalChildren(parent, children);
+			parentObject->removeChild(id);
 		} else {
 			throw Exception("Client: Removing nonexistent parent " + parent.toString() + " from object " + id.toString());
 		}
@@ -97,9 +177,13 @@ void Client::removeParent(const Id &id)
 
 void Client::removeChild(const Id &id, const Id &child)
 {
-	if (mObjects.contains(id)) {
-		if (mObjects.contains(child)) {
-			mObjects[id]->removeChild(child);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		if (findObject(child)) {
+			IdList children = object->children();
+			children.removeAll(child);
+			journalChildren(id, children);
+			object->removeChild(child);
 		} else {
 			throw Exception("Client: removing nonexistent child " + child.toString() + " from object " + id.toString());
 		}
@@ -110,20 +194,85 @@ void Client::removeChild(const Id &id, const Id &child)
 
 void Client::setProperty(const Id &id, const QString &name, const QVariant &value )
 {
-	if (mObjects.contains(id)) {
-		Q_ASSERT(mObjects[id]->hasProperty(name)
-				 ? mObjects[id]->property(name).userType() == value.userType()
-				 : true);
-		mObjects[id]->setProperty(name, value);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		setObjectProperty(object, name, value);
 	} else {
 		throw Exception("Client: Setting property of nonexistent object " + id.toString());
 	}
 }
 
+void Client::setProperties(Id const &id, QMap<QString, QVariant> const &properties)
+{
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		// All values are checked before the first one is written, so an import either sets
+		// all properties of an element or none of them.
+		QMapIterator<QString, QVariant> iterator(properties);
+		while (iterator.hasNext()) {
+			iterator.next();
+			checkObjectProperty(object, iterator.key(), iterator.value());
+		}
+		iterator.toFront();
+		while (iterator.hasNext()) {
+			iterator.next();
+			storeObjectProperty(object, iterator.key(), iterator.value());
+		}
+	} else {
+		throw Exception("Client: Setting properties of nonexistent object " + id.toString());
+	}
+}
+
+void Client::setObjectProperty(Object *object, QString const &name, QVariant const &value)
+{
+	checkObjectProperty(object, name, value);
+	storeObjectProperty(object, name, value);
+}
+
+void Client::checkObjectProperty(Object const *object, QString const &name, QVariant const &value) const
+{
+	if (!mPropertyValidator || object->id() == Id::rootId() || object->logicalId() != Id())
+		return;
+	// Defaults are not stored, and metamodels don't always give a valid one
+	if (sameValue(value, defaultPropertyValue(object, name)))
+		return;
+	QString error;
+	if (!mPropertyValidator->validate(object->id().type(), name, value, error)) {
+		throw Exception("Client: Invalid value of property '" + name + "' of "
+				+ object->id().toString() + ": " + error);
+	}
+}
+
+void Client::storeObjectProperty(Object *object, QString const &name, QVariant const &value)
+{
+	Q_ASSERT(object->hasProperty(name)
+			 ? object->property(name).userType() == value.userType()
+			 : true);
+	// Value equal to the default of the type is not stored, unset property reads as default.
+	if (sameValue(value, defaultPropertyValue(object, name))) {
+		if (object->hasProperty(name)) {
+			journalProperty(object->id(), name, QVariant());
+			object->removeProperty(name);
+		}
+		return;
+	}
+	journalProperty(object->id(), name, value);
+	object->setProperty(name, value);
+}
+
 QVariant Client::property( const Id &id, const QString &name ) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->property(name);
+	Object const * const object = findObject(id);
+	if (object) {
+		QMap<QString, QVariant> const &properties = object->properties();
+		QMap<QString, QVariant>::const_iterator const value = properties.constFind(name);
+		if (value != properties.constEnd())
+			return value.value();
+		QVariant const defaultValue = defaultPropertyValue(object, name);
+		if (defaultValue.isValid())
+			return defaultValue;
+		// Throws the error of a nonexistent property
+		return object->property(name);
 	} else {
 		throw Exception("Client: Requesting property of nonexistent object " + id.toString());
 	}
@@ -131,8 +280,13 @@ QVariant Client::property( const Id &id, const QString &name ) const
 
 void Client::removeProperty( const Id &id, const QString &name )
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->removeProperty(name);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		if (object->hasProperty(name))
+			journalProperty(id, name, QVariant());
+		else if (defaultPropertyValue(object, name).isValid())
+			return;
+		return object->removeProperty(name);
 	} else {
 		throw Exception("Client: Removing property of nonexistent object " + id.toString());
 	}
@@ -140,17 +294,46 @@ void Client::removeProperty( const Id &id, const QString &name )
 
 bool Client::hasProperty(const Id &id, const QString &name) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->hasProperty(name);
+	Object const * const object = findObject(id);
+	if (object) {
+		return object->hasProperty(name) || defaultPropertyValue(object, name).isValid();
 	} else {
 		throw Exception("Client: Checking the existence of a property '" + name + "' of nonexistent object " + id.toString());
 	}
 }
 
+QMapIterator<QString, QVariant> Client::propertiesIterator(Id const &id) const
+{
+	Object const * const object = findObject(id);
+	if (object) {
+		return QMapIterator<QString, QVariant>(object->properties());
+	} else {
+		throw Exception("Client: Requesting properties of nonexistent object " + id.toString());
+	}
+}
+
+QMap<QString, QVariant> const &Client::properties(Id const &id) const
+{
+	Object const * const object = findObject(id);
+	if (object) {
+		return object->properties();
+	} else {
+		throw Exception("Client: Requesting properties of nonexistent object " + id.toString());
+	}
+}
+
 void Client::setTemporaryRemovedLinks(Id const &id, QString const &direction, qReal::IdList const &linkIdList)
 {
-	if (mObjects.contains(id)) {
-		mObjects[id]->setTemporaryRemovedLinks(direction, linkIdList);
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		if (mJournal.isRecording()) {
+			mJournal.temporaryRemovedLinksChanged(id, direction
+					, object->temporaryRemovedLinksAt(direction), linkIdList);
+		} else {
+			mJournal.changedOutsideCommand();
+		}
+		markChanged(id);
+		object->setTemporaryRemovedLinks(direction, linkIdList);
 	} else {
 		throw Exception("Client: Setting temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -158,8 +341,9 @@ void Client::setTemporaryRemovedLinks(Id const &id, QString const &direction, qR
 
 IdList Client::temporaryRemovedLinksAt(Id const &id, QString const &direction) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->temporaryRemovedLinksAt(direction);
+	Object const * const object = findObject(id);
+	if (object) {
+		return object->temporaryRemovedLinksAt(direction);
 	} else {
 		throw Exception("Client: Requesting temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -167,8 +351,9 @@ IdList Client::temporaryRemovedLinksAt(Id const &id, QString const &direction) c
 
 IdList Client::temporaryRemovedLinks(Id const &id) const
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->temporaryRemovedLinks();
+	Object const * const object = findObject(id);
+	if (object) {
+		return object->temporaryRemovedLinks();
 	} else {
 		throw Exception("Client: Requesting temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -176,8 +361,10 @@ IdList Client::temporaryRemovedLinks(Id const &id) const
 
 void Client::removeTemporaryRemovedLinks(Id const &id)
 {
-	if (mObjects.contains(id)) {
-		return mObjects[id]->removeTemporaryRemovedLinks();
+	Object * const object = findObjectToChange(id);
+	if (object) {
+		markChanged(id);
+		return object->removeTemporaryRemovedLinks();
 	} else {
 		throw Exception("Client: Removing temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -185,16 +372,155 @@ void Client::removeTemporaryRemovedLinks(Id const &id)
 
 void Client::loadFromDisk()
 {
-	serializer.loadFromDisk(mObjects);
-	addChildrenToRootObject();
+	serializer.recoverWorkingDir();
+	IdList topLevel;
+	if (!serializer.loadSkeleton(topLevel)) {
+		QHash<Id, Object*> objects;
+		serializer.loadFromDisk(objects);
+		foreach (Object *object, objects)
+			mObjects.insert(object->id(), ObjectPointer(object));
+		addChildrenToRootObject();
+		// Next save adds the skeleton, so that the save is read lazily
+		mCheckpointOutdated = true;
+		replayJournal();
+		return;
+	}
+
+	// Only top-level elements are read, their subtrees are read on first access
+	serializer.loadIndex(mUnloadedPaths);
+	Object * const root = findObjectToChange(Id::rootId());
+	foreach (Id const &id, topLevel) {
+		QString const path = mUnloadedPaths.take(id);
+		ObjectPointer object(path.isEmpty() ? NULL : serializer.loadObject(path));
+		if (!object)
+			continue;
+		dropDefaultProperties(object);
+		mObjects.insert(id, object);
+		mPendingSubtrees.insert(id);
+		if (!root->children().contains(id))
+			root->addChild(id);
+	}
+	replayJournal();
+}
+
+void Client::replayJournal()
+{
+	QHash<Id, Object*> states;
+	WriteAheadLog::replay(serializer.journalDir(), serializer.journalSegment(), states);
+	mJournalSegment = freeJournalSegment();
+	mRecovered = !states.isEmpty();
+	if (mRecovered)
+		mCheckpointOutdated = true;
+
+	QHashIterator<Id, Object*> iterator(states);
+	while (iterator.hasNext()) {
+		iterator.next();
+		mObjects.remove(iterator.key());
+		mUnloadedPaths.remove(iterator.key());
+		if (iterator.value()) {
+			ObjectPointer object(iterator.value());
+			dropDefaultProperties(object);
+			mObjects.insert(iterator.key(), object);
+		}
+	}
+}
+
+int Client::freeJournalSegment() const
+{
+	QList<int> const segments = WriteAheadLog::segments(serializer.journalDir());
+	int const afterExisting = segments.isEmpty() ? 0 : segments.last() + 1;
+	return qMax(afterExisting, serializer.journalSegment());
+}
+
+Object const *Client::findObject(Id const &id) const
+{
+	QMutexLocker locker(lookupMutex());
+	QHash<Id, ObjectPointer>::const_iterator const object = mObjects.constFind(id);
+	if (object != mObjects.constEnd())
+		return object.value().constData();
+	if (!mUnloadedPaths.contains(id))
+		return NULL;
+	loadSubtree(id);
+	return mObjects.value(id).constData();
+}
+
+Object *Client::findObjectToChange(Id const &id)
+{
+	if (!findObject(id))
+		return NULL;
+	// Table is detached from snapshots first, so objects they have are seen as shared
+	ObjectPointer &object = mObjects[id];
+	object.detach();
+	return object.data();
+}
+
+void Client::loadSubtree(Id const &id) const
+{
+	QString const path = mUnloadedPaths.take(id);
+	if (path.isEmpty())
+		return;
+	ObjectPointer object;
+	{
+		QMutexLocker locker(&mSaveFiles->mutex);
+		// Repository reads an element before changing it, so one it has read is as it was
+		// when the snapshot was taken, while its file may be rewritten since.
+		object = mSaveFiles->readObjects.value(id);
+		if (!object)
+			object = serializer.loadObject(path);
+		if (object && !mIsSnapshot) {
+			if (mSaveFiles->ref != 1)
+				mSaveFiles->readObjects.insert(id, object);
+			else if (!mSaveFiles->readObjects.isEmpty())
+				mSaveFiles->readObjects.clear();
+		}
+	}
+	if (!object)
+		return;
+	dropDefaultProperties(object);
+	mObjects.insert(id, object);
+	mPendingSubtrees.remove(id);
+	foreach (Id const &child, object->children())
+		loadSubtree(child);
+}
+
+void Client::loadAll() const
+{
+	while (!mUnloadedPaths.isEmpty())
+		loadSubtree(mUnloadedPaths.constBegin().key());
+	mPendingSubtrees.clear();
+}
+
+QMutex *Client::lookupMutex() const
+{
+	return mIsSnapshot ? &mLookupMutex : NULL;
+}
+
+void Client::keepSaveForSnapshots()
+{
+	// Elements read while snapshots are alive are kept for them, see loadSubtree()
+	if (mSaveFiles->ref != 1)
+		loadAll();
+	mSaveFiles = new SaveFiles;
+}
+
+void Client::saveSkeleton() const
+{
+	serializer.saveSkeleton(mObjects.value(Id::rootId())->children());
+}
+
+void Client::checkWorkingDirAccess() const
+{
+	if (mIsSnapshot)
+		throw Exception("Client: Snapshot of repository can't be saved or reopened");
 }
 
 void Client::addChildrenToRootObject()
 {
-	foreach (Object *object, mObjects.values()) {
+	Object * const root = findObjectToChange(Id::rootId());
+	foreach (ObjectPointer const &object, mObjects) {
 		if (object->parent() == Id::rootId()) {
-			if (!mObjects[Id::rootId()]->children().contains(object->id()))
-				mObjects[Id::rootId()]->addChild(object->id());
+			if (!root->children().contains(object->id()))
+				root->addChild(object->id());
 		}
 	}
 }
@@ -203,7 +529,7 @@ IdList Client::idsOfAllChildrenOf(Id id) const
 {
 	IdList result;
 	result.append(id);
-	foreach(Id childId,mObjects[id]->children())
+	foreach (Id const &childId, findObject(id)->children())
 		result.append(idsOfAllChildrenOf(childId));
 	return result;
 }
@@ -211,34 +537,42 @@ IdList Client::idsOfAllChildrenOf(Id id) const
 QList<Object*> Client::allChildrenOf(Id id) const
 {
 	QList<Object*> result;
-	result.append(mObjects[id]);
-	foreach(Id childId,mObjects[id]->children())
+	Object const * const object = findObject(id);
+	result.append(savedCopy(object));
+	foreach (Id const &childId, object->children())
 		result.append(allChildrenOf(childId));
 	return result;
 }
 
 bool Client::exist(const Id &id) const
 {
-	return (mObjects[id] != NULL);
+	return findObject(id) != NULL;
 }
 
 void Client::saveAll() const
 {
-	serializer.clearWorkingDir();
-	serializer.saveToDisk(mObjects.values());
+	checkWorkingDirAccess();
+	writeCheckpoint(false);
 }
 
 void Client::save(IdList list) const
 {
+	checkWorkingDirAccess();
+	waitForCheckpoint();
 	QList<Object*> toSave;
 	foreach(Id id, list)
 		toSave.append(allChildrenOf(id));
 
 	serializer.saveToDisk(toSave);
+	qDeleteAll(toSave);
+	saveSkeleton();
 }
 
-void Client::remove(IdList list) const
+void Client::remove(IdList list)
 {
+	checkWorkingDirAccess();
+	waitForCheckpoint();
+	keepSaveForSnapshots();
 	foreach(Id id, list) {
 		qDebug() << id.toString();
 		serializer.removeFromDisk(id);
@@ -247,9 +581,14 @@ void Client::remove(IdList list) const
 
 void Client::remove(const qReal::Id &id)
 {
-	if (mObjects.contains(id)) {
-		delete mObjects[id];
-		mObjects.remove(id);
+	if (findObject(id)) {
+		ObjectPointer const object = mObjects.take(id);
+		markChanged(id);
+		// Removed object is kept by the journal to be restored on undo.
+		if (mJournal.isRecording())
+			mJournal.objectRemoved(object);
+		else
+			mJournal.changedOutsideCommand();
 	} else {
 		throw Exception("Client: Trying to remove nonexistent object " + id.toString());
 	}
@@ -257,13 +596,24 @@ void Client::remove(const qReal::Id &id)
 
 void Client::setWorkingDir(QString const &workingDir)
 {
+	// Unread elements are in the old directory, the next save writes everything to the new one
+	checkWorkingDirAccess();
+	waitForCheckpoint();
+	bool const autosave = mWriteAheadLog != NULL;
+	setAutosaveEnabled(false);
+	loadAll();
+	keepSaveForSnapshots();
 	serializer.setWorkingDir(workingDir);
+	// Journal of the new directory, if any, belongs to other save
+	mJournalSegment = freeJournalSegment();
+	mCheckpointOutdated = true;
+	setAutosaveEnabled(autosave);
 }
 
 void Client::printDebug() const
 {
 	qDebug() << mObjects.size() << " objects in repository";
-	foreach (Object *object, mObjects.values()) {
+	foreach (ObjectPointer const &object, mObjects) {
 		qDebug() << object->id().toString();
 		qDebug() << "Children:";
 		foreach (Id id, object->children())
@@ -276,34 +626,354 @@ void Client::printDebug() const
 
 void Client::exterminate()
 {
+	checkWorkingDirAccess();
+	waitForCheckpoint();
 	printDebug();
+	keepSaveForSnapshots();
+	mJournal.clear();
 	mObjects.clear();
-	serializer.clearWorkingDir();
-	serializer.saveToDisk(mObjects.values());
+	mUnloadedPaths.clear();
+	mPendingSubtrees.clear();
+	mChangedIds.clear();
 	init();
+	writeCheckpoint(false);
 	printDebug();
 }
 
 void Client::open(QString const &workingDir)
 {
+	checkWorkingDirAccess();
+	waitForCheckpoint();
+	bool const autosave = mWriteAheadLog != NULL;
+	setAutosaveEnabled(false);
+	keepSaveForSnapshots();
 	serializer.setWorkingDir(workingDir);
+	mJournal.clear();
 	mObjects.clear();
+	mUnloadedPaths.clear();
+	mPendingSubtrees.clear();
+	mChangedIds.clear();
+	mCheckpointOutdated = false;
 	init();
 	loadFromDisk();
+	dropDefaultProperties();
+	setAutosaveEnabled(autosave);
 }
 
 qReal::IdList Client::elements() const
 {
+	QMutexLocker locker(lookupMutex());
+	loadAll();
 	return mObjects.keys();
 }
 
+QHashIterator<Id, ObjectPointer> Client::objectsIterator() const
+{
+	// Nothing is added to the table once everything is read, iterator may be used without the lock
+	QMutexLocker locker(lookupMutex());
+	loadAll();
+	return QHashIterator<Id, ObjectPointer>(mObjects);
+}
+
+int Client::elementsCount() const
+{
+	QMutexLocker locker(lookupMutex());
+	return mObjects.size() + mUnloadedPaths.size();
+}
+
+int Client::loadedElementsCount() const
+{
+	QMutexLocker locker(lookupMutex());
+	return mObjects.size();
+}
+
 bool Client::isLogicalId(qReal::Id const &elem) const
 {
-	return mObjects[elem]->logicalId() == qReal::Id();
+	return logicalId(elem) == qReal::Id();
 }
 
 qReal::Id Client::logicalId(qReal::Id const &elem) const
 {
-	return mObjects[elem]->logicalId();
+	Object const * const object = findObject(elem);
+	if (object) {
+		return object->logicalId();
+	} else {
+		throw Exception("Client: Requesting logical id of nonexistent object " + elem.toString());
+	}
 }
 
+
+void Client::beginCommand(QString const &description)
+{
+	mJournal.beginCommand(description);
+}
+
+bool Client::endCommand()
+{
+	bool const result = mJournal.endCommand();
+	if (!mJournal.isRecording())
+		appendChanges();
+	return result;
+}
+
+void Client::setJournalListener(JournalListener *listener)
+{
+	mJournal.setListener(listener);
+}
+
+void Client::setDefaultPropertiesProvider(DefaultPropertiesProvider const *provider)
+{
+	waitForCheckpoint();
+	mDefaultProperties = provider;
+	dropDefaultProperties();
+}
+
+void Client::setPropertyValidator(PropertyValidator const *validator)
+{
+	mPropertyValidator = validator;
+}
+
+QVariant Client::defaultPropertyValue(Object const *object, QString const &name) const
+{
+	if (!mDefaultProperties || object->id() == Id::rootId() || object->logicalId() != Id())
+		return QVariant();
+	return mDefaultProperties->defaultPropertyValue(object->id().type(), name);
+}
+
+void Client::dropDefaultProperties()
+{
+	// Saves made before defaults were resolved by repository store every property explicitly.
+	if (!mDefaultProperties)
+		return;
+	for (QHash<Id, ObjectPointer>::iterator object = mObjects.begin(); object != mObjects.end(); ++object)
+		dropDefaultProperties(object.value());
+}
+
+void Client::dropDefaultProperties(ObjectPointer &object) const
+{
+	if (!mDefaultProperties)
+		return;
+	QStringList defaults;
+	QMapIterator<QString, QVariant> iterator(object->properties());
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (sameValue(iterator.value(), defaultPropertyValue(object.constData(), iterator.key())))
+			defaults << iterator.key();
+	}
+	if (defaults.isEmpty())
+		return;
+	object.detach();
+	foreach (QString const &name, defaults)
+		object->removeProperty(name);
+}
+
+Object *Client::savedCopy(Object const *object) const
+{
+	Object * const copy = new Object(*object);
+	if (!mDefaultProperties || object->id() == Id::rootId() || object->logicalId() != Id())
+		return copy;
+	foreach (QString const &name, mDefaultProperties->defaultPropertyNames(object->id().type())) {
+		if (!copy->hasProperty(name))
+			copy->setProperty(name, mDefaultProperties->defaultPropertyValue(object->id().type(), name));
+	}
+	return copy;
+}
+
+bool Client::canUndo() const
+{
+	return mJournal.canUndo();
+}
+
+bool Client::canRedo() const
+{
+	return mJournal.canRedo();
+}
+
+IdList Client::undo(bool &structureChanged)
+{
+	IdList const affected = mJournal.undo(mObjects, structureChanged);
+	foreach (Id const &id, affected)
+		markChanged(id);
+	appendChanges();
+	return affected;
+}
+
+IdList Client::redo(bool &structureChanged)
+{
+	IdList const affected = mJournal.redo(mObjects, structureChanged);
+	foreach (Id const &id, affected)
+		markChanged(id);
+	appendChanges();
+	return affected;
+}
+
+void Client::beginInternalChanges()
+{
+	mJournal.beginInternalChanges();
+}
+
+void Client::endInternalChanges()
+{
+	mJournal.endInternalChanges();
+}
+
+void Client::setAutosaveEnabled(bool enabled)
+{
+	if (enabled == (mWriteAheadLog != NULL))
+		return;
+	checkWorkingDirAccess();
+	waitForCheckpoint();
+	if (enabled) {
+		mWriteAheadLog = new WriteAheadLog(serializer.journalDir(), mJournalSegment);
+		appendChanges();
+	} else {
+		flushJournal();
+		mJournalSegment = mWriteAheadLog->startSegment();
+		delete mWriteAheadLog;
+		mWriteAheadLog = NULL;
+	}
+}
+
+void Client::checkpoint()
+{
+	checkWorkingDirAccess();
+	// Changes made outside of commands get to the journal here at the latest
+	appendChanges();
+	if (mCheckpoint.isRunning())
+		return;
+	waitForCheckpoint();
+	if (!mCheckpointOutdated)
+		return;
+	writeCheckpoint(mWriteAheadLog != NULL);
+}
+
+void Client::flushJournal()
+{
+	appendChanges();
+	if (mWriteAheadLog)
+		mWriteAheadLog->sync();
+}
+
+qint64 Client::journalBytesWritten() const
+{
+	return mWriteAheadLog ? mWriteAheadLog->bytesWritten() : 0;
+}
+
+bool Client::wasRecovered() const
+{
+	return mRecovered;
+}
+
+void Client::markChanged(Id const &id)
+{
+	mChangedIds.insert(id);
+	mCheckpointOutdated = true;
+}
+
+void Client::appendChanges() const
+{
+	if (!mWriteAheadLog || mChangedIds.isEmpty())
+		return;
+
+	QList<Object*> changed;
+	IdList removed;
+	foreach (Id const &id, mChangedIds) {
+		ObjectPointer const object = mObjects.value(id);
+		if (object)
+			changed << savedCopy(object.constData());
+		else
+			removed << id;
+	}
+	mChangedIds.clear();
+	mWriteAheadLog->append(changed, removed);
+}
+
+void Client::writeCheckpoint(bool inBackground) const
+{
+	waitForCheckpoint();
+	appendChanges();
+	// Checkpoint has all changes made so far, later ones go to the new segment
+	mChangedIds.clear();
+	int const segment = mWriteAheadLog ? mWriteAheadLog->startSegment() : mJournalSegment;
+	mCheckpointOutdated = false;
+
+	// Tables are shared with the checkpoint, defaults are filled in by it
+	if (inBackground) {
+		mCheckpoint = QtConcurrent::run(this, &Client::runCheckpoint, mObjects, mUnloadedPaths, segment);
+		mCheckpointPending = true;
+	} else if (!runCheckpoint(mObjects, mUnloadedPaths, segment)) {
+		mCheckpointOutdated = true;
+	}
+}
+
+bool Client::runCheckpoint(QHash<Id, ObjectPointer> const &objects, QHash<Id, QString> const &unreadPaths
+		, int journalSegment) const
+{
+	QList<Object*> copies;
+	try {
+		foreach (ObjectPointer const &object, objects)
+			copies << savedCopy(object.constData());
+		IdList const rootChildren = objects.value(Id::rootId())->children();
+		serializer.prepareCheckpoint(copies, unreadPaths.values(), rootChildren, journalSegment);
+	} catch (char const *error) {
+		// Old save and the journal are left as they are, nothing is lost
+		qDebug() << "Client: checkpoint failed:" << error;
+		qDeleteAll(copies);
+		return false;
+	} catch (...) {
+		qDebug() << "Client: checkpoint failed";
+		qDeleteAll(copies);
+		return false;
+	}
+	qDeleteAll(copies);
+	{
+		QMutexLocker locker(&mSaveFiles->mutex);
+		serializer.commitCheckpoint();
+	}
+	// Records of earlier segments still queued would otherwise recreate their files
+	if (mWriteAheadLog)
+		mWriteAheadLog->sync();
+	WriteAheadLog::removeSegmentsBefore(serializer.journalDir(), journalSegment);
+	return true;
+}
+
+void Client::waitForCheckpoint() const
+{
+	mCheckpoint.waitForFinished();
+	if (mCheckpointPending) {
+		mCheckpointPending = false;
+		if (!mCheckpoint.result())
+			mCheckpointOutdated = true;
+	}
+}
+
+void Client::journalProperty(Id const &id, QString const &name, QVariant const &newValue)
+{
+	markChanged(id);
+	if (!mJournal.isRecording()) {
+		mJournal.changedOutsideCommand();
+		return;
+	}
+
+	Object const * const object = findObject(id);
+	QVariant const oldValue = object->hasProperty(name) ? object->property(name) : QVariant();
+	mJournal.propertyChanged(id, name, oldValue, newValue);
+}
+
+void Client::journalChildren(Id const &id, IdList const &newChildren)
+{
+	markChanged(id);
+	if (mJournal.isRecording())
+		mJournal.childrenChanged(id, findObject(id)->children(), newChildren);
+	else
+		mJournal.changedOutsideCommand();
+}
+
+void Client::journalParent(Id const &id, Id const &newParent)
+{
+	markChanged(id);
+	if (mJournal.isRecording())
+		mJournal.parentChanged(id, findObject(id)->parent(), newParent);
+	else
+		mJournal.changedOutsideCommand();
+}
@@ -5,8 +5,15 @@
 #include "classes/object.h"
 #include "qrRepoGlobal.h"
 #include "serializer.h"
+#include "journal.h"
+#include "writeAheadLog.h"
+#include "../defaultPropertiesProvider.h"
+#include "../propertyValidator.h"
 
 #include <QHash>
+#include <QSet>
+#include <QtCore/QFuture>
+#include <QtCore/QMutex>
 
 namespace qrRepo {
 
@@ -16,8 +23,15 @@ namespace qrRepo {
 		{
 		public:
 			QRREPO_EXPORT Client(QString const &workingDirectory);
+			/// Snapshot of other for readers in other threads. Objects are shared until either
+			/// client changes them, the one that changes an object copies it first. Elements
+			/// not read by other are read by the snapshot when they are looked up, as they were
+			/// when the snapshot was taken. Snapshot never writes to the working directory.
+			QRREPO_EXPORT Client(Client const &other);
 			QRREPO_EXPORT ~Client();
-			qReal::IdList children(const qReal::Id &id) const;
+			/// Reads below look an object up once and never change the repository.
+			/// Returned references stay valid until the object is changed or removed.
+			qReal::IdList const &children(const qReal::Id &id) const;
 			qReal::Id parent(const qReal::Id &id) const;
 			void setParent(const qReal::Id &id, const qReal::Id &parent);
 			void addChild(const qReal::Id &id, const qReal::Id &child);
@@ -25,9 +39,13 @@ namespace qrRepo {
 			void removeParent(const qReal::Id &id);
 			void removeChild(const qReal::Id &id, const qReal::Id &child);
 			void setProperty(const qReal::Id &id, const QString &name, const QVariant &value);
+			void setProperties(const qReal::Id &id, QMap<QString, QVariant> const &properties);
 			QVariant property(const qReal::Id &id, const QString &name) const;
 			void removeProperty(const qReal::Id &id, const QString &name);
 			bool hasProperty(const qReal::Id &id, const QString &name) const;
+			QMapIterator<QString, QVariant> propertiesIterator(qReal::Id const &id) const;
+			/// Stored properties only, unset ones read as defaults are not there.
+			QMap<QString, QVariant> const &properties(qReal::Id const &id) const;
 			void remove(const qReal::Id &id);
 			void setTemporaryRemovedLinks(qReal::Id const &id, QString const &direction, qReal::IdList const &linkIdList);
 			qReal::IdList temporaryRemovedLinksAt(qReal::Id const &id, QString const &direction) const;
@@ -35,6 +53,12 @@ namespace qrRepo {
 			void removeTemporaryRemovedLinks(qReal::Id const &id);
 
 			qReal::IdList elements() const;
+			/// Walks all objects without copying the list of ids, e.g. to select elements by type.
+			QHashIterator<qReal::Id, ObjectPointer> objectsIterator() const;
+			/// All elements of the repository, read from disk or not.
+			int elementsCount() const;
+			/// Elements read from disk so far, see loadFromDisk().
+			int loadedElementsCount() const;
 			bool isLogicalId(qReal::Id const &elem) const;
 			qReal::Id logicalId(qReal::Id const &elem) const;
 
@@ -48,22 +72,137 @@ namespace qrRepo {
 
 			bool exist(qReal::Id const &id) const;
 
+			/// Replaces the save in the working dir with a complete new one. The old save
+			/// stays intact until the new one is written, see Serializer::commitCheckpoint().
 			void saveAll() const;
 			void save(qReal::IdList list) const;
-			void remove(qReal::IdList list) const;
+			void remove(qReal::IdList list);
 			void setWorkingDir(QString const &workingDir);
 
+			void beginCommand(QString const &description);
+			bool endCommand();
+			void setJournalListener(JournalListener *listener);
+			/// Defaults are read by background checkpoints, so a running one is waited for.
+			void setDefaultPropertiesProvider(DefaultPropertiesProvider const *provider);
+			void setPropertyValidator(PropertyValidator const *validator);
+			bool canUndo() const;
+			bool canRedo() const;
+			qReal::IdList undo(bool &structureChanged);
+			qReal::IdList redo(bool &structureChanged);
+			void beginInternalChanges();
+			void endInternalChanges();
+
+			/// Changes are written to the journal of the working dir as they are made, so that
+			/// they are restored after a crash. Changes made before autosave is enabled go
+			/// to the journal at once.
+			void setAutosaveEnabled(bool enabled);
+			/// Saves the repository in background if it changed since the last save. Editing may
+			/// go on meanwhile: the save is made of copies, and the journal covers later changes.
+			void checkpoint();
+			/// Blocks until changes made so far are in the journal on disk.
+			void flushJournal();
+			/// Bytes written to the journal since autosave was enabled.
+			qint64 journalBytesWritten() const;
+			/// True if changes not in the save were restored from the journal when the working dir was read.
+			bool wasRecovered() const;
+
 		private:
 			void init();
 
+			/// Reads only top-level elements if the save has a skeleton. Other elements
+			/// are read with their subtrees when they are looked up for the first time.
 			void loadFromDisk();
 			void addChildrenToRootObject();
+			/// Looks an object up, reading it with its subtree if it is still on disk.
+			Object const *findObject(qReal::Id const &id) const;
+			/// Looks an object up to change it, copying it first if it is shared with a snapshot
+			/// or the undo history.
+			Object *findObjectToChange(qReal::Id const &id);
+			void loadSubtree(qReal::Id const &id) const;
+			/// Reads everything, for walks over all elements and for saves to a clean directory.
+			void loadAll() const;
+			/// Snapshots read lookups and reads from disk one at a time, NULL for the repository itself.
+			QMutex *lookupMutex() const;
+			/// Shall be called before the files of the save are changed other than by a checkpoint:
+			/// reads elements snapshots may still need, and starts new files for the next save.
+			void keepSaveForSnapshots();
+			void saveSkeleton() const;
+			/// Throws for snapshots, they are not bound to a working directory.
+			void checkWorkingDirAccess() const;
+
+			/// Applies changes of the journal made after the save was written.
+			void replayJournal();
+			/// Segment after all existing ones, records there would not mix with stale ones.
+			int freeJournalSegment() const;
+			void markChanged(qReal::Id const &id);
+			/// Queues changes made since the last call to the journal.
+			void appendChanges() const;
+			/// Snapshots the repository and writes it to the working dir, in a worker thread if asked.
+			void writeCheckpoint(bool inBackground) const;
+			/// Writes the save of shared copies of the tables, objects are not changed meanwhile
+			/// since the repository copies shared objects before changing them.
+			/// @returns False if the save could not be written, the old one is left as it was.
+			bool runCheckpoint(QHash<qReal::Id, ObjectPointer> const &objects
+					, QHash<qReal::Id, QString> const &unreadPaths, int journalSegment) const;
+			/// Waits for a background checkpoint and marks its changes unsaved again if it failed.
+			void waitForCheckpoint() const;
 
 			qReal::IdList idsOfAllChildrenOf(qReal::Id id) const;
+			/// Copies of the object and of its subtree for saves, see savedCopy().
 			QList<Object*> allChildrenOf(qReal::Id id) const;
 
-			QHash<qReal::Id, Object*> mObjects;
+			void setObjectProperty(Object *object, QString const &name, QVariant const &value);
+			/// Throws if the validator rejects the value.
+			void checkObjectProperty(Object const *object, QString const &name, QVariant const &value) const;
+			void storeObjectProperty(Object *object, QString const &name, QVariant const &value);
+			QVariant defaultPropertyValue(Object const *object, QString const &name) const;
+			void dropDefaultProperties();
+			void dropDefaultProperties(ObjectPointer &object) const;
+			/// Copy of the object for saves, with defaults of unset properties filled in.
+			Object *savedCopy(Object const *object) const;
+
+			void journalProperty(qReal::Id const &id, QString const &name, QVariant const &newValue);
+			void journalChildren(qReal::Id const &id, qReal::IdList const &newChildren);
+			void journalParent(qReal::Id const &id, qReal::Id const &newParent);
+
+			/// Files of a save, shared by the repository and its snapshots that read them lazily.
+			struct SaveFiles : public QSharedData
+			{
+				/// Tree of the working dir is replaced at the end of a checkpoint, files must not be read then.
+				QMutex mutex;
+				/// Elements the repository read while snapshots were alive, as they are on disk.
+				/// Checkpoints rewrite their files, snapshots that didn't read them take them from here.
+				QHash<qReal::Id, ObjectPointer> readObjects;
+			};
+
+			/// Reading from disk doesn't change the repository, so lookups fill these in const methods.
+			/// Tables are implicitly shared with snapshots.
+			mutable QHash<qReal::Id, ObjectPointer> mObjects;
+			/// Elements of the working dir that are not read yet, with paths to their files.
+			mutable QHash<qReal::Id, QString> mUnloadedPaths;
+			/// Top-level elements read without their subtrees.
+			mutable QSet<qReal::Id> mPendingSubtrees;
 			Serializer serializer;
+			QExplicitlySharedDataPointer<SaveFiles> mSaveFiles;
+			/// Guards the tables above in snapshots, see lookupMutex().
+			mutable QMutex mLookupMutex;
+			Journal mJournal;
+			/// Journal of the working dir, NULL while autosave is disabled.
+			WriteAheadLog *mWriteAheadLog;
+			/// Segment the journal starts from when autosave is enabled. While it is disabled,
+			/// checkpoints mark it as the first segment with changes missing from the save.
+			int mJournalSegment;
+			/// Objects changed or removed since the last append to the journal.
+			mutable QSet<qReal::Id> mChangedIds;
+			/// Cleared when a checkpoint starts, set again if it fails.
+			mutable bool mCheckpointOutdated;
+			mutable QFuture<bool> mCheckpoint;
+			/// Result of mCheckpoint is not taken yet.
+			mutable bool mCheckpointPending;
+			bool mRecovered;
+			DefaultPropertiesProvider const *mDefaultProperties;
+			PropertyValidator const *mPropertyValidator;
+			bool const mIsSnapshot;
 		};
 
 	}
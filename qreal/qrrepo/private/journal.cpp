@@ -0,0 +1,289 @@
+#include "journal.h"
+#include "classes/object.h"
+
+using namespace qReal;
+using namespace qrRepo;
+using namespace qrRepo::details;
+
+Journal::Journal(int maxCommands, int maxEntries)
+	: mDepth(0), mInternalDepth(0), mEntriesCount(0), mMaxCommands(maxCommands), mMaxEntries(maxEntries)
+	, mCanMerge(false), mListener(NULL)
+{
+}
+
+void Journal::setListener(JournalListener *listener)
+{
+	mListener = listener;
+}
+
+void Journal::beginCommand(QString const &description)
+{
+	if (mDepth == 0) {
+		mCurrent.description = description;
+		mCurrent.entries.clear();
+	}
+	++mDepth;
+}
+
+bool Journal::endCommand()
+{
+	Q_ASSERT(mDepth > 0);
+	if (mDepth == 0 || --mDepth > 0)
+		return false;
+
+	if (mCurrent.entries.isEmpty())
+		return false;
+
+	clearRedo();
+	if (tryMerge()) {
+		mCurrent.entries.clear();
+		return false;
+	}
+
+	mEntriesCount += mCurrent.entries.size();
+	mUndo.append(mCurrent);
+	mCurrent.entries.clear();
+	mCanMerge = true;
+	trim();
+
+	if (mListener)
+		mListener->commandAdded(mUndo.last().description);
+	return true;
+}
+
+bool Journal::isRecording() const
+{
+	return mDepth > 0;
+}
+
+void Journal::beginInternalChanges()
+{
+	++mInternalDepth;
+}
+
+void Journal::endInternalChanges()
+{
+	Q_ASSERT(mInternalDepth > 0);
+	if (mInternalDepth > 0)
+		--mInternalDepth;
+}
+
+void Journal::changedOutsideCommand()
+{
+	if (mInternalDepth == 0)
+		clear();
+}
+
+void Journal::propertyChanged(Id const &id, QString const &name, QVariant const &oldValue, QVariant const &newValue)
+{
+	Entry entry;
+	entry.kind = propertyEntry;
+	entry.id = id;
+	entry.name = name;
+	entry.oldValue = oldValue;
+	entry.newValue = newValue;
+	record(entry);
+}
+
+void Journal::childrenChanged(Id const &id, IdList const &oldChildren, IdList const &newChildren)
+{
+	Entry entry;
+	entry.kind = childrenEntry;
+	entry.id = id;
+	entry.oldList = oldChildren;
+	entry.newList = newChildren;
+	record(entry);
+}
+
+void Journal::parentChanged(Id const &id, Id const &oldParent, Id const &newParent)
+{
+	Entry entry;
+	entry.kind = parentEntry;
+	entry.id = id;
+	entry.oldId = oldParent;
+	entry.newId = newParent;
+	record(entry);
+}
+
+void Journal::temporaryRemovedLinksChanged(Id const &id, QString const &direction
+		, IdList const &oldLinks, IdList const &newLinks)
+{
+	Entry entry;
+	entry.kind = temporaryRemovedLinksEntry;
+	entry.id = id;
+	entry.name = direction;
+	entry.oldList = oldLinks;
+	entry.newList = newLinks;
+	record(entry);
+}
+
+void Journal::objectAdded(ObjectPointer const &object)
+{
+	Entry entry;
+	entry.kind = objectAddedEntry;
+	entry.id = object->id();
+	entry.object = object;
+	record(entry);
+}
+
+void Journal::objectRemoved(ObjectPointer const &object)
+{
+	Entry entry;
+	entry.kind = objectRemovedEntry;
+	entry.id = object->id();
+	entry.object = object;
+	record(entry);
+}
+
+bool Journal::canUndo() const
+{
+	return !mUndo.isEmpty();
+}
+
+bool Journal::canRedo() const
+{
+	return !mRedo.isEmpty();
+}
+
+IdList Journal::undo(QHash<Id, ObjectPointer> &objects, bool &structureChanged)
+{
+	structureChanged = false;
+	if (mUndo.isEmpty())
+		return IdList();
+
+	Command const command = mUndo.takeLast();
+	mEntriesCount -= command.entries.size();
+
+	IdList changed;
+	for (int i = command.entries.size() - 1; i >= 0; --i) {
+		apply(command.entries[i], false, objects, structureChanged);
+		changed << command.entries[i].id;
+	}
+
+	mRedo.append(command);
+	mCanMerge = false;
+	return changed;
+}
+
+IdList Journal::redo(QHash<Id, ObjectPointer> &objects, bool &structureChanged)
+{
+	structureChanged = false;
+	if (mRedo.isEmpty())
+		return IdList();
+
+	Command const command = mRedo.takeLast();
+
+	IdList changed;
+	foreach (Entry const &entry, command.entries) {
+		apply(entry, true, objects, structureChanged);
+		changed << entry.id;
+	}
+
+	mEntriesCount += command.entries.size();
+	mUndo.append(command);
+	mCanMerge = false;
+	return changed;
+}
+
+void Journal::clear()
+{
+	bool const hadHistory = !mUndo.isEmpty() || !mRedo.isEmpty();
+
+	mUndo.clear();
+	clearRedo();
+	mEntriesCount = 0;
+	mCanMerge = false;
+
+	if (hadHistory)
+		historyCleared();
+}
+
+void Journal::record(Entry const &entry)
+{
+	Q_ASSERT(isRecording());
+	mCurrent.entries.append(entry);
+}
+
+void Journal::apply(Entry const &entry, bool forward, QHash<Id, ObjectPointer> &objects, bool &structureChanged) const
+{
+	switch (entry.kind) {
+	case objectAddedEntry:
+	case objectRemovedEntry:
+		if (forward == (entry.kind == objectAddedEntry))
+			objects.insert(entry.id, entry.object);
+		else
+			objects.remove(entry.id);
+		structureChanged = true;
+		return;
+	default:
+		break;
+	}
+
+	QHash<Id, ObjectPointer>::iterator const found = objects.find(entry.id);
+	Q_ASSERT(found != objects.end());
+	if (found == objects.end())
+		return;
+	found.value().detach();
+	Object * const object = found.value().data();
+
+	switch (entry.kind) {
+	case propertyEntry: {
+		QVariant const &value = forward ? entry.newValue : entry.oldValue;
+		if (value.isValid())
+			object->setProperty(entry.name, value);
+		else if (object->hasProperty(entry.name))
+			object->removeProperty(entry.name);
+		break;
+	}
+	case childrenEntry:
+		object->setChildren(forward ? entry.newList : entry.oldList);
+		structureChanged = true;
+		break;
+	case parentEntry:
+		object->setParent(forward ? entry.newId : entry.oldId);
+		structureChanged = true;
+		break;
+	case temporaryRemovedLinksEntry:
+		object->setTemporaryRemovedLinks(entry.name, forward ? entry.newList : entry.oldList);
+		break;
+	default:
+		break;
+	}
+}
+
+bool Journal::tryMerge()
+{
+	if (!mCanMerge || mUndo.isEmpty() || mCurrent.entries.size() != 1)
+		return false;
+
+	Entry const &current = mCurrent.entries.first();
+	Command &last = mUndo.last();
+	if (current.kind != propertyEntry || last.entries.size() != 1)
+		return false;
+
+	Entry &previous = last.entries.first();
+	if (previous.kind != propertyEntry || previous.id != current.id || previous.name != current.name)
+		return false;
+
+	previous.newValue = current.newValue;
+	return true;
+}
+
+void Journal::trim()
+{
+	while (mUndo.size() > 1 && (mUndo.size() > mMaxCommands || mEntriesCount > mMaxEntries)) {
+		mEntriesCount -= mUndo.takeFirst().entries.size();
+	}
+}
+
+void Journal::clearRedo()
+{
+	mRedo.clear();
+}
+
+void Journal::historyCleared()
+{
+	if (mListener)
+		mListener->historyCleared();
+}
+
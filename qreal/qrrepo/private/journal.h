@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../../qrgui/kernel/ids.h"
+#include "../journalListener.h"
+#include "classes/object.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QVariant>
+
+namespace qrRepo {
+
+	namespace details {
+
+		/// Log of changes made to repository objects, used for undo and redo.
+		/// Every change is stored with the values before and after it, changes
+		/// are grouped into commands. Removed objects are kept by the journal
+		/// while they can be restored, so undoing a removal of a subtree costs
+		/// as much as the subtree itself. Objects are shared with the repository,
+		/// changes made by undo and redo copy those shared with snapshots first.
+		class Journal
+		{
+		public:
+			explicit Journal(int maxCommands = 100, int maxEntries = 100000);
+
+			void setListener(JournalListener *listener);
+
+			/// Starts a group of changes undone and redone together. Commands may
+			/// be nested, only the outermost one goes to the history.
+			void beginCommand(QString const &description);
+			/// @returns True if outermost command is finished and a new item appeared in the history.
+			bool endCommand();
+
+			/// True if changes are made inside of a command. Other changes can not be
+			/// undone and would make the history inconsistent, so the history shall be cleared.
+			bool isRecording() const;
+
+			/// Changes made between these calls outside of a command keep the history, they are
+			/// made to follow the repository after undo or redo and are not recorded themselves.
+			/// Calls may be nested.
+			void beginInternalChanges();
+			void endInternalChanges();
+
+			/// Shall be called for a change that is made outside of a command. Clears the history
+			/// unless the change is internal.
+			void changedOutsideCommand();
+
+			/// Invalid QVariant as a value means that there is no such property.
+			void propertyChanged(qReal::Id const &id, QString const &name, QVariant const &oldValue, QVariant const &newValue);
+			void childrenChanged(qReal::Id const &id, qReal::IdList const &oldChildren, qReal::IdList const &newChildren);
+			void parentChanged(qReal::Id const &id, qReal::Id const &oldParent, qReal::Id const &newParent);
+			void temporaryRemovedLinksChanged(qReal::Id const &id, QString const &direction
+					, qReal::IdList const &oldLinks, qReal::IdList const &newLinks);
+			void objectAdded(ObjectPointer const &object);
+			/// Removed object is kept to be restored on undo.
+			void objectRemoved(ObjectPointer const &object);
+
+			bool canUndo() const;
+			bool canRedo() const;
+
+			/// Applies inverse changes of the last command to given objects.
+			/// @param structureChanged Set to true if objects were added, removed or moved.
+			/// @returns Elements affected by the command.
+			qReal::IdList undo(QHash<qReal::Id, ObjectPointer> &objects, bool &structureChanged);
+			qReal::IdList redo(QHash<qReal::Id, ObjectPointer> &objects, bool &structureChanged);
+
+			void clear();
+
+		private:
+			enum EntryKind {
+				propertyEntry
+				, childrenEntry
+				, parentEntry
+				, temporaryRemovedLinksEntry
+				, objectAddedEntry
+				, objectRemovedEntry
+			};
+
+			struct Entry {
+				EntryKind kind;
+				qReal::Id id;
+				QString name;
+				QVariant oldValue;
+				QVariant newValue;
+				qReal::IdList oldList;
+				qReal::IdList newList;
+				qReal::Id oldId;
+				qReal::Id newId;
+				ObjectPointer object;
+			};
+
+			struct Command {
+				QString description;
+				QList<Entry> entries;
+			};
+
+			Journal(Journal const &);
+			Journal &operator =(Journal const &);
+
+			void record(Entry const &entry);
+			void apply(Entry const &entry, bool forward, QHash<qReal::Id, ObjectPointer> &objects, bool &structureChanged) const;
+			bool tryMerge();
+			void trim();
+			void clearRedo();
+			void historyCleared();
+
+			QList<Command> mUndo;
+			QList<Command> mRedo;
+			Command mCurrent;
+			int mDepth;
+			int mInternalDepth;
+			int mEntriesCount;
+			int const mMaxCommands;
+			int const mMaxEntries;
+			bool mCanMerge;
+			JournalListener *mListener;
+		};
+
+	}
+
+}
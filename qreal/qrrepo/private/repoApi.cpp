@@ -6,15 +6,40 @@ using namespace qrRepo;
 using namespace qrRepo::details;
 using namespace qReal;
 
+namespace {
+
+// Names of properties read on every walk over the model, so that reads don't build strings.
+QString const nameProperty = "name";
+QString const linksProperty = "links";
+QString const fromProperty = "from";
+QString const toProperty = "to";
+QString const outgoingConnectionsProperty = "outgoingConnections";
+QString const incomingConnectionsProperty = "incomingConnections";
+QString const outgoingUsagesProperty = "outgoingUsages";
+QString const incomingUsagesProperty = "incomingUsages";
+
+}
+
 RepoApi::RepoApi(QString const &workingDirectory)
 	: mClient(workingDirectory)
 {
 }
 
+RepoApi::RepoApi(Client const &source)
+	: mClient(source)
+{
+}
+
+RepoApi *RepoApi::snapshot() const
+{
+	return new RepoApi(mClient);
+}
+
 QString RepoApi::name(Id const &id) const
 {
-	Q_ASSERT(mClient.property(id, "name").canConvert<QString>());
-	return mClient.property(id, "name").toString();
+	QVariant const name = mClient.property(id, nameProperty);
+	Q_ASSERT(name.canConvert<QString>());
+	return name.toString();
 }
 
 void RepoApi::setName(Id const &id, QString const &name)
@@ -27,6 +52,11 @@ IdList RepoApi::children(Id const &id) const
 	return mClient.children(id);
 }
 
+IdList const &RepoApi::constChildren(Id const &id) const
+{
+	return mClient.children(id);
+}
+
 void RepoApi::addChild(Id const &id, Id const &child)
 {
 	mClient.addChild(id, child);
@@ -118,9 +148,9 @@ void RepoApi::setParent(Id const &id, Id const &parent)
 
 IdList RepoApi::links(Id const &id, QString const &direction) const
 {
-	IdList links = mClient.property(id, "links").value<IdList>();
+	IdList const links = mClient.property(id, linksProperty).value<IdList>();
 	IdList result;
-	foreach (Id const link, links) {
+	foreach (Id const &link, links) {
 		if (mClient.property(link, direction).value<Id>() == id) {
 			result.append(link);
 		}
@@ -130,12 +160,12 @@ IdList RepoApi::links(Id const &id, QString const &direction) const
 
 IdList RepoApi::outgoingLinks(Id const &id) const
 {
-	return links(id, "from");
+	return links(id, fromProperty);
 }
 
 IdList RepoApi::incomingLinks(Id const &id) const
 {
-	return links(id, "to");
+	return links(id, toProperty);
 }
 
 IdList RepoApi::links(Id const &id) const
@@ -145,12 +175,12 @@ IdList RepoApi::links(Id const &id) const
 
 qReal::IdList RepoApi::outgoingConnections(qReal::Id const &id) const
 {
-	return mClient.property(id, "outgoingConnections").value<IdList>();
+	return mClient.property(id, outgoingConnectionsProperty).value<IdList>();
 }
 
 qReal::IdList RepoApi::incomingConnections(qReal::Id const &id) const
 {
-	return mClient.property(id, "incomingConnections").value<IdList>();
+	return mClient.property(id, incomingConnectionsProperty).value<IdList>();
 }
 
 void RepoApi::connect(qReal::Id const &source, qReal::Id const &destination)
@@ -167,12 +197,12 @@ void RepoApi::disconnect(qReal::Id const &source, qReal::Id const &destination)
 
 qReal::IdList RepoApi::outgoingUsages(qReal::Id const &id) const
 {
-	return mClient.property(id, "outgoingUsages").value<IdList>();
+	return mClient.property(id, outgoingUsagesProperty).value<IdList>();
 }
 
 qReal::IdList RepoApi::incomingUsages(qReal::Id const &id) const
 {
-	return mClient.property(id, "incomingUsages").value<IdList>();
+	return mClient.property(id, incomingUsagesProperty).value<IdList>();
 }
 
 void RepoApi::addUsage(qReal::Id const &source, qReal::Id const &destination)
@@ -224,8 +254,9 @@ QVariant RepoApi::property(Id const &id, QString const &propertyName) const
 
 QString RepoApi::stringProperty(Id const &id, QString const &propertyName) const
 {
-	Q_ASSERT(mClient.property(id, propertyName).canConvert<QString>());
-	return mClient.property(id, propertyName).toString();
+	QVariant const value = mClient.property(id, propertyName);
+	Q_ASSERT(value.canConvert<QString>());
+	return value.toString();
 }
 
 void RepoApi::setProperty(Id const &id, QString const &propertyName, QVariant const &value)
@@ -233,6 +264,11 @@ void RepoApi::setProperty(Id const &id, QString const &propertyName, QVariant co
 	mClient.setProperty(id, propertyName, value);
 }
 
+void RepoApi::setProperties(Id const &id, QMap<QString, QVariant> const &properties)
+{
+	mClient.setProperties(id, properties);
+}
+
 void RepoApi::removeProperty(Id const &id, QString const &propertyName)
 {
 	mClient.removeProperty(id, propertyName);
@@ -243,10 +279,21 @@ bool RepoApi::hasProperty(Id const &id, QString const &propertyName) const
 	return mClient.hasProperty(id, propertyName);
 }
 
+QMapIterator<QString, QVariant> RepoApi::propertiesIterator(Id const &id) const
+{
+	return mClient.propertiesIterator(id);
+}
+
+QMap<QString, QVariant> const &RepoApi::constProperties(Id const &id) const
+{
+	return mClient.properties(id);
+}
+
 Id RepoApi::from(Id const &id) const
 {
-	Q_ASSERT(mClient.property(id, "from").canConvert<Id>());
-	return mClient.property(id, "from").value<Id>();
+	QVariant const from = mClient.property(id, fromProperty);
+	Q_ASSERT(from.canConvert<Id>());
+	return from.value<Id>();
 }
 
 void RepoApi::setFrom(Id const &id, Id const &from)
@@ -261,8 +308,9 @@ void RepoApi::setFrom(Id const &id, Id const &from)
 
 Id RepoApi::to(Id const &id) const
 {
-	Q_ASSERT(mClient.property(id, "to").canConvert<Id>());
-	return mClient.property(id, "to").value<Id>();
+	QVariant const to = mClient.property(id, toProperty);
+	Q_ASSERT(to.canConvert<Id>());
+	return to.value<Id>();
 }
 
 void RepoApi::setTo(Id const &id, Id const &to)
@@ -358,6 +406,31 @@ void RepoApi::save(qReal::IdList list) const
 	mClient.save(list);
 }
 
+void RepoApi::setAutosaveEnabled(bool enabled)
+{
+	mClient.setAutosaveEnabled(enabled);
+}
+
+void RepoApi::checkpoint()
+{
+	mClient.checkpoint();
+}
+
+void RepoApi::flushJournal()
+{
+	mClient.flushJournal();
+}
+
+bool RepoApi::wasRecovered() const
+{
+	return mClient.wasRecovered();
+}
+
+qint64 RepoApi::journalBytesWritten() const
+{
+	return mClient.journalBytesWritten();
+}
+
 void RepoApi::addToIdList(Id const &target, QString const &listName, Id const &data, QString const &direction)
 {
 	if (target == Id::rootId())
@@ -409,9 +482,11 @@ IdList RepoApi::logicalElements(Id const &type) const
 	Q_ASSERT(type.idSize() == 3);
 
 	IdList result;
-	foreach (Id id, mClient.elements()) {
-		if (id.element() == type.element() && mClient.isLogicalId(id))
-			result.append(id);
+	QHashIterator<Id, ObjectPointer> iterator = mClient.objectsIterator();
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (iterator.key().element() == type.element() && iterator.value()->logicalId() == Id())
+			result.append(iterator.key());
 	}
 	return result;
 }
@@ -421,9 +496,11 @@ IdList RepoApi::graphicalElements(Id const &type) const
 	Q_ASSERT(type.idSize() == 3);
 
 	IdList result;
-	foreach (Id id, mClient.elements()) {
-		if (id.element() == type.element() && !mClient.isLogicalId(id))
-			result.append(id);
+	QHashIterator<Id, ObjectPointer> iterator = mClient.objectsIterator();
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (iterator.key().element() == type.element() && iterator.value()->logicalId() != Id())
+			result.append(iterator.key());
 	}
 	return result;
 }
@@ -431,16 +508,23 @@ IdList RepoApi::graphicalElements(Id const &type) const
 IdList RepoApi::elementsByType(QString const &type) const
 {
 	IdList result;
-	foreach (Id id, mClient.elements()) {
-		if (id.element() == type)
-			result.append(id);
+	QHashIterator<Id, ObjectPointer> iterator = mClient.objectsIterator();
+	while (iterator.hasNext()) {
+		iterator.next();
+		if (iterator.key().element() == type)
+			result.append(iterator.key());
 	}
 	return result;
 }
 
 int RepoApi::elementsCount() const
 {
-	return mClient.elements().size();
+	return mClient.elementsCount();
+}
+
+int RepoApi::loadedElementsCount() const
+{
+	return mClient.loadedElementsCount();
 }
 
 bool RepoApi::exist(Id const &id) const
@@ -462,3 +546,58 @@ void RepoApi::removeTemporaryRemovedLinks(Id const &id)
 {
 	mClient.removeTemporaryRemovedLinks(id);
 }
+
+void RepoApi::beginCommand(QString const &description)
+{
+	mClient.beginCommand(description);
+}
+
+void RepoApi::endCommand()
+{
+	mClient.endCommand();
+}
+
+void RepoApi::setJournalListener(JournalListener *listener)
+{
+	mClient.setJournalListener(listener);
+}
+
+void RepoApi::setDefaultPropertiesProvider(DefaultPropertiesProvider const *provider)
+{
+	mClient.setDefaultPropertiesProvider(provider);
+}
+
+void RepoApi::setPropertyValidator(PropertyValidator const *validator)
+{
+	mClient.setPropertyValidator(validator);
+}
+
+bool RepoApi::canUndo() const
+{
+	return mClient.canUndo();
+}
+
+bool RepoApi::canRedo() const
+{
+	return mClient.canRedo();
+}
+
+IdList RepoApi::undo(bool &structureChanged)
+{
+	return mClient.undo(structureChanged);
+}
+
+IdList RepoApi::redo(bool &structureChanged)
+{
+	return mClient.redo(structureChanged);
+}
+
+void RepoApi::beginInternalChanges()
+{
+	mClient.beginInternalChanges();
+}
+
+void RepoApi::endInternalChanges()
+{
+	mClient.endInternalChanges();
+}
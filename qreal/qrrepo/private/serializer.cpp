@@ -1,6 +1,8 @@
 #include "serializer.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
 #include <QtCore/QDebug>
 #include <QtCore/QPointF>
 #include <QtGui/QPolygon>
@@ -38,22 +40,38 @@ void Serializer::saveToDisk(QList<Object*> const &objects) const
 {
 	foreach (Object *object, objects) {
 		QString filePath = createDirectory(object->id(), object->logicalId());
+		OutFile out(filePath);
+		objectToXml(object).save(out(), 2);
+	}
+}
 
-		QDomDocument doc;
-		QDomElement root = doc.createElement("object");
-		doc.appendChild(root);
-		root.setAttribute("id", object->id().toString());
-		if (object->logicalId() != Id())
-			root.setAttribute("logicalId", object->logicalId().toString());
-
-		root.setAttribute("parent", object->parent().toString());
+QDomDocument Serializer::objectToXml(Object *object)
+{
+	QDomDocument doc;
+	QDomElement root = doc.createElement("object");
+	doc.appendChild(root);
+	root.setAttribute("id", object->id().toString());
+	if (object->logicalId() != Id())
+		root.setAttribute("logicalId", object->logicalId().toString());
+
+	root.setAttribute("parent", object->parent().toString());
+
+	root.appendChild(idListToXml("children", object->children(), doc));
+	root.appendChild(propertiesToXml(object, doc));
+	return doc;
+}
 
-		root.appendChild(idListToXml("children", object->children(), doc));
-		root.appendChild(propertiesToXml(object, doc));
+QByteArray Serializer::serializeObject(Object *object)
+{
+	return objectToXml(object).toByteArray(0);
+}
 
-		OutFile out(filePath);
-		doc.save(out(), 2);
-	}
+Object *Serializer::deserializeObject(QByteArray const &data)
+{
+	QDomDocument doc;
+	if (!doc.setContent(data))
+		return NULL;
+	return parseObject(doc.documentElement());
 }
 
 void Serializer::loadFromDisk(QHash<qReal::Id, Object*> &objectsHash)
@@ -89,6 +107,137 @@ void Serializer::loadModel(QDir const &dir, QHash<qReal::Id, Object*> &objectsHa
 	}
 }
 
+void Serializer::loadIndex(QHash<Id, QString> &paths) const
+{
+	loadIndex(mWorkingDir + "/tree/logical", paths);
+	loadIndex(mWorkingDir + "/tree/graphical", paths);
+}
+
+void Serializer::loadIndex(QString const &modelPath, QHash<Id, QString> &paths) const
+{
+	// Files are laid out by ids: editor/diagram/element/uuid, see createDirectory()
+	QDir const modelDir(modelPath);
+	QDirIterator iterator(modelPath, QDir::Files, QDirIterator::Subdirectories);
+	while (iterator.hasNext()) {
+		QString const path = iterator.next();
+		QString const relativePath = modelDir.relativeFilePath(path);
+		if (relativePath.count('/') != 3)
+			continue;
+		Id const id = Id::loadFromString("qrm:/" + relativePath);
+		if (id != Id::rootId())
+			paths.insert(id, path);
+	}
+}
+
+Object *Serializer::loadObject(QString const &path) const
+{
+	QDomDocument const doc = xmlUtils::loadDocument(path);
+	return parseObject(doc.documentElement());
+}
+
+QString Serializer::skeletonPath() const
+{
+	// Cleared with the tree, so a skeleton is found only if it was written after the last save
+	return mWorkingDir + "/tree/skeleton.xml";
+}
+
+bool Serializer::loadSkeleton(IdList &rootChildren) const
+{
+	if (!QFile::exists(skeletonPath()))
+		return false;
+	QDomDocument const doc = xmlUtils::loadDocument(skeletonPath());
+	rootChildren = loadIdList(doc.documentElement(), "children");
+	return true;
+}
+
+void Serializer::saveSkeleton(IdList const &rootChildren) const
+{
+	QDomDocument doc;
+	QDomElement root = doc.createElement("skeleton");
+	doc.appendChild(root);
+	root.appendChild(idListToXml("children", rootChildren, doc));
+
+	QDir().mkpath(mWorkingDir + "/tree");
+	OutFile out(skeletonPath());
+	doc.save(out(), 2);
+}
+
+QString Serializer::journalDir() const
+{
+	return mWorkingDir + ".journal";
+}
+
+QString Serializer::journalSegmentPath() const
+{
+	// Swapped together with the tree it describes
+	return mWorkingDir + "/tree/journalSegment";
+}
+
+QString Serializer::checkpointDir() const
+{
+	return mWorkingDir + "/checkpoint";
+}
+
+int Serializer::journalSegment() const
+{
+	QFile file(journalSegmentPath());
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return 0;
+	return QString(file.readAll()).trimmed().toInt();
+}
+
+void Serializer::prepareCheckpoint(QList<Object*> const &objects, QStringList const &unreadFiles
+		, IdList const &rootChildren, int journalSegment) const
+{
+	// Only the tree is replaced, other contents of the working dir (e.g. .svn) stay
+	Serializer checkpoint(*this);
+	checkpoint.mWorkingDir = checkpointDir();
+	removeDir(checkpoint.mWorkingDir);
+
+	checkpoint.saveToDisk(objects);
+	// Paths are made of the working dir, see loadIndex()
+	foreach (QString const &path, unreadFiles) {
+		QString const target = checkpoint.mWorkingDir + path.mid(mWorkingDir.length());
+		QDir().mkpath(QFileInfo(target).path());
+		// Element missing from the checkpoint would be lost once the old tree is replaced
+		if (!QFile::copy(path, target))
+			throw "Failed to copy a file of an unread element";
+	}
+	checkpoint.saveSkeleton(rootChildren);
+
+	// Written last, a save without it was interrupted
+	OutFile out(checkpoint.journalSegmentPath());
+	out() << journalSegment << "\n";
+}
+
+void Serializer::commitCheckpoint() const
+{
+	QString const treeDir = mWorkingDir + "/tree";
+	QString const oldDir = mWorkingDir + "/tree.old";
+	removeDir(oldDir);
+	QDir dir;
+	if (dir.exists(treeDir))
+		dir.rename(treeDir, oldDir);
+	dir.rename(checkpointDir() + "/tree", treeDir);
+	removeDir(oldDir);
+	removeDir(checkpointDir());
+}
+
+void Serializer::recoverWorkingDir() const
+{
+	QString const treeDir = mWorkingDir + "/tree";
+	QString const newDir = checkpointDir() + "/tree";
+	QString const oldDir = mWorkingDir + "/tree.old";
+	QDir dir;
+	// Crashed between the renames of commitCheckpoint()
+	if (!dir.exists(treeDir) && QFile::exists(newDir + "/journalSegment"))
+		dir.rename(newDir, treeDir);
+	if (!dir.exists(treeDir) && dir.exists(oldDir))
+		dir.rename(oldDir, treeDir);
+	removeDir(checkpointDir());
+	removeDir(oldDir);
+}
+
 Object *Serializer::parseObject(QDomElement const &elem)
 {
 	QString const id = elem.attribute("id", "");
@@ -219,6 +368,12 @@ QPointF Serializer::parsePointF(QString const &str)
 	return QPointF(x, y);
 }
 
+void Serializer::removeDir(QString const &path)
+{
+	clearDir(path);
+	QDir().rmdir(path);
+}
+
 void Serializer::clearDir(QString const &path)
 {
 	QDir dir(path);
@@ -22,15 +22,49 @@ namespace qrRepo {
 			void removeFromDisk(qReal::Id id) const;
 			void saveToDisk(QList<Object*> const &objects) const;
 			void loadFromDisk(QHash<qReal::Id, Object*> &objectsHash);
+
+			/// Ids of all elements of the save with paths to their files, files are not read.
+			void loadIndex(QHash<qReal::Id, QString> &paths) const;
+			/// Reads one element, NULL if its file is broken.
+			Object *loadObject(QString const &path) const;
+			/// Top-level elements (children of the root) as of the last save. Returns false
+			/// if the save has no skeleton, e.g. it was interrupted or made by an older version.
+			bool loadSkeleton(qReal::IdList &rootChildren) const;
+			void saveSkeleton(qReal::IdList const &rootChildren) const;
+
+			/// Directory of the autosave journal, see WriteAheadLog.
+			QString journalDir() const;
+			/// First journal segment with changes the save doesn't have.
+			int journalSegment() const;
+			/// Writes a complete tree of the save into a staging dir inside the working dir: given
+			/// objects, and files of elements that were not read, copied as they are. Throws if
+			/// a file can't be written or copied, the tree of the working dir is not touched then.
+			void prepareCheckpoint(QList<Object*> const &objects, QStringList const &unreadFiles
+					, qReal::IdList const &rootChildren, int journalSegment) const;
+			/// Replaces the tree of the working dir with the prepared one, the rest of the dir is
+			/// kept. A crash at any moment leaves one of the trees complete, see recoverWorkingDir().
+			void commitCheckpoint() const;
+			/// Finishes or drops a checkpoint interrupted by a crash.
+			void recoverWorkingDir() const;
+
+			/// Object as it is stored in a file, for records of the journal.
+			static QByteArray serializeObject(Object *object);
+			static Object *deserializeObject(QByteArray const &data);
 		private:
 			void loadFromDisk(QString const &currentPath, QHash<qReal::Id, Object*> &objectsHash);
 			void loadModel(QDir const &dir, QHash<qReal::Id, Object*> &objectsHash);
+			void loadIndex(QString const &modelPath, QHash<qReal::Id, QString> &paths) const;
+			QString skeletonPath() const;
+			QString journalSegmentPath() const;
+			QString checkpointDir() const;
 
 			QString pathToElement(qReal::Id const &id) const;
 			QString createDirectory(qReal::Id const &id, qReal::Id const &logicalId) const;
 
-			Object *parseObject(QDomElement const &elem);
+			static QDomDocument objectToXml(Object *object);
+			static Object *parseObject(QDomElement const &elem);
 			static void clearDir(QString const &path);
+			static void removeDir(QString const &path);
 			static QVariant parseValue(QString const &typeName, QString const &valueStr);
 			static qReal::IdList loadIdList(QDomElement const &elem, QString const &name);
 			static qReal::Id loadId(QString const &elementStr);
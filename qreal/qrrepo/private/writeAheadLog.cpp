@@ -0,0 +1,214 @@
+#include "writeAheadLog.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#ifdef Q_OS_WIN
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+#include "classes/object.h"
+#include "serializer.h"
+
+using namespace qrRepo;
+using namespace details;
+using namespace qReal;
+
+namespace {
+	int const recordHeaderSize = sizeof(quint32) + sizeof(quint16);
+
+	void syncToDisk(QFile &file)
+	{
+		file.flush();
+#ifdef Q_OS_WIN
+		_commit(file.handle());
+#else
+		fsync(file.handle());
+#endif
+	}
+}
+
+WriteAheadLog::WriteAheadLog(QString const &dir, int segment)
+	: mDir(dir)
+	, mSegment(segment)
+	, mAppendedBatches(0)
+	, mWrittenBatches(0)
+	, mBytesWritten(0)
+	, mStopping(false)
+{
+	QDir().mkpath(mDir);
+	start(QThread::LowPriority);
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+	{
+		QMutexLocker locker(&mMutex);
+		mStopping = true;
+		mQueued.wakeAll();
+	}
+	wait();
+}
+
+void WriteAheadLog::append(QList<Object*> const &changed, IdList const &removed)
+{
+	if (changed.isEmpty() && removed.isEmpty())
+		return;
+
+	QMutexLocker locker(&mMutex);
+	Batch const batch = { mSegment, changed, removed };
+	mQueue << batch;
+	++mAppendedBatches;
+	mQueued.wakeAll();
+}
+
+int WriteAheadLog::startSegment()
+{
+	QMutexLocker locker(&mMutex);
+	return ++mSegment;
+}
+
+void WriteAheadLog::sync()
+{
+	QMutexLocker locker(&mMutex);
+	qint64 const appended = mAppendedBatches;
+	while (mWrittenBatches < appended)
+		mWritten.wait(&mMutex);
+}
+
+qint64 WriteAheadLog::bytesWritten() const
+{
+	QMutexLocker locker(&mMutex);
+	return mBytesWritten;
+}
+
+void WriteAheadLog::run()
+{
+	QMutexLocker locker(&mMutex);
+	forever {
+		while (mQueue.isEmpty() && !mStopping)
+			mQueued.wait(&mMutex);
+		if (mQueue.isEmpty())
+			return;
+
+		QList<Batch> const batches = mQueue;
+		mQueue.clear();
+		locker.unlock();
+
+		// Files are not kept open between writes so that finished segments can be removed
+		QFile file;
+		qint64 bytes = 0;
+		foreach (Batch const &batch, batches) {
+			if (file.fileName() != segmentPath(mDir, batch.segment)) {
+				if (file.isOpen()) {
+					syncToDisk(file);
+					file.close();
+				}
+				file.setFileName(segmentPath(mDir, batch.segment));
+				if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+					qDebug() << "WriteAheadLog: can't open" << file.fileName();
+			}
+
+			foreach (Object *object, batch.changed) {
+				if (file.isOpen())
+					bytes += writeRecord(file, object->id(), Serializer::serializeObject(object));
+				delete object;
+			}
+			if (file.isOpen()) {
+				foreach (Id const &id, batch.removed)
+					bytes += writeRecord(file, id, QByteArray());
+			}
+		}
+		if (file.isOpen()) {
+			syncToDisk(file);
+			file.close();
+		}
+
+		locker.relock();
+		mWrittenBatches += batches.size();
+		mBytesWritten += bytes;
+		mWritten.wakeAll();
+	}
+}
+
+qint64 WriteAheadLog::writeRecord(QFile &file, Id const &id, QByteArray const &state)
+{
+	QByteArray payload;
+	QDataStream record(&payload, QIODevice::WriteOnly);
+	record << id.toString() << state;
+
+	QDataStream out(&file);
+	out << quint32(payload.size()) << qChecksum(payload.constData(), payload.size());
+	out.writeRawData(payload.constData(), payload.size());
+	return recordHeaderSize + payload.size();
+}
+
+QString WriteAheadLog::segmentPath(QString const &dir, int segment)
+{
+	return dir + "/" + QString::number(segment) + ".wal";
+}
+
+QList<int> WriteAheadLog::segments(QString const &dir)
+{
+	QList<int> result;
+	foreach (QString const &fileName, QDir(dir).entryList(QStringList("*.wal"), QDir::Files)) {
+		bool ok = false;
+		int const segment = fileName.left(fileName.length() - 4).toInt(&ok);
+		if (ok)
+			result << segment;
+	}
+	qSort(result);
+	return result;
+}
+
+void WriteAheadLog::removeSegmentsBefore(QString const &dir, int segment)
+{
+	foreach (int const existing, segments(dir)) {
+		if (existing < segment)
+			QFile::remove(segmentPath(dir, existing));
+	}
+}
+
+void WriteAheadLog::replay(QString const &dir, int firstSegment, QHash<Id, Object*> &states)
+{
+	foreach (int const segment, segments(dir)) {
+		if (segment < firstSegment)
+			continue;
+
+		QFile file(segmentPath(dir, segment));
+		if (!file.open(QIODevice::ReadOnly))
+			continue;
+
+		QDataStream in(&file);
+		forever {
+			quint32 size = 0;
+			quint16 checksum = 0;
+			in >> size >> checksum;
+			if (in.status() != QDataStream::Ok || size > file.bytesAvailable())
+				break;
+
+			QByteArray payload(size, '\0');
+			if (in.readRawData(payload.data(), size) != static_cast<int>(size)
+					|| qChecksum(payload.constData(), payload.size()) != checksum)
+				break;
+
+			QDataStream record(payload);
+			QString idString;
+			QByteArray state;
+			record >> idString >> state;
+			if (record.status() != QDataStream::Ok)
+				break;
+			Object * const object = state.isEmpty() ? NULL : Serializer::deserializeObject(state);
+			if (!state.isEmpty() && !object)
+				break;
+
+			Id const id = Id::loadFromString(idString);
+			delete states.value(id);
+			states.insert(id, object);
+		}
+	}
+}
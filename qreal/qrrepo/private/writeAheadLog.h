@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../../qrgui/kernel/ids.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+namespace qrRepo {
+
+	namespace details {
+
+		class Object;
+
+		/// Journal of changes made since the last save, for recovery after a crash.
+		/// Every record holds the whole state of a changed object or marks it removed,
+		/// so the latest record of an object is enough to restore it. Records are
+		/// written and synced to disk by the log's own thread: batches queued while
+		/// the previous ones are written go to disk together, with one sync.
+		/// The journal is split into numbered segments, a save made when a segment
+		/// is started makes all earlier segments needless.
+		class WriteAheadLog : public QThread
+		{
+		public:
+			/// Records go to the given segment of the journal in the given directory.
+			WriteAheadLog(QString const &dir, int segment);
+			/// Writes everything appended so far.
+			~WriteAheadLog();
+
+			/// Queues copies of changed objects and ids of removed ones, returns immediately.
+			/// Log takes ownership of the objects.
+			void append(QList<Object*> const &changed, qReal::IdList const &removed);
+			/// Records appended after this go to a new segment.
+			/// @returns Number of the new segment.
+			int startSegment();
+			/// Blocks until everything appended so far is on disk.
+			void sync();
+			qint64 bytesWritten() const;
+
+			/// Numbers of segments in the directory, in ascending order.
+			static QList<int> segments(QString const &dir);
+			static void removeSegmentsBefore(QString const &dir, int segment);
+			/// Reads segments starting from the given one, the latest state of every object
+			/// recorded there goes to states, NULL for removed objects. Reading of a segment
+			/// stops at a broken record, e.g. the one that was being written during a crash.
+			static void replay(QString const &dir, int firstSegment, QHash<qReal::Id, Object*> &states);
+
+		protected:
+			void run();
+
+		private:
+			struct Batch {
+				int segment;
+				QList<Object*> changed;
+				qReal::IdList removed;
+			};
+
+			WriteAheadLog(WriteAheadLog const &);
+			WriteAheadLog &operator =(WriteAheadLog const &);
+
+			static QString segmentPath(QString const &dir, int segment);
+			static qint64 writeRecord(QFile &file, qReal::Id const &id, QByteArray const &state);
+
+			QString const mDir;
+			mutable QMutex mMutex;
+			QWaitCondition mQueued;
+			QWaitCondition mWritten;
+			QList<Batch> mQueue;
+			int mSegment;
+			qint64 mAppendedBatches;
+			qint64 mWrittenBatches;
+			qint64 mBytesWritten;
+			bool mStopping;
+		};
+
+	}
+
+}
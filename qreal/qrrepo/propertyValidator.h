@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include "../qrgui/kernel/ids.h"
+
+namespace qrRepo {
+
+/// Checks values of properties of logical elements against the metamodel before repository
+/// stores them, so bad data is rejected when it is written, not when a generator reads it.
+class PropertyValidator
+{
+public:
+	virtual ~PropertyValidator() {}
+
+	/// Returns false and describes the problem in error if elements of given type can't have
+	/// such value of the property. Properties unknown to the metamodel are valid.
+	virtual bool validate(qReal::Id const &type, QString const &name, QVariant const &value
+			, QString &error) const = 0;
+};
+
+}
@@ -25,11 +25,15 @@ HEADERS += \
 	private/client.h \
 	private/qrRepoGlobal.h \
 	private/serializer.h \
+	private/journal.h \
+	private/writeAheadLog.h \
     private/classes/object.h
 
 SOURCES += \
 	private/client.cpp \
 	private/serializer.cpp \
+	private/journal.cpp \
+	private/writeAheadLog.cpp \
     private/classes/object.cpp
 
 # API репозитория
@@ -39,6 +43,10 @@ HEADERS += \
 	logicalRepoApi.h \
 	repoControlInterface.h \
 	commonRepoApi.h \
+	journalListener.h \
+	defaultPropertiesProvider.h \
+	propertyValidator.h \
+	repoCommand.h \
 
 
 SOURCES += \
@@ -18,10 +18,13 @@ namespace qrRepo {
 		explicit RepoApi(QString const &workingDirectory);
 		// Default destructor ok.
 
+		RepoApi *snapshot() const;
+
 		QString name(qReal::Id const &id) const;
 		void setName(qReal::Id const &id, QString const &name);
 
 		qReal::IdList children(qReal::Id const &id) const;
+		qReal::IdList const &constChildren(qReal::Id const &id) const;
 		virtual void addChild(qReal::Id const &id, qReal::Id const &child);
 		virtual void addChild(qReal::Id const &id, qReal::Id const &child, qReal::Id const &logicalId);
 		void removeChild(qReal::Id const &id, qReal::Id const &child);
@@ -55,8 +58,11 @@ namespace qrRepo {
 		QVariant property(qReal::Id const &id, QString const &propertyName) const;
 		QString stringProperty(qReal::Id const &id, QString const &propertyName) const;
 		void setProperty(qReal::Id const &id, QString const &propertyName, QVariant const &value);
+		void setProperties(qReal::Id const &id, QMap<QString, QVariant> const &properties);
 		void removeProperty(qReal::Id const &id, QString const &propertyName);
 		bool hasProperty(qReal::Id const &id, QString const &propertyName) const;
+		QMapIterator<QString, QVariant> propertiesIterator(qReal::Id const &id) const;
+		QMap<QString, QVariant> const &constProperties(qReal::Id const &id) const;
 
 		qReal::IdList temporaryRemovedLinksAt(qReal::Id const &id, QString const &direction) const;
 		void setTemporaryRemovedLinks(qReal::Id const &id, qReal::IdList const &value, QString const &direction);
@@ -93,6 +99,13 @@ namespace qrRepo {
 
 		void open(QString const &workingDir);
 
+		void setAutosaveEnabled(bool enabled);
+		void checkpoint();
+		void flushJournal();
+		bool wasRecovered() const;
+		/// Bytes written to the journal since autosave was enabled, for profiling.
+		qint64 journalBytesWritten() const;
+
 		// "Глобальные" методы, позволяющие делать запросы к модели в целом.
 		//Returns all elements with .element() == type.element()
 		virtual qReal::IdList graphicalElements(qReal::Id const &type) const;
@@ -103,12 +116,27 @@ namespace qrRepo {
 		//Returns all elements with .element() == type
 		qReal::IdList elementsByType(QString const &type) const;
 		int elementsCount() const;
+		int loadedElementsCount() const;
 
 		bool exist(qReal::Id const &id) const;
 
+		void beginCommand(QString const &description);
+		void endCommand();
+
+		void setJournalListener(JournalListener *listener);
+		void setDefaultPropertiesProvider(DefaultPropertiesProvider const *provider);
+		void setPropertyValidator(PropertyValidator const *validator);
+		bool canUndo() const;
+		bool canRedo() const;
+		qReal::IdList undo(bool &structureChanged);
+		qReal::IdList redo(bool &structureChanged);
+		void beginInternalChanges();
+		void endInternalChanges();
+
 	private:
 		RepoApi(RepoApi const &other);  // Копировать нельзя.
 		RepoApi& operator =(RepoApi const &);  // Присваивать тоже.
+		explicit RepoApi(details::Client const &source);
 
 		void addToIdList(qReal::Id const &target, QString const &listName, qReal::Id const &data, QString const &direction = QString());
 		void removeFromList(qReal::Id const &target, QString const &listName, qReal::Id const &data, QString const &direction = QString());
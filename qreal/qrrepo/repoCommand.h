@@ -0,0 +1,29 @@
+#pragma once
+
+#include "commonRepoApi.h"
+
+namespace qrRepo {
+
+/// Groups all repository changes made during its lifetime into one undoable command.
+class RepoCommand
+{
+public:
+	RepoCommand(CommonRepoApi &api, QString const &description)
+		: mApi(api)
+	{
+		mApi.beginCommand(description);
+	}
+
+	~RepoCommand()
+	{
+		mApi.endCommand();
+	}
+
+private:
+	RepoCommand(RepoCommand const &);
+	RepoCommand &operator =(RepoCommand const &);
+
+	CommonRepoApi &mApi;
+};
+
+}
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "../qrgui/kernel/roles.h"
+#include "journalListener.h"
+#include "defaultPropertiesProvider.h"
+#include "propertyValidator.h"
 
 namespace qrRepo {
 
+class RepoApi;
+
 class RepoControlInterface
 {
 public:
@@ -16,6 +21,58 @@ public:
 	virtual void saveTo(QString const &workingDir) = 0;
 
 	virtual void open(QString const &workingDir) = 0;
+
+	/// While autosave is enabled, every finished command goes to a journal in the working dir,
+	/// written and synced to disk in background, and checkpoint() replaces the save with
+	/// a complete new one without blocking editing. A repository opened after a crash
+	/// restores changes from the journal, see wasRecovered().
+	/// Changes made outside of commands are not journaled as they are made: they go to the
+	/// journal with the next finished command, undo or redo, or on checkpoint() or flushJournal(),
+	/// so a crash before that loses them.
+	virtual void setAutosaveEnabled(bool enabled) = 0;
+	/// Journals changes made outside of commands and saves the repository in background
+	/// if it changed. A checkpoint that fails leaves the repository marked as changed.
+	virtual void checkpoint() = 0;
+	/// Blocks until changes made so far are on disk in the journal.
+	virtual void flushJournal() = 0;
+	/// True if the working dir had changes missing from its save and they were restored.
+	virtual bool wasRecovered() const = 0;
+
+	/// Saves are read lazily: a diagram is read from disk when it is accessed for the first time.
+	/// Returns how many elements are read so far, for profiling.
+	virtual int loadedElementsCount() const = 0;
+
+	/// Copy of the repository as it is now, for generators that run in worker threads while
+	/// the repository is being changed. Takes constant time: elements are shared until either
+	/// copy changes them, and elements not read from disk yet are read by the snapshot when it
+	/// needs them. Snapshot can be read from several threads at once, but can't be saved.
+	/// Caller owns it.
+	virtual RepoApi *snapshot() const = 0;
+
+	virtual void setJournalListener(JournalListener *listener) = 0;
+
+	/// Properties of logical elements equal to defaults of their types are not kept in memory
+	/// while a provider is set, but are written to saves and journal as before, so that
+	/// repositories without a provider read them. Provider is not owned by repository.
+	virtual void setDefaultPropertiesProvider(DefaultPropertiesProvider const *provider) = 0;
+
+	/// While a validator is set, writing a value it rejects to a property of a logical element
+	/// throws qReal::Exception and leaves the element unchanged. Validator is not owned by repository.
+	virtual void setPropertyValidator(PropertyValidator const *validator) = 0;
+	virtual bool canUndo() const = 0;
+	virtual bool canRedo() const = 0;
+
+	/// Reverts last command made with CommonRepoApi::beginCommand()/endCommand().
+	/// @param structureChanged Set to true if elements were created, removed or moved.
+	/// @returns Elements changed by the command.
+	virtual qReal::IdList undo(bool &structureChanged) = 0;
+	virtual qReal::IdList redo(bool &structureChanged) = 0;
+
+	/// Changes made outside of commands between these calls are not recorded and do not clear
+	/// the undo history, as any other change outside of a command does. Meant for updates that
+	/// follow undo or redo, calls may be nested.
+	virtual void beginInternalChanges() = 0;
+	virtual void endInternalChanges() = 0;
 };
 
 }
@@ -1,5 +1,109 @@
 #include "constraint.h"
+#include "value.h"
 
 using namespace qRealType;
 
+QRealConstraint::QRealConstraint(KIND kind)
+	: mKind(kind), mMin(0), mMax(0)
+{
+}
 
+QRealConstraint QRealConstraint::range(double min, double max)
+{
+	QRealConstraint result(RANGE);
+	result.mMin = min;
+	result.mMax = max;
+	return result;
+}
+
+QRealConstraint QRealConstraint::regExp(QString const &pattern)
+{
+	QRealConstraint result(REGEXP);
+	result.mRegExp = QRegExp(pattern);
+	return result;
+}
+
+QRealConstraint QRealConstraint::enumeration(QStringList const &values)
+{
+	QRealConstraint result(ENUMERATION);
+	result.mValues = values.toSet();
+	return result;
+}
+
+QRealConstraint QRealConstraint::reference(QStringList const &elementTypes)
+{
+	QRealConstraint result(REFERENCE);
+	result.mValues = elementTypes.toSet();
+	return result;
+}
+
+QRealConstraint::KIND QRealConstraint::kind() const
+{
+	return mKind;
+}
+
+bool QRealConstraint::check(QRealValue const &value) const
+{
+	switch (mKind)
+	{
+	case RANGE:
+		{
+			double const number = value.toReal();
+			return number >= mMin && number <= mMax;
+		}
+	case REGEXP:
+		return mRegExp.exactMatch(value.toString());
+	case ENUMERATION:
+		return mValues.contains(value.toString());
+	case REFERENCE:
+		return checkReference(value.toString());
+	}
+	return false;
+}
+
+bool QRealConstraint::checkReference(QString const &value) const
+{
+	// Property editor stores a list of references as "id$$id$$"
+	int begin = 0;
+	while (begin < value.size()) {
+		int end = value.indexOf("$$", begin);
+		if (end < 0)
+			end = value.size();
+		if (!checkReferenceId(value, begin, end))
+			return false;
+		begin = end + 2;
+	}
+	return true;
+}
+
+bool QRealConstraint::checkReferenceId(QString const &value, int begin, int end) const
+{
+	// qrm:/editor/diagram/element/id
+	if (value.midRef(begin, 5) != QLatin1String("qrm:/"))
+		return false;
+	int const diagramBegin = value.indexOf('/', begin + 5) + 1;
+	int const elementBegin = diagramBegin > 0 ? value.indexOf('/', diagramBegin) + 1 : 0;
+	int const elementEnd = elementBegin > 0 ? value.indexOf('/', elementBegin) : -1;
+	if (elementEnd < 0 || elementEnd >= end)
+		return false;
+
+	return mValues.isEmpty()
+			|| mValues.contains(value.mid(elementBegin, elementEnd - elementBegin));
+}
+
+QString QRealConstraint::toString() const
+{
+	switch (mKind)
+	{
+	case RANGE:
+		return QString("in range [%1, %2]").arg(mMin).arg(mMax);
+	case REGEXP:
+		return QString("matching \"%1\"").arg(mRegExp.pattern());
+	case ENUMERATION:
+		return QString("one of %1").arg(QStringList(mValues.toList()).join(", "));
+	case REFERENCE:
+		return mValues.isEmpty() ? QString("a reference")
+				: QString("a reference to %1").arg(QStringList(mValues.toList()).join(", "));
+	}
+	return QString();
+}
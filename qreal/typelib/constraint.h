@@ -1,12 +1,50 @@
 #pragma once
 
 #include <QList>
+#include <QRegExp>
+#include <QSet>
+#include <QStringList>
 
 namespace qRealType {
+	class QRealValue;
+
+	// Restriction of values of a type. Everything a check needs (regular expression,
+	// set of values) is prepared when the constraint is created, so it is cheap to check
+	// many values against it.
 	class QRealConstraint {
 	public:
-		QRealConstraint(){}
-		~QRealConstraint(){}
+		enum KIND {
+			RANGE,
+			REGEXP,
+			ENUMERATION,
+			REFERENCE,
+		};
+
+		// Numeric value in [min, max]
+		static QRealConstraint range(double min, double max);
+		// Whole string value matches the pattern
+		static QRealConstraint regExp(QString const &pattern);
+		// String value is one of the listed ones
+		static QRealConstraint enumeration(QStringList const &values);
+		// String value is a (possibly empty) "$$"-separated list of ids of elements
+		// ("qrm:/editor/diagram/element/id") of the listed types, any type if the list is empty
+		static QRealConstraint reference(QStringList const &elementTypes);
+
+		KIND kind() const;
+		bool check(QRealValue const &value) const;
+		// Description for error messages
+		QString toString() const;
+
+	private:
+		QRealConstraint(KIND kind);
+		bool checkReference(QString const &value) const;
+		bool checkReferenceId(QString const &value, int begin, int end) const;
+
+		KIND mKind;
+		double mMin;
+		double mMax;
+		QRegExp mRegExp;
+		QSet<QString> mValues;
 	};
 
 	typedef QList<QRealConstraint> QConstraintList;
@@ -124,5 +124,47 @@ int main()
 
 	delete testvar;
 
+	// Constraints
+	qDebug() << "Testing constraints";
+	QRealType *percent = QRealTypeFactory::getTypeByName("integer")->restricted(
+			QConstraintList() << QRealConstraint::range(0, 100));
+	QString error;
+	qDebug() << percent->checkString("42");
+	qDebug() << percent->checkString("142", &error) << error;
+	qDebug() << percent->checkString("forty two", &error) << error;
+	delete percent;
+
+	QRealType *identifier = QRealTypeFactory::getTypeByName("string")->restricted(
+			QConstraintList() << QRealConstraint::regExp("[A-Za-z_][A-Za-z0-9_]*"));
+	qDebug() << identifier->checkString("mCount");
+	qDebug() << identifier->checkString("2count", &error) << error;
+	delete identifier;
+
+	QRealType *visibility = QRealTypeFactory::getTypeByName("string")->restricted(
+			QConstraintList() << QRealConstraint::enumeration(QStringList() << "public" << "private"));
+	qDebug() << visibility->checkString("public");
+	qDebug() << visibility->checkString("friendly", &error) << error;
+	delete visibility;
+
+	QRealType *classReference = QRealTypeFactory::getTypeByName("string")->restricted(
+			QConstraintList() << QRealConstraint::reference(QStringList() << "Class"));
+	qDebug() << classReference->checkString("");
+	qDebug() << classReference->checkString("qrm:/Kernel/KernelDiagram/Class/{1}");
+	qDebug() << classReference->checkString("qrm:/Kernel/KernelDiagram/Field/{2}", &error) << error;
+	qDebug() << classReference->checkString("qrm:/Kernel/KernelDiagram/Class/{1}$$qrm:/Kernel/KernelDiagram/Class/{3}$$");
+	qDebug() << classReference->checkString("Class", &error) << error;
+	delete classReference;
+
+	// Default value of a new type must satisfy its constraints
+	QRealValue *zero = QRealTypeFactory::getTypeByName("integer")->newValue();
+	try {
+		QRealTypeFactory::newSubType("positive", QConstraintList() << QRealConstraint::range(1, 1e9)
+				, zero, QRealTypeFactory::getTypeByName("integer"));
+		qDebug() << "Default value violating constraints is accepted";
+	} catch (char const *message) {
+		qDebug() << message;
+	}
+	delete zero;
+
 	return 0;
 }
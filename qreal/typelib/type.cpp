@@ -22,11 +22,11 @@ namespace qRealType {
 			mName = "boolean";
 			break;
 		case STRING:
-			mDefaultValue->mValue.stringVal = new QString();
 			mDefaultValue->fromString("");
 			mName = "string";
 			break;
 		case ENUM:
+			delete mDefaultValue;
 			mDefaultValue = NULL;
 			mName = "enum";
 			break;
@@ -46,6 +46,16 @@ namespace qRealType {
 		return mName;
 	}
 
+	QREAL_METATYPE QRealType::metaType() const
+	{
+		return mType;
+	}
+
+	QConstraintList const &QRealType::constraints() const
+	{
+		return mConstraints;
+	}
+
 	QRealValue* QRealType::newValue()
 	{
 		if (!mDefaultValue)
@@ -59,7 +69,12 @@ namespace qRealType {
 		result->mConstraints = mConstraints;
 		result->mName = mName;
 		delete result->mDefaultValue;
-		result->mDefaultValue = mDefaultValue->clone();
+		result->mDefaultValue = NULL;
+		if (mDefaultValue)
+		{
+			result->mDefaultValue = mDefaultValue->clone();
+			result->mDefaultValue->mType = result;
+		}
 		return result;
 	}
 
@@ -68,14 +83,69 @@ namespace qRealType {
 		return QRealTypeFactory::newSubType(name, constr, def?def:mDefaultValue, this);
 	}
 
-	QString QRealType::toStringValue(QRealValue const *var)
+	QRealType* QRealType::restricted(QConstraintList const &constr) const
+	{
+		QRealType *result = clone();
+		result->mConstraints << constr;
+		return result;
+	}
+
+	bool QRealType::check(QRealValue const &value, QString *error) const
+	{
+		for (int i = 0; i < mConstraints.size(); ++i)
+		{
+			QRealConstraint const &constraint = mConstraints.at(i);
+			if (!constraint.check(value))
+			{
+				if (error)
+					*error = QString("\"%1\" is not %2").arg(value.toString(), constraint.toString());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool QRealType::checkString(QString const &text, QString *error) const
+	{
+		QRealValue value(this);
+		bool ok = true;
+		switch (mType)
+		{
+		case INTEGER:
+			value.mValue.integerVal = text.toInt(&ok);
+			break;
+		case REAL:
+			value.mValue.realVal = text.toDouble(&ok);
+			break;
+		case BOOLEAN:
+			ok = text == "true" || text == "false";
+			value.mValue.booleanVal = text == "true";
+			break;
+		case STRING:
+			value.mStringValue = text;
+			break;
+		default:
+			ok = false;
+			break;
+		}
+
+		if (!ok)
+		{
+			if (error)
+				*error = QString("\"%1\" is not a value of type %2").arg(text, mName);
+			return false;
+		}
+		return check(value, error);
+	}
+
+	QString QRealType::toStringValue(QRealValue const *var) const
 	{
 		if (mType == INTEGER)
 			return QString().setNum(var->mValue.integerVal);
 		if (mType == REAL)
 			return QString().setNum(var->mValue.realVal);
 		if (mType == STRING)
-			return *(var->mValue.stringVal);
+			return var->mStringValue;
 		if (mType == BOOLEAN)
 		{
 			if (var->mValue.booleanVal)
@@ -88,14 +158,14 @@ namespace qRealType {
 		return QString();
 	}
 
-	void QRealType::fromStringValue(QRealValue *var, QString const &val)
+	void QRealType::fromStringValue(QRealValue *var, QString const &val) const
 	{
 		if (mType == INTEGER)
 			var->mValue.integerVal = val.toInt();
 		else if (mType == REAL)
 			var->mValue.realVal = val.toDouble();
 		else if (mType == STRING)
-			*(var->mValue.stringVal) = val;
+			var->mStringValue = val;
 		else if (mType == BOOLEAN)
 		{
 			if (val == "true")
@@ -109,14 +179,14 @@ namespace qRealType {
 			Q_ASSERT(0);
 	}
 
-	int QRealType::toIntegerValue(QRealValue const *var)
+	int QRealType::toIntegerValue(QRealValue const *var) const
 	{
 		if (mType == INTEGER)
 			return var->mValue.integerVal;
 		if (mType == REAL)
 			return (int)(var->mValue.realVal);
 		if (mType == STRING)
-			return var->mValue.stringVal->toInt();
+			return var->mStringValue.toInt();
 		if (mType == BOOLEAN)
 		{
 			if (var->mValue.booleanVal)
@@ -129,21 +199,21 @@ namespace qRealType {
 		return 0;
 	}
 
-	void QRealType::fromIntegerValue(QRealValue *var, int val)
+	void QRealType::fromIntegerValue(QRealValue *var, int val) const
 	{
 		if (mType == INTEGER)
 			var->mValue.integerVal = val;
 		else if (mType == REAL)
 			var->mValue.realVal = val;
 		else if (mType == STRING)
-			var->mValue.stringVal->setNum(val);
+			var->mStringValue.setNum(val);
 		else if (mType == BOOLEAN)
 			var->mValue.booleanVal = (val != 0);
 		else
 			Q_ASSERT(0);
 	}
 
-	bool QRealType::toBooleanValue(QRealValue const *var)
+	bool QRealType::toBooleanValue(QRealValue const *var) const
 	{
 		if (mType == INTEGER)
 			return var->mValue.integerVal != 0;
@@ -151,9 +221,9 @@ namespace qRealType {
 			throw "Bad cast";
 		if (mType == STRING)
 		{
-			if (*(var->mValue.stringVal) == "true")
+			if (var->mStringValue == "true")
 				return true;
-			else if (*(var->mValue.stringVal) == "false")
+			else if (var->mStringValue == "false")
 				return false;
 			else
 				throw "Bad cast";
@@ -165,28 +235,28 @@ namespace qRealType {
 		return false;
 	}
 
-	void QRealType::fromBooleanValue(QRealValue *var, bool val)
+	void QRealType::fromBooleanValue(QRealValue *var, bool val) const
 	{
 		if (mType == INTEGER)
 			var->mValue.integerVal = val?1:0;
 		else if (mType == REAL)
 			throw "Bad cast";
 		else if (mType == STRING)
-			*(var->mValue.stringVal) = val?"true":"false";
+			var->mStringValue = val?"true":"false";
 		else if (mType == BOOLEAN)
 			var->mValue.booleanVal = val;
 		else
 			Q_ASSERT(0);
 	}
 
-	double QRealType::toRealValue(QRealValue const *var)
+	double QRealType::toRealValue(QRealValue const *var) const
 	{
 		if (mType == INTEGER)
 			return (double)(var->mValue.integerVal);
 		if (mType == REAL)
 			return var->mValue.realVal;
 		if (mType == STRING)
-			return var->mValue.stringVal->toDouble();
+			return var->mStringValue.toDouble();
 		if (mType == BOOLEAN)
 			throw "Bad cast";
 		Q_ASSERT(0);
@@ -194,14 +264,14 @@ namespace qRealType {
 		return 0;
 	}
 
-	void QRealType::fromRealValue(QRealValue *var, double val)
+	void QRealType::fromRealValue(QRealValue *var, double val) const
 	{
 		if (mType == INTEGER)
 			var->mValue.integerVal = (int)val;
 		else if (mType == REAL)
 			var->mValue.realVal = val;
 		else if (mType == STRING)
-			var->mValue.stringVal->setNum(val);
+			var->mStringValue.setNum(val);
 		else if (mType == BOOLEAN)
 			throw "Bad cast";
 		else
@@ -28,20 +28,31 @@ namespace qRealType {
 		~QRealType();
 
 		QString toString() const;
+		QREAL_METATYPE metaType() const;
+		QConstraintList const &constraints() const;
 		QRealValue* newValue();
 
 		QRealType *clone() const;
 		QRealType* newSubType(QString const &name, QConstraintList const &constr, QRealValue const *def = NULL);
+		// Anonymous subtype that is not registered in the factory and is owned by the caller,
+		// e.g. the type of a property of a metamodel element
+		QRealType* restricted(QConstraintList const &constr) const;
+
+		// Checks the value against all constraints of the type
+		bool check(QRealValue const &value, QString *error = NULL) const;
+		// Checks that the text is a value of the type and satisfies its constraints,
+		// without allocating a value
+		bool checkString(QString const &text, QString *error = NULL) const;
 
 		// Used by QRealValue class only
-		QString toStringValue(QRealValue const *var);
-		void fromStringValue(QRealValue *var, QString const &val);
-		int toIntegerValue(QRealValue const *var);
-		void fromIntegerValue(QRealValue *var, int val);
-		bool toBooleanValue(QRealValue const *var);
-		void fromBooleanValue(QRealValue *var, bool val);
-		double toRealValue(QRealValue const *var);
-		void fromRealValue(QRealValue *var, double val);
+		QString toStringValue(QRealValue const *var) const;
+		void fromStringValue(QRealValue *var, QString const &val) const;
+		int toIntegerValue(QRealValue const *var) const;
+		void fromIntegerValue(QRealValue *var, int val) const;
+		bool toBooleanValue(QRealValue const *var) const;
+		void fromBooleanValue(QRealValue *var, bool val) const;
+		double toRealValue(QRealValue const *var) const;
+		void fromRealValue(QRealValue *var, double val) const;
 
 		friend class QRealTypeFactory;
 	};
@@ -18,11 +18,13 @@ QRealTypeFactory::QRealTypeFactory()
 
 void QRealTypeFactory::init()
 {
-	gInstance = new QRealTypeFactory();
+	if (!gInstance)
+		gInstance = new QRealTypeFactory();
 }
 
 QRealType* QRealTypeFactory::getTypeByName(QString const &name)
 {
+	init();
 	return gInstance->getTypeByName_(name);
 }
 
@@ -35,6 +37,7 @@ QRealType* QRealTypeFactory::getTypeByName_(QString const &name) const
 
 QRealType* QRealTypeFactory::newSubType(QString const &name, QConstraintList const &constr, QRealValue const *def, QRealType *type)
 {
+	init();
 	return gInstance->newSubType_(name, constr, def, type);
 }
 
@@ -44,9 +47,13 @@ QRealType* QRealTypeFactory::newSubType_(QString const &name, QConstraintList co
 		throw "Type already exists";
 	QRealType *newtype = type->clone();
 	newtype->mConstraints << constr;
-	// TODO: Check default value against new constraints
 	delete newtype->mDefaultValue;
 	newtype->mDefaultValue = def->clone();
+	newtype->mDefaultValue->mType = newtype;
+	if (!newtype->check(*newtype->mDefaultValue)) {
+		delete newtype;
+		throw "Default value violates constraints";
+	}
 	mTypes[name] = newtype;
 	return newtype;
 }
@@ -1,6 +1,7 @@
 TEMPLATE = lib
 OBJECTS_DIR = .obj
 TARGET = typelib
+CONFIG += staticlib
 
 HEADERS += \
     type.h \
@@ -3,17 +3,21 @@
 
 using namespace qRealType;
 
-QRealValue::QRealValue(QRealType *type)
+QRealValue::QRealValue(QRealType const *type)
 {
 	mType = type;
+	mValue.realVal = 0;
 	// other fields will be initialized by qRealType::newValue()
 }
 
 QRealValue* QRealValue::clone() const
 {
-	QRealValue *result = new QRealValue(mType);
-	result->mValue = mValue;
-	return result;
+	return new QRealValue(*this);
+}
+
+QRealType const *QRealValue::type() const
+{
+	return mType;
 }
 
 QString QRealValue::toString() const
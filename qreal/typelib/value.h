@@ -4,22 +4,26 @@
 
 namespace qRealType {
 	class QRealType;
+	class QRealTypeFactory;
 
+	// Values are small and copyable, so they are kept by value. Strings are stored
+	// as implicitly shared QString, copying a value doesn't copy its text.
 	class QRealValue {
 		union QRealValueUnion {
 			int integerVal;
 			double realVal;
-			QString *stringVal;
 			bool booleanVal;
 		};
-		QRealType *mType;
+		QRealType const *mType;
 		QRealValueUnion mValue;
-		QRealValue(QRealType *type);
+		QString mStringValue;
+		QRealValue(QRealType const *type);
 
 	public:
 		~QRealValue(){};
 
 		QRealValue* clone() const;
+		QRealType const *type() const;
 
 		// Handy proxies
 		QString toString() const;
@@ -32,5 +36,6 @@ namespace qRealType {
 		void fromReal(double val);
 
 		friend class QRealType;
+		friend class QRealTypeFactory;
 	};
 };
@@ -15,29 +15,34 @@ OutFile::OutFile(QString const &fileName)
 
 OutFile::~OutFile()
 {
+	mOut.flush();
 	mFile.close();
 }
 
 QTextStream& OutFile::operator()()
 {
-	mOut << indent();
+	mOut << mIndentString;
+	return mOut;
+}
+
+QTextStream& OutFile::stream()
+{
 	return mOut;
 }
 
 void OutFile::incIndent()
 {
 	++mIndent;
+	mIndentString.fill('\t', qMax(mIndent, 0));
 }
 
 void OutFile::decIndent()
 {
 	--mIndent;
+	mIndentString.fill('\t', qMax(mIndent, 0));
 }
 
-QString OutFile::indent() const
+QString const &OutFile::indent() const
 {
-	QString result;
-	for (int i = 0; i < mIndent; ++i)
-		result += "\t";
-	return result;
+	return mIndentString;
 }
@@ -10,16 +10,19 @@ namespace utils {
 	public:
 		explicit OutFile(QString const &fileName);
 		~OutFile();
+		/// Starts a new line: writes current indentation and returns the stream.
 		QTextStream& operator()();
+		/// Continues current line, without indentation.
+		QTextStream& stream();
 
 		void incIndent();
 		void decIndent();
+		QString const &indent() const;
 	private:
-		QString indent() const;
-
 		QTextStream mOut;
 		QFile mFile;
 		int mIndent;
+		QString mIndentString;
 	};
 
 }
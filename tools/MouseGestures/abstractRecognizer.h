@@ -13,6 +13,7 @@
 class GesturesManager
 {
 public:
+    virtual ~GesturesManager() {}
     virtual void initIdealGestures(QMap<QString, PathVector> const & objects) = 0;
     virtual void setKey(const PathVector & path) = 0;
     virtual double getMaxDistance(QString const & object) = 0;
@@ -24,7 +25,7 @@ template <typename TKey>
         class GesturesRecognizer : public GesturesManager
 {
 public:
-    GesturesRecognizer(){}
+    GesturesRecognizer() : mHasKey(false) {}
 
     double getDistance(QString const & item)
     {
@@ -45,15 +46,21 @@ public:
 
     void setKey(PathVector const & path)
     {
+        if (mHasKey)
+            releaseKey(mKey);
         mKey = getKey(path);
+        mHasKey = true;
     }
 
     virtual double getMaxDistance(QString const & object) = 0;
 
 protected:
     TKey mKey;
+    bool mHasKey;
     virtual double getDistance(TKey const & key1, TKey const & key2) = 0;
     virtual TKey getKey(PathVector const & path) = 0;
+    // Frees the key of the previous gesture if keys own memory
+    virtual void releaseKey(TKey const &) {}
     QMap<QString, TKey> mGestures;
     //maybe to do several lists for multistroke gestures
 };
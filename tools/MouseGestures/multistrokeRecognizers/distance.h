@@ -1,6 +1,7 @@
 #pragma once
 #include "GeometricForms.h"
 #include "cmath"
+#include <QVector>
 
 class Distance
 {
@@ -13,28 +14,27 @@ public:
             return n;
         if (n == 0)
             return m;
-        double matrix[m + 1][n + 1];
-        for (int i = 0; i <= m; i++)
-        {
-            for (int j = 0; j <= n; j++)
-            {
-                if (i == 0 || j ==0 )
-                    matrix[i][j] = std::max(i, j);
-            }
-        }
+        // Only two rows of the matrix are kept: a stack matrix of m * n doubles
+        // overflows the stack on long keys and is not standard C++
+        QVector<double> previous(n + 1);
+        QVector<double> current(n + 1);
+        for (int j = 0; j <= n; j++)
+            previous[j] = j;
         for (int i = 1; i <= m; ++i)
         {
+            current[0] = i;
             for(int j = 1; j <= n; ++j)
             {
                 double dist = norm(key1[i - 1], key2[j - 1]);
-                int aboveCell = matrix[i - 1][j];
-                int leftCell = matrix[i][j - 1];
-                int diagonalCell = matrix[i - 1][j - 1];
-                matrix[i][j] = std::min((double) std::min(aboveCell + 3, leftCell + 3),
-                                        diagonalCell + dist);
+                int aboveCell = previous[j];
+                int leftCell = current[j - 1];
+                int diagonalCell = previous[j - 1];
+                current[j] = std::min((double) std::min(aboveCell + 3, leftCell + 3),
+                                      diagonalCell + dist);
             }
+            qSwap(previous, current);
         }
-        return (double) (matrix[m][n] * (abs(m - n) + 1)) / std::min(n, m);
+        return (double) (previous[n] * (abs(m - n) + 1)) / std::min(n, m);
     }
     static double getOneSizeDistance(const Key & currentKey1, const Key & currentKey2)
     {
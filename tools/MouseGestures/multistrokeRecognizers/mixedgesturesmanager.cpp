@@ -22,16 +22,26 @@ bool MixedGesturesManager::isMultistroke()
 double MixedGesturesManager::getDistance(QPair<double *,double *> const & key1,
                                          QPair<double *, double *> const & key2)
 {
-    double dist1 = (new RectangleGesturesManager())->getDistance(key1.first, key2.first);
-    double dist2 = (new NearestPosGridGesturesManager)->getDistance(key1.second, key2.second);
+    RectangleGesturesManager rectangleManager;
+    NearestPosGridGesturesManager nearestPosManager;
+    double dist1 = rectangleManager.getDistance(key1.first, key2.first);
+    double dist2 = nearestPosManager.getDistance(key1.second, key2.second);
     return dist1 * weight1 + dist2 * weight2;
 }
 
 QPair<double *, double *> MixedGesturesManager::getKey(PathVector const & path)
 {
-    double * key1 = (new RectangleGesturesManager())->getKey(path);
-    double * key2 = (new NearestPosGridGesturesManager)->getKey(path);
+    RectangleGesturesManager rectangleManager;
+    NearestPosGridGesturesManager nearestPosManager;
+    double * key1 = rectangleManager.getKey(path);
+    double * key2 = nearestPosManager.getKey(path);
     return QPair<double *, double *>(key1, key2);
 }
 
+void MixedGesturesManager::releaseKey(QPair<double *, double *> const & key)
+{
+    delete[] key.first;
+    delete[] key.second;
+}
+
 
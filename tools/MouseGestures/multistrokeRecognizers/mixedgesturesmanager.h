@@ -10,6 +10,9 @@ public:
     bool isMultistroke();
     double getDistance(QPair<double *, double *> const & key1, QPair<double *, double *> const & key2);
     QPair<double *, double *> getKey(PathVector const & path);
+
+protected:
+    void releaseKey(QPair<double *, double *> const & key);
 };
 
 class MixedClassifier
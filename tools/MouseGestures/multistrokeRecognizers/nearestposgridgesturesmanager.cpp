@@ -53,4 +53,7 @@ double * NearestPosGridGesturesManager::getKey(PathVector const & path)
     return finalKey;
 }
 
-
+void NearestPosGridGesturesManager::releaseKey(double * const & key)
+{
+    delete[] key;
+}
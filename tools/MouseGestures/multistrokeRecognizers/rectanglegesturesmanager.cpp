@@ -50,4 +50,7 @@ double * RectangleGesturesManager::getKey(PathVector const & path)
     return finalKey;
 }
 
-
+void RectangleGesturesManager::releaseKey(double * const & key)
+{
+    delete[] key;
+}
@@ -10,4 +10,7 @@ public:
     bool isMultistroke();
     double getDistance(double * const & key1, double * const & key2);
     double * getKey(PathVector const & path);
+
+protected:
+    void releaseKey(double * const & key);
 };
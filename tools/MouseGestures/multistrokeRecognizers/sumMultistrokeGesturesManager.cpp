@@ -52,4 +52,7 @@ double * SumGesturesManager::getKey(PathVector const & path)
     return finalKey;
 }
 
-
+void SumGesturesManager::releaseKey(double * const & key)
+{
+    delete[] key;
+}
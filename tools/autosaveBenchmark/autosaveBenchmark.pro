@@ -0,0 +1,18 @@
+# Latency of edits of a large qrrepo model saved periodically: without saves, with a synchronous
+# saveAll() every SAVE_EVERY edits, and with autosave, where edits go to the journal and
+# checkpoints are written in background.
+# Usage: autosaveBenchmark [ELEMENTS=100000] [EDITS=2000] [SAVE_EVERY=500]
+
+QT += xml
+QT -= gui
+
+TARGET = autosaveBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+SOURCES += main.cpp
+
+LIBS += -L../../qreal/qrgui -lqrrepo
@@ -0,0 +1,113 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+#include "../../qreal/qrrepo/repoApi.h"
+
+// Edits are commands renaming an element, as made by the property editor. Every edit is
+// timed separately: a save that blocks the editor shows up in the tail of latencies.
+
+using namespace qReal;
+
+namespace {
+
+enum SaveMode {
+	noSaves
+	, synchronousSaves
+	, autosave
+};
+
+IdList createModel(qrRepo::RepoApi &repo, int elementsCount)
+{
+	int const diagramsCount = qMax(1, elementsCount / 1000);
+	IdList elements;
+	for (int i = 0; i < diagramsCount; ++i) {
+		Id const diagram = Id::createElementId("BenchmarkEditor", "BenchmarkDiagram", "BenchmarkDiagramNode");
+		repo.addChild(Id::rootId(), diagram);
+		repo.setName(diagram, "Diagram" + QString::number(i));
+		for (int j = 0; j < elementsCount / diagramsCount; ++j) {
+			Id const element = Id::createElementId("BenchmarkEditor", "BenchmarkDiagram", "BenchmarkNode");
+			repo.addChild(diagram, element);
+			repo.setName(element, "Node" + QString::number(j));
+			elements << element;
+		}
+	}
+	return elements;
+}
+
+void measure(QTextStream &out, QString const &name, qrRepo::RepoApi &repo, IdList const &elements
+		, int edits, int saveEvery, SaveMode mode)
+{
+	repo.setAutosaveEnabled(mode == autosave);
+	QVector<qint64> latencies(edits);
+	qint64 longestSave = 0;
+	QElapsedTimer total;
+	total.start();
+	for (int i = 0; i < edits; ++i) {
+		Id const &element = elements.at((i * 7919) % elements.size());
+		QElapsedTimer timer;
+		timer.start();
+		repo.beginCommand("rename");
+		repo.setName(element, name + QString::number(i));
+		repo.endCommand();
+		if ((i + 1) % saveEvery == 0) {
+			QElapsedTimer saveTimer;
+			saveTimer.start();
+			if (mode == synchronousSaves)
+				repo.saveAll();
+			else if (mode == autosave)
+				repo.checkpoint();
+			longestSave = qMax(longestSave, saveTimer.nsecsElapsed());
+		}
+		latencies[i] = timer.nsecsElapsed();
+	}
+	qint64 const editingTime = total.nsecsElapsed();
+	// Last checkpoint and the journal are on disk before the next mode starts
+	repo.flushJournal();
+	qint64 const journalBytes = repo.journalBytesWritten();
+	repo.setAutosaveEnabled(false);
+
+	qSort(latencies);
+	out << name << ": edit latency p50 " << latencies[edits / 2] / 1000
+			<< " us, p99 " << latencies[edits * 99 / 100] / 1000
+			<< " us, max " << latencies.last() / 1000
+			<< " us; editor blocked by saves up to " << longestSave / 1000000
+			<< " ms; " << edits * 1000000000LL / qMax(Q_INT64_C(1), editingTime) << " edits/s";
+	if (mode == autosave)
+		out << "; " << journalBytes / qMax(1, edits) << " journal bytes per edit";
+	out << "\n";
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	int const elementsCount = arguments.size() > 1 ? arguments[1].toInt() : 100000;
+	int const edits = arguments.size() > 2 ? qMax(1, arguments[2].toInt()) : 2000;
+	int const saveEvery = arguments.size() > 3 ? qMax(1, arguments[3].toInt()) : 500;
+
+	QString const saveDir = QDir::temp().absoluteFilePath("qrealAutosaveBenchmark");
+	{
+		qrRepo::RepoApi repo(saveDir);
+		repo.exterminate();
+		IdList const elements = createModel(repo, elementsCount);
+
+		QElapsedTimer timer;
+		timer.start();
+		repo.saveAll();
+		out << repo.elementsCount() << " elements, full save takes " << timer.elapsed() << " ms\n";
+
+		measure(out, "no saves", repo, elements, edits, saveEvery, noSaves);
+		measure(out, "saveAll", repo, elements, edits, saveEvery, synchronousSaves);
+		measure(out, "autosave", repo, elements, edits, saveEvery, autosave);
+
+		repo.exterminate();
+	}
+	return 0;
+}
@@ -0,0 +1,30 @@
+# Throughput of the XMI and Java generators on a synthetic class model.
+# Usage: generatorsBenchmark [CLASSES=20000] [FIELDS=5] [METHODS=3]
+# Generated files go to the temporary directory and are removed afterwards.
+
+QT += xml
+QT -= gui
+
+TARGET = generatorsBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+QRGUI = ../../qreal/qrgui
+
+HEADERS += \
+	$$QRGUI/generators/xmi/xmiHandler.h \
+	$$QRGUI/generators/java/javaHandler.h \
+	$$QRGUI/generators/java/controlFlowGraph.h \
+	$$QRGUI/../utils/outFile.h \
+
+SOURCES += \
+	main.cpp \
+	$$QRGUI/generators/xmi/xmiHandler.cpp \
+	$$QRGUI/generators/java/javaHandler.cpp \
+	$$QRGUI/generators/java/controlFlowGraph.cpp \
+	$$QRGUI/../utils/outFile.cpp \
+
+LIBS += -L../../qreal/qrgui -lqrrepo
@@ -0,0 +1,124 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+
+#include "../../qreal/qrrepo/repoApi.h"
+#include "../../qreal/qrgui/generators/xmi/xmiHandler.h"
+#include "../../qreal/qrgui/generators/java/javaHandler.h"
+
+// Builds one class diagram with the given number of classes, each holding fields and
+// methods, and runs the XMI export and the Java generator over it.
+
+using namespace qReal;
+
+namespace {
+
+Id const diagramType("Editor", "ClassDiagram", "ClassDiagram_ClassDiagramNode");
+Id const classType("Editor", "ClassDiagram", "ClassDiagram_Class");
+Id const fieldType("Editor", "ClassDiagram", "ClassDiagram_ClassField");
+Id const methodType("Editor", "ClassDiagram", "ClassDiagram_ClassMethod");
+
+Id addElement(qrRepo::RepoApi &repo, Id const &parent, Id const &type, QString const &name)
+{
+	Id const id = Id::createElementId(type.editor(), type.diagram(), type.element());
+	repo.addChild(parent, id);
+	repo.setName(id, name);
+	// Repository has no defaults provider here, so link properties are written explicitly
+	repo.setProperty(id, "from", Id::rootId().toVariant());
+	repo.setProperty(id, "to", Id::rootId().toVariant());
+	repo.setProperty(id, "links", IdListHelper::toVariant(IdList()));
+	repo.setProperty(id, "outgoingConnections", IdListHelper::toVariant(IdList()));
+	repo.setProperty(id, "incomingConnections", IdListHelper::toVariant(IdList()));
+	repo.setProperty(id, "outgoingUsages", IdListHelper::toVariant(IdList()));
+	repo.setProperty(id, "incomingUsages", IdListHelper::toVariant(IdList()));
+	return id;
+}
+
+void buildModel(qrRepo::RepoApi &repo, int classesCount, int fieldsCount, int methodsCount)
+{
+	Id const diagram = addElement(repo, Id::rootId(), diagramType, "benchmark");
+	for (int i = 0; i < classesCount; ++i) {
+		Id const classId = addElement(repo, diagram, classType, "Class" + QString::number(i));
+		repo.setProperty(classId, "visibility", "public");
+		for (int j = 0; j < fieldsCount; ++j) {
+			Id const field = addElement(repo, classId, fieldType, "field" + QString::number(j));
+			repo.setProperty(field, "visibility", "private");
+			repo.setProperty(field, "type", "int");
+			repo.setProperty(field, "defaultValue", QString::number(j));
+		}
+		for (int j = 0; j < methodsCount; ++j) {
+			Id const method = addElement(repo, classId, methodType, "method" + QString::number(j));
+			repo.setProperty(method, "visibility", "public");
+			repo.setProperty(method, "type", "void");
+			repo.setProperty(method, "operationFactors", "int value");
+		}
+	}
+}
+
+qint64 outputSize(QString const &path)
+{
+	QFileInfo const info(path);
+	if (info.isFile())
+		return info.size();
+	qint64 result = 0;
+	QDirIterator iterator(path, QDir::Files, QDirIterator::Subdirectories);
+	while (iterator.hasNext()) {
+		iterator.next();
+		result += iterator.fileInfo().size();
+	}
+	return result;
+}
+
+void report(QTextStream &out, QString const &name, int classesCount, int elapsed, qint64 size)
+{
+	out << name << ": " << elapsed << " ms, "
+			<< (elapsed ? qint64(classesCount) * 1000 / elapsed : 0) << " classes/s, "
+			<< size / 1024 << " KB written\n";
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	int const classesCount = arguments.size() > 1 ? arguments[1].toInt() : 20000;
+	int const fieldsCount = arguments.size() > 2 ? arguments[2].toInt() : 5;
+	int const methodsCount = arguments.size() > 3 ? arguments[3].toInt() : 3;
+
+	QDir const temp = QDir::temp();
+	QString const repoDir = temp.absoluteFilePath("qrealGeneratorsBenchmarkRepo");
+	QString const xmiFile = temp.absoluteFilePath("qrealGeneratorsBenchmark.xmi");
+	QString const javaDir = temp.absoluteFilePath("qrealGeneratorsBenchmarkJava");
+	temp.mkpath(javaDir);
+
+	qrRepo::RepoApi repo(repoDir);
+	repo.exterminate();
+	buildModel(repo, classesCount, fieldsCount, methodsCount);
+	out << classesCount << " classes, " << fieldsCount << " fields and "
+			<< methodsCount << " methods each\n";
+
+	QTime timer;
+	timer.start();
+	generators::XmiHandler xmi(repo);
+	xmi.exportToXmi(xmiFile);
+	report(out, "xmi", classesCount, timer.elapsed(), outputSize(xmiFile));
+
+	timer.restart();
+	generators::JavaHandler java(repo);
+	java.generateToJava(javaDir);
+	report(out, "java", classesCount, timer.elapsed(), outputSize(javaDir));
+
+	QFile::remove(xmiFile);
+	QDirIterator iterator(javaDir, QDir::Files);
+	while (iterator.hasNext())
+		QFile::remove(iterator.next());
+	temp.rmdir(javaDir);
+	repo.exterminate();
+	return 0;
+}
@@ -0,0 +1,399 @@
+#include "evaluation.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtCore/QRunnable>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <QtXml/QDomDocument>
+
+#include <algorithm>
+
+namespace {
+
+QString const comma = ", ";
+QString const pointDelimeter = " : ";
+QString const strokeDelimeter = " | ";
+QString const rejected = "<rejected>";
+
+struct Sample
+{
+	QString object;
+	StrokesList gesture;
+};
+
+struct Corpus
+{
+	QList<QPair<QString, StrokesList> > idealGestures;
+	QList<Sample> samples;
+};
+
+struct Options
+{
+	QString corpus;
+	QStringList recognizers;
+	int threads;
+	int repeats;
+	QString json;
+};
+
+/// Outcome of recognition of every sample, in the order of the corpus
+struct Results
+{
+	QString recognizer;
+	QVector<QString> recognized;
+	/// Latencies of all recognitions, in nanoseconds
+	QVector<qint64> latencies;
+	qint64 buildTime;
+	qint64 wallTime;
+};
+
+StrokesList stringToGesture(QString const &str)
+{
+	StrokesList gesture;
+	foreach (QString const &strokeStr, str.split(strokeDelimeter, QString::SkipEmptyParts)) {
+		QList<QPoint> stroke;
+		foreach (QString const &pointStr, strokeStr.split(pointDelimeter, QString::SkipEmptyParts))
+			stroke << QPoint(pointStr.section(comma, 0, 0).toInt(), pointStr.section(comma, 1, 1).toInt());
+		if (!stroke.isEmpty())
+			gesture << stroke;
+	}
+	return gesture;
+}
+
+bool loadCorpus(QString const &fileName, Corpus &corpus)
+{
+	QFile file(fileName);
+	QDomDocument doc;
+	if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file))
+		return false;
+
+	QDomNodeList const elements = doc.elementsByTagName("gesture");
+	for (int i = 0; i < elements.size(); ++i) {
+		QDomElement const element = elements.at(i).toElement();
+		QString const name = element.attribute("name");
+		QString const idealPath = element.attribute("idealPath");
+		if (idealPath.isEmpty())
+			continue;
+		corpus.idealGestures << qMakePair(name, stringToGesture(idealPath));
+
+		QDomNodeList const userPaths = element.elementsByTagName("userPath");
+		for (int j = 0; j < userPaths.size(); ++j) {
+			Sample sample;
+			sample.object = name;
+			sample.gesture = stringToGesture(userPaths.at(j).toElement().attribute("path"));
+			corpus.samples << sample;
+		}
+	}
+	return true;
+}
+
+/// Recognizes a range of samples with its own recognizer
+class EvaluationJob : public QRunnable
+{
+public:
+	EvaluationJob(RecognizersFactory const &factory, Corpus const &corpus, int repeats
+			, int begin, int end, Results &results)
+		: mFactory(factory), mCorpus(corpus), mRepeats(repeats), mBegin(begin), mEnd(end)
+		, mName(results.recognizer), mRecognized(results.recognized.data())
+		, mLatencies(results.latencies.data()), mBuildTime(0)
+	{
+		setAutoDelete(false);
+	}
+
+	void run()
+	{
+		QElapsedTimer timer;
+		timer.start();
+		EvaluatedRecognizer *recognizer = mFactory.create(mName);
+		recognizer->setIdealGestures(mCorpus.idealGestures);
+		mBuildTime = timer.nsecsElapsed();
+
+		// Every job writes only its own items of results, vectors are detached beforehand
+		for (int i = mBegin; i < mEnd; ++i) {
+			for (int repeat = 0; repeat < mRepeats; ++repeat) {
+				timer.restart();
+				QString const object = recognizer->recognize(mCorpus.samples[i].gesture);
+				mLatencies[i * mRepeats + repeat] = timer.nsecsElapsed();
+				if (repeat == 0)
+					mRecognized[i] = object.isEmpty() ? rejected : object;
+			}
+		}
+		delete recognizer;
+	}
+
+	qint64 buildTime() const
+	{
+		return mBuildTime;
+	}
+
+private:
+	RecognizersFactory const &mFactory;
+	Corpus const &mCorpus;
+	int const mRepeats;
+	int const mBegin;
+	int const mEnd;
+	QString const mName;
+	QString * const mRecognized;
+	qint64 * const mLatencies;
+	qint64 mBuildTime;
+};
+
+Results evaluate(RecognizersFactory const &factory, QString const &recognizer, Corpus const &corpus
+		, Options const &options)
+{
+	int const samplesCount = corpus.samples.size();
+	Results results;
+	results.recognizer = recognizer;
+	results.recognized.resize(samplesCount);
+	results.latencies.resize(samplesCount * options.repeats);
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(options.threads);
+	int const jobsCount = qMax(1, qMin(options.threads, samplesCount));
+	QList<EvaluationJob *> jobs;
+	for (int i = 0; i < jobsCount; ++i) {
+		jobs << new EvaluationJob(factory, corpus, options.repeats
+				, samplesCount * i / jobsCount, samplesCount * (i + 1) / jobsCount, results);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	foreach (EvaluationJob *job, jobs)
+		pool.start(job);
+	pool.waitForDone();
+	results.wallTime = timer.nsecsElapsed();
+
+	results.buildTime = 0;
+	foreach (EvaluationJob *job, jobs)
+		results.buildTime = qMax(results.buildTime, job->buildTime());
+	qDeleteAll(jobs);
+	return results;
+}
+
+/// Nearest-rank percentile of sorted values
+qint64 percentile(QVector<qint64> const &sorted, double percent)
+{
+	if (sorted.isEmpty())
+		return 0;
+	int const rank = qBound(1, static_cast<int>(percent / 100 * sorted.size() + 0.999999), sorted.size());
+	return sorted[rank - 1];
+}
+
+QString jsonString(QString const &str)
+{
+	QString result = str;
+	result.replace('\\', "\\\\").replace('"', "\\\"");
+	return '"' + result + '"';
+}
+
+double microseconds(qint64 nanoseconds)
+{
+	return nanoseconds / 1000.0;
+}
+
+/// Accuracy and latency of one recognizer, in text and in JSON
+class Report
+{
+public:
+	Report(Corpus const &corpus, Results const &results)
+		: mCorpus(corpus), mResults(results), mCorrect(0), mRejected(0)
+	{
+		for (int i = 0; i < corpus.samples.size(); ++i) {
+			QString const &expected = corpus.samples[i].object;
+			QString const &recognized = results.recognized[i];
+			++mConfusion[expected][recognized];
+			if (recognized == expected)
+				++mCorrect;
+			else if (recognized == rejected)
+				++mRejected;
+		}
+		mSortedLatencies = results.latencies;
+		std::sort(mSortedLatencies.begin(), mSortedLatencies.end());
+	}
+
+	void writeText(QTextStream &out) const
+	{
+		int const total = mCorpus.samples.size();
+		out << mResults.recognizer << ": " << mCorrect << " of " << total << " recognized ("
+				<< 100.0 * mCorrect / qMax(1, total) << "%), " << mRejected << " rejected, "
+				<< total - mCorrect - mRejected << " wrong\n";
+		out << "  latency, us: p50 " << microseconds(percentile(mSortedLatencies, 50))
+				<< ", p90 " << microseconds(percentile(mSortedLatencies, 90))
+				<< ", p99 " << microseconds(percentile(mSortedLatencies, 99))
+				<< ", max " << microseconds(mSortedLatencies.isEmpty() ? 0 : mSortedLatencies.last())
+				<< "; templates built in " << microseconds(mResults.buildTime) << " us"
+				<< ", wall time " << mResults.wallTime / 1000000 << " ms\n";
+
+		// Rows are drawn objects, columns are what they were recognized as
+		QStringList const columns = this->columns();
+		out << "  confusion (row: drawn, column: recognized):\n    ";
+		for (int i = 0; i < columns.size(); ++i)
+			out << "\t" << i;
+		out << "\n";
+		foreach (QString const &row, rows()) {
+			out << "    ";
+			for (int i = 0; i < columns.size(); ++i)
+				out << "\t" << mConfusion.value(row).value(columns[i]);
+			out << "\t" << row << "\n";
+		}
+		for (int i = 0; i < columns.size(); ++i)
+			out << "    " << i << ": " << columns[i] << "\n";
+	}
+
+	void writeJson(QTextStream &out) const
+	{
+		int const total = mCorpus.samples.size();
+		out << "    {\n"
+				<< "      \"recognizer\": " << jsonString(mResults.recognizer) << ",\n"
+				<< "      \"samples\": " << total << ",\n"
+				<< "      \"recognized\": " << mCorrect << ",\n"
+				<< "      \"rejected\": " << mRejected << ",\n"
+				<< "      \"wrong\": " << total - mCorrect - mRejected << ",\n"
+				<< "      \"accuracy\": " << static_cast<double>(mCorrect) / qMax(1, total) << ",\n"
+				<< "      \"latencyUs\": {\"p50\": " << microseconds(percentile(mSortedLatencies, 50))
+				<< ", \"p90\": " << microseconds(percentile(mSortedLatencies, 90))
+				<< ", \"p99\": " << microseconds(percentile(mSortedLatencies, 99))
+				<< ", \"max\": " << microseconds(mSortedLatencies.isEmpty() ? 0 : mSortedLatencies.last())
+				<< "},\n"
+				<< "      \"buildTimeUs\": " << microseconds(mResults.buildTime) << ",\n"
+				<< "      \"wallTimeMs\": " << mResults.wallTime / 1000000 << ",\n"
+				<< "      \"confusion\": {";
+		QStringList const rows = this->rows();
+		for (int i = 0; i < rows.size(); ++i) {
+			out << (i ? ",\n" : "\n") << "        " << jsonString(rows[i]) << ": {";
+			QMap<QString, int> const &row = mConfusion[rows[i]];
+			bool first = true;
+			foreach (QString const &column, row.keys()) {
+				out << (first ? "" : ", ") << jsonString(column) << ": " << row[column];
+				first = false;
+			}
+			out << "}";
+		}
+		out << "\n      }\n    }";
+	}
+
+private:
+	QStringList rows() const
+	{
+		return mConfusion.keys();
+	}
+
+	QStringList columns() const
+	{
+		QStringList result = rows();
+		foreach (QString const &row, rows()) {
+			foreach (QString const &column, mConfusion[row].keys()) {
+				if (!result.contains(column))
+					result << column;
+			}
+		}
+		return result;
+	}
+
+	Corpus const &mCorpus;
+	Results const &mResults;
+	int mCorrect;
+	int mRejected;
+	QMap<QString, QMap<QString, int> > mConfusion;
+	QVector<qint64> mSortedLatencies;
+};
+
+bool parseOptions(QStringList const &arguments, QString const &defaultCorpus, Options &options)
+{
+	options.corpus = defaultCorpus;
+	options.threads = QThread::idealThreadCount();
+	options.repeats = 1;
+	for (int i = 1; i < arguments.size(); ++i) {
+		QString const &argument = arguments[i];
+		if (i + 1 >= arguments.size())
+			return false;
+		QString const value = arguments[++i];
+		if (argument == "--corpus")
+			options.corpus = value;
+		else if (argument == "--recognizers")
+			options.recognizers = value.split(",", QString::SkipEmptyParts);
+		else if (argument == "--threads")
+			options.threads = qMax(1, value.toInt());
+		else if (argument == "--repeats")
+			options.repeats = qMax(1, value.toInt());
+		else if (argument == "--json")
+			options.json = value;
+		else
+			return false;
+	}
+	return true;
+}
+
+}
+
+int runEvaluation(QStringList const &arguments, RecognizersFactory const &factory
+		, QString const &defaultCorpus)
+{
+	QTextStream out(stdout);
+	Options options;
+	if (!parseOptions(arguments, defaultCorpus, options)) {
+		out << "Usage: " << arguments.value(0) << " [--corpus FILE] [--recognizers A,B]"
+				<< " [--threads N] [--repeats N] [--json FILE|-]\n"
+				<< "Recognizers: " << factory.names().join(", ") << "\n";
+		return 2;
+	}
+	if (options.recognizers.isEmpty())
+		options.recognizers = factory.names();
+	foreach (QString const &name, options.recognizers) {
+		if (!factory.names().contains(name)) {
+			out << "Unknown recognizer " << name << "\n";
+			return 2;
+		}
+	}
+
+	Corpus corpus;
+	if (!loadCorpus(options.corpus, corpus)) {
+		out << "Can not read " << options.corpus << "\n";
+		return 1;
+	}
+
+	// Text report goes to standard error when JSON is written to standard output
+	QFile errorFile;
+	errorFile.open(stderr, QIODevice::WriteOnly);
+	QTextStream err(&errorFile);
+	QTextStream &text = options.json == "-" ? err : out;
+	text << "Corpus " << options.corpus << ": " << corpus.idealGestures.size() << " ideal gestures, "
+			<< corpus.samples.size() << " user gestures; " << options.threads << " threads, "
+			<< options.repeats << " repeats\n";
+
+	QList<Results> allResults;
+	foreach (QString const &name, options.recognizers) {
+		allResults << evaluate(factory, name, corpus, options);
+		Report(corpus, allResults.last()).writeText(text);
+		text.flush();
+	}
+
+	if (options.json.isEmpty())
+		return 0;
+
+	QFile jsonFile(options.json);
+	bool const opened = options.json == "-" ? jsonFile.open(stdout, QIODevice::WriteOnly)
+			: jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+	if (!opened) {
+		text << "Can not write " << options.json << "\n";
+		return 1;
+	}
+	QTextStream json(&jsonFile);
+	json << "{\n"
+			<< "  \"corpus\": " << jsonString(options.corpus) << ",\n"
+			<< "  \"idealGestures\": " << corpus.idealGestures.size() << ",\n"
+			<< "  \"samples\": " << corpus.samples.size() << ",\n"
+			<< "  \"threads\": " << options.threads << ",\n"
+			<< "  \"repeats\": " << options.repeats << ",\n"
+			<< "  \"recognizers\": [";
+	for (int i = 0; i < allResults.size(); ++i) {
+		json << (i ? ",\n" : "\n");
+		Report(corpus, allResults[i]).writeJson(json);
+	}
+	json << "\n  ]\n}\n";
+	return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QPoint>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+// Headless evaluation of gesture recognizers on a corpus of recorded user gestures
+// (usersGestures.xml of tools/gesturesTest and tools/MouseGestures).
+// Samples are split between threads of a pool, every thread works with its own instance of
+// a recognizer, and results are stored by sample, so a report does not depend on the number
+// of threads or on the order they finish in.
+
+/// Gesture as it was drawn: one list of points per stroke
+typedef QList<QList<QPoint> > StrokesList;
+
+/// Recognizer under evaluation. An instance is used by one thread only.
+class EvaluatedRecognizer
+{
+public:
+	virtual ~EvaluatedRecognizer() {}
+
+	virtual void setIdealGestures(QList<QPair<QString, StrokesList> > const &gestures) = 0;
+	/// Name of the recognized object, empty if the gesture is rejected
+	virtual QString recognize(StrokesList const &gesture) = 0;
+};
+
+/// Creates recognizers of one family, e.g. all algorithms of tools/gesturesTest
+class RecognizersFactory
+{
+public:
+	virtual ~RecognizersFactory() {}
+
+	virtual QStringList names() const = 0;
+	virtual EvaluatedRecognizer *create(QString const &name) const = 0;
+};
+
+/// Runs recognizers of the factory over the corpus and prints the report. Arguments:
+///   --corpus FILE       usersGestures.xml, defaultCorpus if omitted
+///   --recognizers A,B   recognizers to run, all of the factory by default
+///   --threads N         size of the thread pool, QThread::idealThreadCount() by default
+///   --repeats N         times every sample is recognized for latency, 1 by default
+///   --json FILE         also writes results to FILE in JSON, "-" for standard output
+/// Returns exit code of the program.
+int runEvaluation(QStringList const &arguments, RecognizersFactory const &factory
+		, QString const &defaultCorpus);
@@ -0,0 +1,11 @@
+QT += xml
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/evaluation.h
+
+SOURCES += $$PWD/evaluation.cpp
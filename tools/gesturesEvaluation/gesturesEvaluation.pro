@@ -0,0 +1,10 @@
+# Parallel, reproducible evaluation of gesture recognizers on recorded user gestures.
+# Recognizers of tools/gesturesTest, tools/MouseGestures and qrgui have classes with the same
+# names, so every family is evaluated by its own program built over the common evaluation.pri.
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+	singleStroke \
+	multistroke \
+	qrgui \
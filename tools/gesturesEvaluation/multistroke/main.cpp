@@ -0,0 +1,94 @@
+#include <QtCore/QCoreApplication>
+
+#include "evaluation.h"
+#include "abstractRecognizer.h"
+#include "multistrokeGesturesManagers.h"
+#include "rectanglegesturesmanager.h"
+#include "nearestposgridgesturesmanager.h"
+#include "sumMultistrokeGesturesManager.h"
+#include "mixedgesturesmanager.h"
+
+// Gesture managers of tools/MouseGestures are run through AbstractRecognizer,
+// the same way TestThread of MouseGestures tests them.
+
+namespace {
+
+class MultistrokeRecognizer : public EvaluatedRecognizer
+{
+public:
+	explicit MultistrokeRecognizer(GesturesManager *manager)
+		: mManager(manager), mRecognizer(manager)
+	{
+	}
+
+	~MultistrokeRecognizer()
+	{
+		delete mManager;
+	}
+
+	void setIdealGestures(QList<QPair<QString, StrokesList> > const &gestures)
+	{
+		QList<Entity> entities;
+		foreach (QPair<QString, StrokesList> const &gesture, gestures)
+			entities << Entity(gesture.first, gesture.second);
+		mRecognizer.setIdealGestures(entities);
+	}
+
+	QString recognize(StrokesList const &gesture)
+	{
+		return mRecognizer.recognizeObject(gesture);
+	}
+
+private:
+	GesturesManager * const mManager;
+	AbstractRecognizer mRecognizer;
+};
+
+class MultistrokeFactory : public RecognizersFactory
+{
+public:
+	QStringList names() const
+	{
+		return QStringList() << "levenshteinHull" << "oneSizeHull" << "levenshteinXYSort"
+				<< "oneSizeXYSort" << "squaresCurve" << "simpleMultistroke"
+				<< "rectangle" << "nearestPosGrid" << "sum" << "mixed";
+	}
+
+	EvaluatedRecognizer *create(QString const &name) const
+	{
+		return new MultistrokeRecognizer(createManager(name));
+	}
+
+private:
+	static GesturesManager *createManager(QString const &name)
+	{
+		if (name == "levenshteinHull")
+			return new LevenshteinHullGesturesManager();
+		if (name == "oneSizeHull")
+			return new OneSizeHullGesturesManager();
+		if (name == "levenshteinXYSort")
+			return new LevenshteinXYSortGesturesManager();
+		if (name == "oneSizeXYSort")
+			return new OneSizeXYSortGesturesManager();
+		if (name == "squaresCurve")
+			return new SquaresCurveGesturesManager();
+		if (name == "simpleMultistroke")
+			return new SimpleMultistrokeManager();
+		if (name == "rectangle")
+			return new RectangleGesturesManager();
+		if (name == "nearestPosGrid")
+			return new NearestPosGridGesturesManager();
+		if (name == "sum")
+			return new SumGesturesManager();
+		return new MixedGesturesManager();
+	}
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+	// Managers only compute keys, no widgets are created
+	QCoreApplication app(argc, argv);
+	return runEvaluation(app.arguments(), MultistrokeFactory(), "../../MouseGestures/usersGestures.xml");
+}
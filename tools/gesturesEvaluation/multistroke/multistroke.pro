@@ -0,0 +1,41 @@
+# Evaluation of gesture managers of tools/MouseGestures.
+# Usage: gesturesEvaluationMultistroke [--corpus FILE] [--recognizers A,B] [--threads N] [--repeats N] [--json FILE|-]
+
+# abstractRecognizer.h includes widgets for drawing gestures, nothing of them is used
+QT += gui
+
+TARGET = gesturesEvaluationMultistroke
+TEMPLATE = app
+
+include(../evaluation.pri)
+
+MOUSE_GESTURES = ../../MouseGestures
+
+INCLUDEPATH += \
+	$$MOUSE_GESTURES \
+	$$MOUSE_GESTURES/multistrokeRecognizers \
+
+HEADERS += \
+	$$MOUSE_GESTURES/GeometricForms.h \
+	$$MOUSE_GESTURES/abstractRecognizer.h \
+	$$MOUSE_GESTURES/validpathcreator.h \
+	$$MOUSE_GESTURES/pathcorrector.h \
+	$$MOUSE_GESTURES/adopter.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/distance.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/sorts.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/curveKeyBuilder.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/gridKeyBuilder.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/multistrokeGesturesManagers.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/rectanglegesturesmanager.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/nearestposgridgesturesmanager.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/sumMultistrokeGesturesManager.h \
+	$$MOUSE_GESTURES/multistrokeRecognizers/mixedgesturesmanager.h \
+
+SOURCES += main.cpp \
+	$$MOUSE_GESTURES/validpathcreator.cpp \
+	$$MOUSE_GESTURES/pathcorrector.cpp \
+	$$MOUSE_GESTURES/adopter.cpp \
+	$$MOUSE_GESTURES/multistrokeRecognizers/rectanglegesturesmanager.cpp \
+	$$MOUSE_GESTURES/multistrokeRecognizers/nearestposgridgesturesmanager.cpp \
+	$$MOUSE_GESTURES/multistrokeRecognizers/sumMultistrokeGesturesManager.cpp \
+	$$MOUSE_GESTURES/multistrokeRecognizers/mixedgesturesmanager.cpp \
@@ -0,0 +1,61 @@
+#include <QtCore/QCoreApplication>
+
+#include "evaluation.h"
+#include "gesturesrecognizer.h"
+
+// Recognizers of qrgui, as EditorManager creates them for a diagram; objects of the corpus
+// become elements of one diagram.
+
+namespace {
+
+class QrguiRecognizer : public EvaluatedRecognizer
+{
+public:
+	explicit QrguiRecognizer(QString const &name)
+		: mRecognizer(GesturesRecognizer::create(name))
+	{
+	}
+
+	~QrguiRecognizer()
+	{
+		delete mRecognizer;
+	}
+
+	void setIdealGestures(QList<QPair<QString, StrokesList> > const &gestures)
+	{
+		QList<QPair<qReal::Id, PathVector> > idealGestures;
+		foreach (QPair<QString, StrokesList> const &gesture, gestures)
+			idealGestures << qMakePair(qReal::Id("gestures", "evaluation", gesture.first), gesture.second);
+		mRecognizer->setIdealGestures(idealGestures);
+	}
+
+	QString recognize(StrokesList const &gesture)
+	{
+		return mRecognizer->recognize(gesture).element();
+	}
+
+private:
+	GesturesRecognizer * const mRecognizer;
+};
+
+class QrguiFactory : public RecognizersFactory
+{
+public:
+	QStringList names() const
+	{
+		return GesturesRecognizer::names();
+	}
+
+	EvaluatedRecognizer *create(QString const &name) const
+	{
+		return new QrguiRecognizer(name);
+	}
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	return runEvaluation(app.arguments(), QrguiFactory(), "../../MouseGestures/usersGestures.xml");
+}
@@ -0,0 +1,71 @@
+#include <QtCore/QCoreApplication>
+
+#include "evaluation.h"
+#include "gesturesmanager.h"
+
+// Algorithms of tools/gesturesTest work with one stroke, so strokes are joined in drawing order,
+// as the test window of gesturesTest records them.
+
+namespace {
+
+QList<QPoint> joinStrokes(StrokesList const &gesture)
+{
+	QList<QPoint> path;
+	foreach (QList<QPoint> const &stroke, gesture)
+		path << stroke;
+	return path;
+}
+
+class SingleStrokeRecognizer : public EvaluatedRecognizer
+{
+public:
+	typedef QString (GesturesManager::*Method)(QList<QPoint> const &path);
+
+	explicit SingleStrokeRecognizer(Method method)
+		: mMethod(method)
+	{
+	}
+
+	void setIdealGestures(QList<QPair<QString, StrokesList> > const &gestures)
+	{
+		QList<GestureObject> objects;
+		foreach (QPair<QString, StrokesList> const &gesture, gestures)
+			objects << qMakePair(gesture.first, joinStrokes(gesture.second));
+		mManager.setIdealGestres(objects);
+	}
+
+	QString recognize(StrokesList const &gesture)
+	{
+		return (mManager.*mMethod)(joinStrokes(gesture));
+	}
+
+private:
+	GesturesManager mManager;
+	Method const mMethod;
+};
+
+class SingleStrokeFactory : public RecognizersFactory
+{
+public:
+	QStringList names() const
+	{
+		return QStringList() << "qt" << "rectangle" << "chaosStar";
+	}
+
+	EvaluatedRecognizer *create(QString const &name) const
+	{
+		if (name == "qt")
+			return new SingleStrokeRecognizer(&GesturesManager::qtRecognize);
+		if (name == "rectangle")
+			return new SingleStrokeRecognizer(&GesturesManager::rectRecognize);
+		return new SingleStrokeRecognizer(&GesturesManager::chaosRecognize);
+	}
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	return runEvaluation(app.arguments(), SingleStrokeFactory(), "../../gesturesTest/usersGestures.xml");
+}
@@ -0,0 +1,29 @@
+# Evaluation of single stroke recognizers of tools/gesturesTest.
+# Usage: gesturesEvaluationSingleStroke [--corpus FILE] [--recognizers A,B] [--threads N] [--repeats N] [--json FILE|-]
+
+QT -= gui
+
+TARGET = gesturesEvaluationSingleStroke
+TEMPLATE = app
+
+include(../evaluation.pri)
+
+GESTURES_TEST = ../../gesturesTest
+
+INCLUDEPATH += $$GESTURES_TEST
+
+HEADERS += \
+	$$GESTURES_TEST/qtAlgorithm/mousegesturerecognizer.h \
+	$$GESTURES_TEST/common/levenshteindistance.h \
+	$$GESTURES_TEST/rectangleAlgorithm/keyBuilder.h \
+	$$GESTURES_TEST/rectangleAlgorithm/pathcorrector.h \
+	$$GESTURES_TEST/chaosStarAlgorithm/key8manager.h \
+	$$GESTURES_TEST/gesturesmanager.h \
+
+SOURCES += main.cpp \
+	$$GESTURES_TEST/qtAlgorithm/mousegesturerecognizer.cpp \
+	$$GESTURES_TEST/common/levenshteindistance.cpp \
+	$$GESTURES_TEST/rectangleAlgorithm/keyBuilder.cpp \
+	$$GESTURES_TEST/rectangleAlgorithm/pathcorrector.cpp \
+	$$GESTURES_TEST/chaosStarAlgorithm/key8manager.cpp \
+	$$GESTURES_TEST/gesturesmanager.cpp \
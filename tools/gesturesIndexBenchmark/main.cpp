@@ -0,0 +1,139 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtCore/QTime>
+#include <QtCore/QTextStream>
+#include <QtXml/QDomDocument>
+
+#include "gesturesrecognizer.h"
+#include "keymanager.h"
+#include "pathcorrector.h"
+#include "levenshteindistance.h"
+#include "gestureindex.h"
+
+// Runs recorded user gestures from tools/gesturesTest through the key builder of qrgui and
+// recognizes them twice: by the old linear scan over all ideal keys and by GestureIndex.
+// Reports accuracy of both (they must agree) and the average recognition time.
+// Keys are built as KeyStringRecognizer builds them, so the index sees the key distribution of qrgui.
+
+struct Sample
+{
+	QString name;
+	QString key;
+};
+
+// Strokes of a stored gesture joined into one path, as KeyStringRecognizer::joinStrokes does
+static PointVector stringToPath(QString const &valueStr)
+{
+	PointVector result;
+	foreach (PointVector const &stroke, GesturesRecognizer::stringToGesture(valueStr))
+		result << stroke;
+	return result;
+}
+
+static qReal::Id linearNearest(QString const &key, QMap<QString, qReal::Id> const &gestures)
+{
+	float const e = 100;
+	float const maxKeyDistance = 100;
+	float min = e;
+	qReal::Id id;
+	if (key.isEmpty())
+		return id;
+	foreach (QString const &idealKey, gestures.keys()) {
+		float const distance = static_cast<float>(LevenshteinDistance::getLevenshteinDistance(idealKey, key) * e
+				/ std::min(key.size(), idealKey.size()));
+		if (distance < min && distance < maxKeyDistance) {
+			min = distance;
+			id = gestures[idealKey];
+		}
+	}
+	return id;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+
+	QStringList const args = app.arguments();
+	QString const fileName = args.count() > 1 ? args[1] : "../gesturesTest/usersGestures.xml";
+	int const repeats = args.count() > 2 ? qMax(1, args[2].toInt()) : 20;
+
+	QFile file(fileName);
+	QDomDocument doc;
+	if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) {
+		out << "Can not read " << fileName << "\n";
+		return 1;
+	}
+	file.close();
+
+	KeyManager keyManager;
+	QMap<QString, qReal::Id> gestures;
+	GestureIndex index;
+	QList<Sample> samples;
+
+	QDomNodeList const elements = doc.elementsByTagName("gesture");
+	for (int i = 0; i < elements.size(); ++i) {
+		QDomElement const element = elements.at(i).toElement();
+		QString const name = element.attribute("name");
+		QString const idealPath = element.attribute("idealPath");
+		if (idealPath.isEmpty())
+			continue;
+
+		QString const idealKey = keyManager.getKey(PathCorrector::getMousePath(stringToPath(idealPath)));
+		qReal::Id const id("gestures", "benchmark", name);
+		gestures.insert(idealKey, id);
+		index.insert(idealKey, id);
+
+		QDomNodeList const userPaths = element.elementsByTagName("userPath");
+		for (int j = 0; j < userPaths.size(); ++j) {
+			PointVector const path = PathCorrector::correctPath(stringToPath(
+					userPaths.at(j).toElement().attribute("path")));
+			Sample sample;
+			sample.name = name;
+			sample.key = keyManager.getKey(path);
+			samples.append(sample);
+		}
+	}
+
+	int linearRecognized = 0;
+	int indexRecognized = 0;
+	int disagreements = 0;
+	long comparisons = 0;
+	foreach (Sample const &sample, samples) {
+		qReal::Id const linear = linearNearest(sample.key, gestures);
+		qReal::Id const indexed = index.nearest(sample.key);
+		comparisons += index.lastComparisons();
+		if (linear.element() == sample.name)
+			++linearRecognized;
+		if (indexed.element() == sample.name)
+			++indexRecognized;
+		if (linear != indexed)
+			++disagreements;
+	}
+
+	QTime timer;
+	timer.start();
+	for (int i = 0; i < repeats; ++i)
+		foreach (Sample const &sample, samples)
+			linearNearest(sample.key, gestures);
+	int const linearTime = timer.elapsed();
+
+	timer.restart();
+	for (int i = 0; i < repeats; ++i)
+		foreach (Sample const &sample, samples)
+			index.nearest(sample.key);
+	int const indexTime = timer.elapsed();
+
+	int const recognitions = qMax(1, samples.size() * repeats);
+	out << "Ideal gestures: " << gestures.size() << ", user gestures: " << samples.size() << "\n"
+			<< "linear scan: recognized " << linearRecognized << ", "
+			<< 1000.0 * linearTime / recognitions << " us per gesture\n"
+			<< "index: recognized " << indexRecognized << ", "
+			<< 1000.0 * indexTime / recognitions << " us per gesture, "
+			<< static_cast<double>(comparisons) / qMax(1, samples.size()) << " keys compared on average\n"
+			<< "disagreements: " << disagreements << "\n";
+
+	return disagreements == 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+# Accuracy and latency of the gesture recognizers of qrgui on recorded user gestures.
+# Usage: gesturesRecognizersBenchmark [PATH_TO_usersGestures.xml] [REPEATS] [TEMPLATES]
+
+QT += xml
+QT -= gui
+
+TARGET = gesturesRecognizersBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+QRGUI = ../../qreal/qrgui
+
+INCLUDEPATH += $$QRGUI/view/gestures
+
+HEADERS += \
+	$$QRGUI/kernel/ids.h \
+	$$QRGUI/view/gestures/keymanager.h \
+	$$QRGUI/view/gestures/pathcorrector.h \
+	$$QRGUI/view/gestures/levenshteindistance.h \
+	$$QRGUI/view/gestures/gestureindex.h \
+	$$QRGUI/view/gestures/gesturesrecognizer.h \
+	$$QRGUI/view/gestures/keystringrecognizer.h \
+	$$QRGUI/view/gestures/gridkeybuilder.h \
+	$$QRGUI/view/gestures/gridrecognizers.h \
+
+SOURCES += main.cpp \
+	$$QRGUI/kernel/ids.cpp \
+	$$QRGUI/view/gestures/keymanager.cpp \
+	$$QRGUI/view/gestures/pathcorrector.cpp \
+	$$QRGUI/view/gestures/levenshteindistance.cpp \
+	$$QRGUI/view/gestures/gestureindex.cpp \
+	$$QRGUI/view/gestures/gesturesrecognizer.cpp \
+	$$QRGUI/view/gestures/keystringrecognizer.cpp \
+	$$QRGUI/view/gestures/gridkeybuilder.cpp \
+	$$QRGUI/view/gestures/gridrecognizers.cpp \
@@ -0,0 +1,102 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+#include <QtCore/QFile>
+#include <QtCore/QTime>
+#include <QtCore/QTextStream>
+#include <QtXml/QDomDocument>
+
+#include "gesturesrecognizer.h"
+
+// Replays the corpus of tools/MouseGestures (the one TestThread uses) through every recognizer
+// qrgui can be configured with: ideal gestures become the templates, as EditorManager builds
+// them for a diagram, and every recorded user gesture is recognized against them.
+// Latency is measured against the ideal gestures copied up to TEMPLATES elements, since
+// a real metamodel has far more gestures than the corpus.
+
+struct Sample
+{
+	qReal::Id id;
+	PathVector gesture;
+};
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+
+	QStringList const args = app.arguments();
+	QString const fileName = args.count() > 1 ? args[1] : "../MouseGestures/usersGestures.xml";
+	int const repeats = args.count() > 2 ? qMax(1, args[2].toInt()) : 5;
+	int const templatesCount = args.count() > 3 ? args[3].toInt() : 300;
+
+	QFile file(fileName);
+	QDomDocument doc;
+	if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) {
+		out << "Can not read " << fileName << "\n";
+		return 1;
+	}
+	file.close();
+
+	QList<QPair<qReal::Id, PathVector> > idealGestures;
+	QList<Sample> samples;
+	QDomNodeList const elements = doc.elementsByTagName("gesture");
+	for (int i = 0; i < elements.size(); ++i) {
+		QDomElement const element = elements.at(i).toElement();
+		QString const idealPath = element.attribute("idealPath");
+		if (idealPath.isEmpty())
+			continue;
+		qReal::Id const id("gestures", "benchmark", element.attribute("name"));
+		idealGestures << qMakePair(id, GesturesRecognizer::stringToGesture(idealPath));
+
+		QDomNodeList const userPaths = element.elementsByTagName("userPath");
+		for (int j = 0; j < userPaths.size(); ++j) {
+			Sample sample;
+			sample.id = id;
+			sample.gesture = GesturesRecognizer::stringToGesture(userPaths.at(j).toElement().attribute("path"));
+			samples.append(sample);
+		}
+	}
+	out << "Ideal gestures: " << idealGestures.size() << ", user gestures: " << samples.size() << "\n";
+
+	QList<QPair<qReal::Id, PathVector> > manyGestures;
+	for (int i = 0; !idealGestures.isEmpty() && i < templatesCount; ++i) {
+		QPair<qReal::Id, PathVector> gesture = idealGestures[i % idealGestures.size()];
+		gesture.first = qReal::Id(gesture.first.editor(), gesture.first.diagram()
+				, gesture.first.element() + QString::number(i));
+		manyGestures << gesture;
+	}
+
+	foreach (QString const &name, GesturesRecognizer::names()) {
+		GesturesRecognizer *recognizer = GesturesRecognizer::create(name);
+
+		recognizer->setIdealGestures(idealGestures);
+
+		int recognized = 0;
+		foreach (Sample const &sample, samples) {
+			if (recognizer->recognize(sample.gesture) == sample.id)
+				++recognized;
+		}
+
+		GesturesRecognizer *manyRecognizer = GesturesRecognizer::create(name);
+		QTime timer;
+		timer.start();
+		manyRecognizer->setIdealGestures(manyGestures);
+		int const manyBuildTime = timer.elapsed();
+
+		timer.restart();
+		for (int i = 0; i < repeats; ++i)
+			foreach (Sample const &sample, samples)
+				manyRecognizer->recognize(sample.gesture);
+		int const recognitionTime = timer.elapsed();
+
+		int const recognitions = qMax(1, samples.size() * repeats);
+		out << name << ": recognized " << recognized << " ("
+				<< 100.0 * recognized / qMax(1, samples.size()) << "%); " << manyGestures.size() << " templates built in " << manyBuildTime << " ms, "
+				<< 1000.0 * recognitionTime / recognitions << " us per gesture\n";
+		out.flush();
+		delete manyRecognizer;
+		delete recognizer;
+	}
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+
+#include "../../qreal/qrrepo/repoApi.h"
+#include "../../qreal/qrgui/kernel/exception/exception.h"
+#include "../../qreal/typelib/typelib.h"
+
+// Types are compiled once, as EditorManager does for every property of a metamodel element,
+// then a stream of values (every tenth of them invalid) is checked against them.
+
+using namespace qReal;
+using namespace qRealType;
+
+namespace {
+
+Id const elementType("BenchmarkEditor", "BenchmarkDiagram", "BenchmarkElement");
+int const propertiesCount = 4;
+char const * const propertyNames[propertiesCount] = { "percent", "identifier", "visibility", "target" };
+
+class Schema : public qrRepo::PropertyValidator
+{
+public:
+	Schema()
+	{
+		QRealType const *integer = QRealTypeFactory::getTypeByName("integer");
+		QRealType const *string = QRealTypeFactory::getTypeByName("string");
+		mTypes << integer->restricted(QConstraintList() << QRealConstraint::range(0, 100));
+		mTypes << string->restricted(QConstraintList()
+				<< QRealConstraint::regExp("[A-Za-z_][A-Za-z0-9_]*"));
+		mTypes << string->restricted(QConstraintList() << QRealConstraint::enumeration(
+				QStringList() << "public" << "protected" << "private" << "package"));
+		mTypes << string->restricted(QConstraintList()
+				<< QRealConstraint::reference(QStringList(elementType.element())));
+	}
+
+	~Schema()
+	{
+		qDeleteAll(mTypes);
+	}
+
+	QRealType const &type(int slot) const
+	{
+		return *mTypes[slot];
+	}
+
+	virtual bool validate(Id const &type, QString const &name, QVariant const &value
+			, QString &error) const
+	{
+		if (type != elementType)
+			return true;
+		for (int i = 0; i < propertiesCount; ++i) {
+			if (name == propertyNames[i])
+				return mTypes[i]->checkString(value.toString(), &error);
+		}
+		return true;
+	}
+
+private:
+	QList<QRealType *> mTypes;
+};
+
+QString value(int slot, int i)
+{
+	bool const invalid = i % 10 == 9;
+	switch (slot) {
+	case 0:
+		return QString::number(invalid ? 100 + i % 100 : i % 101);
+	case 1:
+		return (invalid ? "1field" : "field") + QString::number(i % 1000);
+	case 2:
+		return invalid ? "friend" : (i % 2 ? "public" : "private");
+	default:
+		return invalid ? Id("BenchmarkEditor", "BenchmarkDiagram", "Other", "id").toString()
+				: Id(elementType, QString::number(i % 1000)).toString();
+	}
+}
+
+void checkValues(QTextStream &out, Schema const &schema, int valuesCount)
+{
+	// Values are prepared beforehand so that only the checks are timed
+	QStringList values;
+	for (int i = 0; i < 1000; ++i)
+		values << value(i % propertiesCount, i);
+
+	int rejected = 0;
+	QTime timer;
+	timer.start();
+	for (int i = 0; i < valuesCount; ++i) {
+		int const slot = i % values.size() % propertiesCount;
+		if (!schema.type(slot).checkString(values[i % values.size()]))
+			++rejected;
+	}
+	int const elapsed = timer.elapsed();
+	out << "check: " << valuesCount << " values in " << elapsed << " ms, "
+			<< (elapsed ? static_cast<qint64>(valuesCount) * 1000 / elapsed : 0) << " values/s, "
+			<< rejected << " rejected\n";
+	out.flush();
+}
+
+int import(QString const &saveDir, Schema const *schema, int elementsCount, int &rejected)
+{
+	qrRepo::RepoApi repo(saveDir);
+	repo.exterminate();
+	repo.setPropertyValidator(schema);
+
+	rejected = 0;
+	QTime timer;
+	timer.start();
+	for (int i = 0; i < elementsCount; ++i) {
+		Id const id = Id::createElementId(elementType.editor(), elementType.diagram()
+				, elementType.element());
+		repo.addChild(Id::rootId(), id);
+		QMap<QString, QVariant> properties;
+		for (int slot = 0; slot < propertiesCount; ++slot)
+			properties.insert(propertyNames[slot], value(slot, i));
+		try {
+			repo.setProperties(id, properties);
+		} catch (Exception const &) {
+			++rejected;
+		}
+	}
+	int const elapsed = timer.elapsed();
+	repo.exterminate();
+	return elapsed;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	int const valuesCount = arguments.size() > 1 ? arguments[1].toInt() : 1000000;
+	int const elementsCount = arguments.size() > 2 ? arguments[2].toInt() : 100000;
+
+	Schema const schema;
+	checkValues(out, schema, valuesCount);
+
+	QString const saveDir = QDir::temp().absoluteFilePath("qrealPropertyValidationBenchmark");
+	int rejected = 0;
+	int const plain = import(saveDir, NULL, elementsCount, rejected);
+	int const validated = import(saveDir, &schema, elementsCount, rejected);
+	out << "import of " << elementsCount << " elements: " << plain << " ms without validation, "
+			<< validated << " ms with validation, " << rejected << " elements rejected\n";
+	QDir().rmdir(saveDir);
+	return 0;
+}
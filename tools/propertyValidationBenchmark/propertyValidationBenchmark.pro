@@ -0,0 +1,18 @@
+# Throughput of checking property values against types compiled from a metamodel
+# (integer range, regular expression, enumeration, reference), alone and when the repository
+# validates every write of a bulk import.
+# Usage: propertyValidationBenchmark [VALUES] [ELEMENTS]
+
+QT += xml
+QT -= gui
+
+TARGET = propertyValidationBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+SOURCES += main.cpp
+
+LIBS += -L../../qreal/qrgui -lqrrepo -L../../qreal/typelib -ltypelib
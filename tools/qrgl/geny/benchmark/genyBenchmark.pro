@@ -0,0 +1,40 @@
+# Code generation throughput of geny for a model of ELEMENTS elements: classes with four
+# fields each, one output file per class, run with one thread and with THREADS threads.
+# Usage: genyBenchmark [ELEMENTS] [THREADS]
+
+TEMPLATE = app
+TARGET = genyBenchmark
+CONFIG += console
+CONFIG -= app_bundle
+DEPENDPATH += . ../interpreter
+INCLUDEPATH += . ../interpreter
+
+OBJECTS_DIR = .obj
+
+HEADERS += ../interpreter/gemake.h \
+           ../interpreter/interpreter.h \
+           ../interpreter/taskTemplate.h \
+           ../../../../unreal/trunk/qrrepo/repoApi.h \
+           ../../../../unreal/trunk/qrgui/kernel/roles.h \
+	   ../../../../unreal/trunk/qrgui/kernel/ids.h \
+	   ../../../../unreal/trunk/qrrepo/private/client.h \
+	   ../../../../unreal/trunk/qrgui/kernel/definitions.h \
+           ../../../../unreal/trunk/qrrepo/private/classes/object.h \
+           ../../../../unreal/trunk/qrrepo/private/qrRepoGlobal.h \
+           ../../../../unreal/trunk/qrrepo/private/serializer.h \
+           ../../../../unreal/trunk/qrrepo/repoControlInterface.h \
+           ../../../../unreal/trunk/qrrepo/commonRepoApi.h \
+           ../../../../unreal/trunk/qrrepo/graphicalRepoApi.h \
+           ../../../../unreal/trunk/qrrepo/logicalRepoApi.h
+SOURCES += main.cpp \
+           ../interpreter/gemake.cpp \
+           ../interpreter/interpreter.cpp \
+           ../interpreter/taskTemplate.cpp \
+	   ../../../../unreal/trunk/qrgui/kernel/ids.cpp \
+           ../../../../unreal/trunk/qrrepo/private/client.cpp \
+	   ../../../../unreal/trunk/qrrepo/private/classes/object.cpp \
+	   ../../../../unreal/trunk/qrrepo/private/serializer.cpp
+
+LIBS += -L../../../../unreal/trunk/qrgui -lqrrepo
+
+QMAKE_LFLAGS="-Wl,-O1,-rpath,$(PWD)/../../../../unreal/trunk/qrgui"
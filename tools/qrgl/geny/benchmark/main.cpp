@@ -0,0 +1,118 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QTime>
+
+#include "gemake.h"
+
+using namespace Geny;
+
+//Model: ELEMENTS / 5 classes with four fields each. Main task writes a file per class,
+//fields are generated by a subtask with a switch, so every construct of geny is involved.
+
+static void writeFile(const QString& filename, const QString& content) {
+	QFile file(filename);
+	if (file.open(QIODevice::WriteOnly | QIODevice::Text))
+		QTextStream(&file) << content;
+}
+
+static void createModel(const QString& repoPath, int elementsCount) {
+	qrRepo::RepoApi repo(repoPath);
+	repo.exterminate();
+
+	int const classesCount = elementsCount / 5;
+	for (int i = 0; i < classesCount; ++i) {
+		qReal::Id const classId = qReal::Id::createElementId("GenyBenchmark", "Diagram", "Class");
+		repo.addChild(qReal::Id::rootId(), classId);
+		repo.setProperty(classId, "name", "Class" + QString::number(i));
+		for (int j = 0; j < 4; ++j) {
+			qReal::Id const fieldId = qReal::Id::createElementId("GenyBenchmark", "Diagram", "Field");
+			repo.addChild(classId, fieldId);
+			repo.setProperty(fieldId, "name", "field" + QString::number(j));
+			repo.setProperty(fieldId, "type", j % 2 ? "int" : "String");
+			repo.setProperty(fieldId, "visibility", j == 0 ? "public" : "private");
+		}
+	}
+	repo.saveAll();
+}
+
+static QString createTasks(const QDir& dir, const QString& repoPath, const QString& outputPath) {
+	writeFile(dir.absoluteFilePath("main.geny"),
+			"Task Main\n"
+			"#!/ A file per class\n"
+			"#!foreach Class in elementsByType(Class)\n"
+			"#!{\n"
+			"#!toFile " + outputPath + "/@@name@@.java\n"
+			"#!{\n"
+			"class @@name@@ {\n"
+			"#!foreach Field in children\n"
+			"#!{\n"
+			"\t@@!task Field@@\n"
+			"#!}\n"
+			"}\n"
+			"#!}\n"
+			"#!}\n");
+	writeFile(dir.absoluteFilePath("field.geny"),
+			"Task Field\n"
+			"#!switch visibility\n"
+			"#!{\n"
+			"#!case 'public':\n"
+			"#!{\n"
+			"public @@type@@ @@name@@;\n"
+			"#!}\n"
+			"#!default\n"
+			"#!{\n"
+			"private @@type@@ @@name@@;\n"
+			"#!}\n"
+			"#!}\n");
+
+	QString const makeFilename = dir.absoluteFilePath("geMake.geny");
+	writeFile(makeFilename, repoPath + "\n"
+			+ dir.absoluteFilePath("main.geny") + "\n"
+			+ dir.absoluteFilePath("field.geny") + "\n");
+	return makeFilename;
+}
+
+static void run(QTextStream& out, const QString& makeFilename, int threadsCount, int elementsCount) {
+	QTime timer;
+	timer.start();
+	Gemake geMake(makeFilename);
+	int const loadTime = timer.elapsed();
+
+	geMake.setMaxThreadCount(threadsCount);
+	timer.restart();
+	geMake.make();
+	int const makeTime = timer.elapsed();
+
+	out << threadsCount << " thread(s): load " << loadTime << " ms, generation " << makeTime << " ms, "
+			<< (makeTime ? elementsCount * 1000 / makeTime : 0) << " elements/s, "
+			<< geMake.filesWritten() << " files\n";
+	out.flush();
+}
+
+int main(int argc, char *argv[]) {
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	int const elementsCount = arguments.size() > 1 ? arguments[1].toInt() : 10000;
+	int const threadsCount = arguments.size() > 2 ? arguments[2].toInt() : QThread::idealThreadCount();
+
+	QDir dir(QDir::temp().absoluteFilePath("qrealGenyBenchmark"));
+	dir.mkpath(dir.absolutePath());
+	dir.mkpath("output");
+	QString const repoPath = dir.absoluteFilePath("repo");
+
+	createModel(repoPath, elementsCount);
+	QString const makeFilename = createTasks(dir, repoPath, dir.absoluteFilePath("output"));
+
+	out << elementsCount << " elements\n";
+	run(out, makeFilename, 1, elementsCount);
+	if (threadsCount > 1)
+		run(out, makeFilename, threadsCount, elementsCount);
+
+	qrRepo::RepoApi(repoPath).exterminate();
+	return 0;
+}
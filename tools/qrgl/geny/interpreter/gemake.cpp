@@ -1,72 +1,194 @@
 #include <QStringList>
 #include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QTextStream>
 
 #include "interpreter.h"
 #include "gemake.h"
 
 using namespace Geny;
 
-Gemake::Gemake(QString gemakeFilename): makeFile(gemakeFilename), 
-		filesByTasks(0), inStream(0), repoPath("") {
+namespace {
+	//Block of toFile with the state of the interpreter it was met by
+	class ToFileJob : public QRunnable {
+		public:
+			ToFileJob(Gemake* geMaker, const qrRepo::RepoApi& rApi, const TaskTemplate& task,
+					const TemplateNode* node, const QString& filename, int sequenceNumber,
+					qReal::Id curObject, const QMap<QString, qReal::Id>& labels):
+					geMaker(geMaker), rApi(rApi), task(task), node(node), filename(filename),
+					sequenceNumber(sequenceNumber), curObject(curObject), labels(labels) {
+			}
+
+			void run() {
+				Interpreter ipreter(rApi, task, curObject, geMaker);
+				ipreter.setLabels(labels);
+				geMaker->writeFile(filename, ipreter.interpret(node->children), sequenceNumber);
+			}
+
+		private:
+			Gemake* geMaker;
+			const qrRepo::RepoApi& rApi;
+			const TaskTemplate& task;
+			const TemplateNode* node;
+			QString filename;
+			int sequenceNumber;
+			qReal::Id curObject;
+			QMap<QString, qReal::Id> labels;
+	};
+}
+
+Gemake::Gemake(QString gemakeFilename): makeFilename(gemakeFilename),
+		repoPath(""), rApi(0), lastSequenceNumber(0), writtenFilesCount(0) {
 	init();
 }
 
 Gemake::~Gemake() {
-	if (!inStream)
-		delete inStream;
-	if (!filesByTasks)
-		delete filesByTasks;
-	makeFile.close();
+	threadPool.waitForDone();
+	qDeleteAll(tasksByNames);
+	delete rApi;
 }
 
-QString Gemake::getTaskFilename(const QString& taskName) {
-	return filesByTasks->value(taskName);
+const TaskTemplate* Gemake::task(const QString& taskName) const {
+	return tasksByNames.value(taskName);
 }
 
 bool Gemake::init() {
-	if (!makeFile.isOpen() && makeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		inStream = new QTextStream(&makeFile);
-	}
-	
-	if (!makeFile.isOpen() || inStream == 0){
+	QFile makeFile(makeFilename);
+	if (!makeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
 		qDebug() << "cannot load make file \"" << makeFile.fileName() << "\"";
+		return false;
 	}
 
-	repoPath = inStream->readLine();
+	QTextStream inStream(&makeFile);
+	repoPath = inStream.readLine();
 
 	QStringList taskFilenames;
-	while (!inStream->atEnd()) {
-		QString curFilename = inStream->readLine();
+	while (!inStream.atEnd()) {
+		QString curFilename = inStream.readLine();
 		if (curFilename.trimmed().isEmpty())
 			continue;
 
 		taskFilenames.append(curFilename.trimmed());
 	}
-	
-	if (!filesByTasks)
-		delete filesByTasks;
-	filesByTasks = new QMap<QString, QString>();
+	makeFile.close();
+
+	qDeleteAll(tasksByNames);
+	tasksByNames.clear();
 
 	foreach (QString curFilename, taskFilenames) {
-		QFile curFile(curFilename);
-		QTextStream* curStream = 0;
-		if (curFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-			curStream = new QTextStream(&curFile);
-			QString startLine = curStream->readLine();
-			if (startLine.startsWith("Task ")) {
-				filesByTasks->insert(startLine.mid(5).trimmed(), curFilename);
-			}
-			else
-				qDebug() << "File" << curFilename << "doesn't start with task name";
+		TaskTemplate* curTask = TaskTemplate::load(curFilename);
+		if (!curTask)
+			continue;
+
+		if (tasksByNames.contains(curTask->name())) {
+			qDebug() << "Task" << curTask->name() << "from" << curFilename << "is already defined";
+			delete curTask;
+			continue;
 		}
-		else
-			qDebug() << "File" << curFilename << "wasn't found!";
+		tasksByNames.insert(curTask->name(), curTask);
 	}
 
+	delete rApi;
+	rApi = new qrRepo::RepoApi(repoPath);
+	elementsByTypes.clear();
+
 	return true;
 }
 
 void Gemake::make() {
-	Interpreter ipreter(repoPath, filesByTasks->value("Main"), qReal::Id(), this);
+	const TaskTemplate* mainTask = task("Main");
+	if (!rApi || !mainTask) {
+		qDebug() << "There is no \"Main\" task in make file \"" << makeFilename << "\"";
+		return;
+	}
+
+	//Workers read the repository together with the main interpreter, and reading loads
+	//it lazily. Snapshot has everything loaded and may be read from several threads
+	if (threadPool.maxThreadCount() > 1) {
+		qrRepo::RepoApi* const snapshot = rApi->snapshot();
+		delete rApi;
+		rApi = snapshot;
+		elementsByTypes.clear();
+	}
+
+	Interpreter ipreter(*rApi, *mainTask, qReal::Id(), this);
 	ipreter.interpret();
+
+	threadPool.waitForDone();
+}
+
+void Gemake::setMaxThreadCount(int count) {
+	threadPool.setMaxThreadCount(count);
+}
+
+int Gemake::filesWritten() const {
+	return writtenFilesCount;
+}
+
+qReal::IdList Gemake::elementsByType(const QString& type) {
+	QMutexLocker locker(&elementsMutex);
+	if (!elementsByTypes.contains(type)) {
+		qReal::IdList elements;
+		foreach (qReal::Id element, rApi->elementsByType(type)) {
+			if (rApi->isLogicalElement(element))
+				elements << element;
+		}
+		elementsByTypes.insert(type, elements);
+	}
+	return elementsByTypes.value(type);
+}
+
+void Gemake::toFile(const TaskTemplate& task, const TemplateNode* node, const QString& filename,
+		qReal::Id curObject, const QMap<QString, qReal::Id>& labels) {
+	ToFileJob* job = new ToFileJob(this, *rApi, task, node, filename, reserveFile(filename),
+			curObject, labels);
+
+	if (threadPool.maxThreadCount() <= 1) {
+		job->run();
+		delete job;
+	} else
+		threadPool.start(job);
+}
+
+int Gemake::reserveFile(const QString& filename) {
+	QMutexLocker locker(&filesMutex);
+	lastSequenceNumber++;
+	sequenceNumbersByFiles.insert(filename, lastSequenceNumber);
+	return lastSequenceNumber;
+}
+
+void Gemake::writeFile(const QString& filename, const QString& content, int sequenceNumber) {
+	QSharedPointer<QMutex> fileMutex;
+	{
+		QMutexLocker locker(&filesMutex);
+		if (sequenceNumbersByFiles.value(filename) != sequenceNumber)
+			return;
+		fileMutex = mutexesByFiles.value(filename);
+		if (!fileMutex) {
+			fileMutex = QSharedPointer<QMutex>(new QMutex());
+			mutexesByFiles.insert(filename, fileMutex);
+		}
+	}
+
+	//The file may be reserved again while the block that reserved it before is being written
+	QMutexLocker fileLocker(fileMutex.data());
+	{
+		QMutexLocker locker(&filesMutex);
+		if (sequenceNumbersByFiles.value(filename) != sequenceNumber)
+			return;
+	}
+
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		qDebug() << "cannot open \"" << file.fileName() << "\"";
+		return;
+	}
+
+	QTextStream out(&file);
+	out << content;
+	out.flush();
+	file.close();
+	writtenFilesCount.ref();
 }
@@ -1,11 +1,21 @@
 #pragma once
 
-#include <QString>
-#include <QFile>
-#include <QTextStream>
+#include <QAtomicInt>
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+//#include "../../../qrrepo/repoApi.h" // когда в транке лежит
+#include "../../../../unreal/trunk/qrrepo/repoApi.h" // когда лежит в tools
+
+#include "taskTemplate.h"
 
 namespace Geny {
+	//Loads the repository and parses all tasks once for the whole run.
+	//The repository is only read during the run, so toFile blocks that don't save labels
+	//are run in parallel, each by its own interpreter, over a snapshot of the repository.
 	class Gemake {
 		public:
 			Gemake(QString gemakeFilename);
@@ -13,12 +23,39 @@ namespace Geny {
 
 			bool init();
 			void make();
-			QString getTaskFilename(const QString& taskName);
+
+			//1 runs toFile blocks one after another, as they are met
+			void setMaxThreadCount(int count);
+			int filesWritten() const;
+
+			const TaskTemplate* task(const QString& taskName) const;
+
+			//Logical elements of the given type, looked up once per run
+			qReal::IdList elementsByType(const QString& type);
+
+			//Runs the block of toFile in a worker thread
+			void toFile(const TaskTemplate& task, const TemplateNode* node, const QString& filename,
+					qReal::Id curObject, const QMap<QString, qReal::Id>& labels);
+
+			//toFile blocks may write the same file: the block met last wins, as if they
+			//were run one after another. Returns a number to pass to writeFile.
+			int reserveFile(const QString& filename);
+			void writeFile(const QString& filename, const QString& content, int sequenceNumber);
 
 		private:
-			QFile makeFile;
-			QMap<QString, QString> *filesByTasks;
-			QTextStream* inStream;
+			QString makeFilename;
+			QMap<QString, TaskTemplate*> tasksByNames;
 			QString repoPath;
+			qrRepo::RepoApi* rApi;
+
+			QMutex elementsMutex;
+			QHash<QString, qReal::IdList> elementsByTypes;
+
+			QThreadPool threadPool;
+			QMutex filesMutex;
+			int lastSequenceNumber;
+			QHash<QString, int> sequenceNumbersByFiles;
+			QHash<QString, QSharedPointer<QMutex> > mutexesByFiles;
+			QAtomicInt writtenFilesCount;
 	};
 }
@@ -10,6 +10,7 @@ INCLUDEPATH += .
 # Input
 HEADERS += gemake.h \
            interpreter.h \
+           taskTemplate.h \
            ../../../../unreal/trunk/qrrepo/repoApi.h \
            ../../../../unreal/trunk/qrgui/kernel/roles.h \
 	   ../../../../unreal/trunk/qrgui/kernel/ids.h \
@@ -24,6 +25,7 @@ HEADERS += gemake.h \
            ../../../../unreal/trunk/qrrepo/logicalRepoApi.h
 SOURCES += gemake.cpp \
            interpreter.cpp \
+           taskTemplate.cpp \
            main.cpp \
 	   ../../../../unreal/trunk/qrgui/kernel/ids.cpp \
            ../../../../unreal/trunk/qrrepo/private/client.cpp \
@@ -10,6 +10,7 @@ INCLUDEPATH += .
 # Input
 HEADERS += gemake.h \
            interpreter.h \
+           taskTemplate.h \
            ../../../qrrepo/repoApi.h \
            ../../../qrgui/kernel/roles.h \
            ../../../qrgui/kernel/ids.h \
@@ -24,6 +25,7 @@ HEADERS += gemake.h \
            ../../../qrrepo/logicalRepoApi.h
 SOURCES += gemake.cpp \
            interpreter.cpp \
+           taskTemplate.cpp \
            main.cpp \
            ../../../qrgui/kernel/ids.cpp \
            ../../../qrrepo/private/client.cpp \
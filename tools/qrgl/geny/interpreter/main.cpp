@@ -12,6 +12,9 @@ int main(int argc, char *argv[]) {
 	}
 
 	Gemake geMake(argv[1]);
+	//второй параметр - число потоков для toFile, 1 - без параллельной генерации
+	if (argc > 2)
+		geMake.setMaxThreadCount(QString(argv[2]).toInt());
 	geMake.make();
 
 	//qDebug() << interpreter.interpret(); 
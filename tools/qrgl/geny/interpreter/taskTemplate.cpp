@@ -0,0 +1,347 @@
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+
+#include "taskTemplate.h"
+
+using namespace Geny;
+
+static bool containsSaveObj(const QList<TemplateNode*>& nodes) {
+	foreach (TemplateNode* node, nodes) {
+		if (node->type == TemplateNode::saveObjType || containsSaveObj(node->children))
+			return true;
+	}
+	return false;
+}
+
+TemplateNode::TemplateNode(NodeType type):
+		type(type), isDefault(false), savesLabels(false) {
+}
+
+TemplateNode::~TemplateNode() {
+	qDeleteAll(children);
+}
+
+TaskTemplate::TaskTemplate(const QString& name, const QString& filename):
+		taskName(name), taskFilename(filename), currentLine(0) {
+}
+
+TaskTemplate::~TaskTemplate() {
+	qDeleteAll(rootNodes);
+}
+
+TaskTemplate* TaskTemplate::load(const QString& filename) {
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		qDebug() << "cannot load file \"" << filename << "\"";
+		return 0;
+	}
+
+	QTextStream stream(&file);
+	QStringList lines;
+	while (!stream.atEnd())
+		lines << stream.readLine();
+	file.close();
+
+	if (lines.isEmpty() || !lines.first().startsWith("Task ")) {
+		qDebug() << "Task file" << filename << "doesn't start with \"Task __name__\"";
+		return 0;
+	}
+
+	TaskTemplate* result = new TaskTemplate(lines.first().mid(5).trimmed(), filename); //5 - "Task " length
+	result->lines = lines;
+	result->currentLine = 1;
+	result->parseBlock(result->rootNodes, false);
+	result->lines.clear();
+
+	return result;
+}
+
+QString TaskTemplate::name() const {
+	return taskName;
+}
+
+QString TaskTemplate::filename() const {
+	return taskFilename;
+}
+
+const QList<TemplateNode*>& TaskTemplate::nodes() const {
+	return rootNodes;
+}
+
+TaskTemplate::ControlStringType TaskTemplate::controlStringType(const QString& str) {
+	QString workStr = str.trimmed();
+	if (!workStr.startsWith("#!"))
+		return notControlType;
+
+	workStr = controlStringBody(workStr);
+
+	if (workStr.startsWith("/"))
+		return commentType;
+	if (workStr.startsWith("foreach "))
+		return foreachType;
+	if (workStr.startsWith("for "))
+		return forType;
+	if (workStr.startsWith("{"))
+		return leftBraceType;
+	if (workStr.startsWith("}"))
+		return rightBraceType;
+	if (workStr.startsWith("toFile"))
+		return toFileType;
+	if (workStr.startsWith("saveObj"))
+		return saveObjType;
+	if (workStr.startsWith("switch"))
+		return switchType;
+	if (workStr.startsWith("case") || workStr.startsWith("default"))
+		return caseType;
+
+	return notControlType;
+}
+
+QString TaskTemplate::controlStringBody(const QString& str) {
+	return str.trimmed().mid(2).trimmed(); //убираем #!
+}
+
+void TaskTemplate::parseBlock(QList<TemplateNode*>& nodes, bool inBraces) {
+	while (currentLine < lines.size()) {
+		QString curStr = lines.at(currentLine);
+		currentLine++;
+
+		switch (controlStringType(curStr)) {
+			case rightBraceType:
+				if (inBraces)
+					return;
+				error("#!} but not control expression (e.g. #!foreach) found!");
+				break;
+			case leftBraceType:
+				error("#!{ but not control expression (e.g. #!foreach) found!");
+				break;
+			case commentType:
+				break;
+			case notControlType:
+				{
+					TemplateNode* node = new TemplateNode(TemplateNode::lineType);
+					if (parseLine(curStr, node->segments) && !node->segments.isEmpty())
+						nodes << node;
+					else
+						delete node;
+					break;
+				}
+			default:
+				{
+					TemplateNode* node = parseControlString(curStr);
+					if (node)
+						nodes << node;
+				}
+		}
+	}
+
+	if (inBraces)
+		error("There is no brace balance!");
+}
+
+void TaskTemplate::parseBraceBlock(QList<TemplateNode*>& nodes) {
+	if (currentLine >= lines.size() || controlStringType(lines.at(currentLine)) != leftBraceType) {
+		error("After block operator not #!{ but \'"
+				+ (currentLine < lines.size() ? lines.at(currentLine) : QString()) + "\' found!");
+		return;
+	}
+
+	currentLine++;
+	parseBlock(nodes, true);
+}
+
+void TaskTemplate::parseCases(QList<TemplateNode*>& cases) {
+	if (currentLine >= lines.size() || controlStringType(lines.at(currentLine)) != leftBraceType) {
+		error("After #!switch not #!{ found!");
+		return;
+	}
+	currentLine++;
+
+	while (currentLine < lines.size()) {
+		QString caseStr = lines.at(currentLine);
+		currentLine++;
+
+		ControlStringType type = controlStringType(caseStr);
+		if (type == rightBraceType)
+			return;
+		if (type == commentType || caseStr.trimmed().isEmpty())
+			continue;
+		if (type != caseType) {
+			error("There is must be case string but \'" + caseStr + "\' found!");
+			continue;
+		}
+
+		TemplateNode* node = new TemplateNode(TemplateNode::caseType);
+		bool ok = parseCaseString(caseStr, node);
+		parseBraceBlock(node->children);
+		if (ok)
+			cases << node;
+		else
+			delete node;
+	}
+
+	error("There is no brace balance!");
+}
+
+TemplateNode* TaskTemplate::parseControlString(const QString& str) {
+	QStringList strElements = controlStringBody(str).split(' ', QString::SkipEmptyParts);
+	TemplateNode* node = 0;
+	bool ok = true;
+
+	switch (controlStringType(str)) {
+		case foreachType:
+			node = new TemplateNode(TemplateNode::foreachType);
+			ok = parseForeachString(str, node);
+			parseBraceBlock(node->children);
+			break;
+		case forType:
+			/*
+			strElements.at(1) : that method to call;
+			ex : #!for to - strElements.at(1) = "to"
+			ex : #!for parent - strElements.at(1) = "parent"
+			*/
+			node = new TemplateNode(TemplateNode::forType);
+			ok = strElements.size() == 2;
+			if (ok)
+				node->argument = strElements.at(1);
+			else
+				error("Bad \'for\' structure!");
+			parseBraceBlock(node->children);
+			break;
+		case toFileType:
+			node = new TemplateNode(TemplateNode::toFileType);
+			ok = strElements.size() == 2 && strElements.at(0) == "toFile";
+			if (ok)
+				ok = parseLine(strElements.at(1), node->segments);
+			else
+				error("Bad \'toFile\' structure!");
+			parseBraceBlock(node->children);
+			node->savesLabels = containsSaveObj(node->children);
+			break;
+		case saveObjType:
+			node = new TemplateNode(TemplateNode::saveObjType);
+			node->argument = controlStringBody(str).mid(7).trimmed(); //object label
+			break;
+		case switchType:
+			node = new TemplateNode(TemplateNode::switchType);
+			ok = strElements.size() == 2 && strElements.at(0) == "switch";
+			if (ok)
+				node->argument = strElements.at(1);
+			else
+				error("Bad \'switch\' structure!");
+			parseCases(node->children);
+			break;
+		case caseType:
+			error("#!case outside of #!switch found!");
+			node = new TemplateNode(TemplateNode::caseType);
+			ok = false;
+			parseBraceBlock(node->children);
+			break;
+		default:
+			break;
+	}
+
+	if (!ok) {
+		delete node;
+		return 0;
+	}
+	return node;
+}
+
+bool TaskTemplate::parseLine(const QString& str, QList<Segment>& segments) {
+	//Обработка @@_smth_@@
+	QStringList listOfSplitting = str.split("@@");
+	if (listOfSplitting.size() % 2 == 0) {
+		error("problem with number of @@");
+		return false;
+	}
+
+	//каждый нечетный элемент listOfSplitting - что-то между @@ @@
+	for (int i = 0; i < listOfSplitting.size(); ++i) {
+		Segment segment;
+		if (i % 2 == 0) {
+			if (listOfSplitting.at(i).isEmpty())
+				continue;
+			segment.type = Segment::textType;
+			segment.text = listOfSplitting.at(i);
+		} else if (!parseExpression(listOfSplitting.at(i), segment))
+			continue;
+		segments << segment;
+	}
+
+	return true;
+}
+
+bool TaskTemplate::parseExpression(const QString& expression, Segment& segment) {
+	QString workStr = expression.trimmed();
+	if (workStr.isEmpty()) {
+		error("Empty @@ @@ expression");
+		return false;
+	}
+
+	if (workStr.at(0) == '!') {
+		if (!workStr.startsWith("!task ")) {
+			error("Fail in @@! expression");
+			return false;
+		}
+		segment.type = Segment::taskType;
+		segment.text = workStr.mid(6).trimmed();
+		return true;
+	}
+
+	if (!workStr.contains('@')) {
+		segment.type = Segment::propertyType;
+		segment.text = workStr;
+		return true;
+	}
+
+	QStringList listOfSplitting = workStr.split("@");
+	if (listOfSplitting.size() != 2) {
+		error("Fail in \'@@ @ @@\' expression");
+		return false;
+	}
+	segment.type = Segment::labeledPropertyType;
+	segment.label = listOfSplitting.at(0).trimmed();
+	segment.text = listOfSplitting.at(1).trimmed();
+	return true;
+}
+
+bool TaskTemplate::parseForeachString(const QString& str, TemplateNode* node) {
+	QStringList strElements = controlStringBody(str).split(' ', QString::SkipEmptyParts);
+
+	if ( (strElements.size() != 4) ||
+			(strElements.at(0) != "foreach") || (strElements.at(2) != "in") ) {
+		error("Bad \'foreach\' structure!");
+		return false;
+	}
+
+	node->argument = strElements.at(1); //elementsType
+	node->listName = strElements.at(3); //elementsListName
+	return true;
+}
+
+bool TaskTemplate::parseCaseString(const QString& str, TemplateNode* node) {
+	QString workStr = controlStringBody(str);
+
+	if (workStr.startsWith("default")) {
+		node->isDefault = true;
+		return true;
+	}
+
+	QString caseValue = workStr.mid(4).trimmed(); //отрезаем "case"
+	int firstApostoIndex = caseValue.indexOf("\'");
+	int lastApostoIndex = caseValue.lastIndexOf("\'");
+
+	if (firstApostoIndex == -1 || lastApostoIndex == firstApostoIndex) {
+		error("Bad \'case\' structure!");
+		return false;
+	}
+
+	node->argument = caseValue.mid(firstApostoIndex + 1, lastApostoIndex - firstApostoIndex - 1);
+	return true;
+}
+
+void TaskTemplate::error(const QString& message) const {
+	qDebug() << "Error! In" << taskFilename << "line" << currentLine << ":" << message;
+}
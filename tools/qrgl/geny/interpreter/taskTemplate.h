@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Geny {
+	//Piece of a template line: plain text or an expression between @@ @@
+	struct Segment {
+		enum SegmentType {
+			textType,
+			propertyType, //@@property@@
+			labeledPropertyType, //@@label @ property@@
+			taskType //@@!task TaskName@@
+		};
+
+		SegmentType type;
+		QString text; //text, property name or task name
+		QString label;
+	};
+
+	struct TemplateNode {
+		enum NodeType {
+			lineType,
+			foreachType, forType,
+			switchType, caseType,
+			toFileType, saveObjType
+		};
+
+		explicit TemplateNode(NodeType type);
+		~TemplateNode();
+
+		NodeType type;
+
+		//lineType: the line itself, toFileType: the file name
+		QList<Segment> segments;
+
+		//foreachType: type of elements ("." for any), forType: method name,
+		//switchType: property name, caseType: case value, saveObjType: label
+		QString argument;
+		//foreachType: list method, e.g. "children" or "elementsByType(Class)"
+		QString listName;
+		//caseType: #!default
+		bool isDefault;
+		//toFileType: the block saves labels, so it can't be run apart from the task
+		bool savesLabels;
+
+		//Block of foreach, for, case and toFile, cases of switch
+		QList<TemplateNode*> children;
+	};
+
+	//Task file parsed once: control strings become nodes, @@ @@ expressions become segments.
+	//Templates are read-only after parsing, so one template may be run by several threads.
+	class TaskTemplate {
+		public:
+			~TaskTemplate();
+
+			//Returns 0 if the file can't be read or doesn't start with "Task __name__"
+			static TaskTemplate* load(const QString& filename);
+
+			QString name() const;
+			QString filename() const;
+			const QList<TemplateNode*>& nodes() const;
+
+		private:
+			TaskTemplate(const QString& name, const QString& filename);
+
+			enum ControlStringType {
+				commentType, foreachType,
+				forType,
+				leftBraceType, rightBraceType,
+				toFileType, saveObjType,
+				switchType, caseType,
+				notControlType
+			};
+			static ControlStringType controlStringType(const QString&);
+			//Control string without #! and surrounding spaces
+			static QString controlStringBody(const QString&);
+
+			//Parses lines up to the closing #!} or to the end of the file
+			void parseBlock(QList<TemplateNode*>& nodes, bool inBraces);
+			//Parses #!{ ... #!} starting at the current line
+			void parseBraceBlock(QList<TemplateNode*>& nodes);
+			void parseCases(QList<TemplateNode*>& cases);
+			//Returns 0 for comments and broken control strings, their blocks are skipped
+			TemplateNode* parseControlString(const QString& str);
+
+			bool parseLine(const QString& str, QList<Segment>& segments);
+			bool parseExpression(const QString& expression, Segment& segment);
+
+			//Fill in the node from "#!foreach Type in list", "#!case 'value':" or "#!default"
+			bool parseForeachString(const QString& str, TemplateNode* node);
+			bool parseCaseString(const QString& str, TemplateNode* node);
+
+			void error(const QString& message) const;
+
+			QString taskName;
+			QString taskFilename;
+			QList<TemplateNode*> rootNodes;
+
+			//Parsing state
+			QStringList lines;
+			int currentLine;
+	};
+}
@@ -0,0 +1,149 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtCore/QUuid>
+
+#include "../../qreal/qrrepo/repoApi.h"
+
+// Creates a flat logical model the way LogicalModel does: dense mode writes every link list
+// and every metamodel property with its default value, sparse mode writes only the name and
+// lets the repository resolve the rest from a default table. Saves of both modes hold all
+// properties, so their sizes are expected to match.
+
+using namespace qReal;
+
+namespace {
+
+Id const elementType("BenchmarkEditor", "BenchmarkDiagram", "BenchmarkElement");
+
+class Defaults : public qrRepo::DefaultPropertiesProvider
+{
+public:
+	explicit Defaults(int propertiesCount)
+	{
+		for (int i = 0; i < propertiesCount; ++i) {
+			mDefaults.insert("property" + QString::number(i), QString("default value %1").arg(i));
+		}
+	}
+
+	QStringList names() const
+	{
+		return mDefaults.keys();
+	}
+
+	virtual QVariant defaultPropertyValue(Id const &type, QString const &name) const
+	{
+		if (name == "from" || name == "to")
+			return Id::rootId().toVariant();
+		if (name == "links" || name == "outgoingConnections" || name == "incomingConnections"
+				|| name == "outgoingUsages" || name == "incomingUsages")
+		{
+			return IdListHelper::toVariant(IdList());
+		}
+		if (type != elementType || !mDefaults.contains(name))
+			return QVariant();
+		return mDefaults[name];
+	}
+
+	virtual QStringList defaultPropertyNames(Id const &type) const
+	{
+		QStringList result;
+		result << "from" << "to" << "links" << "outgoingConnections" << "incomingConnections"
+				<< "outgoingUsages" << "incomingUsages";
+		if (type == elementType)
+			result << names();
+		return result;
+	}
+
+private:
+	QMap<QString, QString> mDefaults;
+};
+
+/// Resident set size in kilobytes, 0 where /proc is not available.
+long residentMemory()
+{
+	QFile status("/proc/self/status");
+	if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+		return 0;
+	foreach (QString const &line, QString(status.readAll()).split('\n')) {
+		if (line.startsWith("VmRSS:"))
+			return line.section(' ', 1, 1, QString::SectionSkipEmpty).toLong();
+	}
+	return 0;
+}
+
+qint64 directorySize(QString const &path)
+{
+	qint64 result = 0;
+	QDirIterator iterator(path, QDir::Files, QDirIterator::Subdirectories);
+	while (iterator.hasNext()) {
+		iterator.next();
+		result += iterator.fileInfo().size();
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	if (arguments.size() < 2 || (arguments[1] != "sparse" && arguments[1] != "dense")) {
+		out << "Usage: repoDefaultsBenchmark sparse|dense [ELEMENTS] [PROPERTIES]\n";
+		return 1;
+	}
+	bool const sparse = arguments[1] == "sparse";
+	int const elementsCount = arguments.size() > 2 ? arguments[2].toInt() : 100000;
+	int const propertiesCount = arguments.size() > 3 ? arguments[3].toInt() : 10;
+
+	QString const saveDir = QDir::temp().absoluteFilePath("qrealRepoDefaultsBenchmark");
+	Defaults defaults(propertiesCount);
+	QStringList const propertyNames = defaults.names();
+
+	long const memoryBefore = residentMemory();
+	int elapsed = 0;
+	{
+		qrRepo::RepoApi repo(saveDir);
+		repo.exterminate();
+		if (sparse)
+			repo.setDefaultPropertiesProvider(&defaults);
+
+		QTime timer;
+		timer.start();
+		for (int i = 0; i < elementsCount; ++i) {
+			Id const id = Id::createElementId(elementType.editor(), elementType.diagram()
+					, elementType.element());
+			repo.addChild(Id::rootId(), id);
+			repo.setProperty(id, "name", "element " + QString::number(i));
+			if (sparse)
+				continue;
+			repo.setProperty(id, "from", Id::rootId().toVariant());
+			repo.setProperty(id, "to", Id::rootId().toVariant());
+			repo.setProperty(id, "links", IdListHelper::toVariant(IdList()));
+			repo.setProperty(id, "outgoingConnections", IdListHelper::toVariant(IdList()));
+			repo.setProperty(id, "incomingConnections", IdListHelper::toVariant(IdList()));
+			repo.setProperty(id, "outgoingUsages", IdListHelper::toVariant(IdList()));
+			repo.setProperty(id, "incomingUsages", IdListHelper::toVariant(IdList()));
+			foreach (QString const &name, propertyNames)
+				repo.setProperty(id, name, defaults.defaultPropertyValue(elementType, name));
+		}
+		elapsed = timer.elapsed();
+		out << (sparse ? "sparse" : "dense") << ": " << elementsCount << " elements with "
+				<< propertiesCount << " metamodel properties\n";
+		out << "creation: " << elapsed << " ms, "
+				<< (elapsed ? elementsCount * 1000 / elapsed : 0) << " elements/s\n";
+		out << "resident memory growth: " << residentMemory() - memoryBefore << " KB\n";
+		out.flush();
+
+		repo.saveAll();
+		out << "save size: " << directorySize(saveDir) / 1024 << " KB\n";
+		repo.exterminate();
+	}
+	QDir().rmdir(saveDir);
+	return 0;
+}
@@ -0,0 +1,18 @@
+# Memory, save size and element creation throughput of qrrepo with properties equal
+# to type defaults stored explicitly (dense) or resolved from a default table (sparse).
+# Usage: repoDefaultsBenchmark sparse|dense [ELEMENTS] [PROPERTIES]
+# Run each mode in a separate process, resident memory is read from /proc/self/status.
+
+QT += xml
+QT -= gui
+
+TARGET = repoDefaultsBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+SOURCES += main.cpp
+
+LIBS += -L../../qreal/qrgui -lqrrepo
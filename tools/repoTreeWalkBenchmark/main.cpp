@@ -0,0 +1,173 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+
+#include <cstdlib>
+#include <new>
+
+#include "../../qreal/qrrepo/repoApi.h"
+
+// Builds a class-diagram-like model and walks it as generators do: every element is visited
+// from the root, its name, type and a few properties are read, links of classes are followed
+// and elements of some types are looked up.
+
+using namespace qReal;
+
+namespace {
+
+unsigned long allocationsCount = 0;
+
+QString const editor = "BenchmarkEditor";
+QString const diagram = "BenchmarkDiagram";
+QString const nameProperty = "name";
+QString const typeProperty = "type";
+QString const linksProperty = "links";
+QString const visibilityProperty = "visibility";
+QString const classType = "BenchmarkClass";
+QString const fieldType = "BenchmarkField";
+QString const associationType = "BenchmarkAssociation";
+
+void createModel(qrRepo::RepoApi &repo, int diagramsCount, int classesCount, int fieldsCount)
+{
+	for (int i = 0; i < diagramsCount; ++i) {
+		Id const diagramId = Id::createElementId(editor, diagram, "BenchmarkDiagramNode");
+		repo.addChild(Id::rootId(), diagramId);
+		repo.setName(diagramId, "Diagram" + QString::number(i));
+
+		Id previousClass;
+		for (int j = 0; j < classesCount; ++j) {
+			Id const classId = Id::createElementId(editor, diagram, classType);
+			repo.addChild(diagramId, classId);
+			repo.setName(classId, "Class" + QString::number(j));
+			// Link lists are created with an element by the models of qrgui
+			repo.setProperty(classId, linksProperty, IdListHelper::toVariant(IdList()));
+			for (int k = 0; k < fieldsCount; ++k) {
+				Id const fieldId = Id::createElementId(editor, diagram, fieldType);
+				repo.addChild(classId, fieldId);
+				repo.setName(fieldId, "field" + QString::number(k));
+				repo.setProperty(fieldId, typeProperty, k % 2 ? "int" : "String");
+				repo.setProperty(fieldId, visibilityProperty, k == 0 ? "public" : "private");
+			}
+
+			if (previousClass != Id()) {
+				Id const association = Id::createElementId(editor, diagram, associationType);
+				repo.addChild(diagramId, association);
+				repo.setName(association, "association" + QString::number(j));
+				repo.setFrom(association, previousClass);
+				repo.setTo(association, classId);
+			}
+			previousClass = classId;
+		}
+	}
+}
+
+/// Walk with calls returning copies, as generators are written now.
+/// Returns the length of all strings read and the number of links followed.
+int copyingWalk(qrRepo::RepoApi const &repo, Id const &id)
+{
+	int result = 0;
+	if (repo.typeName(id) == fieldType) {
+		result += repo.property(id, typeProperty).toString().size();
+		result += repo.property(id, visibilityProperty).toString().size();
+	} else if (repo.typeName(id) == classType) {
+		result += repo.outgoingLinks(id).size();
+	}
+	IdList const children = repo.children(id);
+	foreach (Id const &child, children) {
+		result += repo.name(child).size();
+		result += copyingWalk(repo, child);
+	}
+	return result;
+}
+
+/// The same walk with accessors returning references
+int referenceWalk(qrRepo::RepoApi const &repo, Id const &id)
+{
+	int result = 0;
+	if (id.element() == fieldType) {
+		QMap<QString, QVariant> const &properties = repo.constProperties(id);
+		result += properties.value(typeProperty).toString().size();
+		result += properties.value(visibilityProperty).toString().size();
+	} else if (id.element() == classType) {
+		result += repo.outgoingLinks(id).size();
+	}
+	IdList const &children = repo.constChildren(id);
+	foreach (Id const &child, children) {
+		result += repo.constProperties(child).value(nameProperty).toString().size();
+		result += referenceWalk(repo, child);
+	}
+	return result;
+}
+
+void measure(QTextStream &out, QString const &name, qrRepo::RepoApi const &repo, int walks
+		, int (*walk)(qrRepo::RepoApi const &, Id const &))
+{
+	unsigned long const allocationsBefore = allocationsCount;
+	QTime timer;
+	timer.start();
+	int checksum = 0;
+	for (int i = 0; i < walks; ++i) {
+		checksum = walk(repo, Id::rootId());
+		checksum += repo.elementsByType(classType).size();
+		checksum += repo.elementsByType(associationType).size();
+	}
+	int const elapsed = timer.elapsed();
+	unsigned long const allocations = allocationsCount - allocationsBefore;
+
+	out << name << ": checksum " << checksum << ", " << allocations / qMax(1, walks)
+			<< " allocations per walk, " << elapsed / qMax(1, walks) << " ms per walk\n";
+	out.flush();
+}
+
+}
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+	++allocationsCount;
+	void * const result = std::malloc(size ? size : 1);
+	if (!result)
+		throw std::bad_alloc();
+	return result;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+void operator delete(void *pointer) throw()
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) throw()
+{
+	std::free(pointer);
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QStringList const arguments = app.arguments();
+	int const diagramsCount = arguments.size() > 1 ? arguments[1].toInt() : 20;
+	int const classesCount = arguments.size() > 2 ? arguments[2].toInt() : 50;
+	int const fieldsCount = arguments.size() > 3 ? arguments[3].toInt() : 5;
+	int const walks = arguments.size() > 4 ? qMax(1, arguments[4].toInt()) : 10;
+
+	QString const saveDir = QDir::temp().absoluteFilePath("qrealRepoTreeWalkBenchmark");
+	{
+		qrRepo::RepoApi repo(saveDir);
+		repo.exterminate();
+		createModel(repo, diagramsCount, classesCount, fieldsCount);
+		out << repo.elementsCount() << " elements\n";
+
+		measure(out, "copying calls", repo, walks, copyingWalk);
+		measure(out, "reference calls", repo, walks, referenceWalk);
+
+		repo.exterminate();
+	}
+	QDir().rmdir(saveDir);
+	return 0;
+}
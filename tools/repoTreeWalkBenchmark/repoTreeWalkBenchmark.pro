@@ -0,0 +1,20 @@
+# Heap allocations and time of a generator-like walk over a qrrepo model, made with calls that
+# return copies (children, property, elementsByType) and with read-only accessors returning
+# references (constChildren, constProperties).
+# Usage: repoTreeWalkBenchmark [DIAGRAMS] [CLASSES_PER_DIAGRAM] [FIELDS_PER_CLASS] [WALKS]
+# Allocations are counted by replacing global operator new, build against qrrepo of two
+# revisions to compare them.
+
+QT += xml
+QT -= gui
+
+TARGET = repoTreeWalkBenchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = .obj
+
+SOURCES += main.cpp
+
+LIBS += -L../../qreal/qrgui -lqrrepo